@@ -0,0 +1,188 @@
+#include "PCH.h"
+#include "../Core/Material/Material.h"
+#include "../Core/Math/Random.h"
+#include "../Core/Math/SamplingHelpers.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace rt;
+using namespace math;
+
+namespace {
+
+const char* const BenchmarkedBSDFs[] =
+{
+    "null", "diffuse", "roughDiffuse", "dielectric", "roughDielectric", "metal", "roughMetal", "plastic", "roughPlastic",
+};
+
+const uint32 NumSamples = 1024;
+
+struct BSDFBenchmarkInputs
+{
+    std::vector<Vector4> outgoingDirs;
+    std::vector<Vector4> incomingDirs;
+    std::vector<Vector4> samples;
+    std::vector<Vector4> baseColors;
+
+    BSDFBenchmarkInputs()
+    {
+        Random random;
+        for (uint32 i = 0; i < NumSamples; ++i)
+        {
+            outgoingDirs.push_back(SamplingHelpers::GetHemishpereCos(random.GetFloat2()));
+            incomingDirs.push_back(-SamplingHelpers::GetHemishpereCos(random.GetFloat2()));
+            samples.push_back(random.GetVector4());
+            baseColors.push_back(random.GetVector4());
+        }
+    }
+
+    RT_FORCE_INLINE static const Vector3x8 Pack(const std::vector<Vector4>& v, uint32 i)
+    {
+        return Vector3x8(v[i], v[i + 1], v[i + 2], v[i + 3], v[i + 4], v[i + 5], v[i + 6], v[i + 7]);
+    }
+};
+
+MaterialPtr CreateBenchmarkMaterial(const benchmark::State& state)
+{
+    MaterialPtr material = Material::Create();
+    material->SetBsdf(BenchmarkedBSDFs[state.range(0)]);
+    material->roughness = 0.3f;
+    material->Compile();
+    return material;
+}
+
+} // namespace
+
+static void Benchmark_BSDF_Sample(benchmark::State& state)
+{
+    const BSDFBenchmarkInputs inputs;
+    const MaterialPtr material = CreateBenchmarkMaterial(state);
+    const BSDF* bsdf = material->GetBSDF();
+
+    Wavelength wavelength;
+    SampledMaterialParameters params;
+    params.roughness = material->roughness.baseValue;
+    params.IoR = material->IoR;
+
+    RayColor weight = RayColor::Zero();
+
+    for (auto _ : state)
+    {
+        for (uint32 i = 0; i < NumSamples; ++i)
+        {
+            params.baseColor = RayColor(inputs.baseColors[i]);
+            BSDF::SamplingContext ctx{ *material, params, inputs.samples[i].ToFloat3(), inputs.outgoingDirs[i], wavelength };
+            if (bsdf->Sample(ctx))
+            {
+                weight += ctx.outColor;
+            }
+        }
+        benchmark::DoNotOptimize(weight);
+    }
+
+    state.SetLabel(bsdf->GetName());
+    state.SetItemsProcessed(state.iterations() * NumSamples);
+}
+BENCHMARK(Benchmark_BSDF_Sample)->DenseRange(0, 8);
+
+static void Benchmark_BSDF_Sample_Simd8(benchmark::State& state)
+{
+    const BSDFBenchmarkInputs inputs;
+    const MaterialPtr material = CreateBenchmarkMaterial(state);
+    const BSDF* bsdf = material->GetBSDF();
+
+    const Vector8 roughness(material->roughness.baseValue);
+    const Vector8 IoR(material->IoR);
+
+    Vector3x8 weight = Vector3x8::Zero();
+
+    for (auto _ : state)
+    {
+        for (uint32 i = 0; i < NumSamples; i += 8)
+        {
+            BSDF::SamplingContext_Simd8 ctx
+            {
+                *material,
+                BSDFBenchmarkInputs::Pack(inputs.baseColors, i),
+                roughness,
+                IoR,
+                BSDFBenchmarkInputs::Pack(inputs.samples, i),
+                BSDFBenchmarkInputs::Pack(inputs.outgoingDirs, i),
+            };
+            bsdf->Sample_Simd8(ctx);
+            weight += ctx.outColor;
+        }
+        benchmark::DoNotOptimize(weight);
+    }
+
+    state.SetLabel(bsdf->GetName());
+    state.SetItemsProcessed(state.iterations() * NumSamples);
+}
+BENCHMARK(Benchmark_BSDF_Sample_Simd8)->DenseRange(0, 8);
+
+static void Benchmark_BSDF_Evaluate(benchmark::State& state)
+{
+    const BSDFBenchmarkInputs inputs;
+    const MaterialPtr material = CreateBenchmarkMaterial(state);
+    const BSDF* bsdf = material->GetBSDF();
+
+    Wavelength wavelength;
+    SampledMaterialParameters params;
+    params.roughness = material->roughness.baseValue;
+    params.IoR = material->IoR;
+
+    RayColor weight = RayColor::Zero();
+    float pdf = 0.0f;
+
+    for (auto _ : state)
+    {
+        for (uint32 i = 0; i < NumSamples; ++i)
+        {
+            params.baseColor = RayColor(inputs.baseColors[i]);
+            const BSDF::EvaluationContext ctx{ *material, params, wavelength, inputs.outgoingDirs[i], inputs.incomingDirs[i] };
+            weight += bsdf->Evaluate(ctx, &pdf);
+        }
+        benchmark::DoNotOptimize(weight);
+        benchmark::DoNotOptimize(pdf);
+    }
+
+    state.SetLabel(bsdf->GetName());
+    state.SetItemsProcessed(state.iterations() * NumSamples);
+}
+BENCHMARK(Benchmark_BSDF_Evaluate)->DenseRange(0, 8);
+
+static void Benchmark_BSDF_Evaluate_Simd8(benchmark::State& state)
+{
+    const BSDFBenchmarkInputs inputs;
+    const MaterialPtr material = CreateBenchmarkMaterial(state);
+    const BSDF* bsdf = material->GetBSDF();
+
+    const Vector8 roughness(material->roughness.baseValue);
+    const Vector8 IoR(material->IoR);
+
+    Vector3x8 weight = Vector3x8::Zero();
+    Vector8 pdf = Vector8::Zero();
+
+    for (auto _ : state)
+    {
+        for (uint32 i = 0; i < NumSamples; i += 8)
+        {
+            const BSDF::EvaluationContext_Simd8 ctx
+            {
+                *material,
+                BSDFBenchmarkInputs::Pack(inputs.baseColors, i),
+                roughness,
+                IoR,
+                BSDFBenchmarkInputs::Pack(inputs.outgoingDirs, i),
+                BSDFBenchmarkInputs::Pack(inputs.incomingDirs, i),
+            };
+            weight += bsdf->Evaluate_Simd8(ctx, &pdf);
+        }
+        benchmark::DoNotOptimize(weight);
+        benchmark::DoNotOptimize(pdf);
+    }
+
+    state.SetLabel(bsdf->GetName());
+    state.SetItemsProcessed(state.iterations() * NumSamples);
+}
+BENCHMARK(Benchmark_BSDF_Evaluate_Simd8)->DenseRange(0, 8);
@@ -0,0 +1,159 @@
+#include "PCH.h"
+#include "../Core/Containers/DynArray.h"
+#include "../Core/Containers/SmallDynArray.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace rt;
+
+
+static void Benchmark_DynArray_PushBack(benchmark::State& state)
+{
+    const uint32 numElements = static_cast<uint32>(state.range(0));
+
+    for (auto _ : state)
+    {
+        DynArray<uint32> array;
+        for (uint32 i = 0; i < numElements; ++i)
+        {
+            array.PushBack(i);
+        }
+        benchmark::DoNotOptimize(array.Data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * numElements);
+}
+BENCHMARK(Benchmark_DynArray_PushBack)->RangeMultiplier(16)->Range(16, 1024 * 1024);
+
+
+static void Benchmark_StdVector_PushBack(benchmark::State& state)
+{
+    const uint32 numElements = static_cast<uint32>(state.range(0));
+
+    for (auto _ : state)
+    {
+        std::vector<uint32> array;
+        for (uint32 i = 0; i < numElements; ++i)
+        {
+            array.push_back(i);
+        }
+        benchmark::DoNotOptimize(array.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * numElements);
+}
+BENCHMARK(Benchmark_StdVector_PushBack)->RangeMultiplier(16)->Range(16, 1024 * 1024);
+
+
+// growing array of arrays, inner arrays are relocated with memcpy
+static void Benchmark_DynArray_PushBack_Nested(benchmark::State& state)
+{
+    const uint32 numElements = static_cast<uint32>(state.range(0));
+
+    for (auto _ : state)
+    {
+        DynArray<DynArray<uint32>> array;
+        for (uint32 i = 0; i < numElements; ++i)
+        {
+            array.EmplaceBack(4u, i);
+        }
+        benchmark::DoNotOptimize(array.Data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * numElements);
+}
+BENCHMARK(Benchmark_DynArray_PushBack_Nested)->RangeMultiplier(16)->Range(16, 64 * 1024);
+
+
+static void Benchmark_StdVector_PushBack_Nested(benchmark::State& state)
+{
+    const uint32 numElements = static_cast<uint32>(state.range(0));
+
+    for (auto _ : state)
+    {
+        std::vector<std::vector<uint32>> array;
+        for (uint32 i = 0; i < numElements; ++i)
+        {
+            array.emplace_back(4u, i);
+        }
+        benchmark::DoNotOptimize(array.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * numElements);
+}
+BENCHMARK(Benchmark_StdVector_PushBack_Nested)->RangeMultiplier(16)->Range(16, 64 * 1024);
+
+
+// short-lived tiny arrays, as in per-hit decal lists
+static void Benchmark_DynArray_ShortLived(benchmark::State& state)
+{
+    const uint32 numElements = static_cast<uint32>(state.range(0));
+
+    uint32 sum = 0;
+    for (auto _ : state)
+    {
+        DynArray<uint32> array;
+        for (uint32 i = 0; i < numElements; ++i)
+        {
+            array.PushBack(i);
+        }
+        for (const uint32 value : array)
+        {
+            sum += value;
+        }
+    }
+
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(Benchmark_DynArray_ShortLived)->Arg(2)->Arg(8)->Arg(32);
+
+
+static void Benchmark_SmallDynArray_ShortLived(benchmark::State& state)
+{
+    const uint32 numElements = static_cast<uint32>(state.range(0));
+
+    uint32 sum = 0;
+    for (auto _ : state)
+    {
+        SmallDynArray<uint32, 8> array;
+        for (uint32 i = 0; i < numElements; ++i)
+        {
+            array.PushBack(i);
+        }
+        for (const uint32 value : array)
+        {
+            sum += value;
+        }
+    }
+
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(Benchmark_SmallDynArray_ShortLived)->Arg(2)->Arg(8)->Arg(32);
+
+
+static void Benchmark_StdVector_ShortLived(benchmark::State& state)
+{
+    const uint32 numElements = static_cast<uint32>(state.range(0));
+
+    uint32 sum = 0;
+    for (auto _ : state)
+    {
+        std::vector<uint32> array;
+        for (uint32 i = 0; i < numElements; ++i)
+        {
+            array.push_back(i);
+        }
+        for (const uint32 value : array)
+        {
+            sum += value;
+        }
+    }
+
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(Benchmark_StdVector_ShortLived)->Arg(2)->Arg(8)->Arg(32);
@@ -74,6 +74,19 @@ static void Benchmark_Transcendental_FastExp4(benchmark::State& state)
 }
 BENCHMARK(Benchmark_Transcendental_FastExp4);
 
+static void Benchmark_Transcendental_FastExp8(benchmark::State& state)
+{
+    Vector8 x(-80.0f, -80.1f, -80.2f, -80.3f, -80.4f, -80.5f, -80.6f, -80.7f);
+    Vector8 y = Vector8::Zero();
+    for (auto _ : state)
+    {
+        y += FastExp(x);
+        x += Vector8(1.0e-6f);
+    }
+    benchmark::DoNotOptimize(y);
+}
+BENCHMARK(Benchmark_Transcendental_FastExp8);
+
 
 static void Benchmark_Transcendental_Log(benchmark::State& state)
 {
@@ -0,0 +1,264 @@
+#include "PCH.h"
+#include "../Core/Shapes/MeshShape.h"
+#include "../Core/Rendering/Context.h"
+#include "../Core/Rendering/RendererContext.h"
+#include "../Core/Traversal/TraversalContext.h"
+#include "../Core/Utils/Memory.h"
+#include "../Core/Utils/ThreadPool.h"
+#include "../Core/Math/Random.h"
+
+#include <benchmark/benchmark.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // __linux__
+
+using namespace rt;
+using namespace math;
+
+namespace {
+
+// random triangles scattered inside [-1, 1] cube
+MeshShapePtr CreateTriangleSoup(Random& random, const uint32 numTriangles)
+{
+    std::vector<Float3> positions;
+    std::vector<uint32> indices;
+    positions.reserve(3 * numTriangles);
+    indices.reserve(3 * numTriangles);
+
+    const std::vector<Float3> normals(3 * numTriangles, Float3(0.0f, 0.0f, 1.0f));
+    const std::vector<Float3> tangents(3 * numTriangles, Float3(1.0f, 0.0f, 0.0f));
+
+    for (uint32 i = 0; i < numTriangles; ++i)
+    {
+        const Vector4 center = random.GetVector4Bipolar();
+        for (uint32 j = 0; j < 3; ++j)
+        {
+            indices.push_back(static_cast<uint32>(positions.size()));
+            positions.push_back((center + random.GetVector4Bipolar() * 0.01f).ToFloat3());
+        }
+    }
+
+    const std::vector<uint32> materialIndices(numTriangles, UINT32_MAX);
+
+    MeshDesc meshDesc;
+    meshDesc.path = "triangleSoup";
+    meshDesc.vertexBufferDesc.numTriangles = numTriangles;
+    meshDesc.vertexBufferDesc.numVertices = static_cast<uint32>(positions.size());
+    meshDesc.vertexBufferDesc.materialIndexBuffer = materialIndices.data();
+    meshDesc.vertexBufferDesc.vertexIndexBuffer = indices.data();
+    meshDesc.vertexBufferDesc.positions = positions.data();
+    meshDesc.vertexBufferDesc.normals = normals.data();
+    meshDesc.vertexBufferDesc.tangents = tangents.data();
+
+    MeshShapePtr mesh = std::make_shared<MeshShape>();
+    if (!mesh->Initialize(meshDesc))
+    {
+        return nullptr;
+    }
+
+    return mesh;
+}
+
+// counts data TLB misses of the calling thread (if the kernel allows it)
+class DataTLBMissCounter
+{
+public:
+    DataTLBMissCounter()
+    {
+#if defined(__linux__)
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        mFile = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif // __linux__
+    }
+
+    ~DataTLBMissCounter()
+    {
+#if defined(__linux__)
+        if (mFile >= 0)
+        {
+            close(mFile);
+        }
+#endif // __linux__
+    }
+
+    bool IsAvailable() const
+    {
+        return mFile >= 0;
+    }
+
+    void Start()
+    {
+#if defined(__linux__)
+        if (mFile >= 0)
+        {
+            ioctl(mFile, PERF_EVENT_IOC_RESET, 0);
+            ioctl(mFile, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif // __linux__
+    }
+
+    uint64 Stop()
+    {
+        uint64 count = 0;
+#if defined(__linux__)
+        if (mFile >= 0)
+        {
+            ioctl(mFile, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(mFile, &count, sizeof(count)) != sizeof(count))
+            {
+                count = 0;
+            }
+        }
+#endif // __linux__
+        return count;
+    }
+
+private:
+    int mFile = -1;
+};
+
+} // namespace
+
+// Incoherent rays against a mesh whose BVH and vertex data span hundreds of megabytes.
+// Argument toggles large pages for the system allocator, so the TLB pressure of both variants can be compared.
+static void Benchmark_Traversal_LargeMesh(benchmark::State& state)
+{
+    MemoryInitOptions memoryOptions;
+    memoryOptions.useLargePages = state.range(0) != 0;
+    InitMemory(memoryOptions);
+
+    Random random;
+    const MeshShapePtr mesh = CreateTriangleSoup(random, 1024 * 1024);
+
+    // allocations made from now on must not be affected
+    InitMemory();
+
+    if (!mesh)
+    {
+        state.SkipWithError("Failed to create mesh");
+        return;
+    }
+
+    const uint32 numRays = 1024 * 16;
+    std::vector<Ray> rays;
+    rays.reserve(numRays);
+    for (uint32 i = 0; i < numRays; ++i)
+    {
+        const Vector4 origin = random.GetVector4Bipolar() * 2.0f;
+        const Vector4 target = random.GetVector4Bipolar();
+        rays.emplace_back(origin, target - origin);
+    }
+
+    RenderingContext context;
+    DataTLBMissCounter tlbMissCounter;
+
+    uint32 numHits = 0;
+    uint64 numTLBMisses = 0;
+
+    for (auto _ : state)
+    {
+        tlbMissCounter.Start();
+
+        for (const Ray& ray : rays)
+        {
+            HitPoint hitPoint;
+            mesh->Traverse({ ray, hitPoint, context }, 0);
+            numHits += hitPoint.distance < HitPoint::DefaultDistance ? 1 : 0;
+        }
+
+        numTLBMisses += tlbMissCounter.Stop();
+    }
+
+    benchmark::DoNotOptimize(numHits);
+
+    state.SetItemsProcessed(state.iterations() * numRays);
+
+    if (tlbMissCounter.IsAvailable())
+    {
+        state.counters["dTLB-misses/ray"] = benchmark::Counter(
+            static_cast<double>(numTLBMisses) / static_cast<double>(state.iterations() * numRays));
+    }
+}
+BENCHMARK(Benchmark_Traversal_LargeMesh)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// All hardware threads tracing incoherent rays against a large mesh.
+// Argument enables pinning threads to NUMA nodes together with per-node copies of BVH and triangles
+// (expected to be faster on multi-socket machines only).
+static void Benchmark_Traversal_LargeMesh_MultiThreaded(benchmark::State& state)
+{
+    const bool useNuma = state.range(0) != 0;
+
+    MemoryInitOptions memoryOptions;
+    memoryOptions.replicateOnNumaNodes = useNuma;
+    InitMemory(memoryOptions);
+
+    Random random;
+    const MeshShapePtr mesh = CreateTriangleSoup(random, 1024 * 1024);
+
+    InitMemory();
+
+    if (!mesh)
+    {
+        state.SkipWithError("Failed to create mesh");
+        return;
+    }
+
+    ThreadPool threadPool;
+    threadPool.SetNumThreads(0, useNuma);
+
+    DynArray<RenderingContext> contexts;
+    contexts.Resize(threadPool.GetNumThreads());
+    for (uint32 i = 0; i < contexts.Size(); ++i)
+    {
+        contexts[i].numaNode = threadPool.GetThreadNumaNode(i);
+    }
+
+    const uint32 numRaysPerTask = 1024;
+    const uint32 numTasks = 16 * threadPool.GetNumThreads();
+    std::vector<Ray> rays;
+    rays.reserve(numRaysPerTask * numTasks);
+    for (uint32 i = 0; i < numRaysPerTask * numTasks; ++i)
+    {
+        const Vector4 origin = random.GetVector4Bipolar() * 2.0f;
+        const Vector4 target = random.GetVector4Bipolar();
+        rays.emplace_back(origin, target - origin);
+    }
+
+    std::atomic<uint32> numHits(0);
+
+    const ParallelTask task = [&](uint32 taskID, uint32 threadID)
+    {
+        RenderingContext& context = contexts[threadID];
+
+        uint32 localNumHits = 0;
+        for (uint32 i = 0; i < numRaysPerTask; ++i)
+        {
+            HitPoint hitPoint;
+            mesh->Traverse({ rays[taskID * numRaysPerTask + i], hitPoint, context }, 0);
+            localNumHits += hitPoint.distance < HitPoint::DefaultDistance ? 1 : 0;
+        }
+
+        numHits += localNumHits;
+    };
+
+    for (auto _ : state)
+    {
+        threadPool.RunParallelTask(task, numTasks);
+    }
+
+    benchmark::DoNotOptimize(numHits.load());
+
+    state.SetItemsProcessed(state.iterations() * numRaysPerTask * numTasks);
+}
+BENCHMARK(Benchmark_Traversal_LargeMesh_MultiThreaded)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -24,11 +24,53 @@ BVH::BVH()
 
 bool BVH::AllocateNodes(uint32 numNodes)
 {
+    mNumaReplicas.Clear();
     mNodes.Resize(numNodes);
     mNumNodes = numNodes;
     return true;
 }
 
+bool BVH::CreateNumaReplicas()
+{
+    return mNumaReplicas.Create(mNodes.Data(), sizeof(Node) * mNumNodes);
+}
+
+bool BVH::Refit(const math::Box* leafBoxes, uint32 numLeaves)
+{
+    if (mNumNodes == 0)
+    {
+        return true;
+    }
+
+    RefitNode(0, leafBoxes, numLeaves);
+
+    return CreateNumaReplicas();
+}
+
+const math::Box BVH::RefitNode(uint32 nodeIndex, const math::Box* leafBoxes, uint32 numLeaves)
+{
+    Node& node = mNodes[nodeIndex];
+
+    math::Box box = math::Box::Empty();
+    if (node.IsLeaf())
+    {
+        RT_ASSERT(node.childIndex + node.numLeaves <= numLeaves);
+        for (uint32 i = 0; i < node.numLeaves; ++i)
+        {
+            box = math::Box(box, leafBoxes[node.childIndex + i]);
+        }
+    }
+    else
+    {
+        box = math::Box(RefitNode(node.childIndex, leafBoxes, numLeaves), RefitNode(node.childIndex + 1, leafBoxes, numLeaves));
+    }
+
+    node.min = box.min.ToFloat3();
+    node.max = box.max.ToFloat3();
+
+    return box;
+}
+
 bool BVH::SaveToFile(const std::string& filePath) const
 {
     FILE* file = fopen(filePath.c_str(), "wb");
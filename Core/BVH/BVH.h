@@ -7,6 +7,7 @@
 #include "../Math/Box.h"
 #include "../Math/Simd8Box.h"
 #include "../Utils/Memory.h"
+#include "../Utils/Numa.h"
 #include "../Containers/DynArray.h"
 
 #include <string>
@@ -87,16 +88,33 @@ public:
     bool SaveToFile(const std::string& filePath) const;
     bool LoadFromFile(const std::string& filePath);
 
+    // copy nodes to each NUMA node's memory (if enabled), must be called after the BVH is built
+    bool CreateNumaReplicas();
+
+    // recompute node bounds after leaves moved, keeping the tree topology (leaf boxes must be in the BVH leaves order)
+    // NOTE: tree quality degrades with large movements, rebuild is preferred then
+    bool Refit(const math::Box* leafBoxes, uint32 numLeaves);
+
     RT_FORCE_INLINE const Node* GetNodes() const { return mNodes.Data(); }
+
+    // get nodes from NUMA node's local copy (if present)
+    RT_FORCE_INLINE const Node* GetNodes(const uint32 numaNode) const
+    {
+        const void* replica = mNumaReplicas.Get(numaNode);
+        return replica ? static_cast<const Node*>(replica) : mNodes.Data();
+    }
     RT_FORCE_INLINE uint32 GetNumNodes() const { return mNumNodes; }
 
 private:
     void CalculateStatsForNode(uint32 node, Stats& outStats, uint32 depth) const;
+    const math::Box RefitNode(uint32 nodeIndex, const math::Box* leafBoxes, uint32 numLeaves);
     bool AllocateNodes(uint32 numNodes);
 
     DynArray<Node, SystemAllocator> mNodes;
     uint32 mNumNodes;
 
+    NumaReplicas mNumaReplicas;
+
     friend class BVHBuilder;
 };
 
@@ -66,19 +66,22 @@ bool BVHBuilder::Build(const Box* data, const uint32 numLeaves,
                 overallBox.min.f[0], overallBox.min.f[1], overallBox.min.f[2],
                 overallBox.max.f[0], overallBox.max.f[1], overallBox.max.f[2]);
 
-    WorkSet rootWorkSet;
-    rootWorkSet.box = overallBox;
-    rootWorkSet.numLeaves = mNumLeaves;
-    rootWorkSet.leafIndices.Reserve(mNumLeaves);
-    for (uint32 i = 0; i < mNumLeaves; ++i)
-    {
-        rootWorkSet.leafIndices.PushBack(i);
-    }
-
     Timer timer;
     timer.Start();
 
     {
+        // all the temporary index lists are allocated from the thread's frame arena
+        FrameAllocatorScope frameAllocatorScope;
+
+        WorkSet rootWorkSet;
+        rootWorkSet.box = overallBox;
+        rootWorkSet.numLeaves = mNumLeaves;
+        rootWorkSet.leafIndices.Reserve(mNumLeaves);
+        for (uint32 i = 0; i < mNumLeaves; ++i)
+        {
+            rootWorkSet.leafIndices.PushBack(i);
+        }
+
         Context context(mNumLeaves);
 
         BVH::Node& rootNode = mTarget.mNodes.Front();
@@ -86,6 +89,9 @@ bool BVHBuilder::Build(const Box* data, const uint32 numLeaves,
         BuildNode(rootWorkSet, context, rootNode);
     }
 
+    // building is one-off, don't keep the scratch memory around
+    FrameAllocator::ReleaseUnusedMemory();
+
     RT_ASSERT(mNumGeneratedLeaves == mNumLeaves); // Number of generated leaves is invalid
     RT_ASSERT(mNumGeneratedNodes <= 2 * mNumLeaves); // Number of generated nodes is invalid
 
@@ -140,7 +146,7 @@ void BVHBuilder::BuildNode(const WorkSet& workSet, Context& context, BVH::Node&
 
     for (uint32 axis = 0; axis < NumAxes; ++axis)
     {
-        const Indices& sortedIndices = context.mSortedLeavesIndicesCache[axis];
+        const ScratchIndices& sortedIndices = context.mSortedLeavesIndicesCache[axis];
 
         // calculate left child node AABB for each possible split position
         {
@@ -213,11 +219,15 @@ void BVHBuilder::BuildNode(const WorkSet& workSet, Context& context, BVH::Node&
     childWorkSet.sortedBy = bestAxis;
     childWorkSet.depth = workSet.depth + 1;
 
-    const Indices& sortedIndices = context.mSortedLeavesIndicesCache[bestAxis];
+    const ScratchIndices& sortedIndices = context.mSortedLeavesIndicesCache[bestAxis];
+
+    // child lists are released after both subtrees are built
+    // Note: sorted indices cache is preallocated for all the leaves, so it never grows within this scope
+    FrameAllocatorScope frameAllocatorScope;
 
-    Indices leftIndices, rightIndices;
-    leftIndices.Resize_SkipConstructor(leftCount);
-    rightIndices.Resize_SkipConstructor(rightCount);
+    NodeLeafIndices leftIndices, rightIndices;
+    leftIndices.Resize(leftCount);
+    rightIndices.Resize(rightCount);
     memcpy(leftIndices.Data(), sortedIndices.Data(), sizeof(uint32) * leftCount);
     memcpy(rightIndices.Data(), sortedIndices.Data() + leftCount, sizeof(uint32) * rightCount);
 
@@ -246,12 +256,14 @@ void BVHBuilder::SortLeaves(const WorkSet& workSet, Context& context) const
 {
     for (uint32 axis = 0; axis < NumAxes; ++axis)
     {
-        Indices& indicesToSort = context.mSortedLeavesIndicesCache[axis];
+        ScratchIndices& indicesToSort = context.mSortedLeavesIndicesCache[axis];
+
+        // the cache is preallocated for all the leaves, so this never allocates
+        indicesToSort.Resize_SkipConstructor(workSet.numLeaves);
+        memcpy(indicesToSort.Data(), workSet.leafIndices.Data(), sizeof(uint32) * workSet.numLeaves);
 
         if (workSet.sortedBy != axis) // sort only what needs to be sorted
         {
-            indicesToSort = workSet.leafIndices;
-
             const auto comparator = [this, axis](const uint32 a, const uint32 b)
             {
                 RT_ASSERT(a < mNumLeaves);
@@ -269,11 +281,6 @@ void BVHBuilder::SortLeaves(const WorkSet& workSet, Context& context) const
             std::sort(indicesToSort.begin(), indicesToSort.end(), comparator);
         }
     }
-
-    if (workSet.sortedBy < NumAxes)
-    {
-        context.mSortedLeavesIndicesCache[workSet.sortedBy] = std::move(workSet.leafIndices);
-    }
 }
 
 } // namespace rt
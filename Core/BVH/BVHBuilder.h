@@ -2,6 +2,7 @@
 
 #include "RayLib.h"
 #include "BVH.h"
+#include "../Containers/SmallDynArray.h"
 
 namespace rt {
 
@@ -36,11 +37,17 @@ private:
 
     constexpr static uint32 NumAxes = 3;
 
+    // temporary leaf lists, released when the build is finished
+    using ScratchIndices = DynArray<uint32, FrameAllocator>;
+
+    // leaf lists of a node, most nodes are close to the bottom of the tree so their lists stay inline
+    using NodeLeafIndices = SmallDynArray<uint32, 16, FrameAllocator>;
+
     struct Context
     {
         DynArray<math::Box> mLeftBoxesCache;
         DynArray<math::Box> mRightBoxesCache;
-        Indices mSortedLeavesIndicesCache[3];
+        ScratchIndices mSortedLeavesIndicesCache[3];
 
         Context(uint32 numLeaves);
     };
@@ -48,7 +55,7 @@ private:
     struct RT_ALIGN(16) WorkSet
     {
         math::Box box;
-        Indices leafIndices;
+        NodeLeafIndices leafIndices;
         uint32 numLeaves;
         uint32 sortedBy;
         uint32 depth;
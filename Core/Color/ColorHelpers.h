@@ -14,7 +14,7 @@ RT_GLOBAL_CONST math::Vector4 XYZtoRGB_b = {  0.055648f, -0.204043f,  1.057311f,
 
 // Convert linear to sRGB
 template<typename T>
-RT_FORCE_INLINE math::Vector4 Convert_sRGB_To_Linear(const T& gammaColor)
+RT_FORCE_INLINE const T Convert_sRGB_To_Linear(const T& gammaColor)
 {
     // based on:
     // http://chilliant.blogspot.com/2012/08/srgb-approximations-for-hlsl.html
@@ -28,7 +28,7 @@ RT_FORCE_INLINE math::Vector4 Convert_sRGB_To_Linear(const T& gammaColor)
 
 // Convert sRGB to linear
 template<typename T>
-RT_FORCE_INLINE math::Vector4 Convert_Linear_To_sRGB(const T& linearColor)
+RT_FORCE_INLINE const T Convert_Linear_To_sRGB(const T& linearColor)
 {
     // based on:
     // http://chilliant.blogspot.com/2012/08/srgb-approximations-for-hlsl.html
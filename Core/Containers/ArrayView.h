@@ -11,16 +11,18 @@ namespace rt {
 /**
  * A view of contiguous array of elements.
  * Access type (const vs. non-const) depends on ElementType.
+ * SizeType can be set to size_t for arrays that may exceed 4G elements.
  */
-template<typename ElementType>
+template<typename ElementType, typename SizeType = uint32>
 class ArrayView
 {
-    template<typename T, typename Allocator> friend class DynArray;
+    template<typename T, typename Allocator, typename Policy> friend class DynArray;
 
 public:
+    static_assert(std::is_unsigned<SizeType>::value, "Array size type must be unsigned");
 
     // maximum size of array view (1 element is reserved for iterator to the end)
-    static constexpr uint32 MaxSize = std::numeric_limits<uint32>::max() - 1;
+    static constexpr SizeType MaxSize = std::numeric_limits<SizeType>::max() - 1;
 
     using Iterator = ArrayIterator<ElementType>;
     using ConstIterator = ConstArrayIterator<ElementType>;
@@ -29,7 +31,7 @@ public:
     RT_FORCE_INLINE ArrayView();
 
     // create view of raw array
-    RT_FORCE_INLINE ArrayView(ElementType* elements, uint32 numElements);
+    RT_FORCE_INLINE ArrayView(ElementType* elements, SizeType numElements);
 
     // copy/move constructor/assignment
     ArrayView(const ArrayView& other) = default;
@@ -39,17 +41,17 @@ public:
 
     // copy constructor from read-write-typed to const-typed
     template<typename ElementType2>
-    ArrayView(const ArrayView<ElementType2>& other);
+    ArrayView(const ArrayView<ElementType2, SizeType>& other);
 
     // copy assignment from read-write-typed to const-typed
     template<typename ElementType2>
-    ArrayView& operator = (const ArrayView<ElementType2>& other);
+    ArrayView& operator = (const ArrayView<ElementType2, SizeType>& other);
 
 
     /**
      * Get number of elements.
      */
-    RT_FORCE_INLINE uint32 Size() const;
+    RT_FORCE_INLINE SizeType Size() const;
 
     /**
      * Get raw data pointed by the view.
@@ -92,15 +94,15 @@ public:
      * Element access operators.
      * @note The index must be valid. Otherwise it will cause an assertion.
      */
-    RT_FORCE_INLINE ElementType& operator[](uint32 index);
-    RT_FORCE_INLINE const ElementType& operator[](uint32 index) const;
+    RT_FORCE_INLINE ElementType& operator[](SizeType index);
+    RT_FORCE_INLINE const ElementType& operator[](SizeType index) const;
 
     /**
      * Create view of a sub-range.
      * @param index Starting index.
      * @param size  Number of elements in range.
      */
-    RT_FORCE_INLINE ArrayView Range(uint32 index, uint32 size) const;
+    RT_FORCE_INLINE ArrayView Range(SizeType index, SizeType size) const;
 
     /**
      * Find element by value.
@@ -120,7 +122,7 @@ public:
 
 protected:
     alignas(void*) ElementType* mElements;
-    uint32 mSize;
+    SizeType mSize;
 };
 
 #pragma pack(pop)
@@ -129,26 +131,26 @@ protected:
 /**
  * Comparison operators.
  */
-template<typename ElementTypeA, typename ElementTypeB>
-bool operator == (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTypeB>& rhs);
-template<typename ElementTypeA, typename ElementTypeB>
-bool operator != (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTypeB>& rhs);
-template<typename ElementTypeA, typename ElementTypeB>
-bool operator < (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTypeB>& rhs);
-template<typename ElementTypeA, typename ElementTypeB>
-bool operator > (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTypeB>& rhs);
-template<typename ElementTypeA, typename ElementTypeB>
-bool operator <= (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTypeB>& rhs);
-template<typename ElementTypeA, typename ElementTypeB>
-bool operator >= (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTypeB>& rhs);
+template<typename ElementTypeA, typename ElementTypeB, typename SizeType>
+bool operator == (const ArrayView<ElementTypeA, SizeType>& lhs, const ArrayView<ElementTypeB, SizeType>& rhs);
+template<typename ElementTypeA, typename ElementTypeB, typename SizeType>
+bool operator != (const ArrayView<ElementTypeA, SizeType>& lhs, const ArrayView<ElementTypeB, SizeType>& rhs);
+template<typename ElementTypeA, typename ElementTypeB, typename SizeType>
+bool operator < (const ArrayView<ElementTypeA, SizeType>& lhs, const ArrayView<ElementTypeB, SizeType>& rhs);
+template<typename ElementTypeA, typename ElementTypeB, typename SizeType>
+bool operator > (const ArrayView<ElementTypeA, SizeType>& lhs, const ArrayView<ElementTypeB, SizeType>& rhs);
+template<typename ElementTypeA, typename ElementTypeB, typename SizeType>
+bool operator <= (const ArrayView<ElementTypeA, SizeType>& lhs, const ArrayView<ElementTypeB, SizeType>& rhs);
+template<typename ElementTypeA, typename ElementTypeB, typename SizeType>
+bool operator >= (const ArrayView<ElementTypeA, SizeType>& lhs, const ArrayView<ElementTypeB, SizeType>& rhs);
 
 
 /**
  * Calculate hash of an array view.
  * @note This function is meant to be fast (it's used in hash tables), not to be cryptographically secure.
  */
-template<typename ElementType>
-uint32 GetHash(const ArrayView<ElementType>& arrayView);
+template<typename ElementType, typename SizeType>
+uint32 GetHash(const ArrayView<ElementType, SizeType>& arrayView);
 
 
 } // namespace rt
@@ -4,23 +4,23 @@
 
 namespace rt {
 
-template<typename ElementType>
-ArrayView<ElementType>::ArrayView()
+template<typename ElementType, typename SizeType>
+ArrayView<ElementType, SizeType>::ArrayView()
     : mElements(nullptr)
     , mSize(0)
 {
 }
 
-template<typename ElementType>
-ArrayView<ElementType>::ArrayView(ElementType* elements, uint32 numElements)
+template<typename ElementType, typename SizeType>
+ArrayView<ElementType, SizeType>::ArrayView(ElementType* elements, SizeType numElements)
     : mElements(elements)
     , mSize(numElements)
 {
 }
 
-template<typename ElementType>
+template<typename ElementType, typename SizeType>
 template<typename ElementType2>
-ArrayView<ElementType>::ArrayView(const ArrayView<ElementType2>& other)
+ArrayView<ElementType, SizeType>::ArrayView(const ArrayView<ElementType2, SizeType>& other)
 {
     static_assert(std::is_same<typename std::remove_cv<ElementType>::type, ElementType2>::value,
                   "Only (non-const -> const) ArrayView element type conversion is supported");
@@ -29,9 +29,9 @@ ArrayView<ElementType>::ArrayView(const ArrayView<ElementType2>& other)
     mSize = other.Size();
 }
 
-template<typename ElementType>
+template<typename ElementType, typename SizeType>
 template<typename ElementType2>
-ArrayView<ElementType>& ArrayView<ElementType>::operator = (const ArrayView<ElementType2>& other)
+ArrayView<ElementType, SizeType>& ArrayView<ElementType, SizeType>::operator = (const ArrayView<ElementType2, SizeType>& other)
 {
     static_assert(std::is_same<typename std::remove_cv<ElementType>::type, ElementType2>::value,
                   "Only (non-const -> const) ArrayView element type conversion is supported");
@@ -43,110 +43,110 @@ ArrayView<ElementType>& ArrayView<ElementType>::operator = (const ArrayView<Elem
 
 //////////////////////////////////////////////////////////////////////////
 
-template<typename ElementType>
-uint32 ArrayView<ElementType>::Size() const
+template<typename ElementType, typename SizeType>
+SizeType ArrayView<ElementType, SizeType>::Size() const
 {
     return mSize;
 }
 
-template<typename ElementType>
-bool ArrayView<ElementType>::Empty() const
+template<typename ElementType, typename SizeType>
+bool ArrayView<ElementType, SizeType>::Empty() const
 {
     return mSize == 0;
 }
 
-template<typename ElementType>
-const ElementType* ArrayView<ElementType>::Data() const
+template<typename ElementType, typename SizeType>
+const ElementType* ArrayView<ElementType, SizeType>::Data() const
 {
     return mElements;
 }
 
-template<typename ElementType>
-ElementType* ArrayView<ElementType>::Data()
+template<typename ElementType, typename SizeType>
+ElementType* ArrayView<ElementType, SizeType>::Data()
 {
     return mElements;
 }
 
-template<typename ElementType>
-const ElementType& ArrayView<ElementType>::Front() const
+template<typename ElementType, typename SizeType>
+const ElementType& ArrayView<ElementType, SizeType>::Front() const
 {
     RT_ASSERT(mSize > 0, "Array is empty");
     return mElements[0];
 }
 
-template<typename ElementType>
-ElementType& ArrayView<ElementType>::Front()
+template<typename ElementType, typename SizeType>
+ElementType& ArrayView<ElementType, SizeType>::Front()
 {
     RT_ASSERT(mSize > 0, "Array is empty");
     return mElements[0];
 }
 
-template<typename ElementType>
-const ElementType& ArrayView<ElementType>::Back() const
+template<typename ElementType, typename SizeType>
+const ElementType& ArrayView<ElementType, SizeType>::Back() const
 {
     RT_ASSERT(mSize > 0, "Array is empty");
     return mElements[mSize - 1];
 }
 
-template<typename ElementType>
-ElementType& ArrayView<ElementType>::Back()
+template<typename ElementType, typename SizeType>
+ElementType& ArrayView<ElementType, SizeType>::Back()
 {
     static_assert(!std::is_const<ElementType>::value, "You can only use ConstIterator for const-typed ArrayView");
     RT_ASSERT(mSize > 0, "Array is empty");
     return mElements[mSize - 1];
 }
 
-template<typename ElementType>
-typename ArrayView<ElementType>::ConstIterator ArrayView<ElementType>::Begin() const
+template<typename ElementType, typename SizeType>
+typename ArrayView<ElementType, SizeType>::ConstIterator ArrayView<ElementType, SizeType>::Begin() const
 {
     return ConstIterator(mElements, 0);
 }
 
-template<typename ElementType>
-typename ArrayView<ElementType>::Iterator ArrayView<ElementType>::Begin()
+template<typename ElementType, typename SizeType>
+typename ArrayView<ElementType, SizeType>::Iterator ArrayView<ElementType, SizeType>::Begin()
 {
     return Iterator(mElements, 0);
 }
 
-template<typename ElementType>
-typename ArrayView<ElementType>::ConstIterator ArrayView<ElementType>::End() const
+template<typename ElementType, typename SizeType>
+typename ArrayView<ElementType, SizeType>::ConstIterator ArrayView<ElementType, SizeType>::End() const
 {
     return ConstIterator(mElements, mSize);
 }
 
-template<typename ElementType>
-typename ArrayView<ElementType>::Iterator ArrayView<ElementType>::End()
+template<typename ElementType, typename SizeType>
+typename ArrayView<ElementType, SizeType>::Iterator ArrayView<ElementType, SizeType>::End()
 {
     return Iterator(mElements, mSize);
 }
 
-template<typename ElementType>
-ElementType& ArrayView<ElementType>::operator[](uint32 index)
+template<typename ElementType, typename SizeType>
+ElementType& ArrayView<ElementType, SizeType>::operator[](SizeType index)
 {
     static_assert(!std::is_const<ElementType>::value, "You can only use const-reference to access const-typed ArrayView elements");
-    RT_ASSERT(index < mSize, "Invalid array index %u (size is %u)", index, mSize);
+    RT_ASSERT(index < mSize, "Invalid array index %zu (size is %zu)", static_cast<size_t>(index), static_cast<size_t>(mSize));
     return mElements[index];
 }
 
-template<typename ElementType>
-const ElementType& ArrayView<ElementType>::operator[](uint32 index) const
+template<typename ElementType, typename SizeType>
+const ElementType& ArrayView<ElementType, SizeType>::operator[](SizeType index) const
 {
-    RT_ASSERT(index < mSize, "Invalid array index %u (size is %u)", index, mSize);
+    RT_ASSERT(index < mSize, "Invalid array index %zu (size is %zu)", static_cast<size_t>(index), static_cast<size_t>(mSize));
     return mElements[index];
 }
 
-template<typename ElementType>
-ArrayView<ElementType> ArrayView<ElementType>::Range(uint32 index, uint32 size) const
+template<typename ElementType, typename SizeType>
+ArrayView<ElementType, SizeType> ArrayView<ElementType, SizeType>::Range(SizeType index, SizeType size) const
 {
-    RT_ASSERT(index < mSize, "Invalid array index %u (size is %u)", index, mSize);
-    RT_ASSERT(index + size < mSize + 1, "Subrange exceedes array size (last index is %u, size is %u)", index + size, mSize);
+    RT_ASSERT(index < mSize, "Invalid array index %zu (size is %zu)", static_cast<size_t>(index), static_cast<size_t>(mSize));
+    RT_ASSERT(index + size < mSize + 1, "Subrange exceedes array size (last index is %zu, size is %zu)", static_cast<size_t>(index + size), static_cast<size_t>(mSize));
     return ArrayView(mElements + index, size);
 }
 
-template<typename ElementType>
-typename ArrayView<ElementType>::ConstIterator ArrayView<ElementType>::Find(const ElementType& element) const
+template<typename ElementType, typename SizeType>
+typename ArrayView<ElementType, SizeType>::ConstIterator ArrayView<ElementType, SizeType>::Find(const ElementType& element) const
 {
-    for (uint32 i = 0; i < mSize; ++i)
+    for (SizeType i = 0; i < mSize; ++i)
     {
         if (mElements[i] == element)
         {
@@ -157,10 +157,10 @@ typename ArrayView<ElementType>::ConstIterator ArrayView<ElementType>::Find(cons
     return End();
 }
 
-template<typename ElementType>
-typename ArrayView<ElementType>::Iterator ArrayView<ElementType>::Find(const ElementType& element)
+template<typename ElementType, typename SizeType>
+typename ArrayView<ElementType, SizeType>::Iterator ArrayView<ElementType, SizeType>::Find(const ElementType& element)
 {
-    for (uint32 i = 0; i < mSize; ++i)
+    for (SizeType i = 0; i < mSize; ++i)
     {
         if (mElements[i] == element)
         {
@@ -171,8 +171,8 @@ typename ArrayView<ElementType>::Iterator ArrayView<ElementType>::Find(const Ele
     return End();
 }
 
-template<typename ElementTypeA, typename ElementTypeB>
-bool operator == (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTypeB>& rhs)
+template<typename ElementTypeA, typename ElementTypeB, typename SizeType>
+bool operator == (const ArrayView<ElementTypeA, SizeType>& lhs, const ArrayView<ElementTypeB, SizeType>& rhs)
 {
     static_assert(std::is_same<typename std::remove_cv<ElementTypeA>::type,
                                typename std::remove_cv<ElementTypeB>::type>::value,
@@ -181,7 +181,7 @@ bool operator == (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTyp
     if (lhs.Size() != rhs.Size())
         return false;
 
-    for (uint32 i = 0; i < lhs.Size(); ++i)
+    for (SizeType i = 0; i < lhs.Size(); ++i)
     {
         if (lhs[i] != rhs[i])
         {
@@ -192,8 +192,8 @@ bool operator == (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTyp
     return true;
 }
 
-template<typename ElementTypeA, typename ElementTypeB>
-bool operator != (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTypeB>& rhs)
+template<typename ElementTypeA, typename ElementTypeB, typename SizeType>
+bool operator != (const ArrayView<ElementTypeA, SizeType>& lhs, const ArrayView<ElementTypeB, SizeType>& rhs)
 {
     static_assert(std::is_same<typename std::remove_cv<ElementTypeA>::type,
                                typename std::remove_cv<ElementTypeB>::type>::value,
@@ -202,7 +202,7 @@ bool operator != (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTyp
     if (lhs.Size() != rhs.Size())
         return true;
 
-    for (uint32 i = 0; i < lhs.Size(); ++i)
+    for (SizeType i = 0; i < lhs.Size(); ++i)
     {
         if (lhs[i] != rhs[i])
         {
@@ -213,8 +213,8 @@ bool operator != (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTyp
     return false;
 }
 
-template<typename ElementTypeA, typename ElementTypeB>
-bool operator < (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTypeB>& rhs)
+template<typename ElementTypeA, typename ElementTypeB, typename SizeType>
+bool operator < (const ArrayView<ElementTypeA, SizeType>& lhs, const ArrayView<ElementTypeB, SizeType>& rhs)
 {
     static_assert(std::is_same<typename std::remove_cv<ElementTypeA>::type,
                                typename std::remove_cv<ElementTypeB>::type>::value,
@@ -226,7 +226,7 @@ bool operator < (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementType
     if (lhs.Size() > rhs.Size())
         return false;
 
-    for (uint32 i = 0; i < lhs.Size(); ++i)
+    for (SizeType i = 0; i < lhs.Size(); ++i)
     {
         if (lhs[i] < rhs[i])
             return true;
@@ -239,14 +239,14 @@ bool operator < (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementType
     return false;
 }
 
-template<typename ElementTypeA, typename ElementTypeB>
-bool operator > (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTypeB>& rhs)
+template<typename ElementTypeA, typename ElementTypeB, typename SizeType>
+bool operator > (const ArrayView<ElementTypeA, SizeType>& lhs, const ArrayView<ElementTypeB, SizeType>& rhs)
 {
     return rhs < lhs;
 }
 
-template<typename ElementTypeA, typename ElementTypeB>
-bool operator <= (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTypeB>& rhs)
+template<typename ElementTypeA, typename ElementTypeB, typename SizeType>
+bool operator <= (const ArrayView<ElementTypeA, SizeType>& lhs, const ArrayView<ElementTypeB, SizeType>& rhs)
 {
     static_assert(std::is_same<typename std::remove_cv<ElementTypeA>::type,
                                typename std::remove_cv<ElementTypeB>::type>::value,
@@ -258,7 +258,7 @@ bool operator <= (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTyp
     if (lhs.Size() > rhs.Size())
         return false;
 
-    for (uint32 i = 0; i < lhs.Size(); ++i)
+    for (SizeType i = 0; i < lhs.Size(); ++i)
     {
         if (lhs[i] < rhs[i])
             return true;
@@ -271,14 +271,14 @@ bool operator <= (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTyp
     return true;
 }
 
-template<typename ElementTypeA, typename ElementTypeB>
-bool operator >= (const ArrayView<ElementTypeA>& lhs, const ArrayView<ElementTypeB>& rhs)
+template<typename ElementTypeA, typename ElementTypeB, typename SizeType>
+bool operator >= (const ArrayView<ElementTypeA, SizeType>& lhs, const ArrayView<ElementTypeB, SizeType>& rhs)
 {
     return rhs <= lhs;
 }
 
-template<typename ElementType>
-uint32 GetHash(const ArrayView<ElementType>& arrayView)
+template<typename ElementType, typename SizeType>
+uint32 GetHash(const ArrayView<ElementType, SizeType>& arrayView)
 {
     // hashing algorithm based on boost's hash_combine
 
@@ -2,18 +2,45 @@
 
 #include "ArrayView.h"
 #include "../Utils/Memory.h"
+#include "../Utils/MemoryHelpers.h"
 
 namespace rt {
 
+/**
+ * Default DynArray policy: 32-bit sizes, capacity grows by 50%.
+ */
+struct DynArrayPolicy
+{
+    // type used for sizes and indices
+    using SizeType = uint32;
+
+    // capacity grows geometrically: newCapacity = capacity * GrowthNumerator / GrowthDenominator
+    static constexpr uint32 GrowthNumerator = 3;
+    static constexpr uint32 GrowthDenominator = 2;
+};
+
+/**
+ * Policy for arrays that may exceed 4G elements (e.g. index buffers of giant meshes).
+ */
+struct LargeDynArrayPolicy : public DynArrayPolicy
+{
+    using SizeType = size_t;
+};
+
 /**
  * Dynamic array (like std::vector).
+ * Policy controls size type and growth factor (see DynArrayPolicy).
  */
-template<typename ElementType, typename Allocator = DefaultAllocator>
-class DynArray : public ArrayView<ElementType>
+template<typename ElementType, typename Allocator = DefaultAllocator, typename Policy = DynArrayPolicy>
+class DynArray : public ArrayView<ElementType, typename Policy::SizeType>
 {
 public:
-    using IteratorType = typename ArrayView<ElementType>::Iterator;
-    using ConstIteratorType = typename ArrayView<ElementType>::ConstIterator;
+    using SizeType = typename Policy::SizeType;
+    using ViewType = ArrayView<ElementType, SizeType>;
+    using IteratorType = typename ViewType::Iterator;
+    using ConstIteratorType = typename ViewType::ConstIterator;
+
+    static_assert(Policy::GrowthNumerator > Policy::GrowthDenominator, "DynArray must grow");
 
     // basic constructors and assignment operators
     RT_FORCE_INLINE DynArray();
@@ -27,14 +54,14 @@ public:
     DynArray(const std::initializer_list<ElementType>& list);
 
     // initialize using C-style array
-    DynArray(const ElementType* elements, uint32 count);
+    DynArray(const ElementType* elements, SizeType count);
 
     // initialize with given size (creates default objects)
     // NOTE: ElementType must be trivially constructible
-    explicit DynArray(uint32 size);
+    explicit DynArray(SizeType size);
 
     // initialize with given size
-    DynArray(uint32 size, const ElementType& value);
+    DynArray(SizeType size, const ElementType& value);
 
     /**
      * Remove all the elements.
@@ -61,20 +88,20 @@ public:
      * @return  'True' on success, 'false' on memory allocation failure.
      */
     template<typename ElementType2>
-    bool PushBackArray(const ArrayView<ElementType2>& arrayView);
+    bool PushBackArray(const ArrayView<ElementType2, SizeType>& arrayView);
 
     /**
      * Insert a new element at given index.
      * @return  Iterator to the inserted element, or iterator to the end if the insertion failed.
      */
-    IteratorType InsertAt(uint32 index, const ElementType& element);
-    IteratorType InsertAt(uint32 index, ElementType&& element);
+    IteratorType InsertAt(SizeType index, const ElementType& element);
+    IteratorType InsertAt(SizeType index, ElementType&& element);
 
     /**
      * Insert a new element multiple times, at given index.
      * @return  Iterator to the first inserted element, or iterator to the end if the insertion failed.
      */
-    IteratorType InsertAt(uint32 index, const ElementType& element, uint32 count);
+    IteratorType InsertAt(SizeType index, const ElementType& element, SizeType count);
 
     /**
      * Insert elements from a view at given index.
@@ -84,7 +111,7 @@ public:
      * @return  Iterator to the inserted element, or iterator to the end if the insertion failed.
      */
     template<typename ElementType2>
-    IteratorType InsertArrayAt(uint32 index, const ArrayView<ElementType2>& arrayView);
+    IteratorType InsertArrayAt(SizeType index, const ArrayView<ElementType2, SizeType>& arrayView);
 
     /**
      * Remove an element by iterator.
@@ -108,16 +135,21 @@ public:
      * Reserve space.
      * @return  'false' if memory allocation failed.
      */
-    bool Reserve(uint32 size);
+    bool Reserve(SizeType size);
+
+    /**
+     * Get number of elements that fit in currently allocated memory.
+     */
+    RT_FORCE_INLINE SizeType Capacity() const { return mAllocSize; }
 
     /**
      * Resize the array.
      * Element type must have default constructor.
      * @return 'false' if memory allocation failed.
      */
-    bool Resize(uint32 size);
-    bool Resize_SkipConstructor(uint32 size);
-    bool Resize(uint32 size, const ElementType& defaultElement);
+    bool Resize(SizeType size);
+    bool Resize_SkipConstructor(SizeType size);
+    bool Resize(SizeType size, const ElementType& defaultElement);
 
     /**
      * Replace contents of two arrays.
@@ -136,16 +168,28 @@ private:
     bool ContainsElement(const ElementType& element) const;
 
     // allocated size
-    uint32 mAllocSize;
+    SizeType mAllocSize;
 };
 
+/**
+ * Dynamic array with 64-bit sizes.
+ */
+template<typename ElementType, typename Allocator = DefaultAllocator>
+using LargeDynArray = DynArray<ElementType, Allocator, LargeDynArrayPolicy>;
+
+/**
+ * DynArray holds no pointers to itself, so it can be relocated with memcpy (e.g. when DynArray of DynArrays grows).
+ */
+template<typename ElementType, typename Allocator, typename Policy>
+struct IsTriviallyRelocatable<DynArray<ElementType, Allocator, Policy>> : public std::true_type { };
+
 /**
  * Calculate hash of an dynamic array (simple wrapper for ArrayView's GetHash).
  */
-template<typename ElementType>
-RT_FORCE_INLINE uint32 GetHash(const DynArray<ElementType>& array)
+template<typename ElementType, typename Allocator, typename Policy>
+RT_FORCE_INLINE uint32 GetHash(const DynArray<ElementType, Allocator, Policy>& array)
 {
-    return GetHash(static_cast<const ArrayView<ElementType>&>(array));
+    return GetHash(static_cast<const typename DynArray<ElementType, Allocator, Policy>::ViewType&>(array));
 }
 
 
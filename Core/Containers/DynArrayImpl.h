@@ -7,21 +7,21 @@
 
 namespace rt {
 
-template<typename ElementType, typename Allocator>
-DynArray<ElementType, Allocator>::DynArray()
+template<typename ElementType, typename Allocator, typename Policy>
+DynArray<ElementType, Allocator, Policy>::DynArray()
     : mAllocSize(0)
 {
-    static_assert(sizeof(DynArray<ElementType, Allocator>) == sizeof(void*) + 2 * sizeof(uint32), "Invalid DynArray size");
+    static_assert(sizeof(DynArray<ElementType, Allocator, Policy>) == sizeof(void*) + 2 * sizeof(SizeType), "Invalid DynArray size");
 }
 
-template<typename ElementType, typename Allocator>
-DynArray<ElementType, Allocator>::~DynArray()
+template<typename ElementType, typename Allocator, typename Policy>
+DynArray<ElementType, Allocator, Policy>::~DynArray()
 {
     Clear(true);
 }
 
-template<typename ElementType, typename Allocator>
-DynArray<ElementType, Allocator>::DynArray(const DynArray& other)
+template<typename ElementType, typename Allocator, typename Policy>
+DynArray<ElementType, Allocator, Policy>::DynArray(const DynArray& other)
     : ArrayView<ElementType>()
 {
     mAllocSize = 0;
@@ -35,14 +35,14 @@ DynArray<ElementType, Allocator>::DynArray(const DynArray& other)
     }
 
     this->mSize = other.mSize;
-    for (uint32 i = 0; i < other.mSize; ++i)
+    for (SizeType i = 0; i < other.mSize; ++i)
     {
         new (this->mElements + i) ElementType(other.mElements[i]);
     }
 }
 
-template<typename ElementType, typename Allocator>
-DynArray<ElementType, Allocator>::DynArray(DynArray&& other)
+template<typename ElementType, typename Allocator, typename Policy>
+DynArray<ElementType, Allocator, Policy>::DynArray(DynArray&& other)
     : ArrayView<ElementType>()
 {
     // don't free memory if not needed
@@ -57,8 +57,8 @@ DynArray<ElementType, Allocator>::DynArray(DynArray&& other)
     other.mAllocSize = 0;
 }
 
-template<typename ElementType, typename Allocator>
-DynArray<ElementType, Allocator>& DynArray<ElementType, Allocator>::operator = (const DynArray& other)
+template<typename ElementType, typename Allocator, typename Policy>
+DynArray<ElementType, Allocator, Policy>& DynArray<ElementType, Allocator, Policy>::operator = (const DynArray& other)
 {
     if (&other == this)
         return *this;
@@ -72,7 +72,7 @@ DynArray<ElementType, Allocator>& DynArray<ElementType, Allocator>::operator = (
     }
 
     this->mSize = other.mSize;
-    for (uint32 i = 0; i < other.mSize; ++i)
+    for (SizeType i = 0; i < other.mSize; ++i)
     {
         new (this->mElements + i) ElementType(other.mElements[i]);
     }
@@ -80,8 +80,8 @@ DynArray<ElementType, Allocator>& DynArray<ElementType, Allocator>::operator = (
     return *this;
 }
 
-template<typename ElementType, typename Allocator>
-DynArray<ElementType, Allocator>& DynArray<ElementType, Allocator>::operator = (DynArray&& other)
+template<typename ElementType, typename Allocator, typename Policy>
+DynArray<ElementType, Allocator, Policy>& DynArray<ElementType, Allocator, Policy>::operator = (DynArray&& other)
 {
     // don't free memory if not needed
     Clear(true);
@@ -97,11 +97,11 @@ DynArray<ElementType, Allocator>& DynArray<ElementType, Allocator>::operator = (
     return *this;
 }
 
-template<typename ElementType, typename Allocator>
-DynArray<ElementType, Allocator>::DynArray(const std::initializer_list<ElementType>& list)
+template<typename ElementType, typename Allocator, typename Policy>
+DynArray<ElementType, Allocator, Policy>::DynArray(const std::initializer_list<ElementType>& list)
     : DynArray()
 {
-    if (!Reserve(static_cast<uint32>(list.size())))
+    if (!Reserve(static_cast<SizeType>(list.size())))
     {
         RT_FATAL("Failed to reserve memory for DynArray");
         return;
@@ -113,8 +113,8 @@ DynArray<ElementType, Allocator>::DynArray(const std::initializer_list<ElementTy
     }
 }
 
-template<typename ElementType, typename Allocator>
-DynArray<ElementType, Allocator>::DynArray(const ElementType* elements, uint32 count)
+template<typename ElementType, typename Allocator, typename Policy>
+DynArray<ElementType, Allocator, Policy>::DynArray(const ElementType* elements, SizeType count)
     : DynArray()
 {
     if (!Reserve(count))
@@ -124,14 +124,14 @@ DynArray<ElementType, Allocator>::DynArray(const ElementType* elements, uint32 c
     }
 
     this->mSize = count;
-    for (uint32 i = 0; i < count; ++i)
+    for (SizeType i = 0; i < count; ++i)
     {
         new (this->mElements + i) ElementType(elements[i]);
     }
 }
 
-template<typename ElementType, typename Allocator>
-DynArray<ElementType, Allocator>::DynArray(uint32 size)
+template<typename ElementType, typename Allocator, typename Policy>
+DynArray<ElementType, Allocator, Policy>::DynArray(SizeType size)
     : DynArray()
 {
     static_assert(std::is_trivially_constructible<ElementType>::value, "Element type is not trivially constructible");
@@ -143,14 +143,14 @@ DynArray<ElementType, Allocator>::DynArray(uint32 size)
     }
 
     this->mSize = size;
-    for (uint32 i = 0; i < size; ++i)
+    for (SizeType i = 0; i < size; ++i)
     {
         new (this->mElements + i) ElementType();
     }
 }
 
-template<typename ElementType, typename Allocator>
-DynArray<ElementType, Allocator>::DynArray(uint32 size, const ElementType& value)
+template<typename ElementType, typename Allocator, typename Policy>
+DynArray<ElementType, Allocator, Policy>::DynArray(SizeType size, const ElementType& value)
     : DynArray()
 {
     if (!Reserve(size))
@@ -160,7 +160,7 @@ DynArray<ElementType, Allocator>::DynArray(uint32 size, const ElementType& value
     }
 
     this->mSize = size;
-    for (uint32 i = 0; i < size; ++i)
+    for (SizeType i = 0; i < size; ++i)
     {
         new (this->mElements + i) ElementType(value);
     }
@@ -168,8 +168,8 @@ DynArray<ElementType, Allocator>::DynArray(uint32 size, const ElementType& value
 
 //////////////////////////////////////////////////////////////////////////
 
-template<typename ElementType, typename Allocator>
-void DynArray<ElementType, Allocator>::Clear(bool freeMemory)
+template<typename ElementType, typename Allocator, typename Policy>
+void DynArray<ElementType, Allocator, Policy>::Clear(bool freeMemory)
 {
     if (!this->mElements)
     {
@@ -178,7 +178,7 @@ void DynArray<ElementType, Allocator>::Clear(bool freeMemory)
     }
 
     // call destructors
-    for (uint32 i = 0; i < this->mSize; ++i)
+    for (SizeType i = 0; i < this->mSize; ++i)
     {
         this->mElements[i].~ElementType();
     }
@@ -193,18 +193,18 @@ void DynArray<ElementType, Allocator>::Clear(bool freeMemory)
     }
 }
 
-template<typename ElementType, typename Allocator>
-bool DynArray<ElementType, Allocator>::ContainsElement(const ElementType& element) const
+template<typename ElementType, typename Allocator, typename Policy>
+bool DynArray<ElementType, Allocator, Policy>::ContainsElement(const ElementType& element) const
 {
     return (&element - this->mElements >= 0) && (&element < this->mElements + this->mSize);
 }
 
-template<typename ElementType, typename Allocator>
-typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Allocator>::PushBack(const ElementType& element)
+template<typename ElementType, typename Allocator, typename Policy>
+typename DynArray<ElementType, Allocator, Policy>::IteratorType DynArray<ElementType, Allocator, Policy>::PushBack(const ElementType& element)
 {
     RT_ASSERT(!ContainsElement(element), "Adding element to a DynArray that is already contained by the array is not supported");
 
-    if (!Reserve(this->mSize + 1))
+    if (this->mSize == mAllocSize && !Reserve(this->mSize + 1))
     {
         return this->End();
     }
@@ -213,12 +213,12 @@ typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Al
     return IteratorType(this->mElements, this->mSize++);
 }
 
-template<typename ElementType, typename Allocator>
-typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Allocator>::PushBack(ElementType&& element)
+template<typename ElementType, typename Allocator, typename Policy>
+typename DynArray<ElementType, Allocator, Policy>::IteratorType DynArray<ElementType, Allocator, Policy>::PushBack(ElementType&& element)
 {
     RT_ASSERT(!ContainsElement(element), "Adding element to a DynArray that is already contained by the array is not supported");
 
-    if (!Reserve(this->mSize + 1))
+    if (this->mSize == mAllocSize && !Reserve(this->mSize + 1))
     {
         // memory allocation failed
         return this->End();
@@ -228,11 +228,11 @@ typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Al
     return IteratorType(this->mElements, this->mSize++);
 }
 
-template<typename ElementType, typename Allocator>
+template<typename ElementType, typename Allocator, typename Policy>
 template<typename ... Args>
-typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Allocator>::EmplaceBack(Args&& ... args)
+typename DynArray<ElementType, Allocator, Policy>::IteratorType DynArray<ElementType, Allocator, Policy>::EmplaceBack(Args&& ... args)
 {
-    if (!Reserve(this->mSize + 1))
+    if (this->mSize == mAllocSize && !Reserve(this->mSize + 1))
     {
         // memory allocation failed
         return this->End();
@@ -242,9 +242,9 @@ typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Al
     return IteratorType(this->mElements, this->mSize++);
 }
 
-template<typename ElementType, typename Allocator>
+template<typename ElementType, typename Allocator, typename Policy>
 template<typename ElementType2>
-bool DynArray<ElementType, Allocator>::PushBackArray(const ArrayView<ElementType2>& arrayView)
+bool DynArray<ElementType, Allocator, Policy>::PushBackArray(const ArrayView<ElementType2, SizeType>& arrayView)
 {
     static_assert(std::is_same<typename std::remove_cv<ElementType>::type, typename std::remove_cv<ElementType2>::type>::value,
                   "Incompatible element types");
@@ -262,7 +262,7 @@ bool DynArray<ElementType, Allocator>::PushBackArray(const ArrayView<ElementType
     }
 
     // copy elements
-    for (uint32 i = 0; i < arrayView.mSize; ++i)
+    for (SizeType i = 0; i < arrayView.mSize; ++i)
     {
         new (this->mElements + this->mSize + i) ElementType(arrayView.mElements[i]);
     }
@@ -271,8 +271,8 @@ bool DynArray<ElementType, Allocator>::PushBackArray(const ArrayView<ElementType
     return true;
 }
 
-template<typename ElementType, typename Allocator>
-bool DynArray<ElementType, Allocator>::PopBack()
+template<typename ElementType, typename Allocator, typename Policy>
+bool DynArray<ElementType, Allocator, Policy>::PopBack()
 {
     if (this->Empty())
         return false;
@@ -281,8 +281,8 @@ bool DynArray<ElementType, Allocator>::PopBack()
     return true;
 }
 
-template<typename ElementType, typename Allocator>
-typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Allocator>::InsertAt(uint32 index, const ElementType& element)
+template<typename ElementType, typename Allocator, typename Policy>
+typename DynArray<ElementType, Allocator, Policy>::IteratorType DynArray<ElementType, Allocator, Policy>::InsertAt(SizeType index, const ElementType& element)
 {
     if (!Reserve(this->mSize + 1))
     {
@@ -297,8 +297,8 @@ typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Al
     return IteratorType(this->mElements, index);
 }
 
-template<typename ElementType, typename Allocator>
-typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Allocator>::InsertAt(uint32 index, ElementType&& element)
+template<typename ElementType, typename Allocator, typename Policy>
+typename DynArray<ElementType, Allocator, Policy>::IteratorType DynArray<ElementType, Allocator, Policy>::InsertAt(SizeType index, ElementType&& element)
 {
     if (!Reserve(this->mSize + 1))
     {
@@ -313,8 +313,8 @@ typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Al
     return IteratorType(this->mElements, index);
 }
 
-template<typename ElementType, typename Allocator>
-typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Allocator>::InsertAt(uint32 index, const ElementType& element, uint32 count)
+template<typename ElementType, typename Allocator, typename Policy>
+typename DynArray<ElementType, Allocator, Policy>::IteratorType DynArray<ElementType, Allocator, Policy>::InsertAt(SizeType index, const ElementType& element, SizeType count)
 {
     if (count == 0)
     {
@@ -331,7 +331,7 @@ typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Al
     ElementType* base = this->mElements + index;
     MemoryHelpers::MoveArray<ElementType>(base + count, base, this->mSize - index);
 
-    for (uint32 i = 0; i < count; ++i)
+    for (SizeType i = 0; i < count; ++i)
     {
         new (base + i) ElementType(element);
     }
@@ -340,9 +340,9 @@ typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Al
     return IteratorType(this->mElements, index);
 }
 
-template<typename ElementType, typename Allocator>
+template<typename ElementType, typename Allocator, typename Policy>
 template<typename ElementType2>
-typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Allocator>::InsertArrayAt(uint32 index, const ArrayView<ElementType2>& arrayView)
+typename DynArray<ElementType, Allocator, Policy>::IteratorType DynArray<ElementType, Allocator, Policy>::InsertArrayAt(SizeType index, const ArrayView<ElementType2, SizeType>& arrayView)
 {
     static_assert(std::is_same<typename std::remove_cv<ElementType>::type, typename std::remove_cv<ElementType2>::type>::value,
                   "Incompatible element types");
@@ -362,7 +362,7 @@ typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Al
     ElementType* base = this->mElements + index;
     MemoryHelpers::MoveArray<ElementType>(base + arrayView.mSize, base, this->mSize - index);
 
-    for (uint32 i = 0; i < arrayView.mSize; ++i)
+    for (SizeType i = 0; i < arrayView.mSize; ++i)
     {
         new (base + i) ElementType(arrayView.mElements[i]);
     }
@@ -371,8 +371,8 @@ typename DynArray<ElementType, Allocator>::IteratorType DynArray<ElementType, Al
     return IteratorType(this->mElements, index);
 }
 
-template<typename ElementType, typename Allocator>
-bool DynArray<ElementType, Allocator>::Erase(const ConstIteratorType& iterator)
+template<typename ElementType, typename Allocator, typename Policy>
+bool DynArray<ElementType, Allocator, Policy>::Erase(const ConstIteratorType& iterator)
 {
     if (iterator == this->End())
     {
@@ -387,8 +387,8 @@ bool DynArray<ElementType, Allocator>::Erase(const ConstIteratorType& iterator)
     return true;
 }
 
-template<typename ElementType, typename Allocator>
-bool DynArray<ElementType, Allocator>::Erase(const ConstIteratorType& first, const ConstIteratorType& last)
+template<typename ElementType, typename Allocator, typename Policy>
+bool DynArray<ElementType, Allocator, Policy>::Erase(const ConstIteratorType& first, const ConstIteratorType& last)
 {
     if (first.GetIndex() >= last.GetIndex())
     {
@@ -397,20 +397,20 @@ bool DynArray<ElementType, Allocator>::Erase(const ConstIteratorType& first, con
     }
 
     // call destructors
-    for (int32 i = first.GetIndex(); i < last.GetIndex(); ++i)
+    for (ptrdiff_t i = first.GetIndex(); i < last.GetIndex(); ++i)
     {
         this->mElements[i].~ElementType();
     }
 
-    const int32 num = last.GetIndex() - first.GetIndex();
+    const ptrdiff_t num = last.GetIndex() - first.GetIndex();
     ElementType* base = this->mElements + first.GetIndex();
     MemoryHelpers::MoveArray<ElementType>(base, base + num, this->mSize - last.GetIndex());
     this->mSize -= num;
     return true;
 }
 
-template<typename ElementType, typename Allocator>
-bool DynArray<ElementType, Allocator>::Reserve(uint32 size)
+template<typename ElementType, typename Allocator, typename Policy>
+bool DynArray<ElementType, Allocator, Policy>::Reserve(SizeType size)
 {
     if (size <= mAllocSize)
     {
@@ -418,14 +418,24 @@ bool DynArray<ElementType, Allocator>::Reserve(uint32 size)
         return true;
     }
 
-    uint32 newAllocSize = mAllocSize;
+    // largest capacity representable both as element count and in bytes
+    const SizeType maxViewSize = ViewType::MaxSize;
+    const size_t maxBytesCapacity = std::numeric_limits<size_t>::max() / sizeof(ElementType);
+    const SizeType maxSize = maxBytesCapacity < maxViewSize ? static_cast<SizeType>(maxBytesCapacity) : maxViewSize;
+    if (size > maxSize)
+    {
+        return false;
+    }
+
+    SizeType newAllocSize = mAllocSize;
     while (size > newAllocSize)
     {
-        // grow by 50%
-        newAllocSize += math::Max<uint32>(1, newAllocSize / 2);
+        // grow geometrically, clamped to the maximum size
+        const SizeType increment = math::Max<SizeType>(1, newAllocSize / Policy::GrowthDenominator * (Policy::GrowthNumerator - Policy::GrowthDenominator));
+        newAllocSize = increment < maxSize - newAllocSize ? newAllocSize + increment : maxSize;
     }
 
-    ElementType* newBuffer = static_cast<ElementType*>(Allocator::Allocate(newAllocSize * sizeof(ElementType), alignof(ElementType)));
+    ElementType* newBuffer = static_cast<ElementType*>(Allocator::Allocate(static_cast<size_t>(newAllocSize) * sizeof(ElementType), alignof(ElementType)));
     if (!newBuffer)
     {
         // memory allocation failed
@@ -442,13 +452,13 @@ bool DynArray<ElementType, Allocator>::Reserve(uint32 size)
     return true;
 }
 
-template<typename ElementType, typename Allocator>
-bool DynArray<ElementType, Allocator>::Resize_SkipConstructor(uint32 size)
+template<typename ElementType, typename Allocator, typename Policy>
+bool DynArray<ElementType, Allocator, Policy>::Resize_SkipConstructor(SizeType size)
 {
-    const uint32 oldSize = this->mSize;
+    const SizeType oldSize = this->mSize;
 
     // call destructors
-    for (uint32 i = size; i < oldSize; ++i)
+    for (SizeType i = size; i < oldSize; ++i)
     {
         this->mElements[i].~ElementType();
     }
@@ -462,13 +472,13 @@ bool DynArray<ElementType, Allocator>::Resize_SkipConstructor(uint32 size)
     return true;
 }
 
-template<typename ElementType, typename Allocator>
-bool DynArray<ElementType, Allocator>::Resize(uint32 size)
+template<typename ElementType, typename Allocator, typename Policy>
+bool DynArray<ElementType, Allocator, Policy>::Resize(SizeType size)
 {
-    const uint32 oldSize = this->mSize;
+    const SizeType oldSize = this->mSize;
 
     // call destructors
-    for (uint32 i = size; i < oldSize; ++i)
+    for (SizeType i = size; i < oldSize; ++i)
     {
         this->mElements[i].~ElementType();
     }
@@ -479,7 +489,7 @@ bool DynArray<ElementType, Allocator>::Resize(uint32 size)
     }
 
     // initialize new elements
-    for (uint32 i = oldSize; i < size; ++i)
+    for (SizeType i = oldSize; i < size; ++i)
     {
         new (this->mElements + i) ElementType;
     }
@@ -488,13 +498,13 @@ bool DynArray<ElementType, Allocator>::Resize(uint32 size)
     return true;
 }
 
-template<typename ElementType, typename Allocator>
-bool DynArray<ElementType, Allocator>::Resize(uint32 size, const ElementType& defaultElement)
+template<typename ElementType, typename Allocator, typename Policy>
+bool DynArray<ElementType, Allocator, Policy>::Resize(SizeType size, const ElementType& defaultElement)
 {
-    const uint32 oldSize = this->mSize;
+    const SizeType oldSize = this->mSize;
 
     // call destructors
-    for (uint32 i = size; i < oldSize; ++i)
+    for (SizeType i = size; i < oldSize; ++i)
     {
         this->mElements[i].~ElementType();
     }
@@ -505,7 +515,7 @@ bool DynArray<ElementType, Allocator>::Resize(uint32 size, const ElementType& de
     }
 
     // initialize new elements
-    for (uint32 i = oldSize; i < size; ++i)
+    for (SizeType i = oldSize; i < size; ++i)
     {
         new (this->mElements + i) ElementType(defaultElement);
     }
@@ -514,11 +524,11 @@ bool DynArray<ElementType, Allocator>::Resize(uint32 size, const ElementType& de
     return true;
 }
 
-template<typename ElementType, typename Allocator>
-void DynArray<ElementType, Allocator>::Swap(DynArray& other)
+template<typename ElementType, typename Allocator, typename Policy>
+void DynArray<ElementType, Allocator, Policy>::Swap(DynArray& other)
 {
-    std::swap(this->mElements, other->mElements);
-    std::swap(this->mSize, other->mSize);
+    std::swap(this->mElements, other.mElements);
+    std::swap(this->mSize, other.mSize);
     std::swap(mAllocSize, other.mAllocSize);
 }
 
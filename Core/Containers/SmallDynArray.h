@@ -0,0 +1,101 @@
+#pragma once
+
+#include "ArrayView.h"
+#include "../Utils/Memory.h"
+#include "../Utils/MemoryHelpers.h"
+
+namespace rt {
+
+/**
+ * Dynamic array with inline storage for first few elements (small buffer optimization).
+ * Meant for short-lived, usually tiny arrays in hot code, which would otherwise always hit the heap.
+ * Memory is allocated only when number of elements exceeds InlineCapacity.
+ */
+template<typename ElementType, uint32 InlineCapacity, typename Allocator = DefaultAllocator>
+class SmallDynArray : public ArrayView<ElementType>
+{
+public:
+    static_assert(InlineCapacity > 0, "Inline capacity must not be zero");
+
+    using IteratorType = typename ArrayView<ElementType>::Iterator;
+    using ConstIteratorType = typename ArrayView<ElementType>::ConstIterator;
+
+    RT_FORCE_INLINE SmallDynArray();
+    RT_FORCE_INLINE ~SmallDynArray();
+    SmallDynArray(const SmallDynArray& other);
+    SmallDynArray(SmallDynArray&& other);
+    SmallDynArray& operator = (const SmallDynArray& other);
+    SmallDynArray& operator = (SmallDynArray&& other);
+
+    /**
+     * Remove all the elements.
+     * @param freeMemory    Release heap memory (if any) and go back to inline storage?
+     */
+    void Clear(bool freeMemory = false);
+
+    /**
+     * Insert a new element at the end.
+     * @return  Iterator to the inserted element, or iterator to the end if the insertion failed.
+     */
+    RT_FORCE_INLINE IteratorType PushBack(const ElementType& element);
+    RT_FORCE_INLINE IteratorType PushBack(ElementType&& element);
+
+    /**
+     * In-place construct a new element at the end.
+     * @return  Iterator to the inserted element, or iterator to the end if the insertion failed.
+     */
+    template<typename ... Args>
+    RT_FORCE_INLINE IteratorType EmplaceBack(Args&& ... args);
+
+    /**
+     * Remove last element if exists.
+     * @return 'false' if there is nothing to pop (container is empty).
+     */
+    bool PopBack();
+
+    /**
+     * Reserve space.
+     * @return  'false' if memory allocation failed.
+     */
+    bool Reserve(uint32 size);
+
+    /**
+     * Resize the array.
+     * Element type must have default constructor.
+     * @return 'false' if memory allocation failed.
+     */
+    bool Resize(uint32 size);
+
+    /**
+     * Get number of elements that fit in currently used storage.
+     */
+    RT_FORCE_INLINE uint32 Capacity() const { return mAllocSize; }
+
+    /**
+     * Check if elements are stored in the inline buffer.
+     */
+    RT_FORCE_INLINE bool IsInline() const { return this->mElements == GetInlineBuffer(); }
+
+    // lower-case aliases for Begin()/End(), required by C++ for range-based 'for' to work
+    RT_FORCE_INLINE ConstIteratorType begin() const { return this->Begin(); }
+    RT_FORCE_INLINE ConstIteratorType end() const { return this->End(); }
+    RT_FORCE_INLINE IteratorType begin() { return this->Begin(); }
+    RT_FORCE_INLINE IteratorType end() { return this->End(); }
+
+private:
+    RT_FORCE_INLINE ElementType* GetInlineBuffer() { return reinterpret_cast<ElementType*>(mInlineStorage); }
+    RT_FORCE_INLINE const ElementType* GetInlineBuffer() const { return reinterpret_cast<const ElementType*>(mInlineStorage); }
+
+    // move elements of other array into this (empty) array
+    void MoveFrom(SmallDynArray& other);
+
+    // allocated size
+    uint32 mAllocSize;
+
+    alignas(ElementType) uint8 mInlineStorage[InlineCapacity * sizeof(ElementType)];
+};
+
+} // namespace rt
+
+
+#include "SmallDynArrayImpl.h"
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "SmallDynArray.h"
+#include "../Math/Math.h"
+
+namespace rt {
+
+template<typename ElementType, uint32 InlineCapacity, typename Allocator>
+SmallDynArray<ElementType, InlineCapacity, Allocator>::SmallDynArray()
+    : mAllocSize(InlineCapacity)
+{
+    this->mElements = GetInlineBuffer();
+}
+
+template<typename ElementType, uint32 InlineCapacity, typename Allocator>
+SmallDynArray<ElementType, InlineCapacity, Allocator>::~SmallDynArray()
+{
+    Clear(true);
+}
+
+template<typename ElementType, uint32 InlineCapacity, typename Allocator>
+SmallDynArray<ElementType, InlineCapacity, Allocator>::SmallDynArray(const SmallDynArray& other)
+    : SmallDynArray()
+{
+    *this = other;
+}
+
+template<typename ElementType, uint32 InlineCapacity, typename Allocator>
+SmallDynArray<ElementType, InlineCapacity, Allocator>::SmallDynArray(SmallDynArray&& other)
+    : SmallDynArray()
+{
+    MoveFrom(other);
+}
+
+template<typename ElementType, uint32 InlineCapacity, typename Allocator>
+SmallDynArray<ElementType, InlineCapacity, Allocator>& SmallDynArray<ElementType, InlineCapacity, Allocator>::operator = (const SmallDynArray& other)
+{
+    if (&other == this)
+        return *this;
+
+    Clear();
+
+    if (!Reserve(other.mSize))
+    {
+        RT_FATAL("Failed to reserve memory for SmallDynArray");
+        return *this;
+    }
+
+    for (uint32 i = 0; i < other.mSize; ++i)
+    {
+        new (this->mElements + i) ElementType(other.mElements[i]);
+    }
+    this->mSize = other.mSize;
+
+    return *this;
+}
+
+template<typename ElementType, uint32 InlineCapacity, typename Allocator>
+SmallDynArray<ElementType, InlineCapacity, Allocator>& SmallDynArray<ElementType, InlineCapacity, Allocator>::operator = (SmallDynArray&& other)
+{
+    if (&other == this)
+        return *this;
+
+    Clear(true);
+    MoveFrom(other);
+
+    return *this;
+}
+
+template<typename ElementType, uint32 InlineCapacity, typename Allocator>
+void SmallDynArray<ElementType, InlineCapacity, Allocator>::MoveFrom(SmallDynArray& other)
+{
+    RT_ASSERT(this->mSize == 0 && IsInline());
+
+    if (other.IsInline())
+    {
+        // inline elements can't be stolen, move them one by one
+        MemoryHelpers::MoveArray<ElementType>(this->mElements, other.mElements, other.mSize);
+        this->mSize = other.mSize;
+        other.mSize = 0;
+        return;
+    }
+
+    // steal heap buffer
+    this->mElements = other.mElements;
+    this->mSize = other.mSize;
+    mAllocSize = other.mAllocSize;
+
+    other.mElements = other.GetInlineBuffer();
+    other.mSize = 0;
+    other.mAllocSize = InlineCapacity;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template<typename ElementType, uint32 InlineCapacity, typename Allocator>
+void SmallDynArray<ElementType, InlineCapacity, Allocator>::Clear(bool freeMemory)
+{
+    // call destructors
+    for (uint32 i = 0; i < this->mSize; ++i)
+    {
+        this->mElements[i].~ElementType();
+    }
+
+    this->mSize = 0;
+
+    if (freeMemory && !IsInline())
+    {
+        Allocator::Free(this->mElements);
+        this->mElements = GetInlineBuffer();
+        mAllocSize = InlineCapacity;
+    }
+}
+
+template<typename ElementType, uint32 InlineCapacity, typename Allocator>
+typename SmallDynArray<ElementType, InlineCapacity, Allocator>::IteratorType SmallDynArray<ElementType, InlineCapacity, Allocator>::PushBack(const ElementType& element)
+{
+    if (this->mSize == mAllocSize && !Reserve(this->mSize + 1))
+    {
+        // memory allocation failed
+        return this->End();
+    }
+
+    new (this->mElements + this->mSize) ElementType(element);
+    return IteratorType(this->mElements, this->mSize++);
+}
+
+template<typename ElementType, uint32 InlineCapacity, typename Allocator>
+typename SmallDynArray<ElementType, InlineCapacity, Allocator>::IteratorType SmallDynArray<ElementType, InlineCapacity, Allocator>::PushBack(ElementType&& element)
+{
+    if (this->mSize == mAllocSize && !Reserve(this->mSize + 1))
+    {
+        // memory allocation failed
+        return this->End();
+    }
+
+    new (this->mElements + this->mSize) ElementType(std::move(element));
+    return IteratorType(this->mElements, this->mSize++);
+}
+
+template<typename ElementType, uint32 InlineCapacity, typename Allocator>
+template<typename ... Args>
+typename SmallDynArray<ElementType, InlineCapacity, Allocator>::IteratorType SmallDynArray<ElementType, InlineCapacity, Allocator>::EmplaceBack(Args&& ... args)
+{
+    if (this->mSize == mAllocSize && !Reserve(this->mSize + 1))
+    {
+        // memory allocation failed
+        return this->End();
+    }
+
+    new (this->mElements + this->mSize) ElementType(std::forward<Args>(args) ...);
+    return IteratorType(this->mElements, this->mSize++);
+}
+
+template<typename ElementType, uint32 InlineCapacity, typename Allocator>
+bool SmallDynArray<ElementType, InlineCapacity, Allocator>::PopBack()
+{
+    if (this->Empty())
+        return false;
+
+    this->mElements[--this->mSize].~ElementType();
+    return true;
+}
+
+template<typename ElementType, uint32 InlineCapacity, typename Allocator>
+bool SmallDynArray<ElementType, InlineCapacity, Allocator>::Reserve(uint32 size)
+{
+    if (size <= mAllocSize)
+    {
+        // fits in current storage - ignore
+        return true;
+    }
+
+    // heap buffer grows by 50%, like DynArray
+    uint32 newAllocSize = mAllocSize;
+    while (size > newAllocSize)
+    {
+        newAllocSize += math::Max<uint32>(1, newAllocSize / 2);
+    }
+
+    ElementType* newBuffer = static_cast<ElementType*>(Allocator::Allocate(newAllocSize * sizeof(ElementType), alignof(ElementType)));
+    if (!newBuffer)
+    {
+        // memory allocation failed
+        return false;
+    }
+
+    // move elements
+    MemoryHelpers::MoveArray<ElementType>(newBuffer, this->mElements, this->mSize);
+
+    // replace buffer
+    if (!IsInline())
+    {
+        Allocator::Free(this->mElements);
+    }
+    this->mElements = newBuffer;
+    mAllocSize = newAllocSize;
+    return true;
+}
+
+template<typename ElementType, uint32 InlineCapacity, typename Allocator>
+bool SmallDynArray<ElementType, InlineCapacity, Allocator>::Resize(uint32 size)
+{
+    const uint32 oldSize = this->mSize;
+
+    // call destructors
+    for (uint32 i = size; i < oldSize; ++i)
+    {
+        this->mElements[i].~ElementType();
+    }
+
+    if (!Reserve(size))
+    {
+        return false;
+    }
+
+    // initialize new elements
+    for (uint32 i = oldSize; i < size; ++i)
+    {
+        new (this->mElements + i) ElementType;
+    }
+
+    this->mSize = size;
+    return true;
+}
+
+} // namespace rt
@@ -5,4 +5,32 @@ namespace rt {
 
 using namespace math;
 
+void BSDF::SamplingContext_Simd8::SetEventType(const VectorBool8 mask, const EventType type)
+{
+    const int32 bits = mask.GetMask();
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        if (bits & (1 << i))
+        {
+            outEventType[i] = type;
+        }
+    }
+}
+
+void BSDF::SamplingContext_Simd8::Blend(const SamplingContext_Simd8& other, const VectorBool8 mask)
+{
+    outColor = Vector3x8::Select(outColor, other.outColor, mask);
+    outIncomingDir = Vector3x8::Select(outIncomingDir, other.outIncomingDir, mask);
+    outPdf = Vector8::Select(outPdf, other.outPdf, mask);
+
+    const int32 bits = mask.GetMask();
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        if (bits & (1 << i))
+        {
+            outEventType[i] = other.outEventType[i];
+        }
+    }
+}
+
 } // namespace rt
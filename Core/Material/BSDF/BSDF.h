@@ -4,6 +4,7 @@
 #include "../../Rendering/ShadingData.h"
 #include "../../Utils/Memory.h"
 #include "../../Math/Ray.h"
+#include "../../Math/Vector3x8.h"
 #include "../../Color/RayColor.h"
 
 namespace rt {
@@ -83,6 +84,42 @@ public:
         const math::Vector4 incomingDir;
     };
 
+    // 8-wide variant of the sampling context
+    // NOTE: all the lanes share the same material, colors are in RGB (no dispersion support)
+    struct SamplingContext_Simd8
+    {
+        // inputs
+        const Material& material;
+        math::Vector3x8 baseColor;
+        math::Vector8 roughness;
+        math::Vector8 IoR;
+        math::Vector3x8 sample;
+        math::Vector3x8 outgoingDir;
+
+        // outputs (valid only for lanes returned by Sample_Simd8)
+        math::Vector3x8 outColor = math::Vector3x8::Zero();
+        math::Vector3x8 outIncomingDir = math::Vector3x8::Zero();
+        math::Vector8 outPdf = math::Vector8::Zero();
+        EventType outEventType[8] = { NullEvent, NullEvent, NullEvent, NullEvent, NullEvent, NullEvent, NullEvent, NullEvent };
+
+        // set event type for selected lanes
+        void SetEventType(const math::VectorBool8 mask, const EventType type);
+
+        // copy outputs from other context for selected lanes
+        void Blend(const SamplingContext_Simd8& other, const math::VectorBool8 mask);
+    };
+
+    // 8-wide variant of the evaluation context
+    struct EvaluationContext_Simd8
+    {
+        const Material& material;
+        math::Vector3x8 baseColor;
+        math::Vector8 roughness;
+        math::Vector8 IoR;
+        math::Vector3x8 outgoingDir;
+        math::Vector3x8 incomingDir;
+    };
+
     // get debug name
     virtual const char* GetName() const = 0;
 
@@ -102,6 +139,13 @@ public:
 
     // Compute probability of scaterring event
     virtual float Pdf(const EvaluationContext& ctx, PdfDirection dir = ForwardPdf) const = 0;
+
+    // 8-wide variants of the functions above
+    // Divergent lanes are handled with masks, Sample_Simd8 returns mask of successfully sampled lanes.
+    // Color and PDF of the rejected lanes are zero.
+    virtual const math::VectorBool8 Sample_Simd8(SamplingContext_Simd8& ctx) const = 0;
+    virtual const math::Vector3x8 Evaluate_Simd8(const EvaluationContext_Simd8& ctx, math::Vector8* outDirectPdfW = nullptr, math::Vector8* outReversePdfW = nullptr) const = 0;
+    virtual const math::Vector8 Pdf_Simd8(const EvaluationContext_Simd8& ctx, PdfDirection dir = ForwardPdf) const = 0;
 };
 
 } // namespace rt
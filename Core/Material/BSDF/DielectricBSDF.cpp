@@ -130,4 +130,72 @@ float DielectricBSDF::Pdf(const EvaluationContext& ctx, PdfDirection dir) const
     return 0.0f;
 }
 
+const VectorBool8 DielectricBSDF::Sample_Simd8(SamplingContext_Simd8& ctx) const
+{
+    const Vector8 NdotV = ctx.outgoingDir.z;
+
+    // compute Fresnel term
+    const Vector8 F = FresnelDielectric(NdotV, ctx.IoR);
+
+    // increase probability of sampling refraction
+    const float minReflectionProbability = 0.25f;
+    const Vector8 reflectionProbability = Vector8::MulAndAdd(F, 1.0f - minReflectionProbability, Vector8(minReflectionProbability));
+    const Vector8 refractionProbability = Vector8(1.0f) - reflectionProbability;
+
+    // sample event
+    const VectorBool8 reflection = (reflectionProbability >= Vector8(1.0f)) | (ctx.sample.x < reflectionProbability);
+    const VectorBool8 transmission = (reflectionProbability < Vector8(1.0f)) & (ctx.sample.x >= reflectionProbability);
+
+    const Vector3x8 reflectedDir(-ctx.outgoingDir.x, -ctx.outgoingDir.y, ctx.outgoingDir.z);
+    const Vector3x8 refractedDir = Vector3x8::Refract(-ctx.outgoingDir, Vector3x8(VECTOR_Z), ctx.IoR);
+    ctx.outIncomingDir = Vector3x8::Select(refractedDir, reflectedDir, reflection);
+
+    // discard samples that land on wrong surface side
+    const Vector8 NdotVNdotL = NdotV * ctx.outIncomingDir.z;
+    const VectorBool8 valid =
+        (Vector8::Abs(NdotV) >= Vector8(CosEpsilon)) &
+        ((reflection & (NdotVNdotL > Vector8::Zero())) | (transmission & (NdotVNdotL <= Vector8::Zero())));
+
+    const Vector8 reflectionWeight = F / reflectionProbability;
+    const Vector8 refractionWeight = (Vector8(1.0f) - F) / refractionProbability;
+
+    const Vector3x8 reflectionColor(reflectionWeight);
+    const Vector3x8 refractionColor = ctx.baseColor * refractionWeight;
+
+    ctx.outColor = Vector3x8::Select(Vector3x8::Zero(), Vector3x8::Select(refractionColor, reflectionColor, reflection), valid);
+    ctx.outPdf = Vector8::Select(Vector8::Zero(), Vector8::Select(refractionProbability, reflectionProbability, reflection), valid);
+    ctx.SetEventType(valid & reflection, SpecularReflectionEvent);
+    ctx.SetEventType(valid & transmission, SpecularRefractionEvent);
+
+    return valid;
+}
+
+const Vector3x8 DielectricBSDF::Evaluate_Simd8(const EvaluationContext_Simd8& ctx, Vector8* outDirectPdfW, Vector8* outReversePdfW) const
+{
+    RT_UNUSED(ctx);
+
+    // Dirac delta, assume we cannot hit it
+
+    if (outDirectPdfW)
+    {
+        *outDirectPdfW = Vector8::Zero();
+    }
+
+    if (outReversePdfW)
+    {
+        *outReversePdfW = Vector8::Zero();
+    }
+
+    return Vector3x8::Zero();
+}
+
+const Vector8 DielectricBSDF::Pdf_Simd8(const EvaluationContext_Simd8& ctx, PdfDirection dir) const
+{
+    RT_UNUSED(ctx);
+    RT_UNUSED(dir);
+
+    // Dirac delta, assume we cannot hit it
+    return Vector8::Zero();
+}
+
 } // namespace rt
@@ -73,4 +73,48 @@ float DiffuseBSDF::Pdf(const EvaluationContext& ctx, PdfDirection dir) const
     return 0.0f;
 }
 
+const VectorBool8 DiffuseBSDF::Sample_Simd8(SamplingContext_Simd8& ctx) const
+{
+    const Vector8 NdotV = ctx.outgoingDir.z;
+    const VectorBool8 valid = NdotV >= Vector8(CosEpsilon);
+
+    ctx.outIncomingDir = SamplingHelpers::GetHemishpereCos_Simd8(Vector2x8(ctx.sample.x, ctx.sample.y));
+    ctx.outPdf = Vector8::Select(Vector8::Zero(), ctx.outIncomingDir.z * RT_INV_PI, valid);
+    ctx.outColor = Vector3x8::Select(Vector3x8::Zero(), ctx.baseColor, valid);
+    ctx.SetEventType(valid, DiffuseReflectionEvent);
+
+    return valid;
+}
+
+const Vector3x8 DiffuseBSDF::Evaluate_Simd8(const EvaluationContext_Simd8& ctx, Vector8* outDirectPdfW, Vector8* outReversePdfW) const
+{
+    const Vector8 NdotV = ctx.outgoingDir.z;
+    const Vector8 NdotL = -ctx.incomingDir.z;
+    const VectorBool8 valid = (NdotV > Vector8(CosEpsilon)) & (NdotL > Vector8(CosEpsilon));
+
+    if (outDirectPdfW)
+    {
+        // cos-weighted hemisphere distribution
+        *outDirectPdfW = Vector8::Select(Vector8::Zero(), NdotL * RT_INV_PI, valid);
+    }
+
+    if (outReversePdfW)
+    {
+        // cos-weighted hemisphere distribution
+        *outReversePdfW = Vector8::Select(Vector8::Zero(), NdotV * RT_INV_PI, valid);
+    }
+
+    return ctx.baseColor * Vector8::Select(Vector8::Zero(), NdotL * RT_INV_PI, valid);
+}
+
+const Vector8 DiffuseBSDF::Pdf_Simd8(const EvaluationContext_Simd8& ctx, PdfDirection dir) const
+{
+    const Vector8 NdotV = ctx.outgoingDir.z;
+    const Vector8 NdotL = -ctx.incomingDir.z;
+    const VectorBool8 valid = (NdotV > Vector8(CosEpsilon)) & (NdotL > Vector8(CosEpsilon));
+
+    const Vector8 pdf = (dir == ForwardPdf ? NdotL : NdotV) * RT_INV_PI;
+    return Vector8::Select(Vector8::Zero(), pdf, valid);
+}
+
 } // namespace rt
@@ -62,4 +62,47 @@ float MetalBSDF::Pdf(const EvaluationContext& ctx, PdfDirection dir) const
     return 0.0f;
 }
 
+const VectorBool8 MetalBSDF::Sample_Simd8(SamplingContext_Simd8& ctx) const
+{
+    const Vector8 NdotV = ctx.outgoingDir.z;
+    const VectorBool8 valid = NdotV >= Vector8(CosEpsilon);
+
+    const Vector8 F = FresnelMetal(NdotV, ctx.material.IoR, ctx.material.K);
+
+    ctx.outColor = ctx.baseColor * Vector8::Select(Vector8::Zero(), F, valid);
+    ctx.outIncomingDir = Vector3x8(-ctx.outgoingDir.x, -ctx.outgoingDir.y, ctx.outgoingDir.z);
+    ctx.outPdf = Vector8::Select(Vector8::Zero(), Vector8(1.0f), valid);
+    ctx.SetEventType(valid, SpecularReflectionEvent);
+
+    return valid;
+}
+
+const Vector3x8 MetalBSDF::Evaluate_Simd8(const EvaluationContext_Simd8& ctx, Vector8* outDirectPdfW, Vector8* outReversePdfW) const
+{
+    RT_UNUSED(ctx);
+
+    // Dirac delta, assume we cannot hit it
+
+    if (outDirectPdfW)
+    {
+        *outDirectPdfW = Vector8::Zero();
+    }
+
+    if (outReversePdfW)
+    {
+        *outReversePdfW = Vector8::Zero();
+    }
+
+    return Vector3x8::Zero();
+}
+
+const Vector8 MetalBSDF::Pdf_Simd8(const EvaluationContext_Simd8& ctx, PdfDirection dir) const
+{
+    RT_UNUSED(ctx);
+    RT_UNUSED(dir);
+
+    // Dirac delta, assume we cannot hit it
+    return Vector8::Zero();
+}
+
 } // namespace rt
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../../Math/Transcendental.h"
+#include "../../Math/Vector2x8.h"
+#include "../../Math/Vector3x8.h"
 
 namespace rt {
 
@@ -17,9 +19,9 @@ public:
 
     float D(const math::Vector4& m) const
     {
-        const float NdotH = m.z;
-        const float cosThetaSq = math::Sqr(NdotH);
-        const float tanThetaSq = math::Max(1.0f - cosThetaSq, 0.0f) / cosThetaSq;
+        // NOTE: sin^2 is computed from x and y components (not as 1 - cos^2) to avoid cancellation near the peak
+        const float cosThetaSq = math::Sqr(m.z);
+        const float tanThetaSq = (math::Sqr(m.x) + math::Sqr(m.y)) / cosThetaSq;
         const float cosThetaQu = cosThetaSq * cosThetaSq;
         return mAlphaSqr * RT_INV_PI / (cosThetaQu * math::Sqr(mAlphaSqr + tanThetaSq));
     }
@@ -46,9 +48,9 @@ public:
     const math::Vector4 Sample(const math::Float2 u) const
     {
         // generate microfacet normal vector using GGX distribution function (Trowbridge-Reitz)
-        const float cosThetaSqr = (1.0f - u.x) / (1.0f + (mAlphaSqr - 1.0f) * u.x);
-        const float cosTheta = math::Sqrt(cosThetaSqr);
-        const float sinTheta = math::Sqrt(1.0f - cosThetaSqr);
+        const float invDenom = 1.0f / (1.0f + (mAlphaSqr - 1.0f) * u.x);
+        const float cosTheta = math::Sqrt((1.0f - u.x) * invDenom);
+        const float sinTheta = math::Sqrt(mAlphaSqr * u.x * invDenom);
         const float phi = RT_2PI * u.y;
         const math::Vector4 xy = sinTheta * math::SinCos(phi);
         return math::Vector4::Select<0,0,1,0>(xy, math::Vector4(cosTheta));
@@ -59,4 +61,56 @@ private:
     float mAlphaSqr;
 };
 
+// 8-wide version of the GGX microfacet model
+class Microfacet_Simd8
+{
+public:
+    RT_FORCE_INLINE Microfacet_Simd8(const math::Vector8& alpha)
+        : mAlphaSqr(alpha * alpha)
+    { }
+
+    const math::Vector8 D(const math::Vector3x8& m) const
+    {
+        using namespace math;
+        const Vector8 cosThetaSq = m.z * m.z;
+        const Vector8 tanThetaSq = Vector8::MulAndAdd(m.x, m.x, m.y * m.y) / cosThetaSq;
+        const Vector8 cosThetaQu = cosThetaSq * cosThetaSq;
+        const Vector8 denomSqrt = mAlphaSqr + tanThetaSq;
+        return mAlphaSqr * RT_INV_PI / (cosThetaQu * denomSqrt * denomSqrt);
+    }
+
+    RT_FORCE_INLINE const math::Vector8 Pdf(const math::Vector3x8& m) const
+    {
+        return D(m) * math::Vector8::Abs(m.z);
+    }
+
+    // shadowing-masking term
+    const math::Vector8 G(const math::Vector8& NdotV, const math::Vector8& NdotL) const
+    {
+        using namespace math;
+        const Vector8 one(1.0f);
+        const Vector8 NdotVSq = NdotV * NdotV;
+        const Vector8 NdotLSq = NdotL * NdotL;
+        const Vector8 tanThetaSqV = (one - NdotVSq) / NdotVSq;
+        const Vector8 tanThetaSqL = (one - NdotLSq) / NdotLSq;
+        const Vector8 termV = one + Vector8::Sqrt(Vector8::MulAndAdd(mAlphaSqr, tanThetaSqV, one));
+        const Vector8 termL = one + Vector8::Sqrt(Vector8::MulAndAdd(mAlphaSqr, tanThetaSqL, one));
+        return Vector8(4.0f) / (termV * termL);
+    }
+
+    const math::Vector3x8 Sample(const math::Vector2x8& u) const
+    {
+        using namespace math;
+        const Vector8 one(1.0f);
+        const Vector8 invDenom = one / Vector8::MulAndAdd(mAlphaSqr - one, u.x, one);
+        const Vector8 cosTheta = Vector8::Sqrt((one - u.x) * invDenom);
+        const Vector8 sinTheta = Vector8::Sqrt(mAlphaSqr * u.x * invDenom);
+        const Vector8 phi = u.y * RT_2PI;
+        return { sinTheta * Sin(phi), sinTheta * Cos(phi), cosTheta };
+    }
+
+private:
+    math::Vector8 mAlphaSqr;
+};
+
 } // namespace rt
@@ -3,6 +3,8 @@
 
 namespace rt {
 
+using namespace math;
+
 const char* NullBSDF::GetName() const
 {
     return "null";
@@ -32,4 +34,34 @@ float NullBSDF::Pdf(const EvaluationContext& ctx, PdfDirection dir) const
     return 0.0f;
 }
 
+const VectorBool8 NullBSDF::Sample_Simd8(SamplingContext_Simd8& ctx) const
+{
+    RT_UNUSED(ctx);
+    return VectorBool8(false, false, false, false, false, false, false, false);
+}
+
+const Vector3x8 NullBSDF::Evaluate_Simd8(const EvaluationContext_Simd8& ctx, Vector8* outDirectPdfW, Vector8* outReversePdfW) const
+{
+    RT_UNUSED(ctx);
+
+    if (outDirectPdfW)
+    {
+        *outDirectPdfW = Vector8::Zero();
+    }
+
+    if (outReversePdfW)
+    {
+        *outReversePdfW = Vector8::Zero();
+    }
+
+    return Vector3x8::Zero();
+}
+
+const Vector8 NullBSDF::Pdf_Simd8(const EvaluationContext_Simd8& ctx, PdfDirection dir) const
+{
+    RT_UNUSED(ctx);
+    RT_UNUSED(dir);
+    return Vector8::Zero();
+}
+
 } // namespace rt
@@ -13,6 +13,9 @@ public:
     virtual bool Sample(SamplingContext& ctx) const override;
     virtual const RayColor Evaluate(const EvaluationContext& ctx, float* outDirectPdfW = nullptr, float* outReversePdfW = nullptr) const override;
     virtual float Pdf(const EvaluationContext& ctx, PdfDirection dir) const override;
+    virtual const math::VectorBool8 Sample_Simd8(SamplingContext_Simd8& ctx) const override;
+    virtual const math::Vector3x8 Evaluate_Simd8(const EvaluationContext_Simd8& ctx, math::Vector8* outDirectPdfW = nullptr, math::Vector8* outReversePdfW = nullptr) const override;
+    virtual const math::Vector8 Pdf_Simd8(const EvaluationContext_Simd8& ctx, PdfDirection dir) const override;
 };
 
 } // namespace rt
@@ -126,4 +126,94 @@ float PlasticBSDF::Pdf(const EvaluationContext& ctx, PdfDirection dir) const
     }
 }
 
+const VectorBool8 PlasticBSDF::Sample_Simd8(SamplingContext_Simd8& ctx) const
+{
+    const Vector8 NdotV = ctx.outgoingDir.z;
+    const VectorBool8 valid = NdotV >= Vector8(CosEpsilon);
+
+    const Vector8 Fi = FresnelDielectric(NdotV, ctx.IoR);
+
+    // increase probability of sampling reflection
+    const float minSpecularWeight = 0.25f;
+    const Vector8 specularWeight = Vector8::MulAndAdd(Fi, 1.0f - minSpecularWeight, Vector8(minSpecularWeight));
+    const Vector8 baseColorMax = Vector8::Max(Vector8::Max(ctx.baseColor.x, ctx.baseColor.y), ctx.baseColor.z);
+    const Vector8 diffuseWeight = (Vector8(1.0f) - Fi) * baseColorMax;
+
+    // importance sample specular reflectivity
+    const Vector8 specularProbability = specularWeight / (specularWeight + diffuseWeight);
+    const Vector8 diffuseProbability = Vector8(1.0f) - specularProbability;
+
+    const VectorBool8 specular = (specularProbability >= Vector8(1.0f)) | (ctx.sample.z < specularProbability);
+    const VectorBool8 diffuse = (specularProbability < Vector8(1.0f)) & (ctx.sample.z >= specularProbability);
+
+    // specular reflection
+    const Vector3x8 specularDir(-ctx.outgoingDir.x, -ctx.outgoingDir.y, ctx.outgoingDir.z);
+    const Vector3x8 specularColor(Fi / specularProbability);
+
+    // diffuse reflection
+    const Vector3x8 diffuseDir = SamplingHelpers::GetHemishpereCos_Simd8(Vector2x8(ctx.sample.x, ctx.sample.y));
+    const Vector8 NdotL = diffuseDir.z;
+    const Vector8 diffusePdf = NdotL * RT_INV_PI * diffuseProbability;
+    const Vector8 Fo = FresnelDielectric(NdotL, ctx.IoR);
+    const Vector3x8 diffuseColor = ctx.baseColor * ((Vector8(1.0f) - Fi) * (Vector8(1.0f) - Fo) / diffuseProbability);
+
+    ctx.outIncomingDir = Vector3x8::Select(diffuseDir, specularDir, specular);
+    ctx.outColor = Vector3x8::Select(Vector3x8::Zero(), Vector3x8::Select(diffuseColor, specularColor, specular), valid);
+    ctx.outPdf = Vector8::Select(Vector8::Zero(), Vector8::Select(diffusePdf, specularProbability, specular), valid);
+    ctx.SetEventType(valid & specular, SpecularReflectionEvent);
+    ctx.SetEventType(valid & diffuse, DiffuseReflectionEvent);
+
+    return valid;
+}
+
+const Vector3x8 PlasticBSDF::Evaluate_Simd8(const EvaluationContext_Simd8& ctx, Vector8* outDirectPdfW, Vector8* outReversePdfW) const
+{
+    const Vector8 NdotV = ctx.outgoingDir.z;
+    const Vector8 NdotL = -ctx.incomingDir.z;
+    const VectorBool8 valid = (NdotV >= Vector8(CosEpsilon)) & (NdotL >= Vector8(CosEpsilon));
+
+    const Vector8 Fi = FresnelDielectric(NdotV, ctx.IoR);
+    const Vector8 Fo = FresnelDielectric(NdotL, ctx.IoR);
+
+    const Vector8 specularWeight = Fi;
+    const Vector8 baseColorMax = Vector8::Max(Vector8::Max(ctx.baseColor.x, ctx.baseColor.y), ctx.baseColor.z);
+    const Vector8 diffuseWeight = (Vector8(1.0f) - Fi) * baseColorMax;
+
+    const Vector8 specularProbability = specularWeight / (specularWeight + diffuseWeight);
+    const Vector8 diffuseProbability = Vector8::Select(Vector8::Zero(), Vector8(1.0f) - specularProbability, valid);
+
+    if (outDirectPdfW)
+    {
+        // cos-weighted hemisphere distribution
+        *outDirectPdfW = NdotL * RT_INV_PI * diffuseProbability;
+    }
+
+    if (outReversePdfW)
+    {
+        // cos-weighted hemisphere distribution
+        *outReversePdfW = NdotV * RT_INV_PI * diffuseProbability;
+    }
+
+    const Vector8 value = NdotL * RT_INV_PI * (Vector8(1.0f) - Fi) * (Vector8(1.0f) - Fo);
+    return ctx.baseColor * Vector8::Select(Vector8::Zero(), value, valid);
+}
+
+const Vector8 PlasticBSDF::Pdf_Simd8(const EvaluationContext_Simd8& ctx, PdfDirection dir) const
+{
+    const Vector8 NdotV = ctx.outgoingDir.z;
+    const Vector8 NdotL = -ctx.incomingDir.z;
+    const VectorBool8 valid = (NdotV >= Vector8(CosEpsilon)) & (NdotL >= Vector8(CosEpsilon));
+
+    const Vector8 Fi = FresnelDielectric(NdotV, ctx.IoR);
+    const Vector8 specularWeight = Fi;
+    const Vector8 baseColorMax = Vector8::Max(Vector8::Max(ctx.baseColor.x, ctx.baseColor.y), ctx.baseColor.z);
+    const Vector8 diffuseWeight = (Vector8(1.0f) - Fi) * baseColorMax;
+
+    const Vector8 specularProbability = specularWeight / (specularWeight + diffuseWeight);
+    const Vector8 diffuseProbability = Vector8(1.0f) - specularProbability;
+
+    const Vector8 pdf = (dir == ForwardPdf ? NdotL : NdotV) * RT_INV_PI * diffuseProbability;
+    return Vector8::Select(Vector8::Zero(), pdf, valid);
+}
+
 } // namespace rt
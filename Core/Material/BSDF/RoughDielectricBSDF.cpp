@@ -252,4 +252,168 @@ float RoughDielectricBSDF::Pdf(const EvaluationContext& ctx, PdfDirection dir) c
     }
 }
 
+const VectorBool8 RoughDielectricBSDF::Sample_Simd8(SamplingContext_Simd8& ctx) const
+{
+    const VectorBool8 isSmooth = ctx.roughness < Vector8(SpecularEventRoughnessTreshold);
+    const VectorBool8 isRough = ctx.roughness >= Vector8(SpecularEventRoughnessTreshold);
+
+    // fallback to specular event
+    if (isSmooth.All())
+    {
+        return DielectricBSDF().Sample_Simd8(ctx);
+    }
+
+    const Vector8 NdotV = ctx.outgoingDir.z;
+
+    // microfacet normal (aka. half vector)
+    const Microfacet_Simd8 microfacet(ctx.roughness * ctx.roughness);
+    const Vector3x8 m = microfacet.Sample(Vector2x8(ctx.sample.x, ctx.sample.y));
+    const Vector8 D = microfacet.D(m);
+    const Vector8 microfacetPdf = D * Vector8::Abs(m.z);
+    const Vector8 VdotH = Vector3x8::Dot(m, ctx.outgoingDir);
+
+    // compute Fresnel term
+    const Vector8 F = FresnelDielectric(VdotH, ctx.IoR);
+    const VectorBool8 reflection = ctx.sample.z < F;
+    const VectorBool8 transmission = ctx.sample.z >= F;
+
+    const Vector3x8 reflectedDir = -Vector3x8::Reflect(ctx.outgoingDir, m);
+    const Vector3x8 refractedDir = Vector3x8::Refract(-ctx.outgoingDir, m, ctx.IoR);
+    const Vector3x8 incomingDir = Vector3x8::Select(refractedDir, reflectedDir, reflection);
+
+    const Vector8 NdotL = incomingDir.z;
+    const Vector8 LdotH = Vector3x8::Dot(m, incomingDir);
+
+    // discard samples that land on wrong surface side
+    const Vector8 NdotVNdotL = NdotV * NdotL;
+    VectorBool8 valid =
+        isRough & (Vector8::Abs(NdotV) >= Vector8(CosEpsilon)) &
+        ((reflection & (NdotVNdotL > Vector8::Zero())) | (transmission & (NdotVNdotL <= Vector8::Zero())));
+
+    const Vector8 G = microfacet.G(NdotV, NdotL);
+    const Vector8 weight = Vector8::Abs(VdotH) * G * D / (microfacetPdf * Vector8::Abs(NdotV));
+
+    const Vector8 reflectionPdf = F * microfacetPdf / (4.0f * Vector8::Abs(VdotH));
+
+    const Vector8 eta = Vector8::Select(Vector8::Reciprocal(ctx.IoR), ctx.IoR, NdotV < Vector8::Zero());
+    const Vector8 denomSqrt = Vector8::MulAndAdd(eta, VdotH, LdotH);
+    const Vector8 refractionPdf = (Vector8(1.0f) - F) * microfacetPdf * Vector8::Abs(LdotH) / (denomSqrt * denomSqrt);
+
+    SamplingContext_Simd8 smoothCtx = ctx;
+
+    // Note: reflection is white for dielectrics
+    const Vector3x8 color = Vector3x8::Select(ctx.baseColor, Vector3x8::One(), reflection) * weight;
+
+    ctx.outIncomingDir = incomingDir;
+    ctx.outColor = Vector3x8::Select(Vector3x8::Zero(), color, valid);
+    ctx.outPdf = Vector8::Select(Vector8::Zero(), Vector8::Select(refractionPdf, reflectionPdf, reflection), valid);
+    ctx.SetEventType(valid & reflection, GlossyReflectionEvent);
+    ctx.SetEventType(valid & transmission, GlossyRefractionEvent);
+
+    if (isSmooth.Any())
+    {
+        const VectorBool8 smoothValid = DielectricBSDF().Sample_Simd8(smoothCtx) & isSmooth;
+        ctx.Blend(smoothCtx, isSmooth);
+        valid = valid | smoothValid;
+    }
+
+    return valid;
+}
+
+const Vector3x8 RoughDielectricBSDF::Evaluate_Simd8(const EvaluationContext_Simd8& ctx, Vector8* outDirectPdfW, Vector8* outReversePdfW) const
+{
+    const Vector8 NdotV = ctx.outgoingDir.z; // wi
+    const Vector8 NdotL = -ctx.incomingDir.z; // wo
+
+    // NOTE: smooth dielectric evaluates to zero, so fallback lanes are simply masked out
+    VectorBool8 valid =
+        (ctx.roughness >= Vector8(SpecularEventRoughnessTreshold)) &
+        (Vector8::Abs(NdotV) >= Vector8(CosEpsilon)) &
+        (Vector8::Abs(NdotL) >= Vector8(CosEpsilon));
+
+    // TODO handle dispersion
+    const Vector8 eta = Vector8::Select(Vector8::Reciprocal(ctx.IoR), ctx.IoR, NdotV < Vector8::Zero());
+
+    const VectorBool8 reflection = NdotV * NdotL >= Vector8::Zero();
+
+    // microfacet normal
+    Vector3x8 m = Vector3x8::Select(ctx.outgoingDir * eta - ctx.incomingDir, ctx.outgoingDir - ctx.incomingDir, reflection);
+    m = Vector3x8::Select(m, -m, m.z < Vector8::Zero());
+    m = m.Normalized();
+
+    valid = valid & (Vector8::Abs(m.z) >= Vector8(CosEpsilon));
+
+    const Vector8 VdotH = Vector3x8::Dot(m, ctx.outgoingDir);
+    const Vector8 LdotH = -Vector3x8::Dot(m, ctx.incomingDir);
+
+    const Microfacet_Simd8 microfacet(ctx.roughness * ctx.roughness);
+    const Vector8 F = FresnelDielectric(VdotH, ctx.IoR);
+    const Vector8 D = microfacet.D(m);
+    const Vector8 G = microfacet.G(NdotV, NdotL);
+    const Vector8 microfacetPdf = D * Vector8::Abs(m.z);
+
+    const Vector8 reflectionPdf = F * microfacetPdf / (4.0f * Vector8::Abs(VdotH));
+    const Vector8 reflectionValue = F * G * D / (4.0f * Vector8::Abs(NdotV));
+
+    const Vector8 denomSqrt = Vector8::MulAndAdd(eta, VdotH, LdotH);
+    const Vector8 denom = denomSqrt * denomSqrt;
+    const Vector8 refractionPdf = (Vector8(1.0f) - F) * microfacetPdf * Vector8::Abs(LdotH) / denom;
+    const Vector8 refractionValue = Vector8::Abs(VdotH * LdotH) * (Vector8(1.0f) - F) * G * D / (denom * Vector8::Abs(NdotV));
+
+    const Vector8 pdf = Vector8::Select(Vector8::Zero(), Vector8::Select(refractionPdf, reflectionPdf, reflection), valid);
+
+    if (outDirectPdfW)
+    {
+        *outDirectPdfW = pdf;
+    }
+
+    if (outReversePdfW)
+    {
+        // TODO is this correct for reverse direction?
+        *outReversePdfW = pdf;
+    }
+
+    return Vector3x8(Vector8::Select(Vector8::Zero(), Vector8::Select(refractionValue, reflectionValue, reflection), valid));
+}
+
+const Vector8 RoughDielectricBSDF::Pdf_Simd8(const EvaluationContext_Simd8& ctx, PdfDirection dir) const
+{
+    // TODO is this correct for reverse direction?
+    RT_UNUSED(dir);
+
+    const Vector8 NdotV = ctx.outgoingDir.z; // wi
+    const Vector8 NdotL = -ctx.incomingDir.z; // wo
+
+    VectorBool8 valid =
+        (ctx.roughness >= Vector8(SpecularEventRoughnessTreshold)) &
+        (Vector8::Abs(NdotV) >= Vector8(CosEpsilon)) &
+        (Vector8::Abs(NdotL) >= Vector8(CosEpsilon));
+
+    // TODO handle dispersion
+    const Vector8 eta = Vector8::Select(Vector8::Reciprocal(ctx.IoR), ctx.IoR, NdotV < Vector8::Zero());
+
+    const VectorBool8 reflection = NdotV * NdotL >= Vector8::Zero();
+
+    // microfacet normal
+    Vector3x8 m = Vector3x8::Select(ctx.outgoingDir * eta - ctx.incomingDir, ctx.outgoingDir - ctx.incomingDir, reflection);
+    m = Vector3x8::Select(m, -m, m.z < Vector8::Zero());
+    m = m.Normalized();
+
+    valid = valid & (Vector8::Abs(m.z) >= Vector8(CosEpsilon));
+
+    const Vector8 VdotH = Vector3x8::Dot(m, ctx.outgoingDir);
+    const Vector8 LdotH = -Vector3x8::Dot(m, ctx.incomingDir);
+
+    const Microfacet_Simd8 microfacet(ctx.roughness * ctx.roughness);
+    const Vector8 F = FresnelDielectric(VdotH, ctx.IoR);
+    const Vector8 microfacetPdf = microfacet.Pdf(m);
+
+    const Vector8 reflectionPdf = F * microfacetPdf / (4.0f * Vector8::Abs(VdotH));
+
+    const Vector8 denomSqrt = Vector8::MulAndAdd(eta, VdotH, LdotH);
+    const Vector8 refractionPdf = (Vector8(1.0f) - F) * microfacetPdf * Vector8::Abs(LdotH) / (denomSqrt * denomSqrt);
+
+    return Vector8::Select(Vector8::Zero(), Vector8::Select(refractionPdf, reflectionPdf, reflection), valid);
+}
+
 } // namespace rt
@@ -92,4 +92,67 @@ float RoughDiffuseBSDF::Pdf(const EvaluationContext& ctx, PdfDirection dir) cons
     return 0.0f;
 }
 
+const Vector8 RoughDiffuseBSDF::Evaluate_Internal_Simd8(const Vector8& NdotL, const Vector8& NdotV, const Vector8& LdotV, const Vector8& roughness)
+{
+    const Vector8 s2 = roughness * roughness;
+    const Vector8 A = Vector8(1.0f) - 0.50f * s2 / (Vector8(0.33f) + s2);
+    const Vector8 B =                 0.45f * s2 / (Vector8(0.09f) + s2);
+    const Vector8 s = Vector8::NegMulAndAdd(NdotL, NdotV, LdotV);
+    const Vector8 stinv = Vector8::Select(Vector8::Zero(), s / Vector8::Max(NdotL, NdotV), s > Vector8::Zero());
+
+    return Vector8::Max(Vector8::MulAndAdd(B, stinv, A), Vector8::Zero());
+}
+
+const VectorBool8 RoughDiffuseBSDF::Sample_Simd8(SamplingContext_Simd8& ctx) const
+{
+    const Vector8 NdotV = ctx.outgoingDir.z;
+    const VectorBool8 valid = NdotV >= Vector8(CosEpsilon);
+
+    ctx.outIncomingDir = SamplingHelpers::GetHemishpereCos_Simd8(Vector2x8(ctx.sample.x, ctx.sample.y));
+
+    const Vector8 NdotL = ctx.outIncomingDir.z;
+    const Vector8 LdotV = Vector8::Max(Vector8::Zero(), Vector3x8::Dot(ctx.outgoingDir, -ctx.outIncomingDir));
+    const Vector8 value = Evaluate_Internal_Simd8(NdotL, NdotV, LdotV, ctx.roughness);
+
+    ctx.outPdf = Vector8::Select(Vector8::Zero(), NdotL * RT_INV_PI, valid);
+    ctx.outColor = ctx.baseColor * Vector8::Select(Vector8::Zero(), value, valid);
+    ctx.SetEventType(valid, DiffuseReflectionEvent);
+
+    return valid;
+}
+
+const Vector3x8 RoughDiffuseBSDF::Evaluate_Simd8(const EvaluationContext_Simd8& ctx, Vector8* outDirectPdfW, Vector8* outReversePdfW) const
+{
+    const Vector8 NdotV = ctx.outgoingDir.z;
+    const Vector8 NdotL = -ctx.incomingDir.z;
+    const VectorBool8 valid = (NdotV > Vector8(CosEpsilon)) & (NdotL > Vector8(CosEpsilon));
+
+    if (outDirectPdfW)
+    {
+        // cos-weighted hemisphere distribution
+        *outDirectPdfW = Vector8::Select(Vector8::Zero(), NdotL * RT_INV_PI, valid);
+    }
+
+    if (outReversePdfW)
+    {
+        // cos-weighted hemisphere distribution
+        *outReversePdfW = Vector8::Select(Vector8::Zero(), NdotV * RT_INV_PI, valid);
+    }
+
+    const Vector8 LdotV = Vector8::Max(Vector8::Zero(), Vector3x8::Dot(ctx.outgoingDir, -ctx.incomingDir));
+    const Vector8 value = NdotL * RT_INV_PI * Evaluate_Internal_Simd8(NdotL, NdotV, LdotV, ctx.roughness);
+
+    return ctx.baseColor * Vector8::Select(Vector8::Zero(), value, valid);
+}
+
+const Vector8 RoughDiffuseBSDF::Pdf_Simd8(const EvaluationContext_Simd8& ctx, PdfDirection dir) const
+{
+    const Vector8 NdotV = ctx.outgoingDir.z;
+    const Vector8 NdotL = -ctx.incomingDir.z;
+    const VectorBool8 valid = (NdotV > Vector8(CosEpsilon)) & (NdotL > Vector8(CosEpsilon));
+
+    const Vector8 pdf = (dir == ForwardPdf ? NdotL : NdotV) * RT_INV_PI;
+    return Vector8::Select(Vector8::Zero(), pdf, valid);
+}
+
 } // namespace rt
@@ -12,8 +12,12 @@ public:
     virtual bool Sample(SamplingContext& ctx) const override;
     virtual const RayColor Evaluate(const EvaluationContext& ctx, float* outDirectPdfW = nullptr, float* outReversePdfW = nullptr) const override;
     virtual float Pdf(const EvaluationContext& ctx, PdfDirection dir) const override;
+    virtual const math::VectorBool8 Sample_Simd8(SamplingContext_Simd8& ctx) const override;
+    virtual const math::Vector3x8 Evaluate_Simd8(const EvaluationContext_Simd8& ctx, math::Vector8* outDirectPdfW = nullptr, math::Vector8* outReversePdfW = nullptr) const override;
+    virtual const math::Vector8 Pdf_Simd8(const EvaluationContext_Simd8& ctx, PdfDirection dir) const override;
 
     static float Evaluate_Internal(const float NdotL, const float NdotV, const float LdotV, const float roughness);
+    static const math::Vector8 Evaluate_Internal_Simd8(const math::Vector8& NdotL, const math::Vector8& NdotV, const math::Vector8& LdotV, const math::Vector8& roughness);
 };
 
 } // namespace rt
@@ -136,4 +136,107 @@ float RoughMetalBSDF::Pdf(const EvaluationContext& ctx, PdfDirection dir) const
     return microfacet.Pdf(m) / (4.0f * VdotH);
 }
 
+const VectorBool8 RoughMetalBSDF::Sample_Simd8(SamplingContext_Simd8& ctx) const
+{
+    const VectorBool8 isSmooth = ctx.roughness < Vector8(SpecularEventRoughnessTreshold);
+    const VectorBool8 isRough = ctx.roughness >= Vector8(SpecularEventRoughnessTreshold);
+
+    // fallback to specular event
+    if (isSmooth.All())
+    {
+        return MetalBSDF().Sample_Simd8(ctx);
+    }
+
+    const Vector8 NdotV = ctx.outgoingDir.z;
+
+    // microfacet normal (aka. half vector)
+    const Microfacet_Simd8 microfacet(ctx.roughness * ctx.roughness);
+    const Vector3x8 m = microfacet.Sample(Vector2x8(ctx.sample.x, ctx.sample.y));
+
+    // compute reflected direction
+    const Vector3x8 incomingDir = -Vector3x8::Reflect(ctx.outgoingDir, m);
+
+    const Vector8 NdotL = incomingDir.z;
+    const Vector8 VdotH = Vector3x8::Dot(m, ctx.outgoingDir);
+
+    VectorBool8 valid = isRough & (NdotV >= Vector8(CosEpsilon)) & (NdotL >= Vector8(CosEpsilon));
+
+    const Vector8 D = microfacet.D(m);
+    const Vector8 pdf = D * Vector8::Abs(m.z);
+    const Vector8 G = microfacet.G(NdotV, NdotL);
+    const Vector8 F = FresnelMetal(VdotH, ctx.material.IoR, ctx.material.K);
+
+    SamplingContext_Simd8 smoothCtx = ctx;
+
+    ctx.outIncomingDir = incomingDir;
+    ctx.outPdf = Vector8::Select(Vector8::Zero(), pdf / (4.0f * VdotH), valid);
+    ctx.outColor = ctx.baseColor * Vector8::Select(Vector8::Zero(), VdotH * F * G * D / (pdf * NdotV), valid);
+    ctx.SetEventType(valid, GlossyReflectionEvent);
+
+    if (isSmooth.Any())
+    {
+        const VectorBool8 smoothValid = MetalBSDF().Sample_Simd8(smoothCtx) & isSmooth;
+        ctx.Blend(smoothCtx, isSmooth);
+        valid = valid | smoothValid;
+    }
+
+    return valid;
+}
+
+const Vector3x8 RoughMetalBSDF::Evaluate_Simd8(const EvaluationContext_Simd8& ctx, Vector8* outDirectPdfW, Vector8* outReversePdfW) const
+{
+    // NOTE: smooth metal evaluates to zero, so fallback lanes are simply masked out
+    const VectorBool8 isRough = ctx.roughness >= Vector8(SpecularEventRoughnessTreshold);
+
+    // microfacet normal
+    const Vector3x8 m = (ctx.outgoingDir - ctx.incomingDir).Normalized();
+
+    const Vector8 NdotV = ctx.outgoingDir.z;
+    const Vector8 NdotL = -ctx.incomingDir.z;
+    const Vector8 VdotH = Vector3x8::Dot(m, ctx.outgoingDir);
+
+    // clip the function
+    const VectorBool8 valid = isRough & (NdotV >= Vector8(CosEpsilon)) & (NdotL >= Vector8(CosEpsilon)) & (VdotH >= Vector8(CosEpsilon));
+
+    const Microfacet_Simd8 microfacet(ctx.roughness * ctx.roughness);
+    const Vector8 D = microfacet.D(m);
+    const Vector8 G = microfacet.G(NdotV, NdotL);
+    const Vector8 F = FresnelMetal(VdotH, ctx.material.IoR, ctx.material.K);
+
+    const Vector8 pdf = Vector8::Select(Vector8::Zero(), D * Vector8::Abs(m.z) / (4.0f * VdotH), valid);
+
+    if (outDirectPdfW)
+    {
+        *outDirectPdfW = pdf;
+    }
+
+    if (outReversePdfW)
+    {
+        *outReversePdfW = pdf;
+    }
+
+    return ctx.baseColor * Vector8::Select(Vector8::Zero(), F * G * D / (4.0f * NdotV), valid);
+}
+
+const Vector8 RoughMetalBSDF::Pdf_Simd8(const EvaluationContext_Simd8& ctx, PdfDirection dir) const
+{
+    RT_UNUSED(dir);
+
+    const VectorBool8 isRough = ctx.roughness >= Vector8(SpecularEventRoughnessTreshold);
+
+    // microfacet normal
+    const Vector3x8 m = (ctx.outgoingDir - ctx.incomingDir).Normalized();
+
+    const Vector8 NdotV = ctx.outgoingDir.z;
+    const Vector8 NdotL = -ctx.incomingDir.z;
+    const Vector8 VdotH = Vector3x8::Dot(m, ctx.outgoingDir);
+
+    // clip the function
+    const VectorBool8 valid = isRough & (NdotV >= Vector8(CosEpsilon)) & (NdotL >= Vector8(CosEpsilon)) & (VdotH >= Vector8(CosEpsilon));
+
+    const Microfacet_Simd8 microfacet(ctx.roughness * ctx.roughness);
+
+    return Vector8::Select(Vector8::Zero(), microfacet.Pdf(m) / (4.0f * VdotH), valid);
+}
+
 } // namespace rt
@@ -211,4 +211,192 @@ float RoughPlasticBSDF::Pdf(const EvaluationContext& ctx, PdfDirection dir) cons
     return diffusePdf * diffuseProbability + specularPdf * specularProbability;
 }
 
+const VectorBool8 RoughPlasticBSDF::Sample_Simd8(SamplingContext_Simd8& ctx) const
+{
+    const VectorBool8 isSmooth = ctx.roughness < Vector8(SpecularEventRoughnessTreshold);
+    const VectorBool8 isRough = ctx.roughness >= Vector8(SpecularEventRoughnessTreshold);
+
+    // fallback to specular event
+    if (isSmooth.All())
+    {
+        return PlasticBSDF().Sample_Simd8(ctx);
+    }
+
+    const Vector8 NdotV = ctx.outgoingDir.z;
+
+    const Vector8 Fi = FresnelDielectric(NdotV, ctx.IoR);
+    const Vector8 specularWeight = Fi;
+    const Vector8 baseColorMax = Vector8::Max(Vector8::Max(ctx.baseColor.x, ctx.baseColor.y), ctx.baseColor.z);
+    const Vector8 diffuseWeight = (Vector8(1.0f) - Fi) * baseColorMax;
+
+    // importance sample specular reflectivity
+    const Vector8 specularProbability = specularWeight / (specularWeight + diffuseWeight);
+    const Vector8 diffuseProbability = Vector8(1.0f) - specularProbability;
+
+    const VectorBool8 specular = ctx.sample.z < specularProbability;
+    const VectorBool8 diffuse = ctx.sample.z >= specularProbability;
+
+    // glossy reflection
+    const Microfacet_Simd8 microfacet(ctx.roughness * ctx.roughness);
+    const Vector3x8 m = microfacet.Sample(Vector2x8(ctx.sample.x, ctx.sample.y));
+    const Vector3x8 specularDir = -Vector3x8::Reflect(ctx.outgoingDir, m);
+    const Vector8 specularNdotL = specularDir.z;
+    const Vector8 VdotH = Vector3x8::Dot(m, ctx.outgoingDir);
+    const VectorBool8 specularValid = specular & (specularNdotL >= Vector8(CosEpsilon)) & (VdotH >= Vector8(CosEpsilon));
+
+    const Vector8 D = microfacet.D(m);
+    const Vector8 microfacetPdf = D * Vector8::Abs(m.z);
+    const Vector8 G = microfacet.G(NdotV, specularNdotL);
+    const Vector8 F = FresnelDielectric(VdotH, Vector8(ctx.material.IoR));
+    const Vector8 specularPdf = microfacetPdf / (4.0f * VdotH) * specularProbability;
+    const Vector3x8 specularColor(VdotH * F * G * D / (microfacetPdf * NdotV * specularProbability));
+
+    // diffuse reflection
+    const Vector3x8 diffuseDir = SamplingHelpers::GetHemishpereCos_Simd8(Vector2x8(ctx.sample.x, ctx.sample.y));
+    const Vector8 diffuseNdotL = diffuseDir.z;
+    const Vector8 diffusePdf = diffuseNdotL * RT_INV_PI * diffuseProbability;
+    const Vector8 Fo = FresnelDielectric(diffuseNdotL, ctx.IoR);
+    const Vector3x8 diffuseColor = ctx.baseColor * ((Vector8(1.0f) - Fi) * (Vector8(1.0f) - Fo) / diffuseProbability);
+
+    VectorBool8 valid = isRough & (NdotV >= Vector8(CosEpsilon)) & (specularValid | diffuse);
+
+    SamplingContext_Simd8 smoothCtx = ctx;
+
+    ctx.outIncomingDir = Vector3x8::Select(diffuseDir, specularDir, specular);
+    ctx.outColor = Vector3x8::Select(Vector3x8::Zero(), Vector3x8::Select(diffuseColor, specularColor, specular), valid);
+    ctx.outPdf = Vector8::Select(Vector8::Zero(), Vector8::Select(diffusePdf, specularPdf, specular), valid);
+    ctx.SetEventType(valid & specular, GlossyReflectionEvent);
+    ctx.SetEventType(valid & diffuse, DiffuseReflectionEvent);
+
+    if (isSmooth.Any())
+    {
+        const VectorBool8 smoothValid = PlasticBSDF().Sample_Simd8(smoothCtx) & isSmooth;
+        ctx.Blend(smoothCtx, isSmooth);
+        valid = valid | smoothValid;
+    }
+
+    return valid;
+}
+
+const Vector3x8 RoughPlasticBSDF::Evaluate_Simd8(const EvaluationContext_Simd8& ctx, Vector8* outDirectPdfW, Vector8* outReversePdfW) const
+{
+    const VectorBool8 isSmooth = ctx.roughness < Vector8(SpecularEventRoughnessTreshold);
+
+    // fallback to specular event
+    if (isSmooth.All())
+    {
+        return PlasticBSDF().Evaluate_Simd8(ctx, outDirectPdfW, outReversePdfW);
+    }
+
+    const Vector8 NdotV = ctx.outgoingDir.z;
+    const Vector8 NdotL = -ctx.incomingDir.z;
+    const VectorBool8 valid = (NdotV >= Vector8(CosEpsilon)) & (NdotL >= Vector8(CosEpsilon));
+
+    const Vector8 Fi = FresnelDielectric(NdotV, ctx.IoR);
+    const Vector8 Fo = FresnelDielectric(NdotL, ctx.IoR);
+
+    const Vector8 specularWeight = Fi;
+    const Vector8 baseColorMax = Vector8::Max(Vector8::Max(ctx.baseColor.x, ctx.baseColor.y), ctx.baseColor.z);
+    const Vector8 diffuseWeight = (Vector8(1.0f) - Fi) * baseColorMax;
+
+    const Vector8 specularProbability = specularWeight / (specularWeight + diffuseWeight);
+    const Vector8 diffuseProbability = Vector8(1.0f) - specularProbability;
+
+    const Vector8 diffusePdf = NdotL * RT_INV_PI; // cos-weighted hemisphere distribution
+    const Vector8 diffuseReversePdf = NdotV * RT_INV_PI;
+    const Vector8 diffuseValue = NdotL * RT_INV_PI * (Vector8(1.0f) - Fi) * (Vector8(1.0f) - Fo);
+
+    // microfacet normal
+    const Vector3x8 m = (ctx.outgoingDir - ctx.incomingDir).Normalized();
+    const Vector8 VdotH = Vector3x8::Dot(m, ctx.outgoingDir);
+
+    // clip the function
+    const VectorBool8 specularValid = VdotH >= Vector8(CosEpsilon);
+
+    const Microfacet_Simd8 microfacet(ctx.roughness * ctx.roughness);
+    const Vector8 D = microfacet.D(m);
+    const Vector8 G = microfacet.G(NdotV, NdotL);
+    const Vector8 F = FresnelDielectric(VdotH, Vector8(ctx.material.IoR));
+    const Vector8 specularPdf = Vector8::Select(Vector8::Zero(), D * Vector8::Abs(m.z) / (4.0f * VdotH), specularValid);
+    const Vector8 specularValue = Vector8::Select(Vector8::Zero(), F * G * D / (4.0f * NdotV), specularValid);
+
+    const Vector8 directPdf = Vector8::Select(Vector8::Zero(), Vector8::MulAndAdd(diffusePdf, diffuseProbability, specularPdf * specularProbability), valid);
+    const Vector8 reversePdf = Vector8::Select(Vector8::Zero(), Vector8::MulAndAdd(diffuseReversePdf, diffuseProbability, specularPdf * specularProbability), valid);
+    Vector3x8 result = Vector3x8::MulAndAdd(ctx.baseColor, diffuseValue, Vector3x8(specularValue));
+    result = Vector3x8::Select(Vector3x8::Zero(), result, valid);
+
+    if (isSmooth.Any())
+    {
+        Vector8 smoothDirectPdf, smoothReversePdf;
+        const Vector3x8 smoothResult = PlasticBSDF().Evaluate_Simd8(ctx, &smoothDirectPdf, &smoothReversePdf);
+
+        if (outDirectPdfW)
+        {
+            *outDirectPdfW = Vector8::Select(directPdf, smoothDirectPdf, isSmooth);
+        }
+
+        if (outReversePdfW)
+        {
+            *outReversePdfW = Vector8::Select(reversePdf, smoothReversePdf, isSmooth);
+        }
+
+        return Vector3x8::Select(result, smoothResult, isSmooth);
+    }
+
+    if (outDirectPdfW)
+    {
+        *outDirectPdfW = directPdf;
+    }
+
+    if (outReversePdfW)
+    {
+        *outReversePdfW = reversePdf;
+    }
+
+    return result;
+}
+
+const Vector8 RoughPlasticBSDF::Pdf_Simd8(const EvaluationContext_Simd8& ctx, PdfDirection dir) const
+{
+    const VectorBool8 isSmooth = ctx.roughness < Vector8(SpecularEventRoughnessTreshold);
+
+    // fallback to specular event
+    if (isSmooth.All())
+    {
+        return PlasticBSDF().Pdf_Simd8(ctx, dir);
+    }
+
+    const Vector8 NdotV = ctx.outgoingDir.z;
+    const Vector8 NdotL = -ctx.incomingDir.z;
+    const VectorBool8 valid = (NdotV >= Vector8(CosEpsilon)) & (NdotL >= Vector8(CosEpsilon));
+
+    const Vector8 Fi = FresnelDielectric(NdotV, ctx.IoR);
+    const Vector8 specularWeight = Fi;
+    const Vector8 baseColorMax = Vector8::Max(Vector8::Max(ctx.baseColor.x, ctx.baseColor.y), ctx.baseColor.z);
+    const Vector8 diffuseWeight = (Vector8(1.0f) - Fi) * baseColorMax;
+
+    const Vector8 specularProbability = specularWeight / (specularWeight + diffuseWeight);
+    const Vector8 diffuseProbability = Vector8(1.0f) - specularProbability;
+
+    // cos-weighted hemisphere distribution
+    const Vector8 diffusePdf = (dir == ForwardPdf ? NdotL : NdotV) * RT_INV_PI;
+
+    // microfacet normal
+    const Vector3x8 m = (ctx.outgoingDir - ctx.incomingDir).Normalized();
+    const Vector8 VdotH = Vector3x8::Dot(m, ctx.outgoingDir);
+
+    // clip the function
+    const Microfacet_Simd8 microfacet(ctx.roughness * ctx.roughness);
+    const Vector8 specularPdf = Vector8::Select(Vector8::Zero(), microfacet.Pdf(m) / (4.0f * VdotH), VdotH >= Vector8(CosEpsilon));
+
+    Vector8 pdf = Vector8::Select(Vector8::Zero(), Vector8::MulAndAdd(diffusePdf, diffuseProbability, specularPdf * specularProbability), valid);
+
+    if (isSmooth.Any())
+    {
+        pdf = Vector8::Select(pdf, PlasticBSDF().Pdf_Simd8(ctx, dir), isSmooth);
+    }
+
+    return pdf;
+}
+
 } // namespace rt
@@ -12,12 +12,101 @@
 #include "BSDF/RoughPlasticBSDF.h"
 
 #include "Color/Spectrum.h"
+#include "Textures/BitmapTexture.h"
 #include "Utils/Logger.h"
 
+#include <utility>
+
 namespace rt {
 
 using namespace math;
 
+namespace {
+
+// how a material parameter is evaluated
+enum class ParameterKind : uint8
+{
+    Constant,   // no texture, base value only
+    Bitmap,     // bitmap texture, evaluated without virtual call
+    Generic,    // any other texture type
+
+    Count
+};
+
+static constexpr uint32 NumParameterKinds = static_cast<uint32>(ParameterKind::Count);
+
+ParameterKind GetParameterKind(const TexturePtr& texture)
+{
+    if (!texture)
+    {
+        return ParameterKind::Constant;
+    }
+
+    if (dynamic_cast<const BitmapTexture*>(texture.get()))
+    {
+        return ParameterKind::Bitmap;
+    }
+
+    return ParameterKind::Generic;
+}
+
+template<ParameterKind Kind, typename T>
+RT_FORCE_INLINE const T EvaluateParameter(const MaterialParameter<T>& param, const Vector4& uv)
+{
+    switch (Kind)
+    {
+    case ParameterKind::Bitmap:
+        return static_cast<T>(param.baseValue * static_cast<const BitmapTexture*>(param.texture.get())->BitmapTexture::Evaluate(uv));
+    case ParameterKind::Generic:
+        return static_cast<T>(param.baseValue * param.texture->Evaluate(uv));
+    default:
+        return param.baseValue;
+    }
+}
+
+// fallback path, used when the material is not compiled
+void EvaluateShadingData_Generic(const Material& material, const Wavelength& wavelength, ShadingData& shadingData)
+{
+    const Vector4& texCoord = shadingData.intersection.texCoord;
+    shadingData.materialParams.baseColor = RayColor::Resolve(wavelength, Spectrum(material.baseColor.Evaluate(texCoord)));
+    shadingData.materialParams.emissionColor = RayColor::Resolve(wavelength, Spectrum(material.emission.Evaluate(texCoord)));
+    shadingData.materialParams.roughness = material.roughness.Evaluate(texCoord);
+    shadingData.materialParams.metalness = material.metalness.Evaluate(texCoord);
+    shadingData.materialParams.IoR = material.IoR;
+}
+
+template<ParameterKind BaseColorKind, ParameterKind EmissionKind, ParameterKind RoughnessKind, ParameterKind MetalnessKind>
+void EvaluateShadingData_Specialized(const Material& material, const Wavelength& wavelength, ShadingData& shadingData)
+{
+    const Vector4& texCoord = shadingData.intersection.texCoord;
+    shadingData.materialParams.baseColor = RayColor::Resolve(wavelength, Spectrum(EvaluateParameter<BaseColorKind>(material.baseColor, texCoord)));
+    shadingData.materialParams.emissionColor = RayColor::Resolve(wavelength, Spectrum(EvaluateParameter<EmissionKind>(material.emission, texCoord)));
+    shadingData.materialParams.roughness = EvaluateParameter<RoughnessKind>(material.roughness, texCoord);
+    shadingData.materialParams.metalness = EvaluateParameter<MetalnessKind>(material.metalness, texCoord);
+    shadingData.materialParams.IoR = material.IoR;
+}
+
+using EvaluateShadingDataFunc = void(*)(const Material&, const Wavelength&, ShadingData&);
+
+template<uint32 Index>
+constexpr EvaluateShadingDataFunc GetSpecializedFunc()
+{
+    return &EvaluateShadingData_Specialized<
+        static_cast<ParameterKind>(Index % NumParameterKinds),
+        static_cast<ParameterKind>(Index / NumParameterKinds % NumParameterKinds),
+        static_cast<ParameterKind>(Index / (NumParameterKinds * NumParameterKinds) % NumParameterKinds),
+        static_cast<ParameterKind>(Index / (NumParameterKinds * NumParameterKinds * NumParameterKinds))>;
+}
+
+template<uint32... Indices>
+EvaluateShadingDataFunc SelectSpecializedFunc(uint32 index, std::integer_sequence<uint32, Indices...>)
+{
+    static const EvaluateShadingDataFunc funcs[] = { GetSpecializedFunc<Indices>()... };
+    return funcs[index];
+}
+
+} // namespace
+
 const char* Material::DefaultBsdfName = "diffuse";
 
 DispersionParams::DispersionParams()
@@ -29,6 +118,7 @@ DispersionParams::DispersionParams()
 
 Material::Material(const char* debugName)
     : debugName(debugName)
+    , mEvaluateShadingDataFunc(&EvaluateShadingData_Generic)
 {
 }
 
@@ -115,6 +205,15 @@ void Material::Compile()
 
     emission.baseValue = Vector4::Max(Vector4::Zero(), emission.baseValue);
     baseColor.baseValue = Vector4::Max(Vector4::Zero(), Vector4::Min(VECTOR_ONE, baseColor.baseValue));
+
+    const uint32 index =
+        static_cast<uint32>(GetParameterKind(baseColor.texture)) +
+        static_cast<uint32>(GetParameterKind(emission.texture)) * NumParameterKinds +
+        static_cast<uint32>(GetParameterKind(roughness.texture)) * NumParameterKinds * NumParameterKinds +
+        static_cast<uint32>(GetParameterKind(metalness.texture)) * NumParameterKinds * NumParameterKinds * NumParameterKinds;
+
+    constexpr uint32 numSpecializations = NumParameterKinds * NumParameterKinds * NumParameterKinds * NumParameterKinds;
+    mEvaluateShadingDataFunc = SelectSpecializedFunc(index, std::make_integer_sequence<uint32, numSpecializations>());
 }
 
 const Vector4 Material::GetNormalVector(const Vector4& uv) const
@@ -137,24 +236,31 @@ const Vector4 Material::GetNormalVector(const Vector4& uv) const
     return normal;
 }
 
+static constexpr float MaskTreshold = 0.5f;
+
 bool Material::GetMaskValue(const Vector4& uv) const
 {
     if (maskMap)
     {
-        const float maskTreshold = 0.5f;
-        return maskMap->Evaluate(uv).x > maskTreshold;
+        return maskMap->Evaluate(uv).x > MaskTreshold;
     }
 
     return true;
 }
 
-void Material::EvaluateShadingData(const Wavelength& wavelength, ShadingData& shadingData) const
+void Material::GetMaskCoverage(const Vector4& minUV, const Vector4& maxUV, bool& outOpaque, bool& outTransparent) const
 {
-    shadingData.materialParams.baseColor = RayColor::Resolve(wavelength, Spectrum(baseColor.Evaluate(shadingData.intersection.texCoord)));
-    shadingData.materialParams.emissionColor = RayColor::Resolve(wavelength, Spectrum(emission.Evaluate(shadingData.intersection.texCoord)));
-    shadingData.materialParams.roughness = roughness.Evaluate(shadingData.intersection.texCoord);
-    shadingData.materialParams.metalness = metalness.Evaluate(shadingData.intersection.texCoord);
-    shadingData.materialParams.IoR = IoR;
+    outOpaque = true;
+    outTransparent = false;
+
+    if (maskMap)
+    {
+        Vector4 minValue, maxValue;
+        const bool isBounded = maskMap->GetValueRange(minUV, maxUV, minValue, maxValue);
+
+        outOpaque = isBounded && minValue.x > MaskTreshold;
+        outTransparent = isBounded && maxValue.x <= MaskTreshold;
+    }
 }
 
 const RayColor Material::Evaluate(
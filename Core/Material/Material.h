@@ -82,12 +82,21 @@ public:
 
     RT_FORCE_INLINE const BSDF* GetBSDF() const { return mBSDF.get(); }
 
+    // validate parameters and select specialized shading data evaluation path
+    // NOTE: must be called after any parameter (or texture) change
     RAYLIB_API void Compile();
 
     const math::Vector4 GetNormalVector(const math::Vector4& uv) const;
     bool GetMaskValue(const math::Vector4& uv) const;
 
-    void EvaluateShadingData(const Wavelength& wavelength, ShadingData& shadingData) const;
+    // conservatively check the mask within a texture coordinates box
+    // NOTE: both flags are false if the box crosses the mask edge or the mask texture can't be bounded
+    void GetMaskCoverage(const math::Vector4& minUV, const math::Vector4& maxUV, bool& outOpaque, bool& outTransparent) const;
+
+    RT_FORCE_INLINE void EvaluateShadingData(const Wavelength& wavelength, ShadingData& shadingData) const
+    {
+        mEvaluateShadingDataFunc(*this, wavelength, shadingData);
+    }
 
     // sample material's BSDFs
     const RayColor Sample(
@@ -110,7 +119,12 @@ private:
     Material(const Material&) = delete;
     Material& operator = (const Material&) = delete;
 
+    using EvaluateShadingDataFunc = void(*)(const Material&, const Wavelength&, ShadingData&);
+
     std::unique_ptr<BSDF> mBSDF;
+
+    // selected in Compile() depending on which parameters are textured
+    EvaluateShadingDataFunc mEvaluateShadingDataFunc;
 };
 
 } // namespace rt
@@ -108,5 +108,16 @@ uint32 Distribution::SampleDiscrete(const float u, float& outPdf) const
     return offset;
 }
 
+uint32 Distribution::SampleDiscrete(const float u, float& outPdf, float& outRemappedU) const
+{
+    const uint32 offset = SampleDiscrete(u, outPdf);
+
+    const float binStart = mCDF[offset];
+    const float binSize = mCDF[offset + 1] - binStart;
+    outRemappedU = binSize > 0.0f ? Clamp((u - binStart) / binSize, 0.0f, 0.99999994f) : 0.0f;
+
+    return offset;
+}
+
 } // namespace math
 } // namespace rt
\ No newline at end of file
@@ -19,6 +19,14 @@ public:
     // sample discrete
     uint32 SampleDiscrete(const float u, float& outPdf) const;
 
+    // sample discrete, additionally returns position of the sample within the selected bin (in 0...1 range)
+    uint32 SampleDiscrete(const float u, float& outPdf, float& outRemappedU) const;
+
+    // get pdf of a given bin (normalized so the average value is 1)
+    RT_FORCE_INLINE float GetPdf(uint32 index) const { return mPDF[index]; }
+
+    RT_FORCE_INLINE uint32 GetSize() const { return mSize; }
+
 private:
     float* mPDF;
     float* mCDF; // Cumulative distribution function
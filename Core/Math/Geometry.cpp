@@ -12,6 +12,14 @@ const Vector4 CartesianToSphericalCoordinates(const Vector4& input)
     return Vector4(phi / (2.0f * RT_PI) + 0.5f, theta / RT_PI, 0.0f, 0.0f);
 }
 
+const Vector4 SphericalToCartesianCoordinates(const Vector4& coords)
+{
+    const float phi = (coords.x - 0.5f) * (2.0f * RT_PI);
+    const float theta = coords.y * RT_PI;
+    const float sinTheta = sinf(theta);
+    return Vector4(sinTheta * cosf(phi), cosf(theta), sinTheta * sinf(phi), 0.0f);
+}
+
 void BuildOrthonormalBasis(const Vector4& n, Vector4& u, Vector4& v)
 {
     // algorithm based on "Building an Orthonormal Basis, Revisited" (2017) paper
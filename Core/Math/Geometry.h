@@ -14,6 +14,9 @@ namespace math {
 // convert cartesian (x,y,z) to spherical coordinates (phi,theta)
 const Vector4 CartesianToSphericalCoordinates(const Vector4& input);
 
+// convert spherical coordinates (phi,theta) to cartesian (x,y,z) - inverse of CartesianToSphericalCoordinates
+const Vector4 SphericalToCartesianCoordinates(const Vector4& coords);
+
 RT_FORCE_INLINE constexpr float UniformHemispherePdf()
 {
     return RT_INV_PI / 2.0f;
@@ -30,6 +30,20 @@ void Random::Reset()
     }
 }
 
+void Random::Reset(uint64 seed)
+{
+    const auto getInt = [&seed]() { return static_cast<uint32>(Hash(++seed)); };
+
+    for (uint32 i = 0; i < 2; ++i)
+    {
+        mSeed[i] = ((uint64)getInt() << 32) | (uint64)getInt();
+        mSeedSimd4[i] = VectorInt4(getInt(), getInt(), getInt(), getInt());
+#ifdef RT_USE_AVX2
+        mSeedSimd8[i] = VectorInt8(getInt(), getInt(), getInt(), getInt(), getInt(), getInt(), getInt(), getInt());
+#endif // RT_USE_AVX2
+    }
+}
+
 uint64 Random::GetLong()
 {
     // xoroshiro128+ algorithm
@@ -20,6 +20,9 @@ public:
     // initialize seeds with new values, very slow
     void Reset();
 
+    // initialize seeds deterministically (for reproducible sequences, e.g. in tests)
+    void Reset(uint64 seed);
+
     uint64 GetLong();
     uint32 GetInt();
 
@@ -142,6 +142,14 @@ const Vector4 SamplingHelpers::GetHemishpereCos(const Float2 u)
     return result;
 }
 
+const Vector3x8 SamplingHelpers::GetHemishpereCos_Simd8(const Vector2x8& u)
+{
+    const Vector8 theta = u.y * (2.0f * RT_PI);
+    const Vector8 r = Vector8::Sqrt(u.x);
+
+    return { r * Sin(theta), r * Cos(theta), Vector8::Sqrt(Vector8(1.0f) - u.x) };
+}
+
 const Vector4 SamplingHelpers::GetFloatNormal2(const Float2 u)
 {
     // Box-Muller method
@@ -40,6 +40,7 @@ public:
     // get point on a hemisphere with cosine distribution (0 at equator, 1 at pole)
     // typical usage is Lambertian BRDF sampling
     RAYLIB_API static const Vector4 GetHemishpereCos(const Float2 u);
+    RAYLIB_API static const Vector3x8 GetHemishpereCos_Simd8(const Vector2x8& u);
 
     // get 2D point with normal (Gaussian) distribution
     RAYLIB_API static const Vector4 GetFloatNormal2(const Float2 u);
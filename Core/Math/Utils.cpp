@@ -38,6 +38,37 @@ float FresnelMetal(const float NdV, const float eta, const float k)
     return (rs + rp) * 0.5f;
 }
 
+const Vector8 FresnelDielectric(const Vector8& NdV, const Vector8& eta)
+{
+    const Vector8 one(1.0f);
+    const Vector8 etaSel = Vector8::Select(eta, Vector8::Reciprocal(eta), NdV > Vector8::Zero());
+
+    const Vector8 c = Vector8::Abs(NdV);
+    const Vector8 g2 = etaSel * etaSel * (one - NdV * NdV);
+
+    // total internal reflection
+    const VectorBool8 tir = g2 >= one;
+
+    const Vector8 g = Vector8::Sqrt(Vector8::Max(one - g2, Vector8::Zero()));
+    const Vector8 A = (g - c) / (g + c);
+    const Vector8 B = Vector8::MulAndSub(c, g + c, one) / Vector8::MulAndAdd(c, g - c, one);
+    const Vector8 F = 0.5f * A * A * Vector8::MulAndAdd(B, B, one);
+
+    return Vector8::Select(F, one, tir);
+}
+
+const Vector8 FresnelMetal(const Vector8& NdV, const float eta, const float k)
+{
+    const Vector8 one(1.0f);
+    const Vector8 NdV2 = NdV * NdV;
+    const Vector8 a(eta * eta + k * k);
+    const Vector8 b = a * NdV2;
+    const Vector8 etaNdV2 = NdV * (2.0f * eta);
+    const Vector8 rs = (b - etaNdV2 + one) / (b + etaNdV2 + one);
+    const Vector8 rp = (a - etaNdV2 + NdV2) / (a + etaNdV2 + NdV2);
+    return (rs + rp) * 0.5f;
+}
+
 
 } // namespace math
 } // namespace rt
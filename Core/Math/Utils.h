@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Vector8.h"
+
 namespace rt {
 namespace math {
 
@@ -10,6 +12,10 @@ float FresnelDielectric(float NdV, float eta);
 // compute Fresnel reflection term for metalic material
 float FresnelMetal(const float NdV, const float eta, const float k);
 
+// 8-wide versions of the above
+const Vector8 FresnelDielectric(const Vector8& NdV, const Vector8& eta);
+const Vector8 FresnelMetal(const Vector8& NdV, const float eta, const float k);
+
 
 } // namespace math
 } // namespace rt
@@ -394,6 +394,41 @@ public:
         return { Vector8::Max(a.x, b.x), Vector8::Max(a.y, b.y), Vector8::Max(a.z, b.z) };
     }
 
+    // for each lane select "b" if the mask bit is set, "a" otherwise
+    RT_FORCE_INLINE static const Vector3x8 Select(const Vector3x8& a, const Vector3x8& b, const VectorBool8& sel)
+    {
+        return { Vector8::Select(a.x, b.x, sel), Vector8::Select(a.y, b.y, sel), Vector8::Select(a.z, b.z, sel) };
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+
+    // Reflect a 3D vector
+    RT_FORCE_INLINE static const Vector3x8 Reflect(const Vector3x8& i, const Vector3x8& n)
+    {
+        // return (i - 2.0f * Dot(i, n) * n);
+        const Vector8 vDot = Dot(i, n);
+        return NegMulAndAdd(n, vDot + vDot, i);
+    }
+
+    // Refract a 3D vector (see Vector4::Refract3)
+    // NOTE: returns zero vector for lanes with total internal reflection
+    static const Vector3x8 Refract(const Vector3x8& i, const Vector3x8& n, const Vector8& eta)
+    {
+        const Vector8 one(1.0f);
+
+        const Vector8 NdotV = Dot(i, n);
+        const Vector8 etaSel = Vector8::Select(eta, Vector8::Reciprocal(eta), NdotV < Vector8::Zero());
+
+        const Vector8 k = one - etaSel * etaSel * (one - NdotV * NdotV);
+        const VectorBool8 totalInternalReflection = k <= Vector8::Zero();
+
+        const Vector8 scale = Vector8::MulAndAdd(etaSel, NdotV, Vector8::Sqrt(Vector8::Max(k, Vector8::Zero())));
+        Vector3x8 transmitted = NegMulAndAdd(n, scale, i * etaSel);
+        transmitted.z = Vector8::Select(transmitted.z, -transmitted.z, NdotV > Vector8::Zero());
+
+        return Select(transmitted.Normalized(), Zero(), totalInternalReflection);
+    }
+
 };
 
 
@@ -38,6 +38,18 @@ RT_FORCE_INLINE const Vector4 Vector4_Load_Half2(const Half src[2])
 #endif // RT_USE_FP16C
 }
 
+RT_FORCE_INLINE const Vector4 Vector4_Load_Half3(const Half src[3])
+{
+#ifdef RT_USE_FP16C
+    // NOTE: don't read past the third element
+    __m128i v = _mm_loadu_si32(src);
+    v = _mm_insert_epi16(v, *reinterpret_cast<const uint16*>(src + 2), 2);
+    return _mm_cvtph_ps(v);
+#else // RT_USE_FP16C
+    return Vector4(src[0].ToFloat(), src[1].ToFloat(), src[2].ToFloat(), 0.0f);
+#endif // RT_USE_FP16C
+}
+
 RT_FORCE_INLINE const Vector4 Vector4_Load_Half4(const Half src[4])
 {
 #ifdef RT_USE_FP16C
@@ -48,6 +60,31 @@ RT_FORCE_INLINE const Vector4 Vector4_Load_Half4(const Half src[4])
 #endif // RT_USE_FP16C
 }
 
+RT_FORCE_INLINE void Vector4_Store_Half4(const Vector4& value, Half dst[4])
+{
+#ifdef RT_USE_FP16C
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), _mm_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT));
+#else // RT_USE_FP16C
+    dst[0] = Half(value.x);
+    dst[1] = Half(value.y);
+    dst[2] = Half(value.z);
+    dst[3] = Half(value.w);
+#endif // RT_USE_FP16C
+}
+
+RT_FORCE_INLINE void Vector4_Store_Half3(const Vector4& value, Half dst[3])
+{
+#ifdef RT_USE_FP16C
+    const __m128i v = _mm_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT);
+    *reinterpret_cast<int32*>(dst) = _mm_cvtsi128_si32(v);
+    *reinterpret_cast<uint16*>(dst + 2) = static_cast<uint16>(_mm_extract_epi16(v, 2));
+#else // RT_USE_FP16C
+    dst[0] = Half(value.x);
+    dst[1] = Half(value.y);
+    dst[2] = Half(value.z);
+#endif // RT_USE_FP16C
+}
+
 // Convert uint16 (B5G6R5 format) to a Vector4 (normalized range)
 RT_FORCE_INLINE const Vector4 Vector4_Load_B5G6R5_Norm(const uint16* src)
 {
@@ -88,6 +88,7 @@ struct RT_ALIGN(32) Vector8
     RT_FORCE_INLINE static const Vector8 Min(const Vector8& a, const Vector8& b);
     RT_FORCE_INLINE static const Vector8 Max(const Vector8& a, const Vector8& b);
     RT_FORCE_INLINE static const Vector8 Abs(const Vector8& v);
+    RT_FORCE_INLINE static const Vector8 Saturate(const Vector8& v);
     RT_FORCE_INLINE const Vector8 Clamped(const Vector8& min, const Vector8& max) const;
 
     // Build mask of sign bits.
@@ -38,6 +38,11 @@ const Vector8 Vector8::Lerp(const Vector8& v1, const Vector8& v2, float weight)
     return MulAndAdd(v2 - v1, weight, v1);
 }
 
+const Vector8 Vector8::Saturate(const Vector8& v)
+{
+    return Min(VECTOR8_ONE, Max(Vector8::Zero(), v));
+}
+
 const Vector8 Vector8::Clamped(const Vector8& min, const Vector8& max) const
 {
     return Min(max, Max(min, *this));
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Counters.h"
+#include "Film.h"
 
 #include "../Traversal/RayPacket.h"
 #include "../Traversal/HitPoint.h"
@@ -9,6 +10,8 @@
 
 #include "../Math/Random.h"
 
+#include "../Containers/DynArray.h"
+
 #include "../Sampling/GenericSampler.h"
 
 namespace rt {
@@ -32,6 +35,19 @@ enum class LightSamplingStrategy : uint8
     // TODO "Importance Sampling of Many Lights with Adaptive Tree Splitting"
 };
 
+enum class AccumulationMode : uint8
+{
+    // sum of samples stored as 32-bit floats
+    Float,
+
+    // running average of samples stored as 16-bit floats with a rounding compensation term
+    // (intended for very large images)
+    // NOTE: takes 18 bytes per pixel (RGB primary average, its compensation and secondary average, 6 bytes each),
+    // compared to 32 bytes per pixel of full precision mode (two RGBA float sums). Dropping the compensation would
+    // save another 6 bytes (12 bytes per pixel), but then the average stops converging once a single sample falls below half precision
+    CompensatedHalf,
+};
+
 struct AdaptiveRenderingSettings
 {
     bool enable = false;
@@ -42,6 +58,18 @@ struct AdaptiveRenderingSettings
     float convergenceTreshold = 0.0001f;
 };
 
+// reuse of accumulated samples after camera movement (see Viewport::Reproject)
+struct ReprojectionSettings
+{
+    bool enable = false;
+
+    // maximum relative difference of first hit distance, for a reprojected pixel to be accepted
+    float depthTolerance = 0.02f;
+
+    // reprojected pixels keep at most this many samples, so stale history is quickly outweighed by new samples
+    uint32 maxHistoryPasses = 32;
+};
+
 struct SamplingParams
 {
     // Number of sample dimensions generated by low-discrepancy sampler
@@ -50,12 +78,21 @@ struct SamplingParams
 
     // Enables image-space sample dithering based on blue noise pattern
     bool useBlueNoiseDithering = true;
+
+    // Fixed seed of the sample sequence and per-thread random generators, applied on every viewport reset
+    // (zero means random seed)
+    // NOTE: the image is reproducible only when rendering with a single thread, because tiles are assigned to threads dynamically
+    uint64 seed = 0;
 };
 
 struct RenderingParams
 {
     uint32 numThreads = 0;
 
+    // pin worker threads to NUMA nodes, so they read node-local copies of the scene data
+    // (see MemoryInitOptions::replicateOnNumaNodes, no effect on single-node machines)
+    bool pinThreadsToNumaNodes = false;
+
     SamplingParams samplingParams;
 
     // Antialiasing factor
@@ -87,6 +124,19 @@ struct RenderingParams
 
     // adaptive rendering settings
     AdaptiveRenderingSettings adaptiveSettings;
+
+    // Number of resolution cascade levels. First passes after reset render progressively denser subsets of pixels
+    // (1/4^N, ..., 1/16, 1/4 of pixels, then the remaining ones) and the missing pixels are upsampled in the front buffer,
+    // so a preview is available quickly after camera movement. Each pixel is rendered exactly once during the cascade.
+    // NOTE: used only in single ray traversal mode with floating point accumulation, up to 4 levels are supported
+    uint32 resolutionCascadeLevels = 0;
+
+    // temporal reprojection settings
+    // NOTE: used only with floating point accumulation, resolution cascade is skipped after reprojection
+    ReprojectionSettings reprojectionSettings;
+
+    // storage format of accumulated image
+    AccumulationMode accumulationMode = AccumulationMode::Float;
 };
 
 struct PixelBreakpoint
@@ -107,6 +157,9 @@ struct RT_ALIGN(64) RenderingContext
 
     const Camera* camera = nullptr;
 
+    // angle (in radians) subtended by a single pixel, used to compute ray footprint for texture filtering
+    float pixelSpreadAngle = 0.0f;
+
     Wavelength wavelength;
 
     GenericSampler sampler;
@@ -114,6 +167,9 @@ struct RT_ALIGN(64) RenderingContext
     // per-thread pseudo-random number generator
     math::Random randomGenerator;
 
+    // NUMA node the thread runs on, selects a copy of replicated scene data
+    uint32 numaNode = 0;
+
     // renderer-specific context, can be null
     RendererContextPtr rendererContext;
 
@@ -136,6 +192,12 @@ struct RT_ALIGN(64) RenderingContext
     PixelBreakpoint pixelBreakpoint;
 #endif // RT_CONFIGURATION_FINAL
 
+    // accumulation buffer for currently rendered tile
+    FilmTile filmTile;
+
+    // camera connections recorded in light paths pass, accumulated onto film after the frame is rendered
+    DynArray<FilmSplat> filmSplats;
+
     RayPacket rayPacket;
 
     HitPoint hitPoints[MaxRayPacketSize];
@@ -62,7 +62,7 @@ const RayColor DebugRenderer::RenderPixel(const math::Ray& ray, const RenderPara
         return RayColor::Zero();
     }
 
-    if (hitPoint.subObjectId == RT_LIGHT_OBJECT)
+    if (IsLightSubObject(hitPoint.subObjectId))
     {
         // ray hit a light
         const Vector4 lightColor{ 1.0, 1.0f, 0.0f };
@@ -8,10 +8,88 @@ namespace rt {
 
 using namespace math;
 
-Film::Film(Bitmap& sum, Bitmap* secondarySum)
+FilmTile::FilmTile()
+    : mData(nullptr)
+    , mCapacity(0)
+    , mMinX(0)
+    , mMinY(0)
+    , mWidth(0)
+    , mHeight(0)
+{}
+
+FilmTile::~FilmTile()
+{
+    DefaultAllocator::Free(mData);
+}
+
+FilmTile::FilmTile(FilmTile&& other)
+    : mData(other.mData)
+    , mCapacity(other.mCapacity)
+    , mMinX(other.mMinX)
+    , mMinY(other.mMinY)
+    , mWidth(other.mWidth)
+    , mHeight(other.mHeight)
+{
+    other.mData = nullptr;
+    other.mCapacity = 0;
+    other.mWidth = 0;
+    other.mHeight = 0;
+}
+
+FilmTile& FilmTile::operator = (FilmTile&& other)
+{
+    if (this != &other)
+    {
+        DefaultAllocator::Free(mData);
+
+        mData = other.mData;
+        mCapacity = other.mCapacity;
+        mMinX = other.mMinX;
+        mMinY = other.mMinY;
+        mWidth = other.mWidth;
+        mHeight = other.mHeight;
+
+        other.mData = nullptr;
+        other.mCapacity = 0;
+        other.mWidth = 0;
+        other.mHeight = 0;
+    }
+
+    return *this;
+}
+
+void FilmTile::Begin(uint32 minX, uint32 minY, uint32 maxX, uint32 maxY)
+{
+    RT_ASSERT(minX < maxX);
+    RT_ASSERT(minY < maxY);
+
+    const uint32 numPixels = (maxX - minX) * (maxY - minY);
+    if (numPixels > mCapacity)
+    {
+        DefaultAllocator::Free(mData);
+        mData = static_cast<Vector4*>(DefaultAllocator::Allocate(sizeof(Vector4) * numPixels, RT_CACHE_LINE_SIZE));
+        RT_ASSERT(mData, "Failed to allocate film tile");
+        mCapacity = numPixels;
+    }
+
+    mMinX = minX;
+    mMinY = minY;
+    mWidth = maxX - minX;
+    mHeight = maxY - minY;
+
+    memset(static_cast<void*>(mData), 0, sizeof(Vector4) * numPixels);
+}
+
+Film::Film(Bitmap& sum, Bitmap* secondarySum, FilmTile* tile)
     : mFilmSize((float)sum.GetWidth(), (float)sum.GetHeight())
     , mSum(sum)
     , mSecondarySum(secondarySum) 
+    , mTile(tile)
+    , mSumCompensation(nullptr)
+    , mPrimaryOldWeight(1.0f)
+    , mPrimaryNewWeight(1.0f)
+    , mSecondaryOldWeight(1.0f)
+    , mSecondaryNewWeight(1.0f)
     , mWidth(mSum.GetWidth())
     , mHeight(mSum.GetHeight())
 {
@@ -19,22 +97,78 @@ Film::Film(Bitmap& sum, Bitmap* secondarySum)
     {
         RT_ASSERT(mSecondarySum->GetWidth() == mWidth);
         RT_ASSERT(mSecondarySum->GetHeight() == mHeight);
+        RT_ASSERT(mSecondarySum->GetFormat() == mSum.GetFormat());
     }
 }
 
-RT_FORCE_INLINE static void AccumulateToFloat3(Float3& target, const Vector4& value)
+void Film::SetCompactStorage(Bitmap& compensation, uint32 numPasses)
 {
-    const Vector4 original = Vector4_Load_Float3_Unsafe(target);
-    target = (original + value).ToFloat3();
+    RT_ASSERT(mSum.GetFormat() == Bitmap::Format::R16G16B16_Half);
+    RT_ASSERT(compensation.GetFormat() == Bitmap::Format::R16G16B16_Half);
+    RT_ASSERT(compensation.GetWidth() == mWidth && compensation.GetHeight() == mHeight);
+
+    mSumCompensation = &compensation;
+
+    // secondary sum contains every second sample (starting from the first one)
+    const uint32 numSecondaryPasses = (numPasses + 1u) / 2u;
+
+    mPrimaryNewWeight = 1.0f / static_cast<float>(numPasses + 1u);
+    mPrimaryOldWeight = static_cast<float>(numPasses) * mPrimaryNewWeight;
+    mSecondaryNewWeight = 1.0f / static_cast<float>(numSecondaryPasses + 1u);
+    mSecondaryOldWeight = static_cast<float>(numSecondaryPasses) * mSecondaryNewWeight;
 }
 
-void Film::AccumulateColor(const uint32 x, const uint32 y, const Vector4& sampleColor)
+// Kahan-like update of an average stored in half precision:
+// 'compensation' keeps the part of the average that could not be represented in 'average'
+RT_FORCE_INLINE static void UpdateHalfAverage(Half3& average, Half3* compensation, const Vector4& value, float oldWeight, float newWeight)
+{
+    Vector4 current = Vector4_Load_Half3(&average.x);
+    if (compensation)
+    {
+        current += Vector4_Load_Half3(&compensation->x);
+    }
+
+    const Vector4 target = Vector4::MulAndAdd(current, oldWeight, value * newWeight);
+    Vector4_Store_Half3(target, &average.x);
+
+    if (compensation)
+    {
+        Vector4_Store_Half3(target - Vector4_Load_Half3(&average.x), &compensation->x);
+    }
+}
+
+RT_FORCE_INLINE void Film::AccumulateToFilm(const uint32 x, const uint32 y, const Vector4& sampleColor)
 {
-    AccumulateToFloat3(mSum.GetPixelRef<Float3>(x, y), sampleColor);
+    if (mSumCompensation)
+    {
+        // the sample contributes to the average of the current pass
+        UpdateHalfAverage(mSum.GetPixelRef<Half3>(x, y), &mSumCompensation->GetPixelRef<Half3>(x, y), sampleColor, 1.0f, mPrimaryNewWeight);
+
+        if (mSecondarySum)
+        {
+            UpdateHalfAverage(mSecondarySum->GetPixelRef<Half3>(x, y), nullptr, sampleColor, 1.0f, mSecondaryNewWeight);
+        }
+
+        return;
+    }
+
+    mSum.GetPixelRef<Vector4>(x, y) += sampleColor;
 
     if (mSecondarySum)
     {
-        AccumulateToFloat3(mSecondarySum->GetPixelRef<Float3>(x, y), sampleColor);
+        mSecondarySum->GetPixelRef<Vector4>(x, y) += sampleColor;
+    }
+}
+
+void Film::AccumulateColor(const uint32 x, const uint32 y, const Vector4& sampleColor)
+{
+    if (mTile && mTile->Contains(x, y))
+    {
+        mTile->GetPixelRef(x, y) += sampleColor;
+    }
+    else
+    {
+        AccumulateToFilm(x, y, sampleColor);
     }
 }
 
@@ -67,11 +201,65 @@ void Film::AccumulateColor(const Vector4& pos, const Vector4& sampleColor, Rando
 
     if (uint32(x) < mWidth && uint32(y) < mHeight)
     {
-        AccumulateToFloat3(mSum.GetPixelRef<Float3>(x, y), sampleColor);
+        AccumulateColor(uint32(x), uint32(y), sampleColor);
+    }
+}
 
-        if (mSecondarySum)
+void Film::AccumulateSplats(const ArrayView<FilmSplat>& splats, Random& randomGenerator)
+{
+    for (const FilmSplat& splat : splats)
+    {
+        AccumulateColor(splat.position, splat.color, randomGenerator);
+    }
+}
+
+void Film::FlushTile()
+{
+    if (!mTile)
+    {
+        return;
+    }
+
+    const Vector4* tileData = mTile->mData;
+
+    for (uint32 y = 0; y < mTile->mHeight; ++y)
+    {
+        const uint32 filmY = mTile->mMinY + y;
+        const Vector4* tileRow = tileData + mTile->mWidth * y;
+
+        if (mSumCompensation)
+        {
+            Half3* sumRow = &mSum.GetPixelRef<Half3>(mTile->mMinX, filmY);
+            Half3* compensationRow = &mSumCompensation->GetPixelRef<Half3>(mTile->mMinX, filmY);
+            Half3* secondarySumRow = mSecondarySum ? &mSecondarySum->GetPixelRef<Half3>(mTile->mMinX, filmY) : nullptr;
+
+            for (uint32 x = 0; x < mTile->mWidth; ++x)
+            {
+                UpdateHalfAverage(sumRow[x], compensationRow + x, tileRow[x], mPrimaryOldWeight, mPrimaryNewWeight);
+
+                if (secondarySumRow)
+                {
+                    UpdateHalfAverage(secondarySumRow[x], nullptr, tileRow[x], mSecondaryOldWeight, mSecondaryNewWeight);
+                }
+            }
+        }
+        else if (mSecondarySum)
+        {
+            Vector4* sumRow = &mSum.GetPixelRef<Vector4>(mTile->mMinX, filmY);
+            Vector4* secondarySumRow = &mSecondarySum->GetPixelRef<Vector4>(mTile->mMinX, filmY);
+            for (uint32 x = 0; x < mTile->mWidth; ++x)
+            {
+                sumRow[x] += tileRow[x];
+                secondarySumRow[x] += tileRow[x];
+            }
+        }
+        else
         {
-            AccumulateToFloat3(mSecondarySum->GetPixelRef<Float3>(x, y), sampleColor);
+            Vector4* sumRow = &mSum.GetPixelRef<Vector4>(mTile->mMinX, filmY);
+            for (uint32 x = 0; x < mTile->mWidth; ++x)
+            {
+                sumRow[x] += tileRow[x];
+            }
         }
     }
 }
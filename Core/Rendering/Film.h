@@ -2,6 +2,7 @@
 
 #include "../RayLib.h"
 #include "../Math/Vector4.h"
+#include "../Containers/ArrayView.h"
 
 namespace rt {
 
@@ -11,10 +12,54 @@ namespace math {
 class Random;
 } // namespace math
 
+// Sample splatted at arbitrary film position (e.g. light path vertex connected to camera).
+struct FilmSplat
+{
+    math::Vector4 position; // normalized film coordinates
+    math::Vector4 color;
+};
+
+// Thread-local accumulation buffer for a single rendering tile.
+// Samples are gathered here and flushed to the film once per tile, so threads working
+// on neighbouring tiles never write to shared cache lines while rendering.
+class FilmTile : public NoCopyable
+{
+public:
+    RAYLIB_API FilmTile();
+    RAYLIB_API ~FilmTile();
+    RAYLIB_API FilmTile(FilmTile&& other);
+    RAYLIB_API FilmTile& operator = (FilmTile&& other);
+
+    // prepare (cleared) storage for given image region
+    RAYLIB_API void Begin(uint32 minX, uint32 minY, uint32 maxX, uint32 maxY);
+
+    RT_FORCE_INLINE bool Contains(uint32 x, uint32 y) const
+    {
+        return (x - mMinX) < mWidth && (y - mMinY) < mHeight;
+    }
+
+    RT_FORCE_INLINE math::Vector4& GetPixelRef(uint32 x, uint32 y)
+    {
+        RT_ASSERT(Contains(x, y));
+        return mData[mWidth * (y - mMinY) + (x - mMinX)];
+    }
+
+private:
+    friend class Film;
+
+    math::Vector4* mData;
+    uint32 mCapacity;   // in pixels
+
+    uint32 mMinX;
+    uint32 mMinY;
+    uint32 mWidth;
+    uint32 mHeight;
+};
+
 class Film
 {
 public:
-    Film(Bitmap& sum, Bitmap* secondarySum = nullptr);
+    Film(Bitmap& sum, Bitmap* secondarySum = nullptr, FilmTile* tile = nullptr);
 
     RT_FORCE_INLINE uint32 GetWidth() const
     {
@@ -26,14 +71,32 @@ public:
         return mHeight;
     }
 
+    // Switch to compact storage, where "sum" images contain per-pixel average of 'numPasses' previous passes
+    // stored in half precision. 'compensation' image holds rounding error of the primary average.
+    void SetCompactStorage(Bitmap& compensation, uint32 numPasses);
+
     void AccumulateColor(const math::Vector4& pos, const math::Vector4& sampleColor, math::Random& randomGenerator);
     void AccumulateColor(const uint32 x, const uint32 y, const math::Vector4& sampleColor);
+    void AccumulateSplats(const ArrayView<FilmSplat>& splats, math::Random& randomGenerator);
+
+    // add tile contents to the film (both sums are updated in a single pass)
+    void FlushTile();
 
 private:
+    void AccumulateToFilm(const uint32 x, const uint32 y, const math::Vector4& sampleColor);
+
     math::Vector4 mFilmSize;
 
     Bitmap& mSum;
     Bitmap* mSecondarySum;
+    FilmTile* mTile;
+    Bitmap* mSumCompensation;
+
+    // weights used to update averages in compact storage mode
+    float mPrimaryOldWeight;
+    float mPrimaryNewWeight;
+    float mSecondaryOldWeight;
+    float mSecondaryNewWeight;
 
     const uint32 mWidth;
     const uint32 mHeight;
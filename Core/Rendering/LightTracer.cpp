@@ -2,6 +2,7 @@
 #include "LightTracer.h"
 #include "Film.h"
 #include "Context.h"
+#include "ShadowRayBatch.h"
 #include "Scene/Scene.h"
 #include "Scene/Camera.h"
 #include "Scene/Light/Light.h"
@@ -15,6 +16,9 @@ using namespace math;
 
 LightTracer::LightTracer(const Scene& scene)
     : IRenderer(scene)
+    , mLightPathsPerPixel(1.0f)
+    , mLightPathsCount(0)
+    , mPixelsPerLightPath(1.0f)
 {
 }
 
@@ -23,7 +27,40 @@ const char* LightTracer::GetName() const
     return "Light Tracer";
 }
 
-const RayColor LightTracer::RenderPixel(const Ray&, const RenderParam& param, RenderingContext& ctx) const
+void LightTracer::PreRender(uint32, const Film& film)
+{
+    RT_ASSERT(mLightPathsPerPixel > 0.0f);
+
+    // no adaptive block removal for light path renderers, so paths are always traced for the full film
+    const uint32 numPixels = film.GetHeight() * film.GetWidth();
+    mLightPathsCount = Max(1u, static_cast<uint32>(mLightPathsPerPixel * static_cast<float>(numPixels) + 0.5f));
+    mPixelsPerLightPath = static_cast<float>(numPixels) / static_cast<float>(mLightPathsCount);
+}
+
+uint32 LightTracer::GetNumLightPaths() const
+{
+    return mLightPathsCount;
+}
+
+void LightTracer::TraceLightPaths(const LightPathsParam& param, RenderingContext& ctx) const
+{
+    // camera connections of all the paths in the chunk are traced together
+    CameraSplatBatch cameraSplats(mScene, ctx);
+
+    for (uint32 i = 0; i < param.numLightPaths; ++i)
+    {
+        InitLightPathSample(ctx);
+        TraceLightPath(param.camera, ctx, cameraSplats);
+    }
+}
+
+const RayColor LightTracer::RenderPixel(const Ray&, const RenderParam&, RenderingContext&) const
+{
+    // all the contribution comes from light paths pass
+    return RayColor::Zero();
+}
+
+void LightTracer::TraceLightPath(const Camera& camera, RenderingContext& ctx, CameraSplatBatch& cameraSplats) const
 {
     uint32 depth = 0;
 
@@ -31,7 +68,7 @@ const RayColor LightTracer::RenderPixel(const Ray&, const RenderParam& param, Re
     if (allLocalLights.Empty())
     {
         // no lights on the scene
-        return RayColor::Zero();
+        return;
     }
 
     const float lightPickingProbability = 1.0f / (float)allLocalLights.Size();
@@ -54,7 +91,7 @@ const RayColor LightTracer::RenderPixel(const Ray&, const RenderParam& param, Re
     if (throughput.AlmostZero())
     {
         // generated too weak sample - skip it
-        return RayColor::Zero();
+        return;
     }
 
     emitResult.emissionPdfW *= lightPickingProbability;
@@ -80,7 +117,7 @@ const RayColor LightTracer::RenderPixel(const Ray&, const RenderParam& param, Re
             break; // ray missed
         }
 
-        if (hitPoint.subObjectId == RT_LIGHT_OBJECT)
+        if (IsLightSubObject(hitPoint.subObjectId))
         {
             break; // we hit a light directly
         }
@@ -120,7 +157,7 @@ const RayColor LightTracer::RenderPixel(const Ray&, const RenderParam& param, Re
 
         // connect to camera
         {
-            const Vector4 cameraPos = param.camera.GetTransform().GetTranslation();
+            const Vector4 cameraPos = camera.GetTransform().GetTranslation();
             const Vector4 samplePos = shadingData.intersection.frame.GetTranslation();
 
             Vector4 dirToCamera = cameraPos - samplePos;
@@ -139,20 +176,14 @@ const RayColor LightTracer::RenderPixel(const Ray&, const RenderParam& param, Re
             {
                 Vector4 filmPos;
 
-                if (param.camera.WorldToFilm(samplePos, filmPos))
+                if (camera.WorldToFilm(samplePos, filmPos))
                 {
-                    HitPoint shadowHitPoint;
-                    shadowHitPoint.distance = cameraDistance * 0.999f;
-
                     const Ray shadowRay(samplePos + shadingData.intersection.frame[2] * 0.0001f, dirToCamera);
 
-                    if (!mScene.Traverse_Shadow({ shadowRay, shadowHitPoint, ctx }))
-                    {
-                        const float cameraPdfA = param.camera.PdfW(-dirToCamera) / cameraDistanceSqr;
-                        const RayColor contribution = (cameraFactor * throughput) * cameraPdfA;
-                        const Vector4 value = contribution.ConvertToTristimulus(ctx.wavelength);
-                        param.film.AccumulateColor(filmPos, value, ctx.randomGenerator);
-                    }
+                    // camera PDF is normalized over the whole film, so it has to be rescaled if there's not exactly one light path per pixel
+                    const float cameraPdfA = camera.PdfW(-dirToCamera) * mPixelsPerLightPath / cameraDistanceSqr;
+                    const RayColor contribution = (cameraFactor * throughput) * cameraPdfA;
+                    cameraSplats.Add(shadowRay, cameraDistance * 0.999f, filmPos, contribution.ConvertToTristimulus(ctx.wavelength));
                 }
             }
         }
@@ -178,8 +209,6 @@ const RayColor LightTracer::RenderPixel(const Ray&, const RenderParam& param, Re
     }
 
     ctx.counters.numRays += (uint64)depth + 1;
-
-    return RayColor::Zero();
 }
 
 } // namespace rt
@@ -7,6 +7,7 @@ namespace rt {
 
 struct ShadingData;
 class ILight;
+class CameraSplatBatch;
 
 // Naive unidirectional light tracer
 // Traces random light paths starting from light surface
@@ -18,10 +19,21 @@ public:
     LightTracer(const Scene& scene);
 
     virtual const char* GetName() const override;
+    virtual void PreRender(uint32 passNumber, const Film& film) override;
+    virtual uint32 GetNumLightPaths() const override;
+    virtual void TraceLightPaths(const LightPathsParam& param, RenderingContext& ctx) const override;
     virtual const RayColor RenderPixel(const math::Ray& ray, const RenderParam& param, RenderingContext& ctx) const override;
 
+    // number of light paths traced in a frame, relative to number of pixels
+    float mLightPathsPerPixel;
+
 private:
+    void TraceLightPath(const Camera& camera, RenderingContext& ctx, CameraSplatBatch& cameraSplats) const;
+
+    uint32 mLightPathsCount;
 
+    // ratio of number of pixels to number of light paths, used to normalize camera connections
+    float mPixelsPerLightPath;
 };
 
 } // namespace rt
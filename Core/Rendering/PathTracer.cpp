@@ -83,6 +83,10 @@ const RayColor PathTracer::RenderPixel(const math::Ray& primaryRay, const Render
 
     uint32 depth = 0;
 
+    // ray cone (for texture filtering)
+    float coneWidth = 0.0f;
+    float coneSpreadAngle = context.pixelSpreadAngle;
+
     for (;;)
     {
         hitPoint.distance = HitPoint::DefaultDistance;
@@ -96,11 +100,12 @@ const RayColor PathTracer::RenderPixel(const math::Ray& primaryRay, const Render
         }
 
         // fill up structure with shading data
-        mScene.EvaluateIntersection(ray, hitPoint, context.time, shadingData.intersection);
+        coneWidth += coneSpreadAngle * hitPoint.distance;
+        mScene.EvaluateIntersection(ray, hitPoint, context.time, shadingData.intersection, coneWidth);
         shadingData.outgoingDirWorldSpace = -ray.dir;
 
         // we hit a light directly
-        if (hitPoint.subObjectId == RT_LIGHT_OBJECT)
+        if (IsLightSubObject(hitPoint.subObjectId))
         {
             const ISceneObject* sceneObject = mScene.GetHitObject(hitPoint.objectId);
             RT_ASSERT(sceneObject->GetType() == ISceneObject::Type::Light);
@@ -163,6 +168,9 @@ const RayColor PathTracer::RenderPixel(const math::Ray& primaryRay, const Render
         ray = Ray(shadingData.intersection.frame.GetTranslation(), incomingDirWorldSpace);
         ray.origin += ray.dir * 0.001f;
 
+        // rough surfaces widen the path footprint
+        coneSpreadAngle += shadingData.materialParams.roughness;
+
         depth++;
     }
 
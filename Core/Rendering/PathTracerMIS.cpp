@@ -1,6 +1,7 @@
 #include "PCH.h"
 #include "PathTracerMIS.h"
 #include "Context.h"
+#include "ShadowRayBatch.h"
 #include "PathDebugging.h"
 #include "Scene/Scene.h"
 #include "Scene/Light/Light.h"
@@ -40,7 +41,7 @@ const char* PathTracerMIS::GetName() const
     return "Path Tracer MIS";
 }
 
-const RayColor PathTracerMIS::SampleLight(const LightSceneObject* lightObject, const ShadingData& shadingData, const PathState& pathState, RenderingContext& context, const float lightPickProbability) const
+void PathTracerMIS::SampleLight(const LightSceneObject* lightObject, const ShadingData& shadingData, const PathState& pathState, RenderingContext& context, const float lightPickProbability, ShadowRayBatch& shadowRays) const
 {
     const ILight& light = lightObject->GetLight();
 
@@ -60,7 +61,7 @@ const RayColor PathTracerMIS::SampleLight(const LightSceneObject* lightObject, c
 
     if (radiance.AlmostZero())
     {
-        return RayColor::Zero();
+        return;
     }
 
     RT_ASSERT(IsValid(illuminateResult.directPdfW) && illuminateResult.directPdfW >= 0.0f);
@@ -75,31 +76,11 @@ const RayColor PathTracerMIS::SampleLight(const LightSceneObject* lightObject, c
 
     if (factor.AlmostZero())
     {
-        return RayColor::Zero();
+        return;
     }
 
     RT_ASSERT(bsdfPdfW >= 0.0f && IsValid(bsdfPdfW));
 
-    // cast shadow ray
-    {
-        HitPoint hitPoint;
-        hitPoint.distance = illuminateResult.distance * 0.999f;
-
-        Ray shadowRay(shadingData.intersection.frame.GetTranslation(), illuminateResult.directionToLight);
-        shadowRay.origin += shadowRay.dir * 0.0001f;
-
-        context.counters.numShadowRays++;
-        if (mScene.Traverse_Shadow({ shadowRay, hitPoint, context }))
-        {
-            // shadow ray missed the light - light is occluded
-            return RayColor::Zero();
-        }
-        else
-        {
-            context.counters.numShadowRaysHit++;
-        }
-    }
-
     float weight = 1.0f;
 
     // bypass MIS when this is the last path sample so the energy is not lost
@@ -119,7 +100,11 @@ const RayColor PathTracerMIS::SampleLight(const LightSceneObject* lightObject, c
     const RayColor result = (radiance * factor) * FastDivide(weight, lightPickProbability * illuminateResult.directPdfW);
     RT_ASSERT(result.IsValid());
 
-    return result;
+    // queue shadow ray
+    Ray shadowRay(shadingData.intersection.frame.GetTranslation(), illuminateResult.directionToLight);
+    shadowRay.origin += shadowRay.dir * 0.0001f;
+
+    shadowRays.Add(shadowRay, illuminateResult.distance * 0.999f, result);
 }
 
 const RayColor PathTracerMIS::SampleLights(const ShadingData& shadingData, const PathState& pathState, RenderingContext& context, const float lightPickProbability) const
@@ -129,12 +114,15 @@ const RayColor PathTracerMIS::SampleLights(const ShadingData& shadingData, const
     const auto& lights = mScene.GetLights();
     if (!lights.Empty())
     {
+        // shadow rays are traced 8 at a time
+        ShadowRayBatch shadowRays(mScene, context);
+
         switch (context.params->lightSamplingStrategy)
         {
             case LightSamplingStrategy::Single:
             {
                 const uint32 lightIndex = context.randomGenerator.GetInt() % lights.Size();
-                accumulatedColor = SampleLight(lights[lightIndex], shadingData, pathState, context, lightPickProbability);
+                SampleLight(lights[lightIndex], shadingData, pathState, context, lightPickProbability, shadowRays);
                 break;
             }
 
@@ -142,12 +130,13 @@ const RayColor PathTracerMIS::SampleLights(const ShadingData& shadingData, const
             {
                 for (const LightSceneObject* lightObject : lights)
                 {
-                    accumulatedColor += SampleLight(lightObject, shadingData, pathState, context, lightPickProbability);
+                    SampleLight(lightObject, shadingData, pathState, context, lightPickProbability, shadowRays);
                 }
                 break;
             }
         };
 
+        accumulatedColor = shadowRays.Flush();
         accumulatedColor *= RayColor::Resolve(context.wavelength, Spectrum(mLightSamplingWeight));
     }
 
@@ -267,6 +256,10 @@ const RayColor PathTracerMIS::RenderPixel(const math::Ray& primaryRay, const Ren
 
     const float lightPickProbability = GetLightPickingProbability(context);
 
+    // ray cone (for texture filtering)
+    float coneWidth = 0.0f;
+    float coneSpreadAngle = context.pixelSpreadAngle;
+
     for (;;)
     {
         hitPoint.objectId = RT_INVALID_OBJECT;
@@ -283,11 +276,12 @@ const RayColor PathTracerMIS::RenderPixel(const math::Ray& primaryRay, const Ren
 
         if (hitPoint.distance < FLT_MAX)
         {
-            mScene.EvaluateIntersection(ray, hitPoint, context.time, shadingData.intersection);
+            coneWidth += coneSpreadAngle * hitPoint.distance;
+            mScene.EvaluateIntersection(ray, hitPoint, context.time, shadingData.intersection, coneWidth);
         }
 
         // we hit a light directly
-        if (hitPoint.subObjectId == RT_LIGHT_OBJECT)
+        if (IsLightSubObject(hitPoint.subObjectId))
         {
             const ISceneObject* sceneObject = mScene.GetHitObject(hitPoint.objectId);
             RT_ASSERT(sceneObject->GetType() == ISceneObject::Type::Light);
@@ -392,6 +386,9 @@ const RayColor PathTracerMIS::RenderPixel(const math::Ray& primaryRay, const Ren
         ray = Ray(shadingData.intersection.frame.GetTranslation(), incomingDirWorldSpace);
         ray.origin += ray.dir * 0.001f;
 
+        // rough surfaces widen the path footprint
+        coneSpreadAngle += shadingData.materialParams.roughness;
+
         pathState.depth++;
     }
 
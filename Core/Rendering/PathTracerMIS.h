@@ -8,6 +8,7 @@ namespace rt {
 struct ShadingData;
 class ILight;
 class LightSceneObject;
+class ShadowRayBatch;
 
 // Unidirectional path tracer
 // Samples both BSDF and direct lighting
@@ -39,7 +40,8 @@ private:
     const RayColor SampleLights(const ShadingData& shadingData, const PathState& pathState, RenderingContext& context, const float lightPickProbability) const;
 
     // importance sample single light source
-    const RayColor SampleLight(const LightSceneObject* lightObject, const ShadingData& shadingData, const PathState& pathState, RenderingContext& context, const float lightPickProbability) const;
+    // the contribution is queued in the batch and accounted only if the shadow ray is not occluded
+    void SampleLight(const LightSceneObject* lightObject, const ShadingData& shadingData, const PathState& pathState, RenderingContext& context, const float lightPickProbability, ShadowRayBatch& shadowRays) const;
 
     // compute radiance from a hit local lights
     const RayColor EvaluateLight(const LightSceneObject* lightObject, const math::Ray& ray, float dist, const IntersectionData& intersection, const PathState& pathState, RenderingContext& context, const float lightPickProbability) const;
@@ -1,5 +1,6 @@
 #include "PCH.h"
 
+#include "Context.h"
 #include "PathTracer.h"
 #include "PathTracerMIS.h"
 #include "LightTracer.h"
@@ -28,6 +29,23 @@ void IRenderer::PreRender(uint32, RenderingContext&)
 {
 }
 
+uint32 IRenderer::GetNumLightPaths() const
+{
+    return 0;
+}
+
+void IRenderer::TraceLightPaths(const LightPathsParam&, RenderingContext&) const
+{
+}
+
+void IRenderer::InitLightPathSample(RenderingContext& ctx)
+{
+    ctx.time = ctx.randomGenerator.GetFloat() * ctx.params->motionBlurStrength;
+#ifdef RT_ENABLE_SPECTRAL_RENDERING
+    ctx.wavelength.Randomize(ctx.randomGenerator.GetFloat());
+#endif // RT_ENABLE_SPECTRAL_RENDERING
+}
+
 void IRenderer::PreRenderGlobal(RenderingContext&)
 {
 }
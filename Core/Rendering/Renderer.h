@@ -26,6 +26,13 @@ public:
         Film& film;
     };
 
+    struct LightPathsParam
+    {
+        uint32 iteration;
+        uint32 numLightPaths;
+        const Camera& camera;
+    };
+
     IRenderer(const Scene& scene);
 
     RAYLIB_API virtual ~IRenderer();
@@ -35,6 +42,8 @@ public:
 
     virtual const char* GetName() const = 0;
 
+    RT_FORCE_INLINE const Scene& GetScene() const { return mScene; }
+
     // create per-thread context
     virtual RendererContextPtr CreateContext() const;
 
@@ -47,6 +56,17 @@ public:
     // optional rendering pre-pass, called once per frame for every thread
     virtual void PreRender(uint32 passNumber, RenderingContext& ctx);
 
+    // optional light paths pass, executed every frame after PreRender() and before PreRenderGlobal()
+    // returns total number of light paths to be traced in current frame (zero if the renderer does not trace light paths)
+    // NOTE: light paths splat onto the whole film, so the viewport renders every pixel in every pass for such renderers
+    // (adaptive rendering never removes blocks and resolution cascade is disabled), hence the count should cover the whole film
+    virtual uint32 GetNumLightPaths() const;
+
+    // trace a chunk of light paths
+    // camera connections are recorded as film splats in the context and accumulated onto film after the frame is rendered
+    // Note: this will be called from multiple threads, each thread provides own RenderingContext
+    virtual void TraceLightPaths(const LightPathsParam& param, RenderingContext& ctx) const;
+
     // optional rendering pre-pass, called once (single threaded)
     virtual void PreRenderGlobal(RenderingContext& ctx);
     virtual void PreRenderGlobal();
@@ -59,6 +79,9 @@ public:
     virtual void Raytrace_Packet(RayPacket& packet, const Camera& camera, Film& film, RenderingContext& context) const;
 
 protected:
+    // pick time and wavelength for a light path, as there's no camera sample to inherit them from
+    static void InitLightPathSample(RenderingContext& ctx);
+
     const Scene& mScene;
 
 private:
@@ -0,0 +1,159 @@
+#include "PCH.h"
+#include "ShadowRayBatch.h"
+#include "Context.h"
+#include "../Scene/Scene.h"
+#include "../Math/Simd8Ray.h"
+#include "../Traversal/TraversalContext.h"
+
+namespace rt {
+
+using namespace math;
+
+namespace {
+
+// returns bit mask of occluded rays
+int32 TraceShadowRays(const Scene& scene, RenderingContext& context, const Ray* rays, const float* maxDistances, const uint32 numRays)
+{
+    context.counters.numShadowRays += numRays;
+
+    if (numRays == 1)
+    {
+        // not worth 8-wide traversal
+        HitPoint hitPoint;
+        hitPoint.distance = maxDistances[0];
+        return scene.Traverse_Shadow({ rays[0], hitPoint, context }) ? 1 : 0;
+    }
+
+    // unused lanes are filled with the first ray, but terminated from the start
+    const Ray* r = rays;
+    const uint32 n = numRays;
+    const Ray_Simd8 simdRays(r[0], r[1 % n], r[2 % n], r[3 % n], r[4 % n], r[5 % n], r[6 % n], r[7 % n]);
+
+    Vector8 simdMaxDistances(SimdShadowTraversalContext::TerminatedDistance);
+    for (uint32 i = 0; i < numRays; ++i)
+    {
+        simdMaxDistances[i] = maxDistances[i];
+    }
+
+    return scene.Traverse_Shadow_Simd8({ simdRays, simdMaxDistances, context });
+}
+
+} // namespace
+
+ShadowRayBatch::ShadowRayBatch(const Scene& scene, RenderingContext& context)
+    : mScene(scene)
+    , mContext(context)
+    , mAccumulatedContribution(RayColor::Zero())
+    , mNumRays(0)
+{
+}
+
+void ShadowRayBatch::Add(const Ray& ray, const float maxDistance, const RayColor& contribution)
+{
+    RT_ASSERT(mNumRays < MaxRays);
+    RT_ASSERT(maxDistance >= 0.0f);
+
+    mRays[mNumRays] = ray;
+    mMaxDistances[mNumRays] = maxDistance;
+    mContributions[mNumRays] = contribution;
+    mNumRays++;
+
+    if (mNumRays == MaxRays)
+    {
+        Trace();
+    }
+}
+
+const RayColor ShadowRayBatch::Flush()
+{
+    if (mNumRays > 0)
+    {
+        Trace();
+    }
+
+    const RayColor result = mAccumulatedContribution;
+    mAccumulatedContribution = RayColor::Zero();
+    return result;
+}
+
+void ShadowRayBatch::Trace()
+{
+    const int32 occludedMask = TraceShadowRays(mScene, mContext, mRays, mMaxDistances, mNumRays);
+
+    for (uint32 i = 0; i < mNumRays; ++i)
+    {
+        if (!(occludedMask & (1 << i)))
+        {
+            mContext.counters.numShadowRaysHit++;
+            mAccumulatedContribution += mContributions[i];
+        }
+    }
+
+    mNumRays = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+CameraSplatBatch::CameraSplatBatch(const Scene& scene, RenderingContext& context)
+    : mScene(scene)
+    , mContext(context)
+    , mTime(0.0f)
+    , mNumRays(0)
+{
+}
+
+CameraSplatBatch::~CameraSplatBatch()
+{
+    Flush();
+}
+
+void CameraSplatBatch::Add(const Ray& ray, const float maxDistance, const Vector4& filmPos, const Vector4& color)
+{
+    RT_ASSERT(mNumRays < MaxRays);
+    RT_ASSERT(maxDistance >= 0.0f);
+
+    // rays of a different light path (with motion blur) can't be traced with the same time
+    if (mNumRays > 0 && mTime != mContext.time)
+    {
+        Flush();
+    }
+
+    mTime = mContext.time;
+    mRays[mNumRays] = ray;
+    mMaxDistances[mNumRays] = maxDistance;
+    mFilmPositions[mNumRays] = filmPos;
+    mColors[mNumRays] = color;
+    mNumRays++;
+
+    if (mNumRays == MaxRays)
+    {
+        Flush();
+    }
+}
+
+void CameraSplatBatch::Flush()
+{
+    if (mNumRays == 0)
+    {
+        return;
+    }
+
+    // the batch may be flushed after the context moved on to the next light path
+    const float currentTime = mContext.time;
+    mContext.time = mTime;
+    const int32 occludedMask = TraceShadowRays(mScene, mContext, mRays, mMaxDistances, mNumRays);
+    mContext.time = currentTime;
+
+    for (uint32 i = 0; i < mNumRays; ++i)
+    {
+        if (!(occludedMask & (1 << i)))
+        {
+            mContext.counters.numShadowRaysHit++;
+            mContext.filmSplats.PushBack({ mFilmPositions[i], mColors[i] });
+        }
+    }
+
+    mNumRays = 0;
+}
+
+} // namespace rt
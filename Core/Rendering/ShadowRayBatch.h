@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../RayLib.h"
+#include "../Color/RayColor.h"
+#include "../Math/Ray.h"
+#include "../Math/Vector4.h"
+
+namespace rt {
+
+class Scene;
+struct RenderingContext;
+
+/**
+ * Collects shadow rays together with contributions they carry (if not occluded)
+ * and traces them 8 at a time with the occlusion-only kernel.
+ * Used for batched next event estimation and vertex connections.
+ */
+class RT_ALIGN(32) ShadowRayBatch
+{
+public:
+    static constexpr uint32 MaxRays = 8;
+
+    ShadowRayBatch(const Scene& scene, RenderingContext& context);
+
+    // queue a shadow ray, the batch is traced when it gets full
+    void Add(const math::Ray& ray, const float maxDistance, const RayColor& contribution);
+
+    // trace pending rays and return sum of contributions of all the unoccluded rays
+    const RayColor Flush();
+
+private:
+    void Trace();
+
+    const Scene& mScene;
+    RenderingContext& mContext;
+
+    RayColor mAccumulatedContribution;
+    RayColor mContributions[MaxRays];
+    math::Ray mRays[MaxRays];
+    float mMaxDistances[MaxRays];
+    uint32 mNumRays;
+};
+
+/**
+ * Collects connections of light path vertices to camera and traces their shadow rays 8 at a time.
+ * Colors of unoccluded connections are appended to context's film splats list.
+ * NOTE: all the rays in a batch share the same time (pending rays are traced when context's time changes)
+ */
+class RT_ALIGN(32) CameraSplatBatch
+{
+public:
+    static constexpr uint32 MaxRays = 8;
+
+    CameraSplatBatch(const Scene& scene, RenderingContext& context);
+    ~CameraSplatBatch();
+
+    // queue a shadow ray towards camera, the batch is traced when it gets full
+    void Add(const math::Ray& ray, const float maxDistance, const math::Vector4& filmPos, const math::Vector4& color);
+
+    // trace pending rays
+    void Flush();
+
+private:
+    const Scene& mScene;
+    RenderingContext& mContext;
+
+    math::Vector4 mFilmPositions[MaxRays];
+    math::Vector4 mColors[MaxRays];
+    math::Ray mRays[MaxRays];
+    float mMaxDistances[MaxRays];
+    float mTime;
+    uint32 mNumRays;
+};
+
+} // namespace rt
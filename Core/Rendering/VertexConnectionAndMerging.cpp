@@ -2,7 +2,7 @@
 #include "VertexConnectionAndMerging.h"
 #include "RendererContext.h"
 #include "Context.h"
-#include "Film.h"
+#include "ShadowRayBatch.h"
 #include "Scene/Scene.h"
 #include "Scene/Camera.h"
 #include "Scene/Light/Light.h"
@@ -29,8 +29,6 @@ RT_FORCE_INLINE static constexpr float PdfWtoA(const float pdfW, const float dis
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-static constexpr uint32 g_MaxLightVertices = 256;
-
 class RT_ALIGN(64) VertexConnectionAndMergingContext : public IRendererContext, public Aligned<64>
 {
 public:
@@ -40,18 +38,60 @@ public:
     // list of photons recorded from a single thread
     DynArray<Photon> photons;
 
-    // list of light vertices used in current pixel processing
-    uint32 numLightVertices = 0;
-    LightVertex lightVertices[g_MaxLightVertices];
+    // list of light vertices recorded from a single thread
+    DynArray<LightVertex> lightVertices;
+
+    // number of light paths traced by a single thread
+    uint32 numLightPaths = 0;
 };
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 static_assert(sizeof(VertexConnectionAndMerging::Photon) == 32, "Invalid photon size");
+static_assert(sizeof(VertexConnectionAndMerging::LightVertex) == 64, "Invalid light vertex size");
+
+// Number of recorded vertices fluctuates between frames, so vertex lists are given some headroom
+// to avoid reallocating them every time a frame records more vertices than any previous one.
+RT_FORCE_INLINE static constexpr uint32 GetVertexListCapacity(const uint32 numVertices)
+{
+    return numVertices + numVertices / 2 + 256;
+}
+
+void VertexConnectionAndMerging::LightVertex::Encode(const ShadingData& shadingData, const RayColor& pathThroughput, const Wavelength& wavelength)
+{
+    position = shadingData.intersection.frame[3].ToFloat3();
+    normal.FromVector(shadingData.intersection.frame[2]);
+    tangent.FromVector(shadingData.intersection.frame[0]);
+    outgoingDir.FromVector(shadingData.outgoingDirWorldSpace);
+    material = shadingData.intersection.material;
+    texCoord = shadingData.intersection.texCoord.ToFloat2();
+    throughput.FromVector(pathThroughput.ConvertToTristimulus(wavelength));
+}
+
+void VertexConnectionAndMerging::LightVertex::Decode(const Wavelength& wavelength, ShadingData& outShadingData, RayColor& outThroughput) const
+{
+    IntersectionData& intersection = outShadingData.intersection;
+
+    // packed vectors are not exactly perpendicular
+    intersection.frame[2] = normal.ToVector();
+    intersection.frame[0] = Vector4::Orthogonalize(tangent.ToVector(), intersection.frame[2]).Normalized3();
+    intersection.frame[1] = Vector4::Cross3(intersection.frame[0], intersection.frame[2]);
+    intersection.frame[3] = Vector4(position);
+    intersection.texCoord = Vector4(texCoord);
+    intersection.material = material;
+
+    outShadingData.outgoingDirWorldSpace = outgoingDir.ToVector();
+    material->EvaluateShadingData(wavelength, outShadingData);
+
+    outThroughput = RayColor::Resolve(wavelength, Spectrum{ throughput.ToVector() });
+}
 
 VertexConnectionAndMerging::VertexConnectionAndMerging(const Scene& scene)
     : IRenderer(scene)
     , mLightPathsCount(0)
+    , mPixelsPerLightPath(1.0f)
+    , mNumPooledLightPaths(0)
+    , mVertexConnectionNormalizationFactor(0.0f)
 {
     mBSDFSamplingWeight = Vector4(1.0f);
     mLightSamplingWeight = Vector4(1.0f);
@@ -62,6 +102,8 @@ VertexConnectionAndMerging::VertexConnectionAndMerging(const Scene& scene)
     mUseVertexConnection = true;
     mUseVertexMerging = true;
     mMaxPathLength = 10;
+    mNumVertexConnections = 4;
+    mLightPathsPerPixel = 1.0f;
     mInitialMergingRadius = 0.02f;
     mMergingRadiusVC = mMergingRadiusVM = mInitialMergingRadius;
     mMinMergingRadius = 0.02f;
@@ -87,22 +129,25 @@ void VertexConnectionAndMerging::PreRender(uint32 passNumber, const Film& film)
     RT_ASSERT(mMergingRadiusMultiplier <= 1.0f);
     RT_ASSERT(mMaxPathLength > 0);
 
-    mLightPathsCount = film.GetHeight() * film.GetWidth();
+    RT_ASSERT(mLightPathsPerPixel > 0.0f);
+
+    const uint32 numPixels = film.GetHeight() * film.GetWidth();
+    mLightPathsCount = Max(1u, static_cast<uint32>(mLightPathsPerPixel * static_cast<float>(numPixels) + 0.5f));
+    mPixelsPerLightPath = static_cast<float>(numPixels) / static_cast<float>(mLightPathsCount);
 
     if (passNumber == 0)
     {
         mMergingRadiusVC = mInitialMergingRadius;
-        mMergingRadiusVM = mInitialMergingRadius;
     }
     else
     {
-        // merging radius for vertex merging is delayed by 1 frame
-        mMergingRadiusVM = mMergingRadiusVC;
-
         mMergingRadiusVC *= mMergingRadiusMultiplier;
         mMergingRadiusVC = Max(mMergingRadiusVC, mMinMergingRadius);
     }
 
+    // light paths are traced in the same frame, before camera paths, so there's no need to delay merging radius
+    mMergingRadiusVM = mMergingRadiusVC;
+
     // Factor used to normalize vertex merging contribution.
     // We divide the summed up energy by disk radius and number of light paths
     mVertexMergingNormalizationFactor = 1.0f / (Sqr(mMergingRadiusVM) * RT_PI * mLightPathsCount);
@@ -110,12 +155,11 @@ void VertexConnectionAndMerging::PreRender(uint32 passNumber, const Film& film)
     // compute MIS weights for vertex connection
     {
         const float etaVCM = RT_PI * Sqr(mMergingRadiusVC) * mLightPathsCount;
-        // Note: we don't use merging in the first iteration
-        mMisVertexMergingWeightFactorVC = (mUseVertexMerging && passNumber > 0) ? Mis(etaVCM) : 0.0f;
+        mMisVertexMergingWeightFactorVC = mUseVertexMerging ? Mis(etaVCM) : 0.0f;
         mMisVertexConnectionWeightFactorVC = mUseVertexConnection ? Mis(1.f / etaVCM) : 0.0f;
     }
 
-    // set MIS weights for vertex merging (delayed by 1 iteration)
+    // set MIS weights for vertex merging
     {
         const float etaVCM = RT_PI * Sqr(mMergingRadiusVM) * mLightPathsCount;
         mMisVertexMergingWeightFactorVM = mUseVertexMerging ? Mis(etaVCM) : 0.0f;
@@ -131,10 +175,14 @@ void VertexConnectionAndMerging::PreRender(uint32 passNumber, RenderingContext&
     if (passNumber == 0)
     {
         rendererContext.photons.Clear();
+        rendererContext.lightVertices.Clear();
+        rendererContext.numLightPaths = 0;
     }
 
     // TODO this is duplicated
     mPhotons.Clear();
+    mLightVertices.Clear();
+    mNumPooledLightPaths = 0;
 }
 
 void VertexConnectionAndMerging::PreRenderGlobal(RenderingContext& ctx)
@@ -151,12 +199,34 @@ void VertexConnectionAndMerging::PreRenderGlobal(RenderingContext& ctx)
     mPhotons.Resize_SkipConstructor(oldPhotonsSize + numPhotonsToAdd);
     LargeMemCopy(mPhotons.Data() + oldPhotonsSize, rendererContext.photons.Data(), numPhotonsToAdd * sizeof(Photon));
 
+    // merge light vertex lists
+    const uint32 oldLightVerticesSize = mLightVertices.Size();
+    const uint32 numLightVerticesToAdd = rendererContext.lightVertices.Size();
+    mLightVertices.Resize_SkipConstructor(oldLightVerticesSize + numLightVerticesToAdd);
+    LargeMemCopy(mLightVertices.Data() + oldLightVerticesSize, rendererContext.lightVertices.Data(), numLightVerticesToAdd * sizeof(LightVertex));
+    mNumPooledLightPaths += rendererContext.numLightPaths;
+
     // prepare data structures
     rendererContext.photons.Clear();
+    rendererContext.photons.Reserve(GetVertexListCapacity(numPhotonsToAdd));
+    rendererContext.lightVertices.Clear();
+    rendererContext.lightVertices.Reserve(GetVertexListCapacity(numLightVerticesToAdd));
+    rendererContext.numLightPaths = 0;
 }
 
 void VertexConnectionAndMerging::PreRenderGlobal()
 {
+    mPhotons.Reserve(GetVertexListCapacity(mPhotons.Size()));
+    mLightVertices.Reserve(GetVertexListCapacity(mLightVertices.Size()));
+
+    // each camera vertex connects to a few vertices picked randomly from the pool instead of all vertices of a single light path,
+    // so the contribution is scaled by average number of vertices per light path
+    mVertexConnectionNormalizationFactor = 0.0f;
+    if (mNumPooledLightPaths > 0 && mNumVertexConnections > 0)
+    {
+        mVertexConnectionNormalizationFactor = static_cast<float>(mLightVertices.Size()) / static_cast<float>(mNumPooledLightPaths * mNumVertexConnections);
+    }
+
     // build hash grid of all light vertices
     // TODO make it multithreaded
     if (mUseVertexMerging)
@@ -169,16 +239,26 @@ void VertexConnectionAndMerging::PreRenderGlobal()
     }
 }
 
-const RayColor VertexConnectionAndMerging::RenderPixel(const math::Ray& ray, const RenderParam& param, RenderingContext& ctx) const
+uint32 VertexConnectionAndMerging::GetNumLightPaths() const
 {
-    // step 1: trace light paths & record photons
-
-    TraceLightPath(param.camera, param.film, ctx);
+    return mLightPathsCount;
+}
 
+void VertexConnectionAndMerging::TraceLightPaths(const LightPathsParam& param, RenderingContext& ctx) const
+{
+    // camera connections of all the paths in the chunk are traced together
+    CameraSplatBatch cameraSplats(mScene, ctx);
 
-    // step 2: trace camera paths:
+    for (uint32 i = 0; i < param.numLightPaths; ++i)
+    {
+        InitLightPathSample(ctx);
+        TraceLightPath(param.camera, ctx, cameraSplats);
+    }
+}
 
-    const VertexConnectionAndMergingContext& rendererContext = *static_cast<const VertexConnectionAndMergingContext*>(ctx.rendererContext.get());
+const RayColor VertexConnectionAndMerging::RenderPixel(const math::Ray& ray, const RenderParam& param, RenderingContext& ctx) const
+{
+    // Note: light paths are already traced and recorded in light paths pass
 
     RayColor resultColor = RayColor::Zero();
 
@@ -189,7 +269,7 @@ const RayColor VertexConnectionAndMerging::RenderPixel(const math::Ray& ray, con
 
         pathState.dVC = 0.0f;
         pathState.dVM = 0.0f;
-        pathState.dVCM = Mis(1.0f / cameraPdf);
+        pathState.dVCM = Mis(1.0f / (cameraPdf * mPixelsPerLightPath));
         pathState.lastSpecular = true;
     }
 
@@ -207,7 +287,7 @@ const RayColor VertexConnectionAndMerging::RenderPixel(const math::Ray& ray, con
         // ray missed - return background light color
         if (hitPoint.distance == HitPoint::DefaultDistance)
         {
-            resultColor.MulAndAccumulate(pathState.throughput, EvaluateGlobalLights(param.iteration, pathState, ctx));
+            resultColor.MulAndAccumulate(pathState.throughput, EvaluateGlobalLights(pathState, ctx));
             break;
         }
 
@@ -225,14 +305,14 @@ const RayColor VertexConnectionAndMerging::RenderPixel(const math::Ray& ray, con
         }
 
         // we hit a light directly
-        if (hitPoint.subObjectId == RT_LIGHT_OBJECT)
+        if (IsLightSubObject(hitPoint.subObjectId))
         {
             const ISceneObject* sceneObject = mScene.GetHitObject(hitPoint.objectId);
             RT_ASSERT(sceneObject->GetType() == ISceneObject::Type::Light);
             const LightSceneObject* lightObject = static_cast<const LightSceneObject*>(sceneObject);
 
             const float cosAtLight = -shadingData.intersection.CosTheta(pathState.ray.dir);
-            const RayColor lightColor = EvaluateLight(param.iteration, lightObject, &shadingData.intersection, pathState, ctx);
+            const RayColor lightColor = EvaluateLight(lightObject, &shadingData.intersection, pathState, ctx);
             RT_ASSERT(lightColor.IsValid());
             resultColor.MulAndAccumulate(pathState.throughput, lightColor);
             break;
@@ -266,33 +346,34 @@ const RayColor VertexConnectionAndMerging::RenderPixel(const math::Ray& ray, con
             resultColor.MulAndAccumulate(pathState.throughput, lightColor);
         }
 
-        // Vertex Connection - connect camera vertex to light vertices (bidirectional path tracing)
-        const uint32 numLightVertices = rendererContext.numLightVertices;
-        if (!isDeltaBsdf && mUseVertexConnection && rendererContext.numLightVertices > 0)
+        // Vertex Connection - connect camera vertex to light vertices randomly picked from the pool (bidirectional path tracing)
+        const uint32 numLightVertices = mLightVertices.Size();
+        if (!isDeltaBsdf && mUseVertexConnection && numLightVertices > 0)
         {
-            RayColor vertexConnectionColor = RayColor::Zero();
+            // connection rays are traced 8 at a time
+            ShadowRayBatch shadowRays(mScene, ctx);
 
-            for (uint32 i = 0; i < numLightVertices; ++i)
+            for (uint32 i = 0; i < mNumVertexConnections; ++i)
             {
-                const LightVertex& lightVertex = rendererContext.lightVertices[i];
+                const LightVertex& lightVertex = mLightVertices[ctx.randomGenerator.GetInt() % numLightVertices]; // TODO get rid of division
 
                 // full path would be too long
-                // Note: all other light vertices can be skiped, as they will produce even longer paths
                 if (lightVertex.pathLength + pathState.length + 1u > mMaxPathLength)
                 {
-                    break;
+                    continue;
                 }
 
-                vertexConnectionColor.MulAndAccumulate(lightVertex.throughput, ConnectVertices(pathState, shadingData, lightVertex, ctx));
+                ConnectVertices(pathState, shadingData, lightVertex, ctx, shadowRays);
             }
 
+            RayColor vertexConnectionColor = shadowRays.Flush();
             vertexConnectionColor *= RayColor::Resolve(ctx.wavelength, Spectrum(mVertexConnectingWeight));
             RT_ASSERT(vertexConnectionColor.IsValid());
-            resultColor.MulAndAccumulate(pathState.throughput, vertexConnectionColor);
+            resultColor.MulAndAccumulate(pathState.throughput * vertexConnectionColor, mVertexConnectionNormalizationFactor);
         }
 
         // Vertex Merging - merge camera vertex to light vertices nearby
-        if (!isDeltaBsdf && mUseVertexMerging && param.iteration > 0)
+        if (!isDeltaBsdf && mUseVertexMerging)
         {
             RayColor vertexMergingColor = MergeVertices(pathState, shadingData, ctx);
             RT_ASSERT(vertexMergingColor.IsValid());
@@ -317,12 +398,12 @@ const RayColor VertexConnectionAndMerging::RenderPixel(const math::Ray& ray, con
     return resultColor;
 }
 
-void VertexConnectionAndMerging::TraceLightPath(const Camera& camera, Film& film, RenderingContext& ctx) const
+void VertexConnectionAndMerging::TraceLightPath(const Camera& camera, RenderingContext& ctx, CameraSplatBatch& cameraSplats) const
 {
     RT_ASSERT(ctx.rendererContext);
     VertexConnectionAndMergingContext& rendererContext = *static_cast<VertexConnectionAndMergingContext*>(ctx.rendererContext.get());
 
-    rendererContext.numLightVertices = 0;
+    rendererContext.numLightPaths++;
 
     PathState pathState;
 
@@ -333,6 +414,7 @@ void VertexConnectionAndMerging::TraceLightPath(const Camera& camera, Film& film
     }
 
     HitPoint hitPoint;
+    ShadingData shadingData;
 
     for (;;)
     {
@@ -347,16 +429,12 @@ void VertexConnectionAndMerging::TraceLightPath(const Camera& camera, Film& film
             break; // ray missed
         }
 
-        if (hitPoint.subObjectId == RT_LIGHT_OBJECT)
+        if (IsLightSubObject(hitPoint.subObjectId))
         {
             break; // we hit a light directly
         }
 
-        RT_ASSERT(rendererContext.numLightVertices < g_MaxLightVertices);
-        LightVertex& vertex = rendererContext.lightVertices[rendererContext.numLightVertices];
-
         // fill up structure with shading data
-        ShadingData& shadingData = vertex.shadingData;
         {
             mScene.EvaluateIntersection(pathState.ray, hitPoint, ctx.time, shadingData.intersection);
 
@@ -385,16 +463,17 @@ void VertexConnectionAndMerging::TraceLightPath(const Camera& camera, Film& film
             // store light vertex for connection
             if (mUseVertexConnection)
             {
-                rendererContext.numLightVertices++;
+                rendererContext.lightVertices.EmplaceBack();
+                LightVertex& vertex = rendererContext.lightVertices.Back();
 
+                vertex.Encode(shadingData, pathState.throughput, ctx.wavelength);
                 vertex.pathLength = uint8(pathState.length);
-                vertex.throughput = pathState.throughput;
                 vertex.dVC = pathState.dVC;
                 vertex.dVM = pathState.dVM;
                 vertex.dVCM = pathState.dVCM;
 
                 // connect vertex to camera directly
-                ConnectToCamera(camera, film, vertex, ctx);
+                ConnectToCamera(camera, shadingData, pathState, ctx, cameraSplats);
             }
 
             // store simplified light vertex (photon) for merging
@@ -576,7 +655,7 @@ bool VertexConnectionAndMerging::AdvancePath(PathState& path, const ShadingData&
     return true;
 }
 
-const RayColor VertexConnectionAndMerging::EvaluateLight(uint32 iteration, const LightSceneObject* lightObject, const IntersectionData* intersection, const PathState& pathState, RenderingContext& ctx) const
+const RayColor VertexConnectionAndMerging::EvaluateLight(const LightSceneObject* lightObject, const IntersectionData* intersection, const PathState& pathState, RenderingContext& ctx) const
 {
     const Matrix4 worldToLight = lightObject->GetInverseTransform(ctx.time);
     const Ray lightSpaceRay = worldToLight.TransformRay_Unsafe(pathState.ray);
@@ -609,8 +688,7 @@ const RayColor VertexConnectionAndMerging::EvaluateLight(uint32 iteration, const
     // no weighting required for directly visible lights
     if (pathState.length > 1)
     {
-        const bool useVertexMerging = mUseVertexMerging && iteration > 0;
-        if (useVertexMerging && !mUseVertexConnection) // special case for photon mapping
+        if (mUseVertexMerging && !mUseVertexConnection) // special case for photon mapping
         {
             if (!pathState.lastSpecular)
             {
@@ -635,7 +713,7 @@ const RayColor VertexConnectionAndMerging::EvaluateLight(uint32 iteration, const
     return lightContribution;
 }
 
-const RayColor VertexConnectionAndMerging::SampleLight(const LightSceneObject* lightObject, const ShadingData& shadingData, const PathState& pathState, RenderingContext& ctx) const
+void VertexConnectionAndMerging::SampleLight(const LightSceneObject* lightObject, const ShadingData& shadingData, const PathState& pathState, RenderingContext& ctx, ShadowRayBatch& shadowRays) const
 {
     const ILight& light = lightObject->GetLight();
 
@@ -654,7 +732,7 @@ const RayColor VertexConnectionAndMerging::SampleLight(const LightSceneObject* l
     RayColor radiance = light.Illuminate(illuminateParam, illuminateResult);
     if (radiance.AlmostZero())
     {
-        return RayColor::Zero();
+        return;
     }
 
     RT_ASSERT(radiance.IsValid());
@@ -670,26 +748,11 @@ const RayColor VertexConnectionAndMerging::SampleLight(const LightSceneObject* l
 
     if (bsdfFactor.AlmostZero())
     {
-        return RayColor::Zero();
+        return;
     }
 
     RT_ASSERT(bsdfPdfW > 0.0f && IsValid(bsdfPdfW));
 
-    // cast shadow ray
-    {
-        HitPoint hitPoint;
-        hitPoint.distance = illuminateResult.distance * 0.999f;
-
-        Ray shadowRay(shadingData.intersection.frame.GetTranslation(), illuminateResult.directionToLight);
-        shadowRay.origin += shadowRay.dir * 0.0001f;
-
-        if (mScene.Traverse_Shadow({ shadowRay, hitPoint, ctx }))
-        {
-            // shadow ray missed the light - light is occluded
-            return RayColor::Zero();
-        }
-    }
-
     // TODO
     //const auto& allLocalLights = mScene.GetLights();
     //const float lightPickProbability = 1.0f / (float)allLocalLights.size();
@@ -704,7 +767,7 @@ const RayColor VertexConnectionAndMerging::SampleLight(const LightSceneObject* l
     const float cosToLight = Vector4::Dot3(shadingData.intersection.frame[2], illuminateResult.directionToLight);
     if (cosToLight <= FLT_EPSILON)
     {
-        return RayColor::Zero();
+        return;
     }
 
     const float wLight = Mis(bsdfPdfW / (lightPickProbability * illuminateResult.directPdfW));
@@ -712,52 +775,60 @@ const RayColor VertexConnectionAndMerging::SampleLight(const LightSceneObject* l
     const float misWeight = 1.0f / (wLight + 1.0f + wCamera);
     RT_ASSERT(misWeight >= 0.0f);
 
-    return (radiance * bsdfFactor) * (misWeight / (lightPickProbability * illuminateResult.directPdfW));
+    const RayColor contribution = (radiance * bsdfFactor) * (misWeight / (lightPickProbability * illuminateResult.directPdfW));
+
+    // queue shadow ray
+    Ray shadowRay(shadingData.intersection.frame.GetTranslation(), illuminateResult.directionToLight);
+    shadowRay.origin += shadowRay.dir * 0.0001f;
+
+    shadowRays.Add(shadowRay, illuminateResult.distance * 0.999f, contribution);
 }
 
 const RayColor VertexConnectionAndMerging::SampleLights(const ShadingData& shadingData, const PathState& pathState, RenderingContext& ctx) const
 {
-    RayColor accumulatedColor = RayColor::Zero();
+    // shadow rays are traced 8 at a time
+    ShadowRayBatch shadowRays(mScene, ctx);
 
     // TODO check only one (or few) lights per sample instead all of them
     // TODO check only nearest lights
     for (const LightSceneObject* lightObject : mScene.GetLights())
     {
-        accumulatedColor += SampleLight(lightObject, shadingData, pathState, ctx);
+        SampleLight(lightObject, shadingData, pathState, ctx, shadowRays);
     }
 
+    RayColor accumulatedColor = shadowRays.Flush();
     accumulatedColor *= RayColor::Resolve(ctx.wavelength, Spectrum(mLightSamplingWeight));
 
     return accumulatedColor;
 }
 
-const RayColor VertexConnectionAndMerging::EvaluateGlobalLights(uint32 iteration, const PathState& pathState, RenderingContext& ctx) const
+const RayColor VertexConnectionAndMerging::EvaluateGlobalLights(const PathState& pathState, RenderingContext& ctx) const
 {
     RayColor result = RayColor::Zero();
 
     for (const LightSceneObject* globalLightObject : mScene.GetGlobalLights())
     {
-        result += EvaluateLight(iteration, globalLightObject, nullptr, pathState, ctx);
+        result += EvaluateLight(globalLightObject, nullptr, pathState, ctx);
     }
 
     return result;
 }
 
-const RayColor VertexConnectionAndMerging::ConnectVertices(PathState& cameraPathState, const ShadingData& shadingData, const LightVertex& lightVertex, RenderingContext& ctx) const
+void VertexConnectionAndMerging::ConnectVertices(PathState& cameraPathState, const ShadingData& shadingData, const LightVertex& lightVertex, RenderingContext& ctx, ShadowRayBatch& shadowRays) const
 {
     // compute connection direction (from camera vertex to light vertex)
-    Vector4 lightDir = lightVertex.shadingData.intersection.frame.GetTranslation() - shadingData.intersection.frame.GetTranslation();
+    Vector4 lightDir = Vector4(lightVertex.position) - shadingData.intersection.frame.GetTranslation();
     const float distanceSqr = lightDir.SqrLength3();
     const float distance = sqrtf(distanceSqr);
     lightDir /= distance;
 
     const float cosCameraVertex = shadingData.intersection.CosTheta(lightDir);
-    const float cosLightVertex = lightVertex.shadingData.intersection.CosTheta(-lightDir);
+    const float cosLightVertex = -Vector4::Dot3(lightVertex.normal.ToVector(), lightDir);
 
     if (cosCameraVertex <= 0.0f || cosLightVertex <= 0.0f)
     {
         // line between vertices is occluded (due to backface culling)
-        return RayColor::Zero();
+        return;
     }
 
     // compute geometry term
@@ -769,31 +840,21 @@ const RayColor VertexConnectionAndMerging::ConnectVertices(PathState& cameraPath
     RT_ASSERT(cameraFactor.IsValid());
     if (cameraFactor.AlmostZero())
     {
-        return RayColor::Zero();
+        return;
     }
 
+    // re-derive light vertex shading data only for connections that weren't rejected so far
+    ShadingData lightShadingData;
+    RayColor lightThroughput;
+    lightVertex.Decode(ctx.wavelength, lightShadingData, lightThroughput);
+
     // evaluate BSDF at light vertex
     float lightBsdfPdfW, lightBsdfRevPdfW;
-    const RayColor lightFactor = lightVertex.shadingData.intersection.material->Evaluate(ctx.wavelength, lightVertex.shadingData, lightDir, &lightBsdfPdfW, &lightBsdfRevPdfW);
+    const RayColor lightFactor = lightShadingData.intersection.material->Evaluate(ctx.wavelength, lightShadingData, lightDir, &lightBsdfPdfW, &lightBsdfRevPdfW);
     RT_ASSERT(lightFactor.IsValid());
     if (lightFactor.AlmostZero())
     {
-        return RayColor::Zero();
-    }
-
-    //// cast shadow ray
-    {
-        HitPoint hitPoint;
-        hitPoint.distance = distance * 0.999f;
-
-        Ray shadowRay(shadingData.intersection.frame.GetTranslation(), lightDir);
-        shadowRay.origin += shadowRay.dir * 0.0001f;
-
-        if (mScene.Traverse_Shadow({ shadowRay, hitPoint, ctx }))
-        {
-            // line between vertices is occluded by other geometry
-            return RayColor::Zero();
-        }
+        return;
     }
 
     // TODO
@@ -817,7 +878,11 @@ const RayColor VertexConnectionAndMerging::ConnectVertices(PathState& cameraPath
     const RayColor contribution = (cameraFactor * lightFactor) * (geometryTerm * misWeight);
     RT_ASSERT(contribution.IsValid());
 
-    return contribution;
+    // queue shadow ray to check if the vertices are not occluded by other geometry
+    Ray shadowRay(shadingData.intersection.frame.GetTranslation(), lightDir);
+    shadowRay.origin += shadowRay.dir * 0.0001f;
+
+    shadowRays.Add(shadowRay, distance * 0.999f, lightThroughput * contribution);
 }
 
 const RayColor VertexConnectionAndMerging::MergeVertices(PathState& cameraPathState, const ShadingData& shadingData, RenderingContext& ctx) const
@@ -905,10 +970,10 @@ const RayColor VertexConnectionAndMerging::MergeVertices(PathState& cameraPathSt
     return query.GetContribution();
 }
 
-void VertexConnectionAndMerging::ConnectToCamera(const Camera& camera, Film& film, const LightVertex& lightVertex, RenderingContext& ctx) const
+void VertexConnectionAndMerging::ConnectToCamera(const Camera& camera, const ShadingData& shadingData, const PathState& lightPathState, RenderingContext& ctx, CameraSplatBatch& cameraSplats) const
 {
     const Vector4 cameraPos = camera.GetTransform().GetTranslation();
-    const Vector4 samplePos = lightVertex.shadingData.intersection.frame.GetTranslation();
+    const Vector4 samplePos = shadingData.intersection.frame.GetTranslation();
 
     Vector4 dirToCamera = cameraPos - samplePos;
 
@@ -919,7 +984,7 @@ void VertexConnectionAndMerging::ConnectToCamera(const Camera& camera, Film& fil
 
     // calculate BSDF contribution
     float bsdfPdfW, bsdfRevPdfW;
-    const RayColor cameraFactor = lightVertex.shadingData.intersection.material->Evaluate(ctx.wavelength, lightVertex.shadingData, -dirToCamera, &bsdfPdfW, &bsdfRevPdfW);
+    const RayColor cameraFactor = shadingData.intersection.material->Evaluate(ctx.wavelength, shadingData, -dirToCamera, &bsdfPdfW, &bsdfRevPdfW);
     RT_ASSERT(cameraFactor.IsValid());
 
     if (cameraFactor.AlmostZero())
@@ -934,37 +999,29 @@ void VertexConnectionAndMerging::ConnectToCamera(const Camera& camera, Film& fil
         return;
     }
 
-    HitPoint shadowHitPoint;
-    shadowHitPoint.distance = cameraDistance * 0.999f;
-
-    Ray shadowRay(samplePos, dirToCamera);
-    shadowRay.origin += shadowRay.dir * 0.0001f;
-
-    if (mScene.Traverse_Shadow({ shadowRay, shadowHitPoint, ctx }))
-    {
-        // vertex is occluded
-        return;
-    }
-
-    const float cosToCamera = Vector4::Dot3(dirToCamera, lightVertex.shadingData.intersection.frame[2]);
+    const float cosToCamera = Vector4::Dot3(dirToCamera, shadingData.intersection.frame[2]);
     if (cosToCamera <= FLT_EPSILON)
     {
         return;
     }
 
-    const float cameraPdfW = camera.PdfW(-dirToCamera);
+    // camera PDF is normalized over the whole film, so it has to be rescaled if there's not exactly one light path per pixel
+    const float cameraPdfW = camera.PdfW(-dirToCamera) * mPixelsPerLightPath;
     const float cameraPdfA = cameraPdfW * cosToCamera / cameraDistanceSqr;
 
     // compute MIS weight
-    const float wLight = Mis(cameraPdfA) * (mMisVertexMergingWeightFactorVC + lightVertex.dVCM + lightVertex.dVC * Mis(bsdfRevPdfW));
+    const float wLight = Mis(cameraPdfA) * (mMisVertexMergingWeightFactorVC + lightPathState.dVCM + lightPathState.dVC * Mis(bsdfRevPdfW));
     const float misWeight = 1.0f / (wLight + 1.0f);
     RT_ASSERT(misWeight >= 0.0f);
 
-    RayColor contribution = (cameraFactor * lightVertex.throughput) * (misWeight * cameraPdfA / (cosToCamera));
+    RayColor contribution = (cameraFactor * lightPathState.throughput) * (misWeight * cameraPdfA / (cosToCamera));
     contribution *= RayColor::Resolve(ctx.wavelength, Spectrum(mCameraConnectingWeight));
 
-    const Vector4 value = contribution.ConvertToTristimulus(ctx.wavelength);
-    film.AccumulateColor(filmPos, value, ctx.randomGenerator);
+    // queue shadow ray to check if the vertex is not occluded
+    Ray shadowRay(samplePos, dirToCamera);
+    shadowRay.origin += shadowRay.dir * 0.0001f;
+
+    cameraSplats.Add(shadowRay, cameraDistance * 0.999f, filmPos, contribution.ConvertToTristimulus(ctx.wavelength));
 }
 
 } // namespace rt
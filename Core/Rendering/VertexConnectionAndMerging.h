@@ -16,7 +16,11 @@
 namespace rt {
 
 struct ShadingData;
+struct Wavelength;
+class Material;
 class LightSceneObject;
+class ShadowRayBatch;
+class CameraSplatBatch;
 
 // Vertex Connection and Merging
 //
@@ -37,6 +41,8 @@ public:
 
     virtual void PreRender(uint32 passNumber, const Film& film) override;
     virtual void PreRender(uint32 passNumber, RenderingContext& ctx) override;
+    virtual uint32 GetNumLightPaths() const override;
+    virtual void TraceLightPaths(const LightPathsParam& param, RenderingContext& ctx) const override;
     virtual void PreRenderGlobal(RenderingContext& ctx) override;
     virtual void PreRenderGlobal() override;
     virtual const RayColor RenderPixel(const math::Ray& ray, const RenderParam& param, RenderingContext& ctx) const override;
@@ -49,6 +55,8 @@ public:
     math::Vector4 mCameraConnectingWeight;
 
     uint32 mMaxPathLength;
+    uint32 mNumVertexConnections;
+    float mLightPathsPerPixel;
     float mInitialMergingRadius;
     float mMinMergingRadius;
     float mMergingRadiusMultiplier;
@@ -56,10 +64,17 @@ public:
     bool mUseVertexConnection;
     bool mUseVertexMerging;
 
-    struct LightVertex
+    // compact light path vertex stored for vertex connection
+    // full shading data is re-derived only when a connection is actually evaluated
+    struct RT_ALIGN(64) LightVertex
     {
-        ShadingData shadingData;
-        RayColor throughput;
+        math::Float3 position;
+        math::PackedUnitVector3 normal;
+        math::PackedUnitVector3 tangent;
+        math::PackedUnitVector3 outgoingDir;
+        const Material* material;
+        math::Float2 texCoord;
+        math::PackedColorRgbHdr throughput;
 
         // quantities for MIS weight calculation
         float dVC;
@@ -67,6 +82,9 @@ public:
         float dVCM;
 
         uint8 pathLength;
+
+        void Encode(const ShadingData& shadingData, const RayColor& pathThroughput, const Wavelength& wavelength);
+        void Decode(const Wavelength& wavelength, ShadingData& outShadingData, RayColor& outThroughput) const;
     };
 
     struct RT_ALIGN(32) Photon
@@ -115,35 +133,48 @@ private:
     const RayColor SampleLights(const ShadingData& shadingData, const PathState& pathState, RenderingContext& ctx) const;
 
     // importance sample single light source
-    const RayColor SampleLight(const LightSceneObject* lightObject, const ShadingData& shadingData, const PathState& pathState, RenderingContext& ctx) const;
+    // the contribution is queued in the batch and accounted only if the shadow ray is not occluded
+    void SampleLight(const LightSceneObject* lightObject, const ShadingData& shadingData, const PathState& pathState, RenderingContext& ctx, ShadowRayBatch& shadowRays) const;
 
     // compute radiance from a hit local lights
-    const RayColor EvaluateLight(uint32 iteration, const LightSceneObject* lightObject, const IntersectionData* intersection, const PathState& pathState, RenderingContext& ctx) const;
+    const RayColor EvaluateLight(const LightSceneObject* lightObject, const IntersectionData* intersection, const PathState& pathState, RenderingContext& ctx) const;
 
     // compute radiance from global lights
-    const RayColor EvaluateGlobalLights(uint32 iteration, const PathState& pathState, RenderingContext& ctx) const;
+    const RayColor EvaluateGlobalLights(const PathState& pathState, RenderingContext& ctx) const;
 
     // generate initial camera ray
     bool GenerateCameraPath(PathState& path, RenderingContext& ctx) const;
 
     // generate initial light ray
     bool GenerateLightSample(PathState& pathState, RenderingContext& ctx) const;
-    void TraceLightPath(const Camera& camera, Film& film, RenderingContext& ctx) const;
+    void TraceLightPath(const Camera& camera, RenderingContext& ctx, CameraSplatBatch& cameraSplats) const;
 
     // evaluate BSDF at ray's intersection and generate scattered ray
     bool AdvancePath(PathState& path, const ShadingData& shadingData, RenderingContext& ctx, PathType pathType) const;
 
-    // connect a camera path end to a light path end and return contribution
-    const RayColor ConnectVertices(PathState& cameraPathState, const ShadingData& shadingData, const LightVertex& lightVertex, RenderingContext& ctx) const;
+    // connect a camera path end to a light path end
+    // the contribution (including light vertex throughput) is queued in the batch and accounted only if the vertices are mutually visible
+    void ConnectVertices(PathState& cameraPathState, const ShadingData& shadingData, const LightVertex& lightVertex, RenderingContext& ctx, ShadowRayBatch& shadowRays) const;
 
     // merge a camera path vertex to light vertices nearby and return contribution
     const RayColor MergeVertices(PathState& cameraPathState, const ShadingData& shadingData, RenderingContext& ctx) const;
 
     // connect a light path to camera directly and splat the contribution onto film
-    void ConnectToCamera(const Camera& camera, Film& film, const LightVertex& lightVertex, RenderingContext& ctx) const;
+    void ConnectToCamera(const Camera& camera, const ShadingData& shadingData, const PathState& lightPathState, RenderingContext& ctx, CameraSplatBatch& cameraSplats) const;
 
+    // number of light paths traced in a frame
     uint32 mLightPathsCount;
 
+    // ratio of number of pixels to number of light paths, used to rescale camera PDF
+    float mPixelsPerLightPath;
+
+    // number of light paths that recorded vertices in the light vertex pool
+    uint32 mNumPooledLightPaths;
+
+    // scales vertex connection contribution, so that connecting to a few randomly picked pool vertices
+    // estimates connecting to all vertices of a single light path
+    float mVertexConnectionNormalizationFactor;
+
     float mMergingRadiusVC;
     float mMergingRadiusVM;
 
@@ -163,6 +194,9 @@ private:
 
     // list of all recorded light photons
     DynArray<Photon> mPhotons;
+
+    // list of all recorded light vertices (light vertex pool)
+    DynArray<LightVertex> mLightVertices;
 };
 
 } // namespace rt
@@ -6,6 +6,8 @@
 #include "Utils/Logger.h"
 #include "Utils/Timer.h"
 #include "Scene/Camera.h"
+#include "Scene/Scene.h"
+#include "Traversal/TraversalContext.h"
 #include "Color/LdrColor.h"
 #include "Color/ColorHelpers.h"
 #include "Math/SamplingHelpers.h"
@@ -18,6 +20,20 @@ using namespace math;
 
 static const uint32 MAX_IMAGE_SZIE = 1 << 16;
 
+// camera without lens effects, so there's exactly one ray per film point
+static const Camera GetPinholeCamera(const Camera& camera)
+{
+    Camera result = camera;
+    result.mDOF.enable = false;
+    result.enableBarellDistortion = false;
+    return result;
+}
+
+static bool IsSameView(const Camera& a, const Camera& b)
+{
+    return a.GetLocalToWorld() == b.GetLocalToWorld() && a.mAspectRatio == b.mAspectRatio && a.mFieldOfView == b.mFieldOfView;
+}
+
 Viewport::Viewport()
 {
     InitThreadData();
@@ -41,6 +57,7 @@ void Viewport::InitThreadData()
         RenderingContext& ctx = mThreadData[i];
         ctx.randomGenerator.Reset();
         ctx.sampler.fallbackGenerator = &ctx.randomGenerator;
+        ctx.numaNode = mThreadPool.GetThreadNumaNode(i);
 
         if (mRenderer)
         {
@@ -62,30 +79,20 @@ bool Viewport::Resize(uint32 width, uint32 height)
         return true;
     }
 
-    Bitmap::InitData initData;
-    initData.linearSpace = true;
-    initData.width = width;
-    initData.height = height;
-    initData.format = Bitmap::Format::R32G32B32_Float;
-
-    if (!mSum.Init(initData))
-    {
-        return false;
-    }
-
-    if (!mSecondarySum.Init(initData))
+    if (!InitAccumulationBuffers(width, height))
     {
         return false;
     }
 
+    // blurred images are allocated on demand (only when bloom is enabled)
     for (Bitmap& blurredImage : mBlurredImages)
     {
-        if (!blurredImage.Init(initData))
-        {
-            return false;
-        }
+        blurredImage.Release();
     }
 
+    Bitmap::InitData initData;
+    initData.width = width;
+    initData.height = height;
     initData.linearSpace = false;
     initData.format = Bitmap::Format::B8G8R8A8_UNorm;
     if (!mFrontBuffer.Init(initData))
@@ -93,6 +100,10 @@ bool Viewport::Resize(uint32 width, uint32 height)
         return false;
     }
 
+    // external targets no longer match the viewport size
+    mFrontBufferTargets.Clear();
+    mFrontBufferTargetIndex = 0;
+
     mPassesPerPixel.Resize(width * height);
 
     mPixelSalt.Resize(width * height);
@@ -106,6 +117,41 @@ bool Viewport::Resize(uint32 width, uint32 height)
     return true;
 }
 
+bool Viewport::InitAccumulationBuffers(uint32 width, uint32 height)
+{
+    const bool compact = mParams.accumulationMode == AccumulationMode::CompensatedHalf;
+
+    Bitmap::InitData initData;
+    initData.linearSpace = true;
+    initData.width = width;
+    initData.height = height;
+    initData.format = compact ? Bitmap::Format::R16G16B16_Half : Bitmap::Format::R32G32B32A32_Float;
+
+    if (!mSum.Init(initData))
+    {
+        return false;
+    }
+
+    if (!mSecondarySum.Init(initData))
+    {
+        return false;
+    }
+
+    if (compact)
+    {
+        if (!mSumCompensation.Init(initData))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        mSumCompensation.Release();
+    }
+
+    return true;
+}
+
 void Viewport::SetPixelBreakpoint(uint32 x, uint32 y)
 {
 #ifndef RT_CONFIGURATION_FINAL
@@ -123,10 +169,25 @@ void Viewport::Reset()
 
     mProgress = RenderingProgress();
 
-    mHaltonSequence.Initialize(mParams.samplingParams.dimensions);
+    // cascade restarts after every reset (e.g. camera movement)
+    mResolutionCascadeLevels =
+        mParams.traversalMode == TraversalMode::Single && !IsCompactAccumulation() ?
+        mParams.resolutionCascadeLevels : 0;
+
+    mHaltonSequence.Initialize(mParams.samplingParams.dimensions, mParams.samplingParams.seed);
+
+    if (mParams.samplingParams.seed != 0)
+    {
+        mRandomGenerator.Reset(mParams.samplingParams.seed);
+        for (uint32 i = 0; i < mThreadData.Size(); ++i)
+        {
+            mThreadData[i].randomGenerator.Reset(mParams.samplingParams.seed + i + 1u);
+        }
+    }
 
     mSum.Clear();
     mSecondarySum.Clear();
+    mSumCompensation.Clear();
     for (Bitmap& blurredImage : mBlurredImages)
     {
         blurredImage.Clear();
@@ -134,12 +195,200 @@ void Viewport::Reset()
 
     memset(mPassesPerPixel.Data(), 0, sizeof(uint32) * GetWidth() * GetHeight());
 
+    // scene or viewport size could change
+    mGBufferValid = false;
+
+    BuildInitialBlocksList();
+}
+
+void Viewport::Reproject(const Camera& newCamera)
+{
+    const ReprojectionSettings& settings = mParams.reprojectionSettings;
+
+    // compact accumulation stores averages with per-tile rounding compensation, so samples can't be moved between pixels
+    if (!settings.enable || !mRenderer || !mHasLastCamera || IsCompactAccumulation())
+    {
+        Reset();
+        return;
+    }
+
+    const uint32 width = GetWidth();
+    const uint32 height = GetHeight();
+    if (width == 0 || height == 0)
+    {
+        return;
+    }
+
+    if (!InitReprojectionHistory())
+    {
+        Reset();
+        return;
+    }
+
+    if (!mGBufferValid)
+    {
+        BuildGBuffer(mLastCamera, mGBuffer);
+    }
+
+    mNewGBuffer.Resize(width * height);
+
+    const Scene& scene = mRenderer->GetScene();
+    const Camera oldCamera = GetPinholeCamera(mLastCamera);
+    const Camera camera = GetPinholeCamera(newCamera);
+    const Vector4 oldOrigin = oldCamera.GetLocalToWorld().GetTranslation();
+    const Vector4 invSize = VECTOR_ONE2 / Vector4::FromIntegers(width, height, 1, 1);
+
+    const auto taskCallback = [&](uint32 y, uint32 threadID)
+    {
+        RenderingContext& ctx = mThreadData[threadID];
+        ctx.time = 0.0f;
+
+        const uint32 realY = height - 1u - y;
+
+        for (uint32 x = 0; x < width; ++x)
+        {
+            const uint32 index = width * y + x;
+
+            const Ray ray = camera.GenerateRay(Vector4::FromIntegers(x, realY, 0, 0) * invSize, ctx);
+            HitPoint hitPoint;
+            scene.Traverse({ ray, hitPoint, ctx });
+            mNewGBuffer[index] = { hitPoint.distance, hitPoint.objectId };
+
+            // background is infinitely far, so only ray direction matters
+            const bool isHit = hitPoint.objectId != RT_INVALID_OBJECT;
+            const Vector4 worldPosition = isHit ? Vector4::MulAndAdd(ray.dir, hitPoint.distance, ray.origin) : oldOrigin + ray.dir;
+
+            uint32 numPasses = 0;
+            uint32 oldX = 0;
+            uint32 oldY = 0;
+
+            Vector4 filmCoords;
+            if (oldCamera.WorldToFilm(worldPosition, filmCoords))
+            {
+                const float oldFilmX = filmCoords.x * static_cast<float>(width) + 0.5f;
+                const float oldFilmY = filmCoords.y * static_cast<float>(height) + 0.5f;
+
+                if (oldFilmX >= 0.0f && oldFilmX < static_cast<float>(width) && oldFilmY >= 0.0f && oldFilmY < static_cast<float>(height))
+                {
+                    oldX = static_cast<uint32>(oldFilmX);
+                    oldY = height - 1u - static_cast<uint32>(oldFilmY);
+
+                    // reject disoccluded pixels: different object or different depth was visible in the previous view
+                    const GBufferPixel& oldPixel = mGBuffer[width * oldY + oldX];
+                    bool isValid = oldPixel.objectId == hitPoint.objectId;
+                    if (isValid && isHit)
+                    {
+                        const float expectedDistance = (worldPosition - oldOrigin).Length3();
+                        isValid = Abs(oldPixel.distance - expectedDistance) <= settings.depthTolerance * expectedDistance;
+                    }
+
+                    // keep even number of samples, so all the pixels in a tile agree on which samples go to the secondary sum
+                    if (isValid)
+                    {
+                        numPasses = Min(mHistoryPassesPerPixel[width * oldY + oldX], settings.maxHistoryPasses) & ~1u;
+                    }
+                }
+            }
+
+            Vector4& sum = mSum.GetPixelRef<Vector4>(x, y);
+            Vector4& secondarySum = mSecondarySum.GetPixelRef<Vector4>(x, y);
+
+            if (numPasses > 0)
+            {
+                // secondary sum contains every second sample (starting from the first one)
+                const uint32 oldNumPasses = mHistoryPassesPerPixel[width * oldY + oldX];
+                const uint32 oldNumSecondaryPasses = (oldNumPasses + 1u) / 2u;
+
+                sum = mHistorySum.GetPixelRef<Vector4>(oldX, oldY) * (static_cast<float>(numPasses) / static_cast<float>(oldNumPasses));
+                secondarySum = mHistorySecondarySum.GetPixelRef<Vector4>(oldX, oldY) * (static_cast<float>(numPasses / 2u) / static_cast<float>(oldNumSecondaryPasses));
+            }
+            else
+            {
+                sum = Vector4::Zero();
+                secondarySum = Vector4::Zero();
+            }
+
+            mPassesPerPixel[index] = numPasses;
+        }
+    };
+
+    mThreadPool.RunParallelTask(taskCallback, height);
+
+    std::swap(mGBuffer, mNewGBuffer);
+    mGBufferValid = true;
+    mLastCamera = newCamera;
+
+    mPostprocessParams.fullUpdateRequired = true;
+
+    mProgress = RenderingProgress();
+
+    // upsampling would overwrite reprojected pixels
+    mResolutionCascadeLevels = 0;
+
+    for (Bitmap& blurredImage : mBlurredImages)
+    {
+        blurredImage.Clear();
+    }
+
     BuildInitialBlocksList();
 }
 
+bool Viewport::InitReprojectionHistory()
+{
+    if (mHistorySum.GetWidth() != GetWidth() || mHistorySum.GetHeight() != GetHeight() || mHistorySum.GetFormat() != mSum.GetFormat())
+    {
+        Bitmap::InitData initData;
+        initData.linearSpace = true;
+        initData.width = GetWidth();
+        initData.height = GetHeight();
+        initData.format = mSum.GetFormat();
+
+        if (!mHistorySum.Init(initData) || !mHistorySecondarySum.Init(initData))
+        {
+            RT_LOG_ERROR("Failed to allocate reprojection history images");
+            return false;
+        }
+    }
+
+    mHistoryPassesPerPixel = mPassesPerPixel;
+
+    return Bitmap::Copy(mHistorySum, mSum) && Bitmap::Copy(mHistorySecondarySum, mSecondarySum);
+}
+
+void Viewport::BuildGBuffer(const Camera& camera, DynArray<GBufferPixel>& outGBuffer)
+{
+    const uint32 width = GetWidth();
+    const uint32 height = GetHeight();
+
+    outGBuffer.Resize(width * height);
+
+    const Scene& scene = mRenderer->GetScene();
+    const Camera pinholeCamera = GetPinholeCamera(camera);
+    const Vector4 invSize = VECTOR_ONE2 / Vector4::FromIntegers(width, height, 1, 1);
+
+    const auto taskCallback = [&](uint32 y, uint32 threadID)
+    {
+        RenderingContext& ctx = mThreadData[threadID];
+        ctx.time = 0.0f;
+
+        const uint32 realY = height - 1u - y;
+
+        for (uint32 x = 0; x < width; ++x)
+        {
+            const Ray ray = pinholeCamera.GenerateRay(Vector4::FromIntegers(x, realY, 0, 0) * invSize, ctx);
+            HitPoint hitPoint;
+            scene.Traverse({ ray, hitPoint, ctx });
+            outGBuffer[width * y + x] = { hitPoint.distance, hitPoint.objectId };
+        }
+    };
+
+    mThreadPool.RunParallelTask(taskCallback, height);
+}
+
 bool Viewport::SetRenderer(const RendererPtr& renderer)
 {
     mRenderer = renderer;
+    mGBufferValid = false;
 
     InitThreadData();
 
@@ -151,15 +400,28 @@ bool Viewport::SetRenderingParams(const RenderingParams& params)
     RT_ASSERT(params.maxRayDepth < 255u);
     RT_ASSERT(params.antiAliasingSpread >= 0.0f);
     RT_ASSERT(params.motionBlurStrength >= 0.0f && params.motionBlurStrength <= 1.0f);
+    RT_ASSERT(params.resolutionCascadeLevels <= 4u);
 
-    if (mParams.numThreads != params.numThreads)
+    if (mParams.numThreads != params.numThreads || mParams.pinThreadsToNumaNodes != params.pinThreadsToNumaNodes)
     {
-        mThreadPool.SetNumThreads(params.numThreads);
+        mThreadPool.SetNumThreads(params.numThreads, params.pinThreadsToNumaNodes);
         InitThreadData();
     }
 
+    const bool accumulationModeChanged = mParams.accumulationMode != params.accumulationMode;
+
     mParams = params;
 
+    if (accumulationModeChanged && GetWidth() > 0 && GetHeight() > 0)
+    {
+        if (!InitAccumulationBuffers(GetWidth(), GetHeight()))
+        {
+            return false;
+        }
+
+        Reset();
+    }
+
     return true;
 }
 
@@ -176,6 +438,76 @@ bool Viewport::SetPostprocessParams(const PostprocessParams& params)
     return true;
 }
 
+bool Viewport::SetFrontBufferTargets(Bitmap* const* targets, uint32 numTargets)
+{
+    for (uint32 i = 0; i < numTargets; ++i)
+    {
+        const Bitmap* bitmap = targets[i];
+        if (!bitmap || bitmap->GetFormat() != Bitmap::Format::B8G8R8A8_UNorm)
+        {
+            RT_LOG_ERROR("Viewport: Front buffer target %u must be B8G8R8A8_UNorm bitmap", i);
+            return false;
+        }
+
+        if (bitmap->GetWidth() != GetWidth() || bitmap->GetHeight() != GetHeight())
+        {
+            RT_LOG_ERROR("Viewport: Front buffer target %u size does not match the viewport size", i);
+            return false;
+        }
+    }
+
+    mFrontBufferTargets.Clear();
+    mFrontBufferTargetIndex = 0;
+
+    if (!mFrontBufferTargets.Reserve(numTargets))
+    {
+        return false;
+    }
+
+    for (uint32 i = 0; i < numTargets; ++i)
+    {
+        FrontBufferTarget target;
+        target.bitmap = targets[i];
+        mFrontBufferTargets.PushBack(std::move(target));
+    }
+
+    // the first target written will be the first one on the list
+    if (numTargets > 0)
+    {
+        mFrontBufferTargetIndex = numTargets - 1;
+    }
+
+    // internal front buffer was not updated while external targets were used
+    mPostprocessParams.fullUpdateRequired = true;
+
+    return true;
+}
+
+void Viewport::InvalidateFrontBufferTarget(const Block& region)
+{
+    if (mFrontBufferTargets.Empty())
+    {
+        return;
+    }
+
+    FrontBufferTarget& target = mFrontBufferTargets[mFrontBufferTargetIndex];
+    if (target.fullUpdateRequired)
+    {
+        return;
+    }
+
+    Block clampedRegion;
+    clampedRegion.minX = Min(region.minX, GetWidth());
+    clampedRegion.maxX = Min(region.maxX, GetWidth());
+    clampedRegion.minY = Min(region.minY, GetHeight());
+    clampedRegion.maxY = Min(region.maxY, GetHeight());
+
+    if (clampedRegion.maxX > clampedRegion.minX && clampedRegion.maxY > clampedRegion.minY)
+    {
+        SplitIntoTiles(clampedRegion, mParams.tileSize, target.pendingTiles);
+    }
+}
+
 void Viewport::ComputeError()
 {
     const Block fullImageBlock(0, GetWidth(), 0, GetHeight());
@@ -197,8 +529,19 @@ bool Viewport::Render(const Camera& camera)
         return false;
     }
 
+    // per-frame scratch data is released when leaving this function
+    FrameAllocatorScope frameAllocatorScope;
+
+    // remember the view for reprojection
+    if (!mHasLastCamera || !IsSameView(mLastCamera, camera))
+    {
+        mGBufferValid = false;
+    }
+    mLastCamera = camera;
+    mHasLastCamera = true;
+
     mHaltonSequence.NextSample();
-    DynArray<uint32> seed(mHaltonSequence.GetNumDimensions());
+    DynArray<uint32, FrameAllocator> seed(mHaltonSequence.GetNumDimensions());
     for (uint32 i = 0; i < mHaltonSequence.GetNumDimensions(); ++i)
     {
         seed[i] = mHaltonSequence.GetInt(i);
@@ -210,6 +553,7 @@ bool Viewport::Render(const Camera& camera)
         ctx.counters.Reset();
         ctx.params = &mParams;
         ctx.camera = &camera;
+        ctx.pixelSpreadAngle = 2.0f * tanf(0.5f * camera.mFieldOfView) / static_cast<float>(GetHeight());
 #ifndef RT_CONFIGURATION_FINAL
         ctx.pixelBreakpoint = mPendingPixelBreakpoint;
 #endif // RT_CONFIGURATION_FINAL
@@ -246,6 +590,14 @@ bool Viewport::Render(const Camera& camera)
             mRenderer->PreRender(mProgress.passesFinished, film);
         }
 
+        // light paths splat onto pixels the cascade hasn't rendered yet, which would stay too bright
+        if (mRenderer->GetNumLightPaths() > 0)
+        {
+            mResolutionCascadeLevels = 0;
+        }
+
+        TraceLightPaths(camera);
+
         const auto renderCallback = [&](uint32 id, uint32 threadID)
         {
             RenderTile(tileContext, mThreadData[threadID], mRenderingTiles[id]);
@@ -259,23 +611,23 @@ bool Viewport::Render(const Camera& camera)
         mRenderer->PreRenderGlobal();
 
         mThreadPool.RunParallelTask(renderCallback, mRenderingTiles.Size());
+
+        AccumulateFilmSplats();
     }
 
     PerformPostProcess();
 
     mProgress.passesFinished++;
 
-    if ((mProgress.passesFinished > 0) && (mProgress.passesFinished % 2 == 0))
+    if (mParams.adaptiveSettings.enable)
     {
-        if (mParams.adaptiveSettings.enable)
-        {
-            UpdateBlocksList();
-            GenerateRenderingTiles();
-        }
-        else
-        {
-            ComputeError();
-        }
+        // error is tracked per-pixel, so blocks can be refined after every pass
+        UpdateBlocksList();
+        GenerateRenderingTiles();
+    }
+    else if (mProgress.passesFinished % 2 == 0)
+    {
+        ComputeError();
     }
 
     // accumulate counters
@@ -288,6 +640,48 @@ bool Viewport::Render(const Camera& camera)
     return true;
 }
 
+void Viewport::TraceLightPaths(const Camera& camera)
+{
+    const uint32 numLightPaths = mRenderer->GetNumLightPaths();
+    if (numLightPaths == 0)
+    {
+        return;
+    }
+
+    const uint32 chunkSize = LightPathsChunkSize;
+    const uint32 numChunks = (numLightPaths + chunkSize - 1) / chunkSize;
+
+    const auto lightPathsCallback = [&](uint32 id, uint32 threadID)
+    {
+        const uint32 firstPath = id * chunkSize;
+        const IRenderer::LightPathsParam param = { mProgress.passesFinished, Min(chunkSize, numLightPaths - firstPath), camera };
+        mRenderer->TraceLightPaths(param, mThreadData[threadID]);
+    };
+
+    mThreadPool.RunParallelTask(lightPathsCallback, numChunks);
+}
+
+void Viewport::AccumulateFilmSplats()
+{
+    // splats are accumulated after all the tiles are flushed, so they are not affected by tiles' compact storage weights
+    // NOTE: renderers tracing light paths render every pixel in every pass, so global pass count is also the per-pixel one
+    Film film(mSum, mProgress.passesFinished % 2 == 0 ? &mSecondarySum : nullptr);
+    if (IsCompactAccumulation())
+    {
+        film.SetCompactStorage(mSumCompensation, mProgress.passesFinished);
+    }
+
+    for (RenderingContext& ctx : mThreadData)
+    {
+        const uint32 numSplats = ctx.filmSplats.Size();
+        film.AccumulateSplats(ctx.filmSplats, mRandomGenerator);
+
+        // number of splats fluctuates between frames, keep some headroom to avoid reallocations
+        ctx.filmSplats.Clear();
+        ctx.filmSplats.Reserve(numSplats + numSplats / 2 + 256);
+    }
+}
+
 void Viewport::RenderTile(const TileRenderingContext& tileContext, RenderingContext& ctx, const Block& tile)
 {
     Timer timer;
@@ -300,58 +694,148 @@ void Viewport::RenderTile(const TileRenderingContext& tileContext, RenderingCont
     const Vector4 filmSize = Vector4::FromIntegers(GetWidth(), GetHeight(), 1, 1);
     const Vector4 invSize = VECTOR_ONE2 / filmSize;
 
-    Film film(mSum, mProgress.passesFinished % 2 == 0 ? &mSecondarySum : nullptr);
+    // pixels rendered in resolution cascade pass were not rendered before
+    const uint32 cascadeStep = GetResolutionCascadeStep();
+
+    // all the pixels within a tile always have the same number of samples accumulated,
+    // because blocks are only split or removed in adaptive rendering mode
+    // (after reprojection the numbers differ, but all of them are even)
+    const uint32 numTilePasses = cascadeStep > 0 ? 0 : mPassesPerPixel[GetWidth() * tile.minY + tile.minX];
+    ctx.filmTile.Begin(tile.minX, tile.minY, tile.maxX, tile.maxY);
+    Film film(mSum, numTilePasses % 2 == 0 ? &mSecondarySum : nullptr, &ctx.filmTile);
+    if (IsCompactAccumulation())
+    {
+        film.SetCompactStorage(mSumCompensation, numTilePasses);
+    }
 
     if (ctx.params->traversalMode == TraversalMode::Single)
     {
+        // camera rays are generated in batches of 8 pixels within a row
+        constexpr uint32 batchSize = 8;
+
+        // NOTE: SIMD ray generation samples camera transform once per batch, so it can't be used when each pixel has its own time
+        const bool useSimdCamera = tileContext.camera.SupportsRayGeneration_Simd8() && ctx.params->motionBlurStrength <= 0.0f;
+        const bool useApertureSamples = tileContext.camera.mDOF.enable;
+
         for (uint32 y = tile.minY; y < tile.maxY; ++y)
         {
+            if (cascadeStep > 1 && (y & (cascadeStep - 1u)) != 0)
+            {
+                continue;
+            }
+
             const uint32 realY = GetHeight() - 1u - y;
 
-            for (uint32 x = tile.minX; x < tile.maxX; ++x)
+            for (uint32 batchX = tile.minX; batchX < tile.maxX; batchX += batchSize)
             {
-#ifndef RT_CONFIGURATION_FINAL
-                if (ctx.pixelBreakpoint.x == x && ctx.pixelBreakpoint.y == y)
-                {
-                    RT_BREAK();
-                }
-#endif // RT_CONFIGURATION_FINAL
+                const uint32 numPixels = Min(batchSize, tile.maxX - batchX);
 
-                const uint32 pixelIndex = y * GetHeight() + x;
-                const Vector4 coords = (Vector4::FromIntegers(x, realY, 0, 0) + tileContext.sampleOffset) * invSize;
+                Vector2x8 coords{ Vector8::FromInteger(batchX), Vector8::FromInteger(realY) };
+                coords.x += Vector8(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+                coords.x += Vector8(tileContext.sampleOffset.x);
+                coords.y += Vector8(tileContext.sampleOffset.y);
+                coords.x *= invSize.x;
+                coords.y *= invSize.y;
+
+                const Vector8 times = ctx.randomGenerator.GetVector8() * ctx.params->motionBlurStrength;
 
-                ctx.sampler.ResetPixel(x, y);
-                ctx.time = ctx.randomGenerator.GetFloat() * ctx.params->motionBlurStrength;
+                // draw per-pixel camera samples
+                GenericSampler::PixelState samplerStates[batchSize];
 #ifdef RT_ENABLE_SPECTRAL_RENDERING
-                ctx.wavelength.Randomize(ctx.sampler.GetFloat());
+                Wavelength wavelengths[batchSize];
 #endif // RT_ENABLE_SPECTRAL_RENDERING
+                Ray rays[batchSize];
+                Vector2x8 apertureSamples = Vector2x8::Zero();
 
-                // generate primary ray
-                const Ray ray = tileContext.camera.GenerateRay(coords, ctx);
-                const IRenderer::RenderParam renderParam = { mProgress.passesFinished, pixelIndex, tileContext.camera, film };
-
-                if (ctx.params->visualizeTimePerPixel)
+                for (uint32 i = 0; i < numPixels; ++i)
                 {
-                    timer.Start();
+                    ctx.sampler.ResetPixel(batchX + i, y);
+                    ctx.time = times[i];
+#ifdef RT_ENABLE_SPECTRAL_RENDERING
+                    ctx.wavelength.Randomize(ctx.sampler.GetFloat());
+                    wavelengths[i] = ctx.wavelength;
+#endif // RT_ENABLE_SPECTRAL_RENDERING
+
+                    if (!useSimdCamera)
+                    {
+                        rays[i] = tileContext.camera.GenerateRay(Vector4(coords.x[i], coords.y[i], 0.0f, 0.0f), ctx);
+                    }
+                    else if (useApertureSamples)
+                    {
+                        apertureSamples.x[i] = ctx.sampler.GetFloat();
+                        apertureSamples.y[i] = ctx.sampler.GetFloat();
+                    }
+
+                    samplerStates[i] = ctx.sampler.GetPixelState();
                 }
 
-                RayColor color = tileContext.renderer.RenderPixel(ray, renderParam, ctx);
-                RT_ASSERT(color.IsValid());
-
-                if (ctx.params->visualizeTimePerPixel)
+                if (useSimdCamera)
                 {
-                    const float timePerRay = 1000.0f * static_cast<float>(timer.Stop());
-                    color = RayColor(timePerRay);
+                    // no motion blur - all the lanes share the same time
+                    ctx.time = times[0];
+
+                    const Ray_Simd8 simdRays = tileContext.camera.GenerateRay_Simd8(coords, apertureSamples, ctx);
+
+                    Vector4 origins[batchSize];
+                    Vector4 directions[batchSize];
+                    simdRays.origin.Unpack(origins);
+                    simdRays.dir.Unpack(directions);
+
+                    for (uint32 i = 0; i < numPixels; ++i)
+                    {
+                        rays[i] = Ray(origins[i], directions[i]);
+                    }
                 }
 
-                const Vector4 sampleColor = color.ConvertToTristimulus(ctx.wavelength);
+                for (uint32 i = 0; i < numPixels; ++i)
+                {
+                    const uint32 x = batchX + i;
+
+                    if (cascadeStep > 0 && !IsResolutionCascadePixel(x, y, cascadeStep))
+                    {
+                        continue;
+                    }
+
+#ifndef RT_CONFIGURATION_FINAL
+                    if (ctx.pixelBreakpoint.x == x && ctx.pixelBreakpoint.y == y)
+                    {
+                        RT_BREAK();
+                    }
+#endif // RT_CONFIGURATION_FINAL
+
+                    const uint32 pixelIndex = y * GetWidth() + x;
+
+                    ctx.sampler.SetPixelState(samplerStates[i]);
+                    ctx.time = times[i];
+#ifdef RT_ENABLE_SPECTRAL_RENDERING
+                    ctx.wavelength = wavelengths[i];
+#endif // RT_ENABLE_SPECTRAL_RENDERING
+
+                    const IRenderer::RenderParam renderParam = { mProgress.passesFinished, pixelIndex, tileContext.camera, film };
+
+                    if (ctx.params->visualizeTimePerPixel)
+                    {
+                        timer.Start();
+                    }
+
+                    RayColor color = tileContext.renderer.RenderPixel(rays[i], renderParam, ctx);
+                    RT_ASSERT(color.IsValid());
+
+                    if (ctx.params->visualizeTimePerPixel)
+                    {
+                        const float timePerRay = 1000.0f * static_cast<float>(timer.Stop());
+                        color = RayColor(timePerRay);
+                    }
+
+                    const Vector4 sampleColor = color.ConvertToTristimulus(ctx.wavelength);
 
 #ifndef RT_ENABLE_SPECTRAL_RENDERING
-                // exception: in spectral rendering these values can get below zero due to RGB->Spectrum conversion
-                RT_ASSERT((sampleColor >= Vector4::Zero()).All());
+                    // exception: in spectral rendering these values can get below zero due to RGB->Spectrum conversion
+                    RT_ASSERT((sampleColor >= Vector4::Zero()).All());
 #endif // RT_ENABLE_SPECTRAL_RENDERING
 
-                film.AccumulateColor(x, y, sampleColor);
+                    film.AccumulateColor(x, y, sampleColor);
+                }
             }
         }
     }
@@ -426,7 +910,92 @@ void Viewport::RenderTile(const TileRenderingContext& tileContext, RenderingCont
         ctx.counters.Append(ctx.localCounters);
     }
 
+    film.FlushTile();
+
+    if (cascadeStep > 0)
+    {
+        uint64 numRenderedPixels = 0;
+        for (uint32 y = tile.minY; y < tile.maxY; ++y)
+        {
+            uint32* rowPasses = mPassesPerPixel.Data() + GetWidth() * y;
+            for (uint32 x = tile.minX; x < tile.maxX; ++x)
+            {
+                if (IsResolutionCascadePixel(x, y, cascadeStep))
+                {
+                    rowPasses[x]++;
+                    numRenderedPixels++;
+                }
+            }
+        }
+
+        ctx.counters.numPrimaryRays += numRenderedPixels;
+        return;
+    }
+
     ctx.counters.numPrimaryRays += (uint64)(tile.maxY - tile.minY) * (uint64)(tile.maxX - tile.minX);
+
+    for (uint32 y = tile.minY; y < tile.maxY; ++y)
+    {
+        uint32* rowPasses = mPassesPerPixel.Data() + GetWidth() * y;
+        for (uint32 x = tile.minX; x < tile.maxX; ++x)
+        {
+            rowPasses[x]++;
+        }
+    }
+}
+
+uint32 Viewport::GetResolutionCascadeStep() const
+{
+    if (mResolutionCascadeLevels == 0 || mProgress.passesFinished > mResolutionCascadeLevels)
+    {
+        return 0;
+    }
+
+    // the last cascade pass renders all the remaining pixels
+    return 1u << (mResolutionCascadeLevels - mProgress.passesFinished);
+}
+
+void Viewport::UpsampleResolutionCascade(Bitmap& target, uint32 step)
+{
+    RT_ASSERT(step > 1 && (step & (step - 1u)) == 0, "Step must be power of two");
+
+    const uint32 numBands = mThreadPool.GetNumThreads();
+    const uint32 mask = ~(step - 1u);
+
+    // NOTE: rendered pixels are only read, so the bands can be processed in parallel
+    const auto taskCallback = [this, &target, numBands, step, mask](uint32 id, uint32)
+    {
+        const uint32 minY = GetHeight() * id / numBands;
+        const uint32 maxY = GetHeight() * (id + 1) / numBands;
+        const uint32 width = GetWidth();
+
+        for (uint32 y = minY; y < maxY; ++y)
+        {
+            uint32* targetRow = &target.GetPixelRef<uint32>(0, y);
+
+            if ((y & mask) != y)
+            {
+                const uint32* sourceRow = &target.GetPixelRef<uint32>(0, y & mask);
+                for (uint32 x = 0; x < width; ++x)
+                {
+                    targetRow[x] = sourceRow[x & mask];
+                }
+            }
+            else
+            {
+                for (uint32 x = 0; x < width; x += step)
+                {
+                    const uint32 value = targetRow[x];
+                    for (uint32 i = x + 1; i < Min(x + step, width); ++i)
+                    {
+                        targetRow[i] = value;
+                    }
+                }
+            }
+        }
+    };
+
+    mThreadPool.RunParallelTask(taskCallback, numBands);
 }
 
 void Viewport::PerformPostProcess()
@@ -438,7 +1007,30 @@ void Viewport::PerformPostProcess()
         float blurSigma = 2.0f;
         for (uint32 i = 0; i < mBlurredImages.Size(); ++i)
         {
-            Bitmap::Copy(mBlurredImages[i], i == 0 ? mSum : mBlurredImages[i - 1]);
+            if (mBlurredImages[i].GetWidth() != GetWidth() || mBlurredImages[i].GetHeight() != GetHeight())
+            {
+                Bitmap::InitData initData;
+                initData.linearSpace = true;
+                initData.width = GetWidth();
+                initData.height = GetHeight();
+                initData.format = Bitmap::Format::R32G32B32_Float;
+
+                if (!mBlurredImages[i].Init(initData))
+                {
+                    RT_LOG_ERROR("Failed to allocate bloom image");
+                    return;
+                }
+            }
+
+            if (i == 0)
+            {
+                // pixels can have different number of samples, so blur the normalized image
+                ResolveSum(mBlurredImages[i]);
+            }
+            else
+            {
+                Bitmap::Copy(mBlurredImages[i], mBlurredImages[i - 1]);
+            }
             mBlurredImages[i].GaussianBlur(blurSigma, 8);
             blurSigma *= 2.5f;
         }
@@ -452,13 +1044,39 @@ void Viewport::PerformPostProcess()
 
     mPostprocessParams.colorScale = mPostprocessParams.params.colorFilter * powf(2.0f, mPostprocessParams.params.exposure);
 
-    if (mPostprocessParams.fullUpdateRequired)
+    Bitmap* target = &mFrontBuffer;
+    bool fullUpdateRequired = mPostprocessParams.fullUpdateRequired;
+    DynArray<Block>* pendingTiles = nullptr;
+
+    if (!mFrontBufferTargets.Empty())
+    {
+        if (mPostprocessParams.fullUpdateRequired)
+        {
+            for (FrontBufferTarget& frontBufferTarget : mFrontBufferTargets)
+            {
+                frontBufferTarget.fullUpdateRequired = true;
+                frontBufferTarget.pendingTiles.Clear();
+            }
+        }
+
+        mFrontBufferTargetIndex = (mFrontBufferTargetIndex + 1) % mFrontBufferTargets.Size();
+
+        FrontBufferTarget& frontBufferTarget = mFrontBufferTargets[mFrontBufferTargetIndex];
+        target = frontBufferTarget.bitmap;
+        fullUpdateRequired = frontBufferTarget.fullUpdateRequired;
+        pendingTiles = &frontBufferTarget.pendingTiles;
+        frontBufferTarget.fullUpdateRequired = false;
+    }
+
+    mPostprocessParams.fullUpdateRequired = false;
+
+    if (fullUpdateRequired)
     {
         // post processing params has changed, perfrom full image update
 
         const uint32 numTiles = mThreadPool.GetNumThreads();
 
-        const auto taskCallback = [this, numTiles](uint32 id, uint32 threadID)
+        const auto taskCallback = [this, numTiles, target](uint32 id, uint32 threadID)
         {
             Block block;
             block.minY = GetHeight() * id / numTiles;
@@ -466,87 +1084,334 @@ void Viewport::PerformPostProcess()
             block.minX = 0;
             block.maxX = GetWidth();
 
-            PostProcessTile(block, threadID);
+            PostProcessTile(block, *target, threadID);
         };
 
         mThreadPool.RunParallelTask(taskCallback, numTiles);
-
-        mPostprocessParams.fullUpdateRequired = false;
     }
     else
     {
         // apply post proces on active blocks only
+        PostProcessTiles(mRenderingTiles, *target);
 
-        if (!mRenderingTiles.Empty())
+        // regions changed while other targets were written, or overwritten by the caller
+        if (pendingTiles)
         {
-            const auto taskCallback = [this](uint32 id, uint32 threadID)
+            PostProcessTiles(*pendingTiles, *target);
+        }
+    }
+
+    const uint32 cascadeStep = GetResolutionCascadeStep();
+    if (cascadeStep > 1)
+    {
+        UpsampleResolutionCascade(*target, cascadeStep);
+    }
+
+    if (pendingTiles)
+    {
+        pendingTiles->Clear();
+
+        // other targets missed tiles rendered in this pass
+        for (uint32 i = 0; i < mFrontBufferTargets.Size(); ++i)
+        {
+            FrontBufferTarget& frontBufferTarget = mFrontBufferTargets[i];
+            if (i != mFrontBufferTargetIndex && !frontBufferTarget.fullUpdateRequired)
             {
-                PostProcessTile(mRenderingTiles[id], threadID);
-            };
+                for (const Block& tile : mRenderingTiles)
+                {
+                    frontBufferTarget.pendingTiles.PushBack(tile);
+                }
+            }
+        }
+    }
+}
+
+void Viewport::PostProcessTiles(const ArrayView<Block>& tiles, Bitmap& target)
+{
+    if (tiles.Empty())
+    {
+        return;
+    }
+
+    const auto taskCallback = [this, &tiles, &target](uint32 id, uint32 threadID)
+    {
+        PostProcessTile(tiles[id], target, threadID);
+    };
+
+    mThreadPool.RunParallelTask(taskCallback, tiles.Size());
+}
+
+const Vector4 Viewport::LoadPixelAverage(const Bitmap& sum, uint32 x, uint32 y, uint32 numPasses) const
+{
+    if (IsCompactAccumulation())
+    {
+        // the image already holds averaged values
+        return Vector4_Load_Half3(&sum.GetPixelRef<Half3>(x, y).x);
+    }
+
+    const float pixelScaling = numPasses > 0 ? 1.0f / (float)numPasses : 0.0f;
+    return sum.GetPixelRef<Vector4>(x, y) * pixelScaling;
+}
 
-            mThreadPool.RunParallelTask(taskCallback, mRenderingTiles.Size());
+const Vector4 Viewport::GetPixelAverage(uint32 x, uint32 y) const
+{
+    Vector4 result = LoadPixelAverage(mSum, x, y, GetNumPixelPasses(x, y));
+    if (IsCompactAccumulation())
+    {
+        result += Vector4_Load_Half3(&mSumCompensation.GetPixelRef<Half3>(x, y).x);
+    }
+    return result;
+}
+
+void Viewport::ResolveSum(Bitmap& target) const
+{
+    RT_ASSERT(target.GetFormat() == Bitmap::Format::R32G32B32_Float);
+    RT_ASSERT(target.GetWidth() == GetWidth() && target.GetHeight() == GetHeight());
+
+    for (uint32 y = 0; y < GetHeight(); ++y)
+    {
+        const uint32* rowPasses = mPassesPerPixel.Data() + GetWidth() * y;
+        for (uint32 x = 0; x < GetWidth(); ++x)
+        {
+            Vector4 value = LoadPixelAverage(mSum, x, y, rowPasses[x]);
+            if (IsCompactAccumulation())
+            {
+                value += Vector4_Load_Half3(&mSumCompensation.GetPixelRef<Half3>(x, y).x);
+            }
+            target.GetPixelRef<Float3>(x, y) = value.ToFloat3();
         }
     }
 }
 
-void Viewport::PostProcessTile(const Block& block, uint32 threadID)
+template<Tonemapper tonemapper, bool useBloom>
+const VectorInt8 Viewport::PostProcessPixels_Simd8(uint32 x, uint32 y, uint32 numPixels, Random& randomGenerator) const
 {
-    Random& randomGenerator = mThreadData[threadID].randomGenerator;
+    RT_ASSERT(numPixels > 0 && numPixels <= 8);
+    RT_ASSERT(x + numPixels <= GetWidth());
 
-    const bool useBloom = mPostprocessParams.params.bloomFactor > 0.0f && !mBlurredImages.Empty();
-    const float bloomWeights[] = { 0.35f, 0.25f, 0.15f, 0.15f, 0.1f };
+    const PostprocessParams& params = mPostprocessParams.params;
 
-    const float pixelScaling = 1.0f / (float)(1u + mProgress.passesFinished);
-  
-    for (uint32 y = block.minY; y < block.maxY; ++y)
+    Vector3x8 rgbColor;
+
+    if (IsCompactAccumulation())
     {
-        for (uint32 x = block.minX; x < block.maxX; ++x)
+        // the image already holds averaged values
+        const Half3* sumRow = &mSum.GetPixelRef<Half3>(0, y);
+        const Half3* compensationRow = &mSumCompensation.GetPixelRef<Half3>(0, y);
+
+        Vector4 values[8];
+        for (uint32 i = 0; i < 8; ++i)
         {
-            const Vector4 rawValue = Vector4_Load_Float3_Unsafe(mSum.GetPixelRef<Float3>(x, y));
-#ifdef RT_ENABLE_SPECTRAL_RENDERING
-            Vector4 rgbColor = Vector4::Max(Vector4::Zero(), ConvertXYZtoRGB(rawValue));
-#else
-            Vector4 rgbColor = rawValue;
-#endif
+            const uint32 pixelX = x + Min(i, numPixels - 1u);
+            values[i] = Vector4_Load_Half3(&sumRow[pixelX].x) + Vector4_Load_Half3(&compensationRow[pixelX].x);
+        }
 
-            // add bloom
-            if (useBloom)
+        rgbColor = Vector3x8(values[0], values[1], values[2], values[3], values[4], values[5], values[6], values[7]);
+    }
+    else
+    {
+        const uint32* rowPasses = mPassesPerPixel.Data() + GetWidth() * y;
+        const Vector4* sumRow = &mSum.GetPixelRef<Vector4>(0, y);
+
+        Vector8 numPasses;
+
+        if (numPixels == 8)
+        {
+            numPasses = VectorInt8::Cast(Vector8(reinterpret_cast<const float*>(rowPasses + x))).ConvertToFloat();
+
+            rgbColor = Vector3x8(
+                sumRow[x + 0], sumRow[x + 1], sumRow[x + 2], sumRow[x + 3],
+                sumRow[x + 4], sumRow[x + 5], sumRow[x + 6], sumRow[x + 7]);
+        }
+        else
+        {
+            // partial group - replicate last valid pixel in the remaining lanes
+            uint32 indices[8];
+            Vector4 values[8];
+            for (uint32 i = 0; i < 8; ++i)
             {
-                rgbColor *= 1.0f - mPostprocessParams.params.bloomFactor;
+                indices[i] = x + Min(i, numPixels - 1u);
+                values[i] = sumRow[indices[i]];
+            }
 
-                Vector4 bloomColor = Vector4::Zero();
-                for (uint32 i = 0; i < mBlurredImages.Size(); ++i)
-                {
-                    const Vector4 blurredColor = Vector4_Load_Float3_Unsafe(mBlurredImages[i].GetPixelRef<Float3>(x, y));
-                    bloomColor = Vector4::MulAndAdd(blurredColor, bloomWeights[i], bloomColor);
-                }
-                rgbColor = Vector4::MulAndAdd(bloomColor, mPostprocessParams.params.bloomFactor, rgbColor);
+            numPasses = VectorInt8(
+                rowPasses[indices[0]], rowPasses[indices[1]], rowPasses[indices[2]], rowPasses[indices[3]],
+                rowPasses[indices[4]], rowPasses[indices[5]], rowPasses[indices[6]], rowPasses[indices[7]]).ConvertToFloat();
+
+            rgbColor = Vector3x8(values[0], values[1], values[2], values[3], values[4], values[5], values[6], values[7]);
+        }
+
+        // scale down by number of samples accumulated in the pixel
+        const Vector8 pixelScaling = Vector8::Select(Vector8::Reciprocal(numPasses), Vector8::Zero(), numPasses == Vector8::Zero());
+        rgbColor = rgbColor * pixelScaling;
+    }
+
+#ifdef RT_ENABLE_SPECTRAL_RENDERING
+    {
+        const Vector3x8 xyzColor = rgbColor;
+        rgbColor.x = Vector8::MulAndAdd(xyzColor.x, XYZtoRGB_r.x, Vector8::MulAndAdd(xyzColor.y, XYZtoRGB_r.y, xyzColor.z * XYZtoRGB_r.z));
+        rgbColor.y = Vector8::MulAndAdd(xyzColor.x, XYZtoRGB_g.x, Vector8::MulAndAdd(xyzColor.y, XYZtoRGB_g.y, xyzColor.z * XYZtoRGB_g.z));
+        rgbColor.z = Vector8::MulAndAdd(xyzColor.x, XYZtoRGB_b.x, Vector8::MulAndAdd(xyzColor.y, XYZtoRGB_b.y, xyzColor.z * XYZtoRGB_b.z));
+        rgbColor.x = Vector8::Max(Vector8::Zero(), rgbColor.x);
+        rgbColor.y = Vector8::Max(Vector8::Zero(), rgbColor.y);
+        rgbColor.z = Vector8::Max(Vector8::Zero(), rgbColor.z);
+    }
+#endif // RT_ENABLE_SPECTRAL_RENDERING
+
+    // add bloom (blurred images are already normalized)
+    if (useBloom)
+    {
+        const float bloomWeights[] = { 0.35f, 0.25f, 0.15f, 0.15f, 0.1f };
+
+        rgbColor = rgbColor * (1.0f - params.bloomFactor);
+
+        Vector3x8 bloomColor = Vector3x8::Zero();
+        for (uint32 i = 0; i < mBlurredImages.Size(); ++i)
+        {
+            const Float3* blurredRow = &mBlurredImages[i].GetPixelRef<Float3>(0, y);
+            Vector4 values[8];
+            for (uint32 j = 0; j < 8; ++j)
+            {
+                values[j] = Vector4_Load_Float3_Unsafe(blurredRow[x + Min(j, numPixels - 1u)]);
             }
 
-            // scale down by number of rendering passes finished
-            // TODO support different number of passes per-pixel (adaptive rendering)
-            rgbColor *= pixelScaling;
+            const Vector3x8 blurredColor(values[0], values[1], values[2], values[3], values[4], values[5], values[6], values[7]);
+            bloomColor = Vector3x8::MulAndAdd(blurredColor, Vector8(bloomWeights[i] * params.bloomFactor), bloomColor);
+        }
 
-            // apply saturation
-            const float grayscale = Vector4::Dot3(rgbColor, Vector4(0.2126f, 0.7152f, 0.0722f));
-            rgbColor = Vector4::Max(Vector4::Zero(), Vector4::Lerp(Vector4(grayscale), rgbColor, mPostprocessParams.params.saturation));
+        rgbColor += bloomColor;
+    }
+
+    // apply saturation
+    {
+        const Vector8 grayscale = Vector8::MulAndAdd(rgbColor.x, Vector8(0.2126f), Vector8::MulAndAdd(rgbColor.y, Vector8(0.7152f), rgbColor.z * 0.0722f));
+        rgbColor.x = Vector8::Max(Vector8::Zero(), Vector8::Lerp(grayscale, rgbColor.x, params.saturation));
+        rgbColor.y = Vector8::Max(Vector8::Zero(), Vector8::Lerp(grayscale, rgbColor.y, params.saturation));
+        rgbColor.z = Vector8::Max(Vector8::Zero(), Vector8::Lerp(grayscale, rgbColor.z, params.saturation));
+    }
+
+    // apply contrast
+    rgbColor.x = FastExp(FastLog(rgbColor.x) * params.contrast);
+    rgbColor.y = FastExp(FastLog(rgbColor.y) * params.contrast);
+    rgbColor.z = FastExp(FastLog(rgbColor.z) * params.contrast);
+
+    // apply exposure
+    rgbColor *= Vector3x8(mPostprocessParams.colorScale);
+
+    // apply tonemapping (the switch inside is resolved at compile time)
+    const Vector8 dither = randomGenerator.GetVector8Bipolar() * params.ditheringStrength;
+    const Vector8 r = ToneMap(rgbColor.x, tonemapper) + dither;
+    const Vector8 g = ToneMap(rgbColor.y, tonemapper) + dither;
+    const Vector8 b = ToneMap(rgbColor.z, tonemapper) + dither;
+
+    // convert to B8G8R8A8 (with clamping)
+    const VectorInt8 minValue = VectorInt8::Zero();
+    const VectorInt8 maxValue(255);
+    const VectorInt8 rInt = VectorInt8::Min(maxValue, VectorInt8::Max(minValue, VectorInt8::Convert(r * VECTOR8_255)));
+    const VectorInt8 gInt = VectorInt8::Min(maxValue, VectorInt8::Max(minValue, VectorInt8::Convert(g * VECTOR8_255)));
+    const VectorInt8 bInt = VectorInt8::Min(maxValue, VectorInt8::Max(minValue, VectorInt8::Convert(b * VECTOR8_255)));
+    return (rInt << 16) | (gInt << 8) | bInt;
+}
+
+template<Tonemapper tonemapper, bool useBloom>
+void Viewport::PostProcessTile_Simd8(const Block& block, Bitmap& target, uint32 threadID)
+{
+    Random& randomGenerator = mThreadData[threadID].randomGenerator;
 
-            // apply contrast
-            rgbColor = FastExp(FastLog(rgbColor) * mPostprocessParams.params.contrast);
+    for (uint32 y = block.minY; y < block.maxY; ++y)
+    {
+        uint32* targetRow = &target.GetPixelRef<uint32>(0, y);
 
-            // apply exposure
-            rgbColor *= mPostprocessParams.colorScale;
+        uint32 x = block.minX;
 
-            // apply tonemapping
-            const Vector4 toneMapped = ToneMap(rgbColor, mPostprocessParams.params.tonemapper);
+        // process leading pixels, so the stores in the main loop are aligned
+        const uint32 misalignment = static_cast<uint32>(reinterpret_cast<size_t>(targetRow + x) % 32u) / sizeof(uint32);
+        if (misalignment > 0)
+        {
+            const uint32 numPixels = Min(8u - misalignment, block.maxX - x);
+            const VectorInt8 packed = PostProcessPixels_Simd8<tonemapper, useBloom>(x, y, numPixels, randomGenerator);
+            for (uint32 i = 0; i < numPixels; ++i)
+            {
+                targetRow[x + i] = static_cast<uint32>(packed[i]);
+            }
+            x += numPixels;
+        }
 
-            // add dither
-            // TODO blue noise dithering
-            const Vector4 dithered = Vector4::MulAndAdd(randomGenerator.GetVector4Bipolar(), mPostprocessParams.params.ditheringStrength, toneMapped);
+        for (; x + 8 <= block.maxX; x += 8)
+        {
+            const VectorInt8 packed = PostProcessPixels_Simd8<tonemapper, useBloom>(x, y, 8, randomGenerator);
+#ifdef RT_USE_AVX
+            // front buffer is not read back while post processing, so bypass the cache
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(targetRow + x), packed);
+#else
+            memcpy(targetRow + x, &packed, sizeof(VectorInt8));
+#endif // RT_USE_AVX
+        }
 
-            mFrontBuffer.GetPixelRef<uint32>(x, y) = dithered.ToBGR();
+        if (x < block.maxX)
+        {
+            const uint32 numPixels = block.maxX - x;
+            const VectorInt8 packed = PostProcessPixels_Simd8<tonemapper, useBloom>(x, y, numPixels, randomGenerator);
+            for (uint32 i = 0; i < numPixels; ++i)
+            {
+                targetRow[x + i] = static_cast<uint32>(packed[i]);
+            }
         }
     }
+
+#ifdef RT_USE_SSE
+    // make non-temporal stores globally visible
+    _mm_sfence();
+#endif // RT_USE_SSE
+}
+
+void Viewport::PostProcessTile(const Block& block, Bitmap& target, uint32 threadID)
+{
+    using KernelFunc = void (Viewport::*)(const Block&, Bitmap&, uint32);
+
+    // [tonemapper][use bloom]
+    static const KernelFunc kernels[][2] =
+    {
+        { &Viewport::PostProcessTile_Simd8<Tonemapper::Clamped, false>,                          &Viewport::PostProcessTile_Simd8<Tonemapper::Clamped, true> },
+        { &Viewport::PostProcessTile_Simd8<Tonemapper::Reinhard, false>,                         &Viewport::PostProcessTile_Simd8<Tonemapper::Reinhard, true> },
+        { &Viewport::PostProcessTile_Simd8<Tonemapper::JimHejland_RichardBurgessDawson, false>,  &Viewport::PostProcessTile_Simd8<Tonemapper::JimHejland_RichardBurgessDawson, true> },
+        { &Viewport::PostProcessTile_Simd8<Tonemapper::ACES, false>,                             &Viewport::PostProcessTile_Simd8<Tonemapper::ACES, true> },
+    };
+
+    const uint32 tonemapperIndex = static_cast<uint32>(mPostprocessParams.params.tonemapper);
+    RT_ASSERT(tonemapperIndex < sizeof(kernels) / sizeof(kernels[0]), "Invalid tonemapper");
+
+    // blurred images are allocated on demand, so make sure they are ready
+    const bool useBloom =
+        mPostprocessParams.params.bloomFactor > 0.0f &&
+        !mBlurredImages.Empty() &&
+        mBlurredImages[mBlurredImages.Size() - 1].GetWidth() == GetWidth();
+
+    (this->*kernels[tonemapperIndex][useBloom ? 1 : 0])(block, target, threadID);
+}
+
+float Viewport::ComputePixelError(uint32 x, uint32 y) const
+{
+    const uint32 numPasses = mPassesPerPixel[GetWidth() * y + x];
+    if (numPasses == 0)
+    {
+        return 0.0f;
+    }
+
+    // secondary sum contains every second sample (starting from the first one)
+    const uint32 numSecondaryPasses = (numPasses + 1u) / 2u;
+
+    const Vector4 a = GetPixelAverage(x, y);
+    const Vector4 b = LoadPixelAverage(mSecondarySum, x, y, numSecondaryPasses);
+    const Vector4 diff = Vector4::Abs(a - b);
+    return (diff.x + 2.0f * diff.y + diff.z) / Sqrt(RT_EPSILON + a.x + 2.0f * a.y + a.z);
+}
+
+float Viewport::NormalizeBlockError(float totalError, const Block& block) const
+{
+    const uint32 totalArea = GetWidth() * GetHeight();
+    const uint32 blockArea = block.Width() * block.Height();
+    return totalError * Sqrt((float)blockArea / (float)totalArea) / (float)blockArea;
 }
 
 float Viewport::ComputeBlockError(const Block& block) const
@@ -556,62 +1421,55 @@ float Viewport::ComputeBlockError(const Block& block) const
         return std::numeric_limits<float>::max();
     }
 
-    RT_ASSERT(mProgress.passesFinished % 2 == 0, "This funcion can be only called after even number of passes");
-
-    const float imageScalingFactor = 1.0f / (float)mProgress.passesFinished;
-
     float totalError = 0.0f;
     for (uint32 y = block.minY; y < block.maxY; ++y)
     {
         float rowError = 0.0f;
         for (uint32 x = block.minX; x < block.maxX; ++x)
         {
-            const Vector4 a = imageScalingFactor * Vector4_Load_Float3_Unsafe(mSum.GetPixelRef<Float3>(x, y));
-            const Vector4 b = (2.0f * imageScalingFactor) * Vector4_Load_Float3_Unsafe(mSecondarySum.GetPixelRef<Float3>(x, y));
-            const Vector4 diff = Vector4::Abs(a - b);
-            const float error = (diff.x + 2.0f * diff.y + diff.z) / Sqrt(RT_EPSILON + a.x + 2.0f * a.y + a.z);
-            rowError += error;
+            rowError += ComputePixelError(x, y);
         }
         totalError += rowError;
     }
 
-    const uint32 totalArea = GetWidth() * GetHeight();
-    const uint32 blockArea = block.Width() * block.Height();
-    return totalError * Sqrt((float)blockArea / (float)totalArea) / (float)blockArea;
+    return NormalizeBlockError(totalError, block);
 }
 
-void Viewport::GenerateRenderingTiles()
+void Viewport::SplitIntoTiles(const Block& block, uint32 tileSize, DynArray<Block>& outTiles)
 {
-    mRenderingTiles.Clear();
-    mRenderingTiles.Reserve(mBlocks.Size());
+    const uint32 rows = 1 + (block.Height() - 1) / tileSize;
+    const uint32 columns = 1 + (block.Width() - 1) / tileSize;
 
-    const uint32 tileSize = mParams.tileSize;
+    Block tile;
 
-    for (const Block& block : mBlocks)
+    for (uint32 j = 0; j < rows; ++j)
     {
-        const uint32 rows = 1 + (block.Height() - 1) / tileSize;
-        const uint32 columns = 1 + (block.Width() - 1) / tileSize;
+        tile.minY = block.minY + j * tileSize;
+        tile.maxY = Min(block.maxY, block.minY + j * tileSize + tileSize);
+        RT_ASSERT(tile.maxY > tile.minY);
 
-        Block tile;
-
-        for (uint32 j = 0; j < rows; ++j)
+        for (uint32 i = 0; i < columns; ++i)
         {
-            tile.minY = block.minY + j * tileSize;
-            tile.maxY = Min(block.maxY, block.minY + j * tileSize + tileSize);
-            RT_ASSERT(tile.maxY > tile.minY);
+            tile.minX = block.minX + i * tileSize;
+            tile.maxX = Min(block.maxX, block.minX + i * tileSize + tileSize);
+            RT_ASSERT(tile.maxX > tile.minX);
 
-            for (uint32 i = 0; i < columns; ++i)
-            {
-                tile.minX = block.minX + i * tileSize;
-                tile.maxX = Min(block.maxX, block.minX + i * tileSize + tileSize);
-                RT_ASSERT(tile.maxX > tile.minX);
-
-                mRenderingTiles.PushBack(tile);
-            }
+            outTiles.PushBack(tile);
         }
     }
 }
 
+void Viewport::GenerateRenderingTiles()
+{
+    mRenderingTiles.Clear();
+    mRenderingTiles.Reserve(mBlocks.Size());
+
+    for (const Block& block : mBlocks)
+    {
+        SplitIntoTiles(block, mParams.tileSize, mRenderingTiles);
+    }
+}
+
 void Viewport::BuildInitialBlocksList()
 {
     mBlocks.Clear();
@@ -641,23 +1499,97 @@ void Viewport::BuildInitialBlocksList()
     mProgress.activeBlocks = mBlocks.Size();
 }
 
+void Viewport::SplitBlock(const Block& block, const ArrayView<float>& errorProfile, Block& childA, Block& childB) const
+{
+    const bool splitHorizontally = block.Width() > block.Height();
+    const uint32 blockSize = splitHorizontally ? block.Width() : block.Height();
+    RT_ASSERT(errorProfile.Size() == blockSize);
+
+    float totalError = 0.0f;
+    for (const float error : errorProfile)
+    {
+        totalError += error;
+    }
+
+    // find a split point, so the estimated error is equal on both sides
+    uint32 splitOffset = blockSize / 2u;
+    if (totalError > 0.0f)
+    {
+        float accumulatedError = 0.0f;
+        for (uint32 i = 0; i < blockSize; ++i)
+        {
+            accumulatedError += errorProfile[i];
+            if (2.0f * accumulatedError >= totalError)
+            {
+                splitOffset = i + 1u;
+                break;
+            }
+        }
+    }
+
+    // don't produce degenerated blocks
+    const uint32 minChildSize = Min(blockSize / 2u, Max(1u, mParams.adaptiveSettings.minBlockSize / 2u));
+    splitOffset = Clamp(splitOffset, minChildSize, blockSize - minChildSize);
+
+    childA = block;
+    childB = block;
+
+    if (splitHorizontally)
+    {
+        childA.maxX = block.minX + splitOffset;
+        childB.minX = block.minX + splitOffset;
+    }
+    else
+    {
+        childA.maxY = block.minY + splitOffset;
+        childB.minY = block.minY + splitOffset;
+    }
+}
+
 void Viewport::UpdateBlocksList()
 {
-    DynArray<Block> newBlocks;
+    FrameAllocatorScope frameAllocatorScope;
+
+    DynArray<Block, FrameAllocator> newBlocks;
+    DynArray<float, FrameAllocator> errorProfile;
 
     const AdaptiveRenderingSettings& settings = mParams.adaptiveSettings;
 
-    if (mProgress.passesFinished < settings.numInitialPasses)
+    // resolution cascade passes render a single sample per pixel in total
+    const uint32 numCascadePasses = mResolutionCascadeLevels;
+
+    if (mProgress.passesFinished < settings.numInitialPasses + numCascadePasses)
     {
         return;
     }
 
-    for (uint32 i = 0; i < mBlocks.Size(); ++i)
+    // light paths splat onto the whole film every pass, so a removed block would keep accumulating splats
+    // while its pixels' pass counts stay fixed - blocks can only be split then
+    const bool allowBlockRemoval = !mRenderer || mRenderer->GetNumLightPaths() == 0;
+
+    for (uint32 i = 0; i < mBlocks.Size(); )
     {
         const Block block = mBlocks[i];
-        const float blockError = ComputeBlockError(block);
 
-        if (blockError < settings.convergenceTreshold)
+        // compute per-pixel error and project it onto the longer block axis
+        const bool splitHorizontally = block.Width() > block.Height();
+        errorProfile.Resize(splitHorizontally ? block.Width() : block.Height(), 0.0f);
+        memset(errorProfile.Data(), 0, sizeof(float) * errorProfile.Size());
+
+        float totalError = 0.0f;
+        for (uint32 y = block.minY; y < block.maxY; ++y)
+        {
+            for (uint32 x = block.minX; x < block.maxX; ++x)
+            {
+                const float pixelError = ComputePixelError(x, y);
+                errorProfile[splitHorizontally ? (x - block.minX) : (y - block.minY)] += pixelError;
+                totalError += pixelError;
+            }
+        }
+
+        const float blockError = NormalizeBlockError(totalError, block);
+
+        if (blockError < settings.convergenceTreshold && allowBlockRemoval)
         {
             // block is fully converged - remove it
             mBlocks[i] = mBlocks.Back();
@@ -674,41 +1606,14 @@ void Viewport::UpdateBlocksList()
             mBlocks.PopBack();
 
             Block childA, childB;
-
-            // TODO split the block so the error is equal on both sides
-
-            if (block.Width() > block.Height())
-            {
-                const uint32 halfPoint = (block.minX + block.maxX) / 2u;
-
-                childA.minX = block.minX;
-                childA.maxX = halfPoint;
-                childA.minY = block.minY;
-                childA.maxY = block.maxY;
-
-                childB.minX = halfPoint;
-                childB.maxX = block.maxX;
-                childB.minY = block.minY;
-                childB.maxY = block.maxY;
-            }
-            else
-            {
-                const uint32 halfPoint = (block.minY + block.maxY) / 2u;
-
-                childA.minX = block.minX;
-                childA.maxX = block.maxX;
-                childA.minY = block.minY;
-                childA.maxY = halfPoint;
-
-                childB.minX = block.minX;
-                childB.maxX = block.maxX;
-                childB.minY = halfPoint;
-                childB.maxY = block.maxY;
-            }
+            SplitBlock(block, errorProfile, childA, childB);
 
             newBlocks.PushBack(childA);
             newBlocks.PushBack(childB);
+            continue;
         }
+
+        ++i;
     }
 
     // add splitted blocks to the list
@@ -10,6 +10,7 @@
 #include "../Sampling/HaltonSampler.h"
 #include "../Sampling/GenericSampler.h"
 #include "../Math/Rectangle.h"
+#include "../Scene/Camera.h"
 #include "../Utils/Bitmap.h"
 #include "../Utils/ThreadPool.h"
 #include "../Utils/Memory.h"
@@ -18,7 +19,6 @@
 namespace rt {
 
 class IRenderer;
-class Camera;
 
 using RendererPtr = std::shared_ptr<IRenderer>;
 
@@ -44,20 +44,53 @@ public:
     RAYLIB_API bool Render(const Camera& camera);
     RAYLIB_API void Reset();
 
+    // Restart rendering after camera change, keeping samples accumulated so far where possible.
+    // Pixels are warped into the new view using first hit distance and object ID of the previous view,
+    // disoccluded or mismatching pixels start from scratch. Performs regular reset if reprojection is disabled.
+    RAYLIB_API void Reproject(const Camera& newCamera);
+
     RAYLIB_API void SetPixelBreakpoint(uint32 x, uint32 y);
 
-    RT_FORCE_INLINE const Bitmap& GetFrontBuffer() const { return mFrontBuffer; }
+    // get post-processed image (the most recently written front buffer target, if any)
+    RT_FORCE_INLINE const Bitmap& GetFrontBuffer() const
+    {
+        return mFrontBufferTargets.Empty() ? mFrontBuffer : *mFrontBufferTargets[mFrontBufferTargetIndex].bitmap;
+    }
+
+    // Post-process directly into caller-owned B8G8R8A8 images (e.g. memory shared with the window system),
+    // instead of the internal front buffer. Targets are written round-robin, one per Render() call, and each one
+    // remembers regions it missed since it was last written, so only those and tiles rendered in the current pass are re-emitted.
+    // NOTE: targets must match the viewport size and are unregistered on resize. Pass no targets to go back to the internal front buffer.
+    RAYLIB_API bool SetFrontBufferTargets(Bitmap* const* targets, uint32 numTargets);
+
+    // get index of the front buffer target written by the last Render() call
+    RT_FORCE_INLINE uint32 GetFrontBufferTargetIndex() const { return mFrontBufferTargetIndex; }
+
+    // notify that a region of the most recently written target was overwritten by the caller (e.g. with UI overlay),
+    // the region will be post-processed again next time the target is written
+    RAYLIB_API void InvalidateFrontBufferTarget(const math::Rectangle<uint32>& region);
+
+    // NOTE: in AccumulationMode::CompensatedHalf mode the buffer contains per-pixel averages instead of sums
     RT_FORCE_INLINE const Bitmap& GetSumBuffer() const { return mSum; }
 
     RT_FORCE_INLINE uint32 GetWidth() const { return mSum.GetWidth(); }
     RT_FORCE_INLINE uint32 GetHeight() const { return mSum.GetHeight(); }
 
+    // get average of samples accumulated so far in a given pixel
+    RAYLIB_API const math::Vector4 GetPixelAverage(uint32 x, uint32 y) const;
+
+    // get number of samples accumulated so far in a given pixel
+    RT_FORCE_INLINE uint32 GetNumPixelPasses(uint32 x, uint32 y) const { return mPassesPerPixel[GetWidth() * y + x]; }
+
     RT_FORCE_INLINE const RenderingProgress& GetProgress() const { return mProgress; }
     RT_FORCE_INLINE const RayTracingCounters& GetCounters() const { return mCounters; }
 
     RAYLIB_API void VisualizeActiveBlocks(Bitmap& bitmap) const;
 
 private:
+    // number of light paths traced by a single task in light paths pass
+    static constexpr uint32 LightPathsChunkSize = 256;
+
     void InitThreadData();
 
     // region of a image used for adaptive rendering
@@ -70,6 +103,20 @@ private:
         const math::Vector4 sampleOffset;
     };
 
+    struct FrontBufferTarget
+    {
+        Bitmap* bitmap = nullptr;
+        DynArray<Block> pendingTiles;       // regions to be post-processed again when the target is written next time
+        bool fullUpdateRequired = true;
+    };
+
+    // first hit of a ray going through pixel center
+    struct GBufferPixel
+    {
+        float distance;
+        uint32 objectId;
+    };
+
     struct RT_ALIGN(16) PostprocessParamsInternal
     {
         PostprocessParams params;
@@ -78,26 +125,84 @@ private:
         bool fullUpdateRequired = false;
     };
 
+    // (re)allocate images holding accumulated samples, according to current accumulation mode
+    bool InitAccumulationBuffers(uint32 width, uint32 height);
+
+    RT_FORCE_INLINE bool IsCompactAccumulation() const { return mSum.GetFormat() == Bitmap::Format::R16G16B16_Half; }
+
+    // get average color of a pixel from a "sum" image
+    const math::Vector4 LoadPixelAverage(const Bitmap& sum, uint32 x, uint32 y, uint32 numPasses) const;
+
     void BuildInitialBlocksList();
 
     // compute average error (variance) in the image
     void ComputeError();
 
+    // calculate estimated error (variance) of a single pixel, based on difference between "sum" and "secondary sum" images
+    float ComputePixelError(uint32 x, uint32 y) const;
+
     // calculate estimated error (variance) of a given block
     float ComputeBlockError(const Block& block) const;
 
+    // convert summed error of pixels within a block into block error metric
+    float NormalizeBlockError(float totalError, const Block& block) const;
+
+    // split block into two parts, so the estimated error is (roughly) the same on both sides
+    void SplitBlock(const Block& block, const ArrayView<float>& errorProfile, Block& childA, Block& childB) const;
+
+    // get pixel lattice step of the current pass in resolution cascade (0 if all the pixels are rendered)
+    uint32 GetResolutionCascadeStep() const;
+
+    // check if a pixel is rendered in current resolution cascade pass
+    RT_FORCE_INLINE bool IsResolutionCascadePixel(uint32 x, uint32 y, uint32 step) const
+    {
+        return (x & (step - 1u)) == 0 && (y & (step - 1u)) == 0 && mPassesPerPixel[GetWidth() * y + x] == 0;
+    }
+
+    // fill pixels skipped in resolution cascade pass with the nearest rendered pixel
+    void UpsampleResolutionCascade(Bitmap& target, uint32 step);
+
+    // trace rays through pixel centers to find first hits for reprojection
+    void BuildGBuffer(const Camera& camera, DynArray<GBufferPixel>& outGBuffer);
+
+    // copy accumulated samples to history images, so they can be read while the current ones are overwritten
+    bool InitReprojectionHistory();
+
+    // split a block into tiles of given maximum size and append them to the list
+    static void SplitIntoTiles(const Block& block, uint32 tileSize, DynArray<Block>& outTiles);
+
     // generate list of tiles to be rendered (updates mRenderingTiles)
     void GenerateRenderingTiles();
 
     void UpdateBlocksList();
 
+    // trace renderer's light paths in parallel chunks, independently of rendering tiles
+    void TraceLightPaths(const Camera& camera);
+
+    // add camera connections recorded in light paths pass to the "sum" images
+    void AccumulateFilmSplats();
+
     // raytrace single image tile (will be called from multiple threads)
     void RenderTile(const TileRenderingContext& tileContext, RenderingContext& renderingContext, const Block& tile);
 
     void PerformPostProcess();
 
+    // post-process tiles in parallel
+    void PostProcessTiles(const ArrayView<Block>& tiles, Bitmap& target);
+
+    // write "sum" image divided by per-pixel number of samples to a given bitmap
+    void ResolveSum(Bitmap& target) const;
+
     // generate "front buffer" image from "sum" image
-    void PostProcessTile(const Block& tile, uint32 threadID);
+    void PostProcessTile(const Block& tile, Bitmap& target, uint32 threadID);
+
+    // post process kernel processing 8 pixels at once, specialized for given tonemapper and bloom usage
+    template<Tonemapper tonemapper, bool useBloom>
+    void PostProcessTile_Simd8(const Block& tile, Bitmap& target, uint32 threadID);
+
+    // post process up to 8 consecutive pixels in a row (returns packed B8G8R8A8 colors)
+    template<Tonemapper tonemapper, bool useBloom>
+    RT_FORCE_INLINE const math::VectorInt8 PostProcessPixels_Simd8(uint32 x, uint32 y, uint32 numPixels, math::Random& randomGenerator) const;
 
     ThreadPool mThreadPool;
 
@@ -109,11 +214,15 @@ private:
     DynArray<GenericSampler> mSamplers;
     DynArray<RenderingContext> mThreadData;
 
-    Bitmap mSum;                        // image with accumulated samples (floating point, high dynamic range)
+    // NOTE: sums are RGBA (not RGB) so pixels can be accessed as aligned Vector4, which costs 32 instead of 24 bytes per pixel for both images
+    Bitmap mSum;                        // image with accumulated samples (RGBA floating point, high dynamic range)
     Bitmap mSecondarySum;               // contains image with every second sample - required for adaptive rendering
+    Bitmap mSumCompensation;            // rounding error of half precision average (compact accumulation mode only)
     Bitmap mFrontBuffer;                // postprocesses image (low dynamic range)
+    DynArray<FrontBufferTarget> mFrontBufferTargets;
+    uint32 mFrontBufferTargetIndex = 0;
     DynArray<Bitmap> mBlurredImages;    // blurred images for bloom
-    DynArray<uint32> mPassesPerPixel;
+    DynArray<uint32> mPassesPerPixel;  // number of samples accumulated in each pixel (can differ between pixels in adaptive mode)
     DynArray<math::Float2> mPixelSalt; // salt value for each pixel
 
     RenderingParams mParams;
@@ -123,6 +232,19 @@ private:
 
     RenderingProgress mProgress;
 
+    // number of resolution cascade levels, latched on reset
+    uint32 mResolutionCascadeLevels = 0;
+
+    // temporal reprojection state
+    Camera mLastCamera;                     // camera used in the last Render() call
+    bool mHasLastCamera = false;
+    bool mGBufferValid = false;             // G-buffer matches the last camera
+    DynArray<GBufferPixel> mGBuffer;
+    DynArray<GBufferPixel> mNewGBuffer;
+    Bitmap mHistorySum;
+    Bitmap mHistorySecondarySum;
+    DynArray<uint32> mHistoryPassesPerPixel;
+
     DynArray<Block> mBlocks;
     DynArray<Block> mRenderingTiles;
 
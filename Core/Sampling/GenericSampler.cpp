@@ -66,9 +66,11 @@ GenericSampler::GenericSampler()
 {
 }
 
-void GenericSampler::ResetFrame(const DynArray<uint32>& seed, bool useBlueNoise)
+void GenericSampler::ResetFrame(const ArrayView<uint32>& seed, bool useBlueNoise)
 {
-    mCurrentSample = seed;
+    // reuses memory after the first frame
+    mCurrentSample.Clear();
+    mCurrentSample.PushBackArray(seed);
     mBlueNoiseTextureLayers = mBlueNoiseTexture && useBlueNoise ? BlueNoise::TextureLayers : 0;
 }
 
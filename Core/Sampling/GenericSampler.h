@@ -17,11 +17,33 @@ public:
     ~GenericSampler() = default;
 
     // move to next frame
-    void ResetFrame(const DynArray<uint32>& sample, bool useBlueNoise);
+    void ResetFrame(const ArrayView<uint32>& sample, bool useBlueNoise);
 
     // move to next pixel
     void ResetPixel(const uint32 x, const uint32 y);
 
+    // per-pixel part of the sampler state (allows interleaving sample generation for multiple pixels)
+    struct PixelState
+    {
+        uint32 blueNoisePixelX;
+        uint32 blueNoisePixelY;
+        uint32 salt;
+        uint32 samplesGenerated;
+    };
+
+    RT_FORCE_INLINE const PixelState GetPixelState() const
+    {
+        return { mBlueNoisePixelX, mBlueNoisePixelY, mSalt, mSamplesGenerated };
+    }
+
+    RT_FORCE_INLINE void SetPixelState(const PixelState& state)
+    {
+        mBlueNoisePixelX = state.blueNoisePixelX;
+        mBlueNoisePixelY = state.blueNoisePixelY;
+        mSalt = state.salt;
+        mSamplesGenerated = state.samplesGenerated;
+    }
+
     // get next sample
     // NOTE: effectively goes to next sample dimension
     uint32 GetInt();
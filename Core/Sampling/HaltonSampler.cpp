@@ -182,10 +182,15 @@ void HaltonSequence::InitStart()
     }
 }
 
-void HaltonSequence::Initialize(uint32 dim)
+void HaltonSequence::Initialize(uint32 dim, uint64 seed)
 {
     ClearPermutation();
 
+    if (seed != 0)
+    {
+        mRandom.Reset(seed);
+    }
+
     assert(mDimensions <= MaxDimensions);
     mDimensions = dim;
 
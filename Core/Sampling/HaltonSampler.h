@@ -16,7 +16,8 @@ public:
 
     RAYLIB_API HaltonSequence();
     RAYLIB_API ~HaltonSequence();
-    RAYLIB_API void Initialize(uint32 mDimensions);
+    // NOTE: seed equal to zero means random start and permutation
+    RAYLIB_API void Initialize(uint32 mDimensions, uint64 seed = 0);
 
     RT_FORCE_INLINE uint32 GetNumDimensions() const { return mDimensions; }
 
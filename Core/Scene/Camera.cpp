@@ -25,6 +25,8 @@ void Camera::SetTransform(const math::Transform& transform)
 
     mTransform = transform;
     mLocalToWorld = transform.ToMatrix4();
+
+    UpdateWorldToScreen();
 }
 
 void Camera::SetPerspective(float aspectRatio, float FoV)
@@ -36,16 +38,13 @@ void Camera::SetPerspective(float aspectRatio, float FoV)
     mFieldOfView = FoV;
     mTanHalfFoV = tanf(mFieldOfView * 0.5f);
 
-    {
-        Matrix4 worldToLocal = mLocalToWorld.FastInverseNoScale();
-        worldToLocal[0].w = 0.0f;
-        worldToLocal[1].w = 0.0f;
-        worldToLocal[2].w = 0.0f;
-        worldToLocal[3].w = 1.0f;
-
-        const Matrix4 projection = Matrix4::MakePerspective(aspectRatio, FoV, 0.01f, 1000.0f);
-        mWorldToScreen = mLocalToWorld.FastInverseNoScale() * projection;
-    }
+    UpdateWorldToScreen();
+}
+
+void Camera::UpdateWorldToScreen()
+{
+    const Matrix4 projection = Matrix4::MakePerspective(mAspectRatio, mFieldOfView, 0.01f, 1000.0f);
+    mWorldToScreen = mLocalToWorld.FastInverseNoScale() * projection;
 }
 
 void Camera::SetAngularVelocity(const math::Quaternion& quat)
@@ -84,7 +83,7 @@ const Ray Camera::GenerateRay(const Vector4& coords, RenderingContext& context)
     Vector4 offsetedCoords = UnipolarToBipolar(coords);
 
     // barrel distortion
-    if (barrelDistortionVariableFactor)
+    if (enableBarellDistortion)
     {
         Vector4 radius = Vector4::Dot2V(offsetedCoords, offsetedCoords);
         radius *= (barrelDistortionConstFactor + barrelDistortionVariableFactor * context.randomGenerator.GetFloat());
@@ -147,6 +146,17 @@ float Camera::PdfW(const math::Vector4& direction) const
 
 
 const Ray_Simd8 Camera::GenerateRay_Simd8(const Vector2x8& coords, RenderingContext& context) const
+{
+    Vector2x8 apertureSamples = Vector2x8::Zero();
+    if (mDOF.enable)
+    {
+        apertureSamples = Vector2x8(context.randomGenerator.GetVector8(), context.randomGenerator.GetVector8());
+    }
+
+    return GenerateRay_Simd8(coords, apertureSamples, context);
+}
+
+const Ray_Simd8 Camera::GenerateRay_Simd8(const Vector2x8& coords, const Vector2x8& apertureSamples, RenderingContext& context) const
 {
     const Matrix4 transform = SampleTransform(context.time);
 
@@ -157,7 +167,7 @@ const Ray_Simd8 Camera::GenerateRay_Simd8(const Vector2x8& coords, RenderingCont
     if (enableBarellDistortion)
     {
         Vector8 radius = Vector2x8::Dot(offsetedCoords, offsetedCoords);
-        radius *= (barrelDistortionConstFactor + barrelDistortionVariableFactor * context.randomGenerator.GetFloat());
+        radius *= Vector8::MulAndAdd(context.randomGenerator.GetVector8(), Vector8(barrelDistortionVariableFactor), Vector8(barrelDistortionConstFactor));
         offsetedCoords += offsetedCoords * radius;
     }
 
@@ -179,8 +189,8 @@ const Ray_Simd8 Camera::GenerateRay_Simd8(const Vector2x8& coords, RenderingCont
         const Vector4 right = transform[0];
         const Vector4 up = transform[1];
 
-        // TODO different bokeh shapes, texture, etc.
-        const Vector2x8 randomPointOnCircle = GenerateBokeh_Simd8(context) * mDOF.aperture;
+        // TODO hexagon, texture, etc.
+        const Vector2x8 randomPointOnCircle = GenerateBokeh_Simd8(apertureSamples) * mDOF.aperture;
         origin = Vector3x8::MulAndAdd(Vector3x8(randomPointOnCircle.x), Vector3x8(right), origin);
         origin = Vector3x8::MulAndAdd(Vector3x8(randomPointOnCircle.y), Vector3x8(up), origin);
 
@@ -217,10 +227,8 @@ const Vector4 Camera::GenerateBokeh(const math::Float3 sample) const
     return Vector4::Zero();
 }
 
-const Vector2x8 Camera::GenerateBokeh_Simd8(RenderingContext& context) const
+const Vector2x8 Camera::GenerateBokeh_Simd8(const Vector2x8& u) const
 {
-    const Vector2x8 u(context.randomGenerator.GetVector8(), context.randomGenerator.GetVector8());
-
     switch (mDOF.bokehShape)
     {
         case BokehShape::Circle:
@@ -73,10 +73,20 @@ public:
     // Generate ray for the camera for a given time
     // x and y coordinates should be in [0.0f, 1.0f) range.
     RAYLIB_API RT_FORCE_NOINLINE const math::Ray GenerateRay(const math::Vector4& coords, RenderingContext& context) const;
+
+    // Generate 8 rays at once (camera transform is sampled only once)
+    // Aperture samples are used for depth of field and should be in [0.0f, 1.0f) range.
     RT_FORCE_NOINLINE const math::Ray_Simd8 GenerateRay_Simd8(const math::Vector2x8& coords, RenderingContext& context) const;
+    RAYLIB_API RT_FORCE_NOINLINE const math::Ray_Simd8 GenerateRay_Simd8(const math::Vector2x8& coords, const math::Vector2x8& apertureSamples, RenderingContext& context) const;
+
+    // check if current bokeh shape is supported by GenerateRay_Simd8
+    RT_FORCE_INLINE bool SupportsRayGeneration_Simd8() const
+    {
+        return !mDOF.enable || mDOF.bokehShape == BokehShape::Circle || mDOF.bokehShape == BokehShape::Square;
+    }
 
     RT_FORCE_INLINE const math::Vector4 GenerateBokeh(const math::Float3 sample) const;
-    RT_FORCE_INLINE const math::Vector2x8 GenerateBokeh_Simd8(RenderingContext& context) const;
+    RT_FORCE_INLINE const math::Vector2x8 GenerateBokeh_Simd8(const math::Vector2x8& u) const;
 
     // Convert world-space coordinates to film-space coordinates including camera projection (0...1 range)
     bool WorldToFilm(const math::Vector4& worldPosition, math::Vector4& outFilmCoords) const;
@@ -101,6 +111,9 @@ public:
     bool enableBarellDistortion;
 
 private:
+    // recompute world to screen matrix after transform or projection change
+    void UpdateWorldToScreen();
+
     float mTanHalfFoV;
 
     math::Matrix4 mLocalToWorld;
@@ -0,0 +1,170 @@
+#include "PCH.h"
+#include "DecalGrid.h"
+#include "Object/SceneObject_Decal.h"
+#include "Utils/Logger.h"
+#include "Utils/Profiler.h"
+
+namespace rt {
+
+using namespace math;
+
+DecalGrid::DecalGrid()
+{
+    Clear();
+}
+
+void DecalGrid::Clear()
+{
+    mBox = Box::Empty();
+    mCellScale = Vector4::Zero();
+    mMaxCellCoords = VectorInt4::Zero();
+    mResolution[0] = mResolution[1] = mResolution[2] = 1;
+    mCellStarts.Clear();
+    mCellDecals.Clear();
+}
+
+bool DecalGrid::Build(const DynArray<const DecalSceneObject*>& decals)
+{
+    RT_SCOPED_TIMER(DecalGrid_Build);
+
+    Clear();
+
+    if (decals.Empty())
+    {
+        return true;
+    }
+
+    // presort decals in application order, so the cell lists are sorted as well
+    DynArray<const DecalSceneObject*> sortedDecals = decals;
+    std::stable_sort(sortedDecals.Data(), sortedDecals.Data() + sortedDecals.Size(), [](const DecalSceneObject* a, const DecalSceneObject* b)
+    {
+        return a->order > b->order;
+    });
+
+    DynArray<Box> boxes;
+    boxes.Reserve(sortedDecals.Size());
+    for (const DecalSceneObject* decal : sortedDecals)
+    {
+        const Box box = decal->GetBoundingBox();
+        boxes.PushBack(box);
+        mBox = Box(mBox, box);
+    }
+
+    // avoid degenerated cells
+    const Vector4 boxSize = mBox.max - mBox.min;
+    const Vector4 gridSize = Vector4::Max(boxSize, Vector4(1.0e-3f * boxSize.HorizontalMax().x + FLT_MIN));
+
+    // initial resolution: cubic cells, roughly 'CellsPerDecal' cells per decal
+    {
+        const float targetNumCells = static_cast<float>(sortedDecals.Size() * CellsPerDecal);
+        const float cellSize = cbrtf(gridSize.x * gridSize.y * gridSize.z / targetNumCells);
+        for (uint32 i = 0; i < 3; ++i)
+        {
+            const float resolution = ceilf(gridSize[i] / cellSize);
+            mResolution[i] = static_cast<uint32>(Clamp(resolution, 1.0f, static_cast<float>(MaxResolution)));
+        }
+    }
+
+    const auto computeCellRange = [this, &gridSize](const Box& box, VectorInt4& outMin, VectorInt4& outMax)
+    {
+        const Vector4 scale = Vector4(static_cast<float>(mResolution[0]), static_cast<float>(mResolution[1]), static_cast<float>(mResolution[2]), 0.0f) / gridSize;
+        const VectorInt4 maxCoords(mResolution[0] - 1, mResolution[1] - 1, mResolution[2] - 1, 0);
+        outMin = VectorInt4::Min(VectorInt4::Max(VectorInt4::TruncateAndConvert((box.min - mBox.min) * scale), VectorInt4::Zero()), maxCoords);
+        outMax = VectorInt4::Min(VectorInt4::Max(VectorInt4::TruncateAndConvert((box.max - mBox.min) * scale), VectorInt4::Zero()), maxCoords);
+    };
+
+    // lower the resolution if huge decals would blow up the cell lists
+    for (;;)
+    {
+        uint64 numEntries = 0;
+        for (const Box& box : boxes)
+        {
+            VectorInt4 minCoords, maxCoords;
+            computeCellRange(box, minCoords, maxCoords);
+            numEntries += uint64(maxCoords.x - minCoords.x + 1) * uint64(maxCoords.y - minCoords.y + 1) * uint64(maxCoords.z - minCoords.z + 1);
+        }
+
+        if (numEntries <= MaxCellEntries)
+        {
+            break;
+        }
+
+        if (mResolution[0] == 1 && mResolution[1] == 1 && mResolution[2] == 1)
+        {
+            RT_LOG_ERROR("Too many decals: %u", sortedDecals.Size());
+            Clear();
+            return false;
+        }
+
+        for (uint32 i = 0; i < 3; ++i)
+        {
+            mResolution[i] = Max(1u, mResolution[i] / 2);
+        }
+    }
+
+    mCellScale = Vector4(static_cast<float>(mResolution[0]), static_cast<float>(mResolution[1]), static_cast<float>(mResolution[2]), 0.0f) / gridSize;
+    mMaxCellCoords = VectorInt4(mResolution[0] - 1, mResolution[1] - 1, mResolution[2] - 1, 0);
+
+    const uint32 numCells = mResolution[0] * mResolution[1] * mResolution[2];
+
+    // count decals in each cell
+    mCellStarts.Resize(numCells + 1);
+    memset(mCellStarts.Data(), 0, mCellStarts.Size() * sizeof(uint32));
+
+    for (const Box& box : boxes)
+    {
+        VectorInt4 minCoords, maxCoords;
+        computeCellRange(box, minCoords, maxCoords);
+
+        for (int32 z = minCoords.z; z <= maxCoords.z; ++z)
+        {
+            for (int32 y = minCoords.y; y <= maxCoords.y; ++y)
+            {
+                for (int32 x = minCoords.x; x <= maxCoords.x; ++x)
+                {
+                    mCellStarts[uint32(x) + mResolution[0] * (uint32(y) + mResolution[1] * uint32(z))]++;
+                }
+            }
+        }
+    }
+
+    // exclusive prefix sum
+    uint32 sum = 0;
+    for (uint32 i = 0; i <= numCells; ++i)
+    {
+        const uint32 count = mCellStarts[i];
+        mCellStarts[i] = sum;
+        sum += count;
+    }
+
+    // fill up the cell lists (decals are visited in sorted order, so the lists are sorted too)
+    DynArray<uint32> cellEnds;
+    cellEnds.Resize(numCells);
+    memcpy(cellEnds.Data(), mCellStarts.Data(), numCells * sizeof(uint32));
+
+    mCellDecals.Resize(sum);
+
+    for (uint32 i = 0; i < boxes.Size(); ++i)
+    {
+        VectorInt4 minCoords, maxCoords;
+        computeCellRange(boxes[i], minCoords, maxCoords);
+
+        for (int32 z = minCoords.z; z <= maxCoords.z; ++z)
+        {
+            for (int32 y = minCoords.y; y <= maxCoords.y; ++y)
+            {
+                for (int32 x = minCoords.x; x <= maxCoords.x; ++x)
+                {
+                    const uint32 cellIndex = uint32(x) + mResolution[0] * (uint32(y) + mResolution[1] * uint32(z));
+                    mCellDecals[cellEnds[cellIndex]++] = sortedDecals[i];
+                }
+            }
+        }
+    }
+
+    RT_LOG_INFO("Decal grid built: decals=%u, resolution=%ux%ux%u, entries=%u", sortedDecals.Size(), mResolution[0], mResolution[1], mResolution[2], sum);
+
+    return true;
+}
+
+} // namespace rt
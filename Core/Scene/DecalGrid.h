@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../RayLib.h"
+#include "../Math/Box.h"
+#include "../Math/VectorInt4.h"
+#include "../Containers/DynArray.h"
+#include "../Containers/ArrayView.h"
+
+namespace rt {
+
+class DecalSceneObject;
+
+/**
+ * Decals acceleration structure.
+ * Uniform grid over all the decals bounding boxes. Each cell holds a list of overlapping decals,
+ * presorted in application order, so there is no limit on number of overlapping decals and no sorting at query time.
+ */
+class RT_ALIGN(16) RAYLIB_API DecalGrid : public Aligned<16>
+{
+public:
+    // limit number of cells per axis
+    static constexpr uint32 MaxResolution = 256;
+
+    // target average number of cells per decal
+    static constexpr uint32 CellsPerDecal = 4;
+
+    // limit total size of cell lists (resolution is lowered if exceeded)
+    static constexpr uint32 MaxCellEntries = 16 * 1024 * 1024;
+
+    DecalGrid();
+
+    void Clear();
+
+    bool Build(const DynArray<const DecalSceneObject*>& decals);
+
+    RT_FORCE_INLINE bool Empty() const { return mCellDecals.Empty(); }
+
+    RT_FORCE_INLINE const math::Box& GetBox() const { return mBox; }
+
+    // get decals that may overlap given point, in application order
+    RT_FORCE_INLINE const ArrayView<const DecalSceneObject* const> Find(const math::Vector4& point) const
+    {
+        if (!mBox.Intersects(point))
+        {
+            return {};
+        }
+
+        const uint32 cellIndex = GetCellIndex(point);
+        const uint32 cellStart = mCellStarts[cellIndex];
+        const uint32 cellEnd = mCellStarts[cellIndex + 1];
+        return { mCellDecals.Data() + cellStart, cellEnd - cellStart };
+    }
+
+private:
+    RT_FORCE_INLINE const math::VectorInt4 GetCellCoords(const math::Vector4& point) const
+    {
+        const math::VectorInt4 coords = math::VectorInt4::TruncateAndConvert((point - mBox.min) * mCellScale);
+        return math::VectorInt4::Min(math::VectorInt4::Max(coords, math::VectorInt4::Zero()), mMaxCellCoords);
+    }
+
+    RT_FORCE_INLINE uint32 GetCellIndex(const math::Vector4& point) const
+    {
+        const math::VectorInt4 coords = GetCellCoords(point);
+        return uint32(coords.x) + mResolution[0] * (uint32(coords.y) + mResolution[1] * uint32(coords.z));
+    }
+
+    math::Box mBox;
+    math::Vector4 mCellScale;
+    math::VectorInt4 mMaxCellCoords;
+    uint32 mResolution[3];
+
+    // cell 'i' decals are stored in mCellDecals[mCellStarts[i]] ... mCellDecals[mCellStarts[i + 1] - 1]
+    DynArray<uint32> mCellStarts;
+    DynArray<const DecalSceneObject*> mCellDecals;
+};
+
+} // namespace rt
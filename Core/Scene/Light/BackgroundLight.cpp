@@ -6,6 +6,10 @@
 #include "../../Math/Transcendental.h"
 #include "../../Math/Geometry.h"
 #include "../../Math/SamplingHelpers.h"
+#include "../../Math/Distribution.h"
+#include "../../Color/ColorHelpers.h"
+#include "../../Containers/DynArray.h"
+#include "../../Utils/Logger.h"
 #include "../Camera.h"
 
 namespace rt {
@@ -15,12 +19,122 @@ using namespace math;
 // TODO this should be calculated
 static const float SceneRadius = 30.0f; // TODO
 
+// resolution of the importance map (in spherical coordinates)
+static const uint32 ImportanceMapWidth = 512;
+static const uint32 ImportanceMapHeight = 256;
+
 BackgroundLight::BackgroundLight() = default;
+BackgroundLight::~BackgroundLight() = default;
 
 BackgroundLight::BackgroundLight(const math::Vector4& color)
     : ILight(color)
 {}
 
+bool BackgroundLight::MakeSamplable()
+{
+    mImportanceMap.reset();
+
+    if (!mTexture)
+    {
+        // constant color - uniform sampling is optimal
+        return true;
+    }
+
+    DynArray<float> importance;
+    importance.Resize(ImportanceMapWidth * ImportanceMapHeight);
+
+    // average intensity of 2x2 samples per cell, so small features (e.g. sun) are not missed
+    float intensitySum = 0.0f;
+    for (uint32 j = 0; j < ImportanceMapHeight; ++j)
+    {
+        for (uint32 i = 0; i < ImportanceMapWidth; ++i)
+        {
+            float intensity = 0.0f;
+            for (uint32 k = 0; k < 4; ++k)
+            {
+                const Vector4 coords(
+                    (static_cast<float>(i) + 0.25f + 0.5f * static_cast<float>(k % 2)) / static_cast<float>(ImportanceMapWidth),
+                    (static_cast<float>(j) + 0.25f + 0.5f * static_cast<float>(k / 2)) / static_cast<float>(ImportanceMapHeight),
+                    0.0f, 0.0f);
+                const Vector4 value = Vector4::Max(Vector4::Zero(), mTexture->Evaluate(coords));
+                intensity += Vector4::Dot3(c_rgbIntensityWeights, value);
+            }
+
+            importance[ImportanceMapWidth * j + i] = 0.25f * intensity;
+            intensitySum += 0.25f * intensity;
+        }
+    }
+
+    if (!(intensitySum > 0.0f))
+    {
+        RT_LOG_WARNING("BackgroundLight: Texture '%s' is black, falling back to uniform sampling", mTexture->GetName());
+        return true;
+    }
+
+    // add small constant term, because filtered texture lookups can be non-zero in cells with zero average intensity,
+    // then account for spherical mapping distortion (cells near the poles cover smaller solid angle)
+    const float minIntensity = 0.01f * intensitySum / static_cast<float>(importance.Size());
+    for (uint32 j = 0; j < ImportanceMapHeight; ++j)
+    {
+        const float sinTheta = sinf(RT_PI * (static_cast<float>(j) + 0.5f) / static_cast<float>(ImportanceMapHeight));
+        for (uint32 i = 0; i < ImportanceMapWidth; ++i)
+        {
+            float& value = importance[ImportanceMapWidth * j + i];
+            value = (value + minIntensity) * sinTheta;
+        }
+    }
+
+    mImportanceMap = std::make_unique<math::Distribution>();
+    if (!mImportanceMap->Initialize(importance.Data(), importance.Size()))
+    {
+        mImportanceMap.reset();
+        return false;
+    }
+
+    return true;
+}
+
+const Vector4 BackgroundLight::SampleDirection(const Float2 u, float& outPdfW) const
+{
+    RT_ASSERT(mImportanceMap);
+
+    float pdf = 0.0f;
+    float remappedU = 0.0f;
+    const uint32 cellIndex = mImportanceMap->SampleDiscrete(u.x, pdf, remappedU);
+
+    const uint32 x = cellIndex % ImportanceMapWidth;
+    const uint32 y = cellIndex / ImportanceMapWidth;
+    RT_ASSERT(y < ImportanceMapHeight);
+
+    const Vector4 coords(
+        (static_cast<float>(x) + remappedU) / static_cast<float>(ImportanceMapWidth),
+        (static_cast<float>(y) + u.y) / static_cast<float>(ImportanceMapHeight),
+        0.0f, 0.0f);
+
+    const Vector4 dir = SphericalToCartesianCoordinates(coords);
+
+    // importance map pdf is defined over (phi,theta) unit square, convert it to solid angle measure
+    const float sinTheta = Max(sqrtf(Max(0.0f, 1.0f - Sqr(dir.y))), FLT_EPSILON);
+    outPdfW = pdf / (2.0f * Sqr(RT_PI) * sinTheta);
+
+    return dir;
+}
+
+float BackgroundLight::GetDirectionPdf(const Vector4& dir) const
+{
+    if (!mImportanceMap)
+    {
+        return UniformSpherePdf();
+    }
+
+    const Vector4 coords = CartesianToSphericalCoordinates(dir);
+    const uint32 x = Min(static_cast<uint32>(coords.x * static_cast<float>(ImportanceMapWidth)), ImportanceMapWidth - 1u);
+    const uint32 y = Min(static_cast<uint32>(coords.y * static_cast<float>(ImportanceMapHeight)), ImportanceMapHeight - 1u);
+
+    const float sinTheta = Max(sqrtf(Max(0.0f, 1.0f - Sqr(dir.y))), FLT_EPSILON);
+    return mImportanceMap->GetPdf(ImportanceMapWidth * y + x) / (2.0f * Sqr(RT_PI) * sinTheta);
+}
+
 ILight::Type BackgroundLight::GetType() const
 {
     return Type::Background;
@@ -62,10 +176,21 @@ const RayColor BackgroundLight::GetBackgroundColor(const Vector4& dir, const Wav
 
 const RayColor BackgroundLight::Illuminate(const IlluminateParam& param, IlluminateResult& outResult) const
 {
-    const Vector4 randomDirLocalSpace = SamplingHelpers::GetHemishpere(param.sample);
-    outResult.directionToLight = param.intersection.LocalToWorld(randomDirLocalSpace);
-    outResult.directPdfW = UniformHemispherePdf();
-    outResult.emissionPdfW = UniformSpherePdf() * UniformCirclePdf(SceneRadius);
+    if (mImportanceMap)
+    {
+        float pdfW = 0.0f;
+        outResult.directionToLight = SampleDirection(Float2(param.sample.x, param.sample.y), pdfW);
+        outResult.directPdfW = pdfW;
+        outResult.emissionPdfW = pdfW * UniformCirclePdf(SceneRadius);
+    }
+    else
+    {
+        const Vector4 randomDirLocalSpace = SamplingHelpers::GetHemishpere(param.sample);
+        outResult.directionToLight = param.intersection.LocalToWorld(randomDirLocalSpace);
+        outResult.directPdfW = UniformHemispherePdf();
+        outResult.emissionPdfW = UniformSpherePdf() * UniformCirclePdf(SceneRadius);
+    }
+
     outResult.distance = BackgroundLightDistance;
     outResult.cosAtLight = 1.0f;
 
@@ -75,14 +200,18 @@ const RayColor BackgroundLight::Illuminate(const IlluminateParam& param, Illumin
 
 const RayColor BackgroundLight::GetRadiance(const RadianceParam& param, float* outDirectPdfA, float* outEmissionPdfW) const
 {
+    // NOTE: without importance map, direct sampling is uniform over hemisphere
+    const float directionPdf = mImportanceMap ? GetDirectionPdf(param.ray.dir) : UniformHemispherePdf();
+    const float emissionDirectionPdf = mImportanceMap ? directionPdf : UniformSpherePdf();
+
     if (outDirectPdfA)
     {
-        *outDirectPdfA = UniformHemispherePdf();
+        *outDirectPdfA = directionPdf;
     }
 
     if (outEmissionPdfW)
     {
-        *outEmissionPdfW = UniformSpherePdf() * UniformCirclePdf(SceneRadius);
+        *outEmissionPdfW = emissionDirectionPdf * UniformCirclePdf(SceneRadius);
     }
 
     // TODO include light rotation
@@ -91,9 +220,18 @@ const RayColor BackgroundLight::GetRadiance(const RadianceParam& param, float* o
 
 const RayColor BackgroundLight::Emit(const EmitParam& param, EmitResult& outResult) const
 {
+    float directionPdf = UniformSpherePdf();
+
     // generate random direction on sphere
-    // TODO texture importance sampling
-    outResult.direction = SamplingHelpers::GetSphere(param.directionSample);
+    if (mImportanceMap)
+    {
+        // photons travel in the opposite direction than the sampled direction towards the light
+        outResult.direction = -SampleDirection(param.directionSample, directionPdf);
+    }
+    else
+    {
+        outResult.direction = SamplingHelpers::GetSphere(param.directionSample);
+    }
 
     // generate random origin
     const Vector4 uv = SamplingHelpers::GetCircle(param.positionSample);
@@ -104,8 +242,8 @@ const RayColor BackgroundLight::Emit(const EmitParam& param, EmitResult& outResu
         outResult.position = SceneRadius * (u * uv.x + v * uv.y - outResult.direction);
     }
 
-    outResult.directPdfA = UniformHemispherePdf();
-    outResult.emissionPdfW = UniformSpherePdf() * UniformCirclePdf(SceneRadius);
+    outResult.directPdfA = mImportanceMap ? directionPdf : UniformHemispherePdf();
+    outResult.emissionPdfW = directionPdf * UniformCirclePdf(SceneRadius);
     outResult.cosAtLight = 1.0f;
 
     // TODO include light rotation
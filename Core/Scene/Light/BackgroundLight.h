@@ -7,14 +7,23 @@ namespace rt {
 class ITexture;
 using TexturePtr = std::shared_ptr<ITexture>;
 
+namespace math {
+class Distribution;
+}
+
 class BackgroundLight : public ILight
 {
 public:
     RAYLIB_API BackgroundLight();
     RAYLIB_API BackgroundLight(const math::Vector4& color);
+    RAYLIB_API ~BackgroundLight();
 
     TexturePtr mTexture = nullptr;
 
+    // build importance map of the texture, so the light is sampled proportionally to its radiance
+    // NOTE: must be called again when the texture changes
+    RAYLIB_API bool MakeSamplable();
+
     virtual Type GetType() const override;
     virtual const math::Box GetBoundingBox() const override;
     virtual bool TestRayHit(const math::Ray& ray, float& outDistance) const override;
@@ -24,6 +33,15 @@ public:
     virtual Flags GetFlags() const override final;
 
     const RayColor GetBackgroundColor(const math::Vector4& dir, const Wavelength& wavelength) const;
+
+private:
+    // sample direction towards the light according to the importance map
+    const math::Vector4 SampleDirection(const math::Float2 u, float& outPdfW) const;
+
+    // solid angle pdf of sampling given direction towards the light
+    float GetDirectionPdf(const math::Vector4& dir) const;
+
+    std::unique_ptr<math::Distribution> mImportanceMap;
 };
 
 } // namespace rt
@@ -27,6 +27,7 @@ public:
     enum class Type : uint8
     {
         Area,
+        Mesh,
         Background,
         Directional,
         Point,
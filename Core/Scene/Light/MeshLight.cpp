@@ -0,0 +1,29 @@
+#include "PCH.h"
+#include "MeshLight.h"
+#include "../../Shapes/MeshShape.h"
+
+namespace rt {
+
+using namespace math;
+
+MeshLight::MeshLight(const MeshShapePtr& mesh, const Vector4& color)
+    : AreaLight(mesh, color)
+    , mMesh(mesh)
+{
+}
+
+ILight::Type MeshLight::GetType() const
+{
+    return Type::Mesh;
+}
+
+bool MeshLight::TestRayHit(const Ray& ray, float& outDistance) const
+{
+    RT_FATAL("Mesh light must be traversed via mesh BVH");
+
+    RT_UNUSED(ray);
+    RT_UNUSED(outDistance);
+    return false;
+}
+
+} // namespace rt
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "AreaLight.h"
+
+namespace rt {
+
+class MeshShape;
+using MeshShapePtr = std::shared_ptr<MeshShape>;
+
+// area light emitting from surface of a triangle mesh
+// NOTE: rays are traced against mesh's BVH, so the light reports hit triangles as sub-objects
+class MeshLight : public AreaLight
+{
+public:
+    RAYLIB_API MeshLight(const MeshShapePtr& mesh, const math::Vector4& color);
+
+    RT_FORCE_INLINE const MeshShape& GetMesh() const { return *mMesh; }
+
+    virtual Type GetType() const override;
+    virtual bool TestRayHit(const math::Ray& ray, float& outDistance) const override;
+
+private:
+    MeshShapePtr mMesh;
+};
+
+} // namespace rt
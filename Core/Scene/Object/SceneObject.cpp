@@ -1,5 +1,6 @@
 #include "PCH.h"
 #include "SceneObject.h"
+#include "Traversal/Traversal_Simd.h"
 
 namespace rt {
 
@@ -43,4 +44,9 @@ const Matrix4 ISceneObject::GetInverseTransform(const float t) const
     return mInverseTranform;
 }
 
+void ITraceableSceneObject::Traverse_Shadow_Simd8(const SimdShadowTraversalContext& context) const
+{
+    GenericTraverse_Shadow_SingleRays(context, this);
+}
+
 } // namespace rt
@@ -14,6 +14,7 @@ struct HitPoint;
 struct IntersectionData;
 struct SingleTraversalContext;
 struct PacketTraversalContext;
+struct SimdShadowTraversalContext;
 
 class Material;
 using MaterialPtr = std::shared_ptr<rt::Material>;
@@ -64,6 +65,10 @@ public:
     // check shadow ray occlusion
     virtual bool Traverse_Shadow(const SingleTraversalContext& context) const = 0;
 
+    // check occlusion of 8 shadow rays at a time (occluded lanes are terminated in the context)
+    // NOTE: default implementation tests the rays one by one
+    virtual void Traverse_Shadow_Simd8(const SimdShadowTraversalContext& context) const;
+
     // Calculate input data for shading routine
     // NOTE: all calculations are performed in local space
     // NOTE: frame[3] (translation) will be already filled, because it can be always calculated from ray distance
@@ -33,13 +33,29 @@ void DecalSceneObject::Apply(ShadingData& shadingData, RenderingContext& context
         return;
     }
 
-    const Vector4 decalBaseColorRgs = baseColor.Evaluate(decalSpacePos);
+    // decal is projected along its Z axis, so only X and Y span the texture space
+    // NOTE: Z coordinate of the texture coordinates is filter footprint (see BitmapTexture)
+    float footprint = 0.0f;
+    if (shadingData.intersection.surfaceFootprint > 0.0f)
+    {
+        const Vector4 decalSpaceTangent = GetBaseInverseTransform().TransformVector(shadingData.intersection.frame[0]);
+        const Vector4 decalSpaceBitangent = GetBaseInverseTransform().TransformVector(shadingData.intersection.frame[1]);
+        const float tangentScale = Vector4(decalSpaceTangent.x, decalSpaceTangent.y, 0.0f).Length3();
+        const float bitangentScale = Vector4(decalSpaceBitangent.x, decalSpaceBitangent.y, 0.0f).Length3();
+
+        // decal space spans [-1...1] range, while texture coordinates span [0...1]
+        footprint = 0.5f * shadingData.intersection.surfaceFootprint * Max(tangentScale, bitangentScale);
+    }
+
+    const Vector4 decalTexCoords(decalSpacePos.x, decalSpacePos.y, footprint);
+
+    const Vector4 decalBaseColorRgs = baseColor.Evaluate(decalTexCoords);
     const RayColor decalBaseColor = RayColor::Resolve(context.wavelength, Spectrum(decalBaseColorRgs));
     const float alpha = Lerp(alphaMin, alphaMax, decalBaseColorRgs.w);
 
     shadingData.materialParams.baseColor = RayColor::Lerp(shadingData.materialParams.baseColor, decalBaseColor, alpha);
 
-    const float decalRoughness = roughness.Evaluate(decalSpacePos);
+    const float decalRoughness = roughness.Evaluate(decalTexCoords);
     shadingData.materialParams.roughness = Lerp(shadingData.materialParams.roughness, decalRoughness, alpha);
 }
 
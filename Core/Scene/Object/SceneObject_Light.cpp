@@ -2,7 +2,8 @@
 #include "SceneObject_Light.h"
 #include "../Light/Light.h"
 #include "../Light/AreaLight.h"
-#include "../../Shapes/Shape.h"
+#include "../Light/MeshLight.h"
+#include "../../Shapes/MeshShape.h"
 #include "Traversal/TraversalContext.h"
 
 namespace rt {
@@ -26,6 +27,21 @@ Box LightSceneObject::GetBoundingBox() const
 
 void LightSceneObject::Traverse(const SingleTraversalContext& context, const uint32 objectID) const
 {
+    if (mLight->GetType() == ILight::Type::Mesh)
+    {
+        const MeshShape& mesh = static_cast<const MeshLight&>(*mLight).GetMesh();
+
+        const float prevDistance = context.hitPoint.distance;
+        mesh.Traverse(context, objectID);
+
+        if (context.hitPoint.distance < prevDistance)
+        {
+            // mark as light, but keep the triangle index
+            context.hitPoint.subObjectId |= RT_LIGHT_SUB_OBJECT_FLAG;
+        }
+        return;
+    }
+
     float lightDistance;
     if (mLight->TestRayHit(context.ray, lightDistance))
     {
@@ -39,6 +55,11 @@ void LightSceneObject::Traverse(const SingleTraversalContext& context, const uin
 
 bool LightSceneObject::Traverse_Shadow(const SingleTraversalContext& context) const
 {
+    if (mLight->GetType() == ILight::Type::Mesh)
+    {
+        return static_cast<const MeshLight&>(*mLight).GetMesh().Traverse_Shadow(context);
+    }
+
     float lightDistance;
     if (mLight->TestRayHit(context.ray, lightDistance))
     {
@@ -52,6 +73,17 @@ bool LightSceneObject::Traverse_Shadow(const SingleTraversalContext& context) co
     return false;
 }
 
+void LightSceneObject::Traverse_Shadow_Simd8(const SimdShadowTraversalContext& context) const
+{
+    if (mLight->GetType() == ILight::Type::Mesh)
+    {
+        static_cast<const MeshLight&>(*mLight).GetMesh().Traverse_Shadow_Simd8(context);
+        return;
+    }
+
+    ITraceableSceneObject::Traverse_Shadow_Simd8(context);
+}
+
 void LightSceneObject::Traverse(const PacketTraversalContext& context, const uint32 objectID, const uint32 numActiveGroups) const
 {
     RT_UNUSED(context);
@@ -67,6 +99,14 @@ void LightSceneObject::EvaluateIntersection(const HitPoint& hitPoint, Intersecti
         const AreaLight& areaLight = static_cast<const AreaLight&>(*mLight);
         areaLight.GetShape()->EvaluateIntersection(hitPoint, outIntersectionData);
     }
+    else if (mLight->GetType() == ILight::Type::Mesh)
+    {
+        HitPoint meshHitPoint = hitPoint;
+        meshHitPoint.subObjectId &= ~RT_LIGHT_SUB_OBJECT_FLAG;
+
+        const MeshLight& meshLight = static_cast<const MeshLight&>(*mLight);
+        meshLight.GetMesh().EvaluateIntersection(meshHitPoint, outIntersectionData);
+    }
     else
     {
         RT_FATAL("Cannot evaluate intersection for non-area lights");
@@ -48,6 +48,11 @@ bool ShapeSceneObject::Traverse_Shadow(const SingleTraversalContext& context) co
     return mShape->Traverse_Shadow(context);
 }
 
+void ShapeSceneObject::Traverse_Shadow_Simd8(const SimdShadowTraversalContext& context) const
+{
+    mShape->Traverse_Shadow_Simd8(context);
+}
+
 void ShapeSceneObject::Traverse(const PacketTraversalContext& context, const uint32 objectID, const uint32 numActiveGroups) const
 {
     // TODO
@@ -23,6 +23,7 @@ private:
     virtual void Traverse(const PacketTraversalContext& context, const uint32 objectID, const uint32 numActiveGroups) const override;
 
     virtual bool Traverse_Shadow(const SingleTraversalContext& context) const override;
+    virtual void Traverse_Shadow_Simd8(const SimdShadowTraversalContext& context) const override;
 
     virtual void EvaluateIntersection(const HitPoint& hitPoint, IntersectionData& outIntersectionData) const override;
 
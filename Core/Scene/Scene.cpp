@@ -6,10 +6,12 @@
 #include "Rendering/ShadingData.h"
 #include "BVH/BVHBuilder.h"
 #include "Material/Material.h"
+#include "Utils/Logger.h"
 #include "Utils/Profiler.h"
 
 #include "Traversal/Traversal_Single.h"
 #include "Traversal/Traversal_Packet.h"
+#include "Traversal/Traversal_Simd.h"
 
 namespace rt {
 
@@ -84,6 +86,11 @@ bool Scene::BuildBVH()
             return false;
         }
 
+        if (!mTraceableObjectsBVH.CreateNumaReplicas())
+        {
+            return false;
+        }
+
         DynArray<const ITraceableSceneObject*> newObjectsArray;
         newObjectsArray.Reserve(mTraceableObjects.Size());
         for (uint32 i = 0; i < mTraceableObjects.Size(); ++i)
@@ -94,34 +101,77 @@ bool Scene::BuildBVH()
         mTraceableObjects = std::move(newObjectsArray);
     }
 
-    // build BVH for decals
+    // build acceleration structure for decals
+    if (!mDecalsGrid.Build(mDecals))
     {
-        DynArray<Box> boxes;
-        for (const DecalSceneObject* decal : mDecals)
-        {
-            boxes.PushBack(decal->GetBoundingBox());
-        }
+        return false;
+    }
 
-        BvhBuildingParams params;
-        params.heuristics = BvhBuildingParams::Heuristics::Volume;
+    return true;
+}
 
-        BVHBuilder::Indices newOrder;
-        BVHBuilder bvhBuilder(mDecalsBVH);
-        if (!bvhBuilder.Build(boxes.Data(), boxes.Size(), params, newOrder))
+bool Scene::RefitBVH()
+{
+    // traceable objects are already in the BVH leaves order
+    DynArray<Box> boxes;
+    boxes.Reserve(mTraceableObjects.Size());
+    for (const ISceneObject* obj : mTraceableObjects)
+    {
+        boxes.PushBack(obj->GetBoundingBox());
+    }
+
+    if (!mTraceableObjectsBVH.Refit(boxes.Data(), boxes.Size()))
+    {
+        return false;
+    }
+
+    return mDecalsGrid.Build(mDecals);
+}
+
+template<typename ObjectType>
+static void ReplacePointer(DynArray<const ObjectType*>& objects, const ISceneObject* oldObject, const ISceneObject* newObject)
+{
+    for (const ObjectType*& object : objects)
+    {
+        if (object == oldObject)
         {
-            return false;
+            object = static_cast<const ObjectType*>(newObject);
         }
+    }
+}
+
+bool Scene::ReplaceObject(uint32 index, SceneObjectPtr object)
+{
+    RT_ASSERT(index < mAllObjects.Size());
+
+    const ISceneObject* oldObject = mAllObjects[index].get();
 
-        DynArray<const DecalSceneObject*> newObjectsArray;
-        newObjectsArray.Reserve(mDecals.Size());
-        for (uint32 i = 0; i < mDecals.Size(); ++i)
+    if (!object || object->GetType() != oldObject->GetType())
+    {
+        RT_LOG_ERROR("Scene object can be only replaced with an object of the same type");
+        return false;
+    }
+
+    if (object->GetType() == ISceneObject::Type::Light)
+    {
+        const ILight& oldLight = static_cast<const LightSceneObject*>(oldObject)->GetLight();
+        const ILight& newLight = static_cast<const LightSceneObject*>(object.get())->GetLight();
+
+        // finite lights are traceable, infinite ones are not
+        if ((oldLight.GetFlags() & ILight::Flag_IsFinite) != (newLight.GetFlags() & ILight::Flag_IsFinite))
         {
-            uint32 sourceIndex = newOrder[i];
-            newObjectsArray.PushBack(mDecals[sourceIndex]);
+            RT_LOG_ERROR("Finite light can be only replaced with a finite light");
+            return false;
         }
-        mDecals = std::move(newObjectsArray);
     }
 
+    ReplacePointer(mTraceableObjects, oldObject, object.get());
+    ReplacePointer(mLights, oldObject, object.get());
+    ReplacePointer(mGlobalLights, oldObject, object.get());
+    ReplacePointer(mDecals, oldObject, object.get());
+
+    mAllObjects[index] = std::move(object);
+
     return true;
 }
 
@@ -164,6 +214,29 @@ bool Scene::Traverse_Object_Shadow(const SingleTraversalContext& context, const
     return object->Traverse_Shadow(objectContext);
 }
 
+void Scene::Traverse_Object_Shadow_Simd8(const SimdShadowTraversalContext& context, const uint32 objectID) const
+{
+    const ITraceableSceneObject* object = mTraceableObjects[objectID];
+
+    const Matrix4 invTransform = object->GetInverseTransform(context.context.time);
+
+    // transform rays to local-space
+    // Note: exact reciprocal is used, so the rays are not less conservative than single shadow rays
+    Ray_Simd8 transformedRay;
+    transformedRay.origin = invTransform.TransformPoint(context.ray.origin);
+    transformedRay.dir = invTransform.TransformVector(context.ray.dir);
+    transformedRay.invDir = Vector3x8::Reciprocal(transformedRay.dir);
+
+    const SimdShadowTraversalContext objectContext =
+    {
+        transformedRay,
+        context.maxDistances,
+        context.context
+    };
+
+    object->Traverse_Shadow_Simd8(objectContext);
+}
+
 void Scene::Traverse_Leaf(const SingleTraversalContext& context, const uint32 objectID, const BVH::Node& node) const
 {
     RT_UNUSED(objectID);
@@ -193,6 +266,24 @@ bool Scene::Traverse_Leaf_Shadow(const SingleTraversalContext& context, const BV
     return false;
 }
 
+bool Scene::Traverse_Leaf_Shadow_Simd8(const SimdShadowTraversalContext& context, const BVH::Node& node) const
+{
+    const uint32 numLeaves = node.numLeaves;
+    const uint32 firstChild = node.childIndex;
+
+    for (uint32 i = 0; i < numLeaves; ++i)
+    {
+        Traverse_Object_Shadow_Simd8(context, firstChild + i);
+
+        if (context.GetActiveMask() == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void Scene::Traverse_Leaf(const PacketTraversalContext& context, const uint32 objectID, const BVH::Node& node, uint32 numActiveGroups) const
 {
     RT_UNUSED(objectID);
@@ -260,6 +351,28 @@ bool Scene::Traverse_Shadow(const SingleTraversalContext& context) const
     }
 }
 
+int32 Scene::Traverse_Shadow_Simd8(const SimdShadowTraversalContext& context) const
+{
+    const int32 initialActiveMask = context.GetActiveMask();
+
+    const uint32 numObjects = mTraceableObjects.Size();
+
+    if (numObjects == 0 || initialActiveMask == 0) // scene is empty or nothing to trace
+    {
+        return 0;
+    }
+    else if (numObjects == 1) // bypass BVH
+    {
+        Traverse_Object_Shadow_Simd8(context, 0);
+    }
+    else // full BVH traversal
+    {
+        GenericTraverse_Shadow(context, this);
+    }
+
+    return initialActiveMask & ~context.GetActiveMask();
+}
+
 void Scene::Traverse(const PacketTraversalContext& context) const
 {
     const uint32 numObjects = mTraceableObjects.Size();
@@ -302,7 +415,7 @@ void Scene::Traverse(const PacketTraversalContext& context) const
     }
 }
 
-void Scene::EvaluateIntersection(const Ray& ray, const HitPoint& hitPoint, const float time, IntersectionData& outData) const
+void Scene::EvaluateIntersection(const Ray& ray, const HitPoint& hitPoint, const float time, IntersectionData& outData, const float rayFootprint) const
 {
     RT_SCOPED_TIMER(Scene_EvaluateIntersection);
 
@@ -317,11 +430,23 @@ void Scene::EvaluateIntersection(const Ray& ray, const HitPoint& hitPoint, const
     outData.frame[3] = invTransform.TransformPoint(worldPosition);
 
     // calculate normal, tangent, tex coord, etc. from intersection data
+    outData.texCoordScale = 0.0f;
     object->EvaluateIntersection(hitPoint, outData);
     RT_ASSERT(outData.texCoord.IsValid());
 
     Vector4 localSpaceTangent = outData.frame[0];
     Vector4 localSpaceNormal = outData.frame[2];
+
+    // project ray footprint onto the surface and convert it to texture space (used for mip level selection)
+    {
+        outData.surfaceFootprint = 0.0f;
+        if (rayFootprint > 0.0f)
+        {
+            const float cosTheta = Abs(Vector4::Dot3(invTransform.TransformVector(ray.dir), localSpaceNormal));
+            outData.surfaceFootprint = rayFootprint / Max(cosTheta, 0.05f);
+        }
+        outData.texCoord.z = outData.surfaceFootprint * outData.texCoordScale;
+    }
     Vector4 localSpaceBitangent = Vector4::Cross3(localSpaceTangent, localSpaceNormal);
 
     // apply normal mapping
@@ -374,91 +499,11 @@ void Scene::EvaluateShadingData(ShadingData& shadingData, RenderingContext& cont
 
 void Scene::EvaluateDecals(ShadingData& shadingData, RenderingContext& context) const
 {
-    if (mDecals.Empty())
-    {
-        return; // no decals
-    }
-
-    const uint32 maxOverlappingDecals = 8;
-    uint32 numOverlappingDecals = 0;
-    const DecalSceneObject* decals[maxOverlappingDecals];
-
-    // collect overlapping decals
-
+    // NOTE: cell lists are presorted in application order
     const Vector4& point = shadingData.intersection.frame.GetTranslation();
-
-    // all nodes
-    const BVH::Node* __restrict nodes = mDecalsBVH.GetNodes();
-
-    // "nodes to visit" stack
-    uint32 stackSize = 0;
-    const BVH::Node* __restrict nodesStack[BVH::MaxDepth];
-
-    // BVH traversal
-    for (const BVH::Node* __restrict currentNode = nodes;;)
+    for (const DecalSceneObject* decal : mDecalsGrid.Find(point))
     {
-        if (currentNode->IsLeaf())
-        {
-            const uint32 numLeaves = currentNode->numLeaves;
-            const uint32 firstChild = currentNode->childIndex;
-
-            for (uint32 i = 0; i < numLeaves; ++i)
-            {
-                RT_ASSERT(numOverlappingDecals < maxOverlappingDecals);
-                decals[numOverlappingDecals++] = mDecals[firstChild + i];
-            }
-        }
-        else
-        {
-            const BVH::Node* __restrict childA = nodes + currentNode->childIndex;
-            const BVH::Node* __restrict childB = childA + 1;
-
-            bool hitA = childA->GetBox().Intersects(point);
-            bool hitB = childB->GetBox().Intersects(point);
-
-            if (hitA && hitB)
-            {
-                currentNode = childA;
-                nodesStack[stackSize++] = childB;
-                continue;
-            }
-            if (hitA)
-            {
-                currentNode = childA;
-                continue;
-            }
-            if (hitB)
-            {
-                currentNode = childB;
-                continue;
-            }
-        }
-
-        if (stackSize == 0)
-        {
-            break;
-        }
-
-        // pop a node
-        currentNode = nodesStack[--stackSize];
-    }
-
-    if (numOverlappingDecals > 0u)
-    {
-        struct DecalSorter
-        {
-            RT_FORCE_INLINE bool operator() (const DecalSceneObject* a, const DecalSceneObject* b) const
-            {
-                return a->order > b->order;
-            }
-        };
-        std::sort(decals, decals + numOverlappingDecals, DecalSorter());
-
-        // apply decals
-        for (uint32 i = 0; i < numOverlappingDecals; ++i)
-        {
-            decals[i]->Apply(shadingData, context);
-        }
+        decal->Apply(shadingData, context);
     }
 }
 
@@ -5,6 +5,7 @@
 #include "../Color/RayColor.h"
 #include "../Traversal/HitPoint.h"
 #include "../BVH/BVH.h"
+#include "DecalGrid.h"
 #include "../Containers/DynArray.h"
 
 namespace rt {
@@ -21,6 +22,7 @@ struct ShadingData;
 struct IntersectionData;
 struct SingleTraversalContext;
 struct PacketTraversalContext;
+struct SimdShadowTraversalContext;
 
 using SceneObjectPtr = std::unique_ptr<ISceneObject>;
 using LightPtr = std::unique_ptr<ILight>;
@@ -47,6 +49,18 @@ public:
 
     RAYLIB_API bool BuildBVH();
 
+    // update bounds of the acceleration structures after objects were moved, without rebuilding them
+    RAYLIB_API bool RefitBVH();
+
+    // replace an object keeping its place in the acceleration structures (the new object must be of the same kind)
+    // NOTE: RefitBVH() must be called afterwards if bounds of the object changed
+    RAYLIB_API bool ReplaceObject(uint32 index, SceneObjectPtr object);
+
+    // objects are indexed in the order they were added
+    RT_FORCE_INLINE uint32 GetNumObjects() const { return mAllObjects.Size(); }
+    RT_FORCE_INLINE ISceneObject* GetSceneObject(uint32 index) { return mAllObjects[index].get(); }
+    RT_FORCE_INLINE const ISceneObject* GetSceneObject(uint32 index) const { return mAllObjects[index].get(); }
+
     RT_FORCE_INLINE const BVH& GetBVH() const { return mTraceableObjectsBVH; }
     RT_FORCE_INLINE const ITraceableSceneObject* GetHitObject(uint32 id) const { return mTraceableObjects[id]; }
     RT_FORCE_INLINE const DynArray<const LightSceneObject*>& GetLights() const { return mLights; }
@@ -57,9 +71,14 @@ public:
     RAYLIB_API void Traverse(const PacketTraversalContext& context) const;
 
     // cast shadow ray
-    bool Traverse_Shadow(const SingleTraversalContext& context) const;
+    RAYLIB_API bool Traverse_Shadow(const SingleTraversalContext& context) const;
+
+    // cast 8 shadow rays at a time, lanes with negative max distance are ignored
+    // returns bit mask of occluded rays
+    RAYLIB_API int32 Traverse_Shadow_Simd8(const SimdShadowTraversalContext& context) const;
 
-    RAYLIB_API void EvaluateIntersection(const math::Ray& ray, const HitPoint& hitPoint, const float time, IntersectionData& outIntersectionData) const;
+    // rayFootprint is the world-space width of the ray cone at the hit point (zero disables texture filtering)
+    RAYLIB_API void EvaluateIntersection(const math::Ray& ray, const HitPoint& hitPoint, const float time, IntersectionData& outIntersectionData, const float rayFootprint = 0.0f) const;
 
     void TraceRay_Simd8(const math::Ray_Simd8& ray, RenderingContext& context, RayColor* outColors) const;
 
@@ -67,6 +86,7 @@ public:
     void Traverse_Leaf(const PacketTraversalContext& context, const uint32 objectID, const BVH::Node& node, uint32 numActiveGroups) const;
 
     bool Traverse_Leaf_Shadow(const SingleTraversalContext& context, const BVH::Node& node) const;
+    bool Traverse_Leaf_Shadow_Simd8(const SimdShadowTraversalContext& context, const BVH::Node& node) const;
 
     void EvaluateShadingData(ShadingData& shadingData, RenderingContext& context) const;
 
@@ -76,6 +96,7 @@ private:
 
     RT_FORCE_NOINLINE void Traverse_Object(const SingleTraversalContext& context, const uint32 objectID) const;
     RT_FORCE_NOINLINE bool Traverse_Object_Shadow(const SingleTraversalContext& context, const uint32 objectID) const;
+    RT_FORCE_NOINLINE void Traverse_Object_Shadow_Simd8(const SimdShadowTraversalContext& context, const uint32 objectID) const;
 
     void EvaluateDecals(ShadingData& shadingData, RenderingContext& context) const;
 
@@ -89,7 +110,7 @@ private:
     BVH mTraceableObjectsBVH;
 
     DynArray<const DecalSceneObject*> mDecals;
-    BVH mDecalsBVH;
+    DecalGrid mDecalsGrid;
 };
 
 } // namespace rt
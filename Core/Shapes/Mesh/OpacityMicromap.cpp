@@ -0,0 +1,171 @@
+#include "PCH.h"
+#include "OpacityMicromap.h"
+#include "VertexBuffer.h"
+#include "Material/Material.h"
+#include "Utils/Logger.h"
+#include "Utils/Profiler.h"
+
+namespace rt {
+
+using namespace math;
+
+void OpacityMicromap::Clear()
+{
+    mTriangleEntries.Clear();
+    mBlocks.Clear();
+}
+
+bool OpacityMicromap::Build(const VertexBuffer& vertexBuffer)
+{
+    RT_SCOPED_TIMER(OpacityMicromap_Build);
+
+    Clear();
+
+    const uint32 numTriangles = vertexBuffer.GetNumTriangles();
+
+    const auto getMaskedMaterial = [&vertexBuffer](const VertexIndices& indices) -> const Material*
+    {
+        if (indices.materialIndex == UINT32_MAX)
+        {
+            return nullptr;
+        }
+
+        const Material* material = vertexBuffer.GetMaterial(indices.materialIndex);
+        return (material && material->maskMap) ? material : nullptr;
+    };
+
+    // don't waste memory on meshes without masked materials
+    {
+        bool hasMaskedTriangles = false;
+        for (uint32 i = 0; i < numTriangles && !hasMaskedTriangles; ++i)
+        {
+            VertexIndices indices;
+            vertexBuffer.GetVertexIndices(i, indices);
+            hasMaskedTriangles = getMaskedMaterial(indices) != nullptr;
+        }
+
+        if (!hasMaskedTriangles)
+        {
+            return true;
+        }
+    }
+
+    uint32 numOpaqueTriangles = 0;
+    uint32 numTransparentTriangles = 0;
+
+    mTriangleEntries.Resize(numTriangles);
+
+    for (uint32 triangleIndex = 0; triangleIndex < numTriangles; ++triangleIndex)
+    {
+        VertexIndices indices;
+        vertexBuffer.GetVertexIndices(triangleIndex, indices);
+
+        const Material* material = getMaskedMaterial(indices);
+        if (!material)
+        {
+            mTriangleEntries[triangleIndex] = static_cast<uint32>(OpacityState::Opaque);
+            numOpaqueTriangles++;
+            continue;
+        }
+
+        VertexShadingData vertexShadingData[3];
+        vertexBuffer.GetShadingData(indices, vertexShadingData[0], vertexShadingData[1], vertexShadingData[2]);
+
+        const Vector4 texCoord0(vertexShadingData[0].texCoord);
+        const Vector4 texCoord1(vertexShadingData[1].texCoord);
+        const Vector4 texCoord2(vertexShadingData[2].texCoord);
+
+        // same interpolation as in MeshShape::EvaluateIntersection
+        const auto interpolateTexCoord = [&](uint32 a, uint32 b)
+        {
+            const float u = static_cast<float>(a) / static_cast<float>(NumSegments);
+            const float v = static_cast<float>(b) / static_cast<float>(NumSegments);
+
+            Vector4 texCoord = Vector4(u) * texCoord1;
+            texCoord = Vector4::MulAndAdd(Vector4(v), texCoord2, texCoord);
+            texCoord = Vector4::MulAndAdd(Vector4(1.0f - u - v), texCoord0, texCoord);
+            return texCoord;
+        };
+
+        // texture coordinates are linear, so the bounding box of the corners bounds the whole (micro-)triangle
+        const auto getTriangleCoverage = [&](const Vector4& a, const Vector4& b, const Vector4& c, bool& outOpaque, bool& outTransparent)
+        {
+            const Vector4 minUV = Vector4::Min(a, Vector4::Min(b, c));
+            const Vector4 maxUV = Vector4::Max(a, Vector4::Max(b, c));
+            material->GetMaskCoverage(minUV, maxUV, outOpaque, outTransparent);
+        };
+
+        Block block = { 0, 0 };
+
+        bool isTriangleOpaque = false;
+        bool isTriangleTransparent = false;
+        getTriangleCoverage(texCoord0, texCoord1, texCoord2, isTriangleOpaque, isTriangleTransparent);
+
+        constexpr uint64 allMicroTriangles = NumMicroTriangles == 64 ? ~0ull : ((1ull << NumMicroTriangles) - 1);
+
+        if (isTriangleOpaque)
+        {
+            block.opaqueBits = allMicroTriangles;
+        }
+        else if (!isTriangleTransparent)
+        {
+            for (uint32 j = 0; j < NumSegments; ++j)
+            {
+                for (uint32 i = 0; i + j < NumSegments; ++i)
+                {
+                    for (uint32 inverted = 0; inverted < 2; ++inverted)
+                    {
+                        if (inverted && i + j == NumSegments - 1)
+                        {
+                            continue;
+                        }
+
+                        bool isOpaque = false;
+                        bool isTransparent = false;
+                        if (inverted)
+                        {
+                            getTriangleCoverage(interpolateTexCoord(i + 1, j), interpolateTexCoord(i, j + 1), interpolateTexCoord(i + 1, j + 1), isOpaque, isTransparent);
+                        }
+                        else
+                        {
+                            getTriangleCoverage(interpolateTexCoord(i, j), interpolateTexCoord(i + 1, j), interpolateTexCoord(i, j + 1), isOpaque, isTransparent);
+                        }
+
+                        const uint64 bit = 1ull << (j * (2 * NumSegments - j) + 2 * i + inverted);
+                        if (isOpaque)
+                        {
+                            block.opaqueBits |= bit;
+                        }
+                        else if (!isTransparent)
+                        {
+                            block.unknownBits |= bit;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (block.opaqueBits == allMicroTriangles)
+        {
+            mTriangleEntries[triangleIndex] = static_cast<uint32>(OpacityState::Opaque);
+            numOpaqueTriangles++;
+        }
+        else if (block.opaqueBits == 0 && block.unknownBits == 0)
+        {
+            mTriangleEntries[triangleIndex] = static_cast<uint32>(OpacityState::Transparent);
+            numTransparentTriangles++;
+        }
+        else
+        {
+            mTriangleEntries[triangleIndex] = FirstBlockEntry + mBlocks.Size();
+            mBlocks.PushBack(block);
+        }
+    }
+
+    RT_LOG_INFO("Opacity micromap built: opaque triangles=%u, transparent triangles=%u, masked triangles=%u",
+        numOpaqueTriangles, numTransparentTriangles, mBlocks.Size());
+
+    return true;
+}
+
+} // namespace rt
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../../RayLib.h"
+#include "../../Math/Math.h"
+#include "../../Containers/DynArray.h"
+
+namespace rt {
+
+class VertexBuffer;
+
+enum class OpacityState : uint8
+{
+    Transparent = 0,
+    Opaque = 1,
+    Unknown = 2, // mask texture must be evaluated
+};
+
+/**
+ * Per-triangle opacity information baked from materials' mask textures.
+ * Each masked triangle is uniformly subdivided into micro-triangles with precomputed opacity state,
+ * so the mask texture is evaluated at traversal time only for micro-triangles crossing the mask edge.
+ * The states are conservative: a micro-triangle is opaque or transparent only if the mask is uniform over all the
+ * texels its texture coordinates footprint covers (masks that can't be bounded end up with unknown state).
+ * Fully opaque and fully transparent triangles don't store micro-triangles at all.
+ */
+class OpacityMicromap
+{
+public:
+    // number of micro-triangle segments per triangle edge
+    static constexpr uint32 NumSegments = 8;
+    static constexpr uint32 NumMicroTriangles = NumSegments * NumSegments;
+
+    void Clear();
+
+    // bake the micromap for all the triangles of a vertex buffer
+    // NOTE: micromap stays empty if none of the materials has a mask texture
+    bool Build(const VertexBuffer& vertexBuffer);
+
+    // true if all the triangles are opaque
+    RT_FORCE_INLINE bool Empty() const { return mTriangleEntries.Empty(); }
+
+    RT_FORCE_INLINE OpacityState GetState(const uint32 triangleIndex, const float u, const float v) const
+    {
+        const uint32 entry = mTriangleEntries[triangleIndex];
+        if (entry < FirstBlockEntry)
+        {
+            return static_cast<OpacityState>(entry);
+        }
+
+        const Block& block = mBlocks[entry - FirstBlockEntry];
+        const uint64 bit = 1ull << GetMicroTriangleIndex(u, v);
+
+        if (block.opaqueBits & bit)
+        {
+            return OpacityState::Opaque;
+        }
+
+        return (block.unknownBits & bit) ? OpacityState::Unknown : OpacityState::Transparent;
+    }
+
+    // map barycentric coordinates to micro-triangle index (row by row, alternating upright and inverted micro-triangles)
+    RT_FORCE_INLINE static uint32 GetMicroTriangleIndex(const float u, const float v)
+    {
+        const float n = static_cast<float>(NumSegments);
+        const float fu = math::Clamp(u, 0.0f, 1.0f) * n;
+        const float fv = math::Clamp(v, 0.0f, 1.0f) * n;
+
+        const uint32 j = math::Min(static_cast<uint32>(fv), NumSegments - 1);
+        const uint32 i = math::Min(static_cast<uint32>(fu), NumSegments - 1 - j);
+        const bool inverted = (i + j < NumSegments - 1) && (fu - static_cast<float>(i) + fv - static_cast<float>(j) > 1.0f);
+
+        return j * (2 * NumSegments - j) + 2 * i + (inverted ? 1 : 0);
+    }
+
+private:
+    static_assert(NumMicroTriangles <= 64, "Micro-triangle states must fit 64-bit masks");
+
+    // triangle entries below this value are plain opacity states, higher ones are block indices
+    static constexpr uint32 FirstBlockEntry = 2;
+
+    struct Block
+    {
+        uint64 opaqueBits;
+        uint64 unknownBits;
+    };
+
+    DynArray<uint32> mTriangleEntries;
+    DynArray<Block> mBlocks;
+};
+
+} // namespace rt
@@ -40,6 +40,8 @@ void VertexBuffer::Clear()
         mPreprocessedTriangles = nullptr;
     }
 
+    mPreprocessedTrianglesReplicas.Clear();
+
     mNumVertices = 0;
     mNumTriangles = 0;
     mVertexIndexBufferOffset = 0;
@@ -127,6 +129,11 @@ bool VertexBuffer::Initialize(const VertexBufferDesc& desc)
             mPreprocessedTriangles[i].edge1 = (v1 - v0).ToFloat3();
             mPreprocessedTriangles[i].edge2 = (v2 - v0).ToFloat3();
         }
+
+        if (!mPreprocessedTrianglesReplicas.Create(mPreprocessedTriangles, preprocessedTrianglesBufferSize))
+        {
+            return false;
+        }
     }
 
     // fill index buffer
@@ -202,14 +209,14 @@ const Material* VertexBuffer::GetMaterial(const uint32 materialIndex) const
     return materialBufferData[materialIndex];
 }
 
-const math::ProcessedTriangle& VertexBuffer::GetTriangle(const uint32 triangleIndex) const
+const math::ProcessedTriangle& VertexBuffer::GetTriangle(const uint32 triangleIndex, const uint32 numaNode) const
 {
-    return mPreprocessedTriangles[triangleIndex];
+    return GetTriangles(numaNode)[triangleIndex];
 }
 
-void VertexBuffer::GetTriangle(const uint32 triangleIndex, Triangle_Simd8& outTriangle) const
+void VertexBuffer::GetTriangle(const uint32 triangleIndex, Triangle_Simd8& outTriangle, const uint32 numaNode) const
 {
-    const ProcessedTriangle& tri = mPreprocessedTriangles[triangleIndex];
+    const ProcessedTriangle& tri = GetTriangles(numaNode)[triangleIndex];
     outTriangle.v0 = Vector3x8(tri.v0);
     outTriangle.edge1 = Vector3x8(tri.edge1);
     outTriangle.edge2 = Vector3x8(tri.edge2);
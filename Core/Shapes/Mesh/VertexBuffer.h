@@ -6,6 +6,7 @@
 #include "../../Math/Triangle.h"
 #include "../../Math/Float3.h"
 #include "../../Containers/DynArray.h"
+#include "../../Utils/Numa.h"
 
 namespace rt {
 
@@ -51,8 +52,9 @@ public:
     const Material* GetMaterial(const uint32 materialIndex) const;
 
     // extract preprocessed triangle data (for one triangle)
-    const math::ProcessedTriangle& GetTriangle(const uint32 triangleIndex) const;
-    void GetTriangle(const uint32 triangleIndex, math::Triangle_Simd8& outTriangle) const;
+    // traversal code should pass NUMA node of the current thread to read node-local copy of the data
+    const math::ProcessedTriangle& GetTriangle(const uint32 triangleIndex, const uint32 numaNode = 0) const;
+    void GetTriangle(const uint32 triangleIndex, math::Triangle_Simd8& outTriangle, const uint32 numaNode = 0) const;
 
     void GetShadingData(const VertexIndices& indices, VertexShadingData& a, VertexShadingData& b, VertexShadingData& c) const;
 
@@ -61,8 +63,15 @@ public:
 
 private:
 
+    RT_FORCE_INLINE const math::ProcessedTriangle* GetTriangles(const uint32 numaNode) const
+    {
+        const void* replica = mPreprocessedTrianglesReplicas.Get(numaNode);
+        return replica ? static_cast<const math::ProcessedTriangle*>(replica) : mPreprocessedTriangles;
+    }
+
     char* mBuffer;
     math::ProcessedTriangle* mPreprocessedTriangles;
+    NumaReplicas mPreprocessedTrianglesReplicas;
 
     size_t mVertexIndexBufferOffset;
     size_t mShadingDataBufferOffset;
@@ -5,11 +5,15 @@
 
 #include "Rendering/Context.h"
 #include "Rendering/ShadingData.h"
+#include "Material/Material.h"
 #include "Traversal/TraversalContext.h"
 #include "Traversal/Traversal_Single.h"
+#include "Traversal/Traversal_Simd.h"
 
 #include "Math/Geometry.h"
 #include "Math/Simd8Geometry.h"
+#include "Math/Distribution.h"
+#include "Math/SamplingHelpers.h"
 
 #include "Utils/Logger.h"
 
@@ -60,6 +64,11 @@ bool MeshShape::Initialize(const MeshDesc& desc)
         return false;
     }
 
+    if (!mBVH.CreateNumaReplicas())
+    {
+        return false;
+    }
+
     // calculate & print stats
     {
         BVH::Stats stats;
@@ -81,16 +90,17 @@ bool MeshShape::Initialize(const MeshDesc& desc)
 
     // reorder triangles
     {
-        DynArray<uint32> newIndexBuffer(desc.vertexBufferDesc.numTriangles * 3);
+        // number of indices may not fit in 32 bits on giant meshes
+        LargeDynArray<uint32> newIndexBuffer(3 * static_cast<size_t>(desc.vertexBufferDesc.numTriangles));
         DynArray<uint32> newMaterialIndexBuffer(desc.vertexBufferDesc.numTriangles);
         for (uint32 i = 0; i < desc.vertexBufferDesc.numTriangles; ++i)
         {
-            const uint32 newTriangleIndex = newTrianglesOrder[i];
+            const size_t newTriangleIndex = newTrianglesOrder[i];
             RT_ASSERT(newTriangleIndex < desc.vertexBufferDesc.numTriangles);
 
-            newIndexBuffer[3 * i] = indexBuffer[3 * newTriangleIndex];
-            newIndexBuffer[3 * i + 1] = indexBuffer[3 * newTriangleIndex + 1];
-            newIndexBuffer[3 * i + 2] = indexBuffer[3 * newTriangleIndex + 2];
+            newIndexBuffer[3 * static_cast<size_t>(i)] = indexBuffer[3 * newTriangleIndex];
+            newIndexBuffer[3 * static_cast<size_t>(i) + 1] = indexBuffer[3 * newTriangleIndex + 1];
+            newIndexBuffer[3 * static_cast<size_t>(i) + 2] = indexBuffer[3 * newTriangleIndex + 2];
             newMaterialIndexBuffer[i] = desc.vertexBufferDesc.materialIndexBuffer[newTriangleIndex];
         }
 
@@ -107,23 +117,77 @@ bool MeshShape::Initialize(const MeshDesc& desc)
 
     // TODO reorder indices
 
+    if (!mOpacityMicromap.Build(mVertexBuffer))
+    {
+        RT_LOG_ERROR("Failed to build opacity micromap");
+        return false;
+    }
+
+    // build triangle area CDF for surface sampling
+    {
+        const uint32 numTriangles = mVertexBuffer.GetNumTriangles();
+
+        DynArray<float> triangleAreas;
+        triangleAreas.Resize(numTriangles);
+
+        double totalArea = 0.0;
+        for (uint32 i = 0; i < numTriangles; ++i)
+        {
+            const ProcessedTriangle& tri = mVertexBuffer.GetTriangle(i);
+            triangleAreas[i] = 0.5f * Vector4::Cross3(Vector4(tri.edge1), Vector4(tri.edge2)).Length3();
+            totalArea += triangleAreas[i];
+        }
+
+        mSurfaceArea = static_cast<float>(totalArea);
+
+        mTriangleDistribution.reset();
+        if (mSurfaceArea > 0.0f)
+        {
+            mTriangleDistribution = std::make_unique<Distribution>();
+            if (!mTriangleDistribution->Initialize(triangleAreas.Data(), numTriangles))
+            {
+                RT_LOG_ERROR("Failed to build triangle distribution");
+                return false;
+            }
+        }
+    }
+
     RT_LOG_INFO("MeshShape '%s' created successfully", !desc.path.empty() ? desc.path.c_str() : "unnamed");
     return true;
 }
 
 float MeshShape::GetSurfaceArea() const
 {
-    RT_FATAL("Not implemented yet");
-    return 0.0f;
+    return mSurfaceArea;
 }
 
 const Vector4 MeshShape::Sample(const Float3& u, math::Vector4* outNormal, float* outPdf) const
 {
-    RT_FATAL("Not implemented yet");
-    RT_UNUSED(u);
-    RT_UNUSED(outPdf);
-    RT_UNUSED(outNormal);
-    return Vector4::Zero();
+    RT_ASSERT(mTriangleDistribution, "Mesh has no surface to sample");
+
+    // pick triangle proportionally to its area
+    float trianglePdf;
+    const uint32 triangleIndex = mTriangleDistribution->SampleDiscrete(u.x, trianglePdf);
+    const ProcessedTriangle& tri = mVertexBuffer.GetTriangle(triangleIndex);
+
+    // uniform point on the triangle
+    const Vector4 uv = SamplingHelpers::GetTriangle(Float2(u.y, u.z));
+    const Vector4 edge1(tri.edge1);
+    const Vector4 edge2(tri.edge2);
+    const Vector4 position = Vector4::MulAndAdd(edge1, uv.x, Vector4::MulAndAdd(edge2, uv.y, Vector4(tri.v0)));
+
+    if (outNormal)
+    {
+        *outNormal = Vector4::Cross3(edge1, edge2).Normalized3();
+    }
+
+    if (outPdf)
+    {
+        // area-proportional triangle selection times uniform density on the triangle
+        *outPdf = 1.0f / mSurfaceArea;
+    }
+
+    return position;
 }
 
 void MeshShape::Traverse(const SingleTraversalContext& context, const uint32 objectID) const
@@ -145,13 +209,13 @@ void MeshShape::Traverse_Leaf(const SingleTraversalContext& context, const uint3
     for (uint32 i = 0; i < numLeaves; ++i)
     {
         const uint32 triangleIndex = childIndex + i;
-        const ProcessedTriangle& tri = mVertexBuffer.GetTriangle(triangleIndex);
+        const ProcessedTriangle& tri = mVertexBuffer.GetTriangle(triangleIndex, context.context.numaNode);
 
         if (Intersect_TriangleRay(context.ray, Vector4(&tri.v0.x), Vector4(&tri.edge1.x), Vector4(&tri.edge2.x), u, v, distance))
         {
             HitPoint& hitPoint = context.hitPoint;
 
-            if (distance < hitPoint.distance)
+            if (distance < hitPoint.distance && IsHitOpaque(triangleIndex, u, v))
             {
                 hitPoint.distance = distance;
                 hitPoint.subObjectId = triangleIndex;
@@ -186,11 +250,11 @@ bool MeshShape::Traverse_Leaf_Shadow(const SingleTraversalContext& context, cons
     for (uint32 i = 0; i < numLeaves; ++i)
     {
         const uint32 triangleIndex = childIndex + i;
-        const ProcessedTriangle& tri = mVertexBuffer.GetTriangle(triangleIndex);
+        const ProcessedTriangle& tri = mVertexBuffer.GetTriangle(triangleIndex, context.context.numaNode);
         if (Intersect_TriangleRay(context.ray, Vector4(&tri.v0.x), Vector4(&tri.edge1.x), Vector4(&tri.edge2.x), u, v, distance))
         {
             HitPoint& hitPoint = context.hitPoint;
-            if (distance < hitPoint.distance)
+            if (distance < hitPoint.distance && IsHitOpaque(triangleIndex, u, v))
             {
                 hitPoint.distance = distance;
 
@@ -206,6 +270,67 @@ bool MeshShape::Traverse_Leaf_Shadow(const SingleTraversalContext& context, cons
     return false;
 }
 
+void MeshShape::Traverse_Shadow_Simd8(const SimdShadowTraversalContext& context) const
+{
+    GenericTraverse_Shadow<MeshShape>(context, this);
+}
+
+bool MeshShape::Traverse_Leaf_Shadow_Simd8(const SimdShadowTraversalContext& context, const BVH::Node& node) const
+{
+    Vector8 distance, u, v;
+    Triangle_Simd8 tri;
+
+    const uint32 numLeaves = node.numLeaves;
+    const uint32 childIndex = node.childIndex;
+
+    for (uint32 i = 0; i < numLeaves; ++i)
+    {
+        const uint32 triangleIndex = childIndex + i;
+
+        mVertexBuffer.GetTriangle(triangleIndex, tri, context.context.numaNode);
+
+        // Note: terminated lanes have negative max distance, so they never report a hit
+        VectorBool8 mask = Intersect_TriangleRay_Simd8(context.ray.dir, context.ray.origin, tri, context.maxDistances, u, v, distance);
+
+#ifdef RT_ENABLE_INTERSECTION_COUNTERS
+        context.context.localCounters.numRayTriangleTests += PopCount(context.GetActiveMask());
+#endif // RT_ENABLE_INTERSECTION_COUNTERS
+
+        int32 intMask = mask.GetMask();
+        if (intMask == 0)
+        {
+            continue;
+        }
+
+        if (!mOpacityMicromap.Empty())
+        {
+            bool opaque[8];
+            for (uint32 k = 0; k < 8; ++k)
+            {
+                opaque[k] = (intMask & (1 << k)) && IsHitOpaque(triangleIndex, u[k], v[k]);
+            }
+            mask = VectorBool8(opaque[0], opaque[1], opaque[2], opaque[3], opaque[4], opaque[5], opaque[6], opaque[7]);
+            intMask = mask.GetMask();
+        }
+
+#ifdef RT_ENABLE_INTERSECTION_COUNTERS
+        context.context.localCounters.numPassedRayTriangleTests += PopCount(intMask);
+#endif // RT_ENABLE_INTERSECTION_COUNTERS
+
+        if (intMask)
+        {
+            context.Terminate(mask);
+
+            if (context.GetActiveMask() == 0)
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
 /*
 void MeshShape::Traverse_Leaf_Simd8(const SimdTraversalContext& context, const uint32 objectID, const BVH::Node& node) const
 {
@@ -224,7 +349,7 @@ void MeshShape::Traverse_Leaf_Simd8(const SimdTraversalContext& context, const u
         const uint32 triangleIndex = node.childIndex + i;
         const VectorInt8 triangleIndexVec(triangleIndex);
 
-        mVertexBuffer.GetTriangle(triangleIndex, tri);
+        mVertexBuffer.GetTriangle(triangleIndex, tri, context.context.numaNode);
 
         const Vector8 mask = Intersect_TriangleRay_Simd8(context.ray.dir, context.ray.origin, tri, hitPoint.distance, u, v, distance);
         const uint32 intMask = mask.GetSignMask();
@@ -261,13 +386,27 @@ void MeshShape::Traverse_Leaf(const PacketTraversalContext& context, const uint3
         const uint32 triangleIndex = node.childIndex + i;
         const Vector8 triangleIndexVec(triangleIndex);
 
-        mVertexBuffer.GetTriangle(triangleIndex, tri);
+        mVertexBuffer.GetTriangle(triangleIndex, tri, context.context.numaNode);
 
         for (uint32 j = 0; j < numActiveGroups; ++j)
         {
             RayGroup& rayGroup = context.ray.groups[context.context.activeGroupsIndices[j]];
 
-            const VectorBool8 mask = Intersect_TriangleRay_Simd8(rayGroup.rays[1].dir, rayGroup.rays[1].origin, tri, rayGroup.maxDistances, u, v, distance);
+            VectorBool8 mask = Intersect_TriangleRay_Simd8(rayGroup.rays[1].dir, rayGroup.rays[1].origin, tri, rayGroup.maxDistances, u, v, distance);
+
+            if (!mOpacityMicromap.Empty())
+            {
+                const int32 intMask = mask.GetMask();
+                if (intMask)
+                {
+                    bool opaque[8];
+                    for (uint32 k = 0; k < 8; ++k)
+                    {
+                        opaque[k] = (intMask & (1 << k)) && IsHitOpaque(triangleIndex, u[k], v[k]);
+                    }
+                    mask = VectorBool8(opaque[0], opaque[1], opaque[2], opaque[3], opaque[4], opaque[5], opaque[6], opaque[7]);
+                }
+            }
 
             context.StoreIntersection(rayGroup, distance, u, v, mask, objectID, triangleIndex);
 
@@ -280,6 +419,26 @@ void MeshShape::Traverse_Leaf(const PacketTraversalContext& context, const uint3
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+bool MeshShape::EvaluateMask(const uint32 triangleIndex, const float u, const float v) const
+{
+    VertexIndices indices;
+    mVertexBuffer.GetVertexIndices(triangleIndex, indices);
+
+    if (indices.materialIndex == UINT32_MAX)
+    {
+        return true;
+    }
+
+    VertexShadingData vertexShadingData[3];
+    mVertexBuffer.GetShadingData(indices, vertexShadingData[0], vertexShadingData[1], vertexShadingData[2]);
+
+    Vector4 texCoord = Vector4(u) * Vector4(vertexShadingData[1].texCoord);
+    texCoord = Vector4::MulAndAdd(Vector4(v), Vector4(vertexShadingData[2].texCoord), texCoord);
+    texCoord = Vector4::MulAndAdd(Vector4(1.0f - u - v), Vector4(vertexShadingData[0].texCoord), texCoord);
+
+    return mVertexBuffer.GetMaterial(indices.materialIndex)->GetMaskValue(texCoord);
+}
+
 void MeshShape::EvaluateIntersection(const HitPoint& hitPoint, IntersectionData& outData) const
  {
     VertexIndices indices;
@@ -306,6 +465,16 @@ void MeshShape::EvaluateIntersection(const HitPoint& hitPoint, IntersectionData&
     RT_ASSERT(texCoord.IsValid());
     outData.texCoord = texCoord;
 
+    // texture-space to local-space length ratio (square root of the UV to triangle area ratio)
+    {
+        const ProcessedTriangle& tri = mVertexBuffer.GetTriangle(hitPoint.subObjectId);
+        const float localArea = Vector4::Cross3(Vector4(tri.edge1), Vector4(tri.edge2)).Length3();
+        const Vector4 texEdge1 = texCoord1 - texCoord0;
+        const Vector4 texEdge2 = texCoord2 - texCoord0;
+        const float texArea = Abs(texEdge1.x * texEdge2.y - texEdge1.y * texEdge2.x);
+        outData.texCoordScale = localArea > 0.0f ? sqrtf(texArea / localArea) : 0.0f;
+    }
+
     const Vector4 tangent0(vertexShadingData[0].tangent);
     const Vector4 tangent1(vertexShadingData[1].tangent);
     const Vector4 tangent2(vertexShadingData[2].tangent);
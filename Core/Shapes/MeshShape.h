@@ -2,6 +2,7 @@
 
 #include "Shape.h"
 #include "Mesh/VertexBuffer.h"
+#include "Mesh/OpacityMicromap.h"
 
 #include "../Traversal/HitPoint.h"
 #include "../BVH/BVH.h"
@@ -13,9 +14,14 @@
 
 namespace rt {
 
+namespace math {
+class Distribution;
+}
+
 struct IntersectionData;
 struct SingleTraversalContext;
 struct PacketTraversalContext;
+struct SimdShadowTraversalContext;
 
 struct MeshDesc
 {
@@ -37,6 +43,7 @@ public:
     virtual float GetSurfaceArea() const override;
     virtual void Traverse(const SingleTraversalContext& context, const uint32 objectID) const override;
     virtual bool Traverse_Shadow(const SingleTraversalContext& context) const override;
+    virtual void Traverse_Shadow_Simd8(const SimdShadowTraversalContext& context) const override;
     virtual const math::Vector4 Sample(const math::Float3& u, math::Vector4 * outNormal, float* outPdf = nullptr) const override;
     virtual void EvaluateIntersection(const HitPoint& hitPoint, IntersectionData& outIntersectionData) const override;
 
@@ -50,14 +57,44 @@ public:
     // Returns true if any hit was found
     bool Traverse_Leaf_Shadow(const SingleTraversalContext& context, const BVH::Node& node) const;
 
+    // Returns true if all the rays are occluded
+    bool Traverse_Leaf_Shadow_Simd8(const SimdShadowTraversalContext& context, const BVH::Node& node) const;
+
 private:
 
+    // check if a hit is not cut out by the material's mask texture
+    RT_FORCE_INLINE bool IsHitOpaque(const uint32 triangleIndex, const float u, const float v) const
+    {
+        if (mOpacityMicromap.Empty())
+        {
+            return true;
+        }
+
+        const OpacityState state = mOpacityMicromap.GetState(triangleIndex, u, v);
+        if (state == OpacityState::Unknown)
+        {
+            return EvaluateMask(triangleIndex, u, v);
+        }
+
+        return state == OpacityState::Opaque;
+    }
+
+    // evaluate mask texture at a given hit point (slow path)
+    bool EvaluateMask(const uint32 triangleIndex, const float u, const float v) const;
+
     // bounding box after scaling
     math::Box mBoundingBox;
 
     // vertex data
     VertexBuffer mVertexBuffer;
 
+    // baked opacity of masked triangles
+    OpacityMicromap mOpacityMicromap;
+
+    // triangle selection table for uniform surface sampling (built on initialization)
+    std::unique_ptr<math::Distribution> mTriangleDistribution;
+    float mSurfaceArea = 0.0f;
+
     // bounding volume hierarchy for tracing acceleration
     BVH mBVH;
 
@@ -1,6 +1,7 @@
 #include "PCH.h"
 #include "Shape.h"
 #include "Traversal/TraversalContext.h"
+#include "Traversal/Traversal_Simd.h"
 
 namespace rt {
 
@@ -56,6 +57,11 @@ bool IShape::Traverse_Shadow(const SingleTraversalContext& context) const
     return intersection.farDist > 0.0f && intersection.nearDist < context.hitPoint.distance;
 }
 
+void IShape::Traverse_Shadow_Simd8(const SimdShadowTraversalContext& context) const
+{
+    GenericTraverse_Shadow_SingleRays(context, this);
+}
+
 bool IShape::Intersect(const Ray&, ShapeIntersection&) const
 {
     RT_FATAL("This shape has no volume");
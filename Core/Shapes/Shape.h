@@ -13,6 +13,7 @@ namespace rt {
 struct HitPoint;
 struct IntersectionData;
 struct SingleTraversalContext;
+struct SimdShadowTraversalContext;
 
 class Material;
 using MaterialPtr = std::shared_ptr<rt::Material>;
@@ -49,6 +50,10 @@ public:
     // traverse the object and check if the ray is occluded
     virtual bool Traverse_Shadow(const SingleTraversalContext& context) const;
 
+    // traverse the object and check which of 8 rays are occluded
+    // NOTE: default implementation tests the rays one by one
+    virtual void Traverse_Shadow_Simd8(const SimdShadowTraversalContext& context) const;
+
     // intersect with a ray and return hit points
     // TODO return array of all hit points along the ray
     virtual bool Intersect(const math::Ray& ray, ShapeIntersection& outResult) const;
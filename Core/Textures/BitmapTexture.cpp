@@ -1,10 +1,11 @@
 #include "PCH.h"
 #include "BitmapTexture.h"
-#include "../Utils/Bitmap.h"
 #include "../Utils/Logger.h"
 #include "../Math/Distribution.h"
 #include "../Containers/DynArray.h"
 #include "../Color/ColorHelpers.h"
+#include "../Math/Vector4Load.h"
+#include "../Utils/BlockCompression.h"
 
 namespace rt {
 
@@ -15,9 +16,290 @@ BitmapTexture::~BitmapTexture() = default;
 
 BitmapTexture::BitmapTexture(const BitmapPtr& bitmap)
     : mBitmap(bitmap)
+    , mMaxSize(0.0f)
     , mFilter(BitmapTextureFilter::Bilinear_SmoothStep)
-    , mForceLinearSpace(false)
-{}
+{
+    if (mBitmap)
+    {
+        GenerateMipmaps();
+    }
+}
+
+namespace {
+
+// pick mip format that decodes the same way as the source format (so compact sources keep compact mip chains)
+Bitmap::Format GetMipFormat(const Bitmap::Format sourceFormat, const uint32 width, const uint32 height)
+{
+    switch (sourceFormat)
+    {
+    case Bitmap::Format::R8_UNorm:
+    case Bitmap::Format::R8G8_UNorm:
+    case Bitmap::Format::B8G8R8_UNorm:
+    case Bitmap::Format::B8G8R8A8_UNorm:
+    case Bitmap::Format::R8G8B8A8_UNorm:
+    case Bitmap::Format::B5G6R5_UNorm:
+        return sourceFormat;
+
+    case Bitmap::Format::B8G8R8A8_UNorm_Palette:
+        return Bitmap::Format::B8G8R8A8_UNorm;
+
+    case Bitmap::Format::BC1:
+    case Bitmap::Format::BC4:
+    case Bitmap::Format::BC5:
+        // block decoders require 4-texel aligned size, so the smallest levels are stored uncompressed
+        return (width % 4u == 0 && height % 4u == 0) ? sourceFormat : Bitmap::Format::R8G8B8A8_UNorm;
+
+    default:
+        // float and 16-bit formats (already in linear space)
+        return Bitmap::Format::R16G16B16A16_Half;
+    }
+}
+
+// source texels (and their weights) covered by a destination texel when halving a mip level size in one dimension
+struct MipFilterTaps
+{
+    uint32 indices[3];
+    float weights[3];
+    uint32 count;
+};
+
+MipFilterTaps GetMipFilterTaps(const uint32 sourceSize, const uint32 x)
+{
+    MipFilterTaps taps;
+
+    if (sourceSize == 1u)
+    {
+        taps.indices[0] = 0;
+        taps.weights[0] = 1.0f;
+        taps.count = 1;
+    }
+    else if (sourceSize % 2u == 0)
+    {
+        taps.indices[0] = 2u * x;
+        taps.indices[1] = 2u * x + 1u;
+        taps.weights[0] = 0.5f;
+        taps.weights[1] = 0.5f;
+        taps.count = 2;
+    }
+    else
+    {
+        // odd size: each destination texel covers 2 + 1/n source texels (polyphase box filter),
+        // so the last source texel is not dropped
+        const uint32 n = sourceSize / 2u;
+        const float invSourceSize = 1.0f / static_cast<float>(sourceSize);
+        taps.indices[0] = 2u * x;
+        taps.indices[1] = 2u * x + 1u;
+        taps.indices[2] = 2u * x + 2u;
+        taps.weights[0] = static_cast<float>(n - x) * invSourceSize;
+        taps.weights[1] = static_cast<float>(n) * invSourceSize;
+        taps.weights[2] = static_cast<float>(x + 1u) * invSourceSize;
+        taps.count = 3;
+    }
+
+    return taps;
+}
+
+RT_FORCE_INLINE uint8 QuantizeUNorm8(const float value)
+{
+    return static_cast<uint8>(Clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+// write linear-space texels into a mip bitmap (inverse of Bitmap::GetPixel)
+void StoreMipTexels(Bitmap& bitmap, const Vector4* texels, const bool linearSpace)
+{
+    const uint32 width = bitmap.GetWidth();
+    const uint32 height = bitmap.GetHeight();
+
+    const auto getTexel = [&](uint32 x, uint32 y)
+    {
+        const Vector4 value = texels[width * y + x];
+        return linearSpace ? value : Convert_Linear_To_sRGB(value);
+    };
+
+    if (Bitmap::IsBlockCompressed(bitmap.GetFormat()))
+    {
+        const uint32 blockSize = bitmap.GetFormat() == Bitmap::Format::BC5 ? 16u : 8u;
+        const uint32 blocksInRow = width / 4u;
+
+        for (uint32 blockY = 0; blockY < height / 4u; ++blockY)
+        {
+            for (uint32 blockX = 0; blockX < blocksInRow; ++blockX)
+            {
+                Vector4 blockTexels[16];
+                for (uint32 i = 0; i < 16; ++i)
+                {
+                    blockTexels[i] = getTexel(4u * blockX + i % 4u, 4u * blockY + i / 4u);
+                }
+
+                uint8* blockData = bitmap.GetData() + blockSize * (blocksInRow * blockY + blockX);
+                switch (bitmap.GetFormat())
+                {
+                case Bitmap::Format::BC1: EncodeBlockBC1(blockTexels, blockData); break;
+                case Bitmap::Format::BC4: EncodeBlockBC4(blockTexels, blockData); break;
+                default: EncodeBlockBC5(blockTexels, blockData); break;
+                }
+            }
+        }
+
+        return;
+    }
+
+    for (uint32 y = 0; y < height; ++y)
+    {
+        for (uint32 x = 0; x < width; ++x)
+        {
+            const Vector4 value = getTexel(x, y);
+
+            switch (bitmap.GetFormat())
+            {
+            case Bitmap::Format::R8_UNorm:
+                bitmap.GetPixelRef<uint8>(x, y) = QuantizeUNorm8(value.x);
+                break;
+
+            case Bitmap::Format::R8G8_UNorm:
+            {
+                uint8* target = bitmap.GetData() + bitmap.GetStride() * (size_t)y + 2u * (size_t)x;
+                target[0] = QuantizeUNorm8(value.x);
+                target[1] = QuantizeUNorm8(value.y);
+                break;
+            }
+
+            case Bitmap::Format::B8G8R8_UNorm:
+            {
+                uint8* target = bitmap.GetData() + bitmap.GetStride() * (size_t)y + 3u * (size_t)x;
+                target[0] = QuantizeUNorm8(value.z);
+                target[1] = QuantizeUNorm8(value.y);
+                target[2] = QuantizeUNorm8(value.x);
+                break;
+            }
+
+            case Bitmap::Format::B8G8R8A8_UNorm:
+            {
+                uint8* target = bitmap.GetData() + bitmap.GetStride() * (size_t)y + 4u * (size_t)x;
+                target[0] = QuantizeUNorm8(value.z);
+                target[1] = QuantizeUNorm8(value.y);
+                target[2] = QuantizeUNorm8(value.x);
+                target[3] = QuantizeUNorm8(value.w);
+                break;
+            }
+
+            case Bitmap::Format::R8G8B8A8_UNorm:
+            {
+                uint8* target = bitmap.GetData() + bitmap.GetStride() * (size_t)y + 4u * (size_t)x;
+                target[0] = QuantizeUNorm8(value.x);
+                target[1] = QuantizeUNorm8(value.y);
+                target[2] = QuantizeUNorm8(value.z);
+                target[3] = QuantizeUNorm8(value.w);
+                break;
+            }
+
+            case Bitmap::Format::B5G6R5_UNorm:
+            {
+                const uint32 red = static_cast<uint32>(Clamp(value.x, 0.0f, 1.0f) * 31.0f + 0.5f);
+                const uint32 green = static_cast<uint32>(Clamp(value.y, 0.0f, 1.0f) * 63.0f + 0.5f);
+                const uint32 blue = static_cast<uint32>(Clamp(value.z, 0.0f, 1.0f) * 31.0f + 0.5f);
+                bitmap.GetPixelRef<uint16>(x, y) = static_cast<uint16>((red << 11u) | (green << 5u) | blue);
+                break;
+            }
+
+            default:
+                RT_ASSERT(bitmap.GetFormat() == Bitmap::Format::R16G16B16A16_Half);
+                Vector4_Store_Half4(value, &bitmap.GetPixelRef<Half4>(x, y).x);
+            }
+        }
+    }
+}
+
+} // namespace
+
+bool BitmapTexture::GenerateMipmaps()
+{
+    const uint32 baseWidth = mBitmap->GetWidth();
+    const uint32 baseHeight = mBitmap->GetHeight();
+
+    if (baseWidth == 0 || baseHeight == 0)
+    {
+        return false;
+    }
+
+    mMaxSize = static_cast<float>(Max(baseWidth, baseHeight));
+
+    uint32 numLevels = 1;
+    while ((Max(baseWidth, baseHeight) >> numLevels) > 0)
+    {
+        numLevels++;
+    }
+
+    mMipBitmaps.Clear();
+    mMipBitmaps.Reserve(numLevels - 1);
+
+    // filter in linear space at full precision, each level is quantized to its storage format only once
+    DynArray<Vector4> sourceTexels;
+    DynArray<Vector4> texels;
+
+    uint32 sourceWidth = baseWidth;
+    uint32 sourceHeight = baseHeight;
+    for (uint32 level = 1; level < numLevels; ++level)
+    {
+        Bitmap::InitData initData;
+        initData.width = Max(1u, sourceWidth / 2u);
+        initData.height = Max(1u, sourceHeight / 2u);
+        initData.format = GetMipFormat(mBitmap->GetFormat(), initData.width, initData.height);
+        initData.linearSpace = initData.format == Bitmap::Format::R16G16B16A16_Half || mBitmap->mLinearSpace;
+
+        Bitmap mipBitmap(mBitmap->GetDebugName());
+        if (!mipBitmap.Init(initData))
+        {
+            RT_LOG_ERROR("BitmapTexture: Failed to allocate mip level %u for bitmap '%s'", level, mBitmap->GetDebugName());
+            break;
+        }
+
+        const auto getSourceTexel = [&](uint32 x, uint32 y)
+        {
+            return level == 1u ? mBitmap->GetPixel(x, y) : sourceTexels[sourceWidth * y + x];
+        };
+
+        // 2x2 box filter (3 taps along odd dimensions)
+        texels.Resize(initData.width * initData.height);
+        for (uint32 y = 0; y < initData.height; ++y)
+        {
+            const MipFilterTaps tapsY = GetMipFilterTaps(sourceHeight, y);
+
+            for (uint32 x = 0; x < initData.width; ++x)
+            {
+                const MipFilterTaps tapsX = GetMipFilterTaps(sourceWidth, x);
+
+                Vector4 value = Vector4::Zero();
+                for (uint32 j = 0; j < tapsY.count; ++j)
+                {
+                    for (uint32 i = 0; i < tapsX.count; ++i)
+                    {
+                        const float weight = tapsX.weights[i] * tapsY.weights[j];
+                        value = Vector4::MulAndAdd(getSourceTexel(tapsX.indices[i], tapsY.indices[j]), weight, value);
+                    }
+                }
+
+                texels[initData.width * y + x] = value;
+            }
+        }
+
+        StoreMipTexels(mipBitmap, texels.Data(), initData.linearSpace);
+
+        mMipBitmaps.PushBack(std::move(mipBitmap));
+        sourceTexels.Swap(texels);
+        sourceWidth = initData.width;
+        sourceHeight = initData.height;
+    }
+
+    mMipLevels.Clear();
+    mMipLevels.PushBack({ mBitmap.get(), mBitmap->GetPixelBlockFetchFunc() });
+    for (const Bitmap& mipBitmap : mMipBitmaps)
+    {
+        mMipLevels.PushBack({ &mipBitmap, mipBitmap.GetPixelBlockFetchFunc() });
+    }
+
+    return true;
+}
 
 const char* BitmapTexture::GetName() const
 {
@@ -29,14 +311,9 @@ const char* BitmapTexture::GetName() const
     return mBitmap->GetDebugName();
 }
 
-const Vector4 BitmapTexture::Evaluate(const Vector4& coords) const
+const Vector4 BitmapTexture::EvaluateLevel(const MipLevel& level, const Vector4& coords) const
 {
-    const Bitmap* bitmapPtr = mBitmap.get();
-
-    if (!bitmapPtr)
-    {
-        return Vector4::Zero();
-    }
+    const Bitmap* bitmapPtr = level.bitmap;
 
     // bitmap size
     const VectorInt4 size = VectorInt4(bitmapPtr->mWidth, bitmapPtr->mHeight, 0, 0).Swizzle<0,1,0,1>();
@@ -56,7 +333,7 @@ const Vector4 BitmapTexture::Evaluate(const Vector4& coords) const
 
     if (mFilter == BitmapTextureFilter::NearestNeighbor)
     {
-        result = bitmapPtr->GetPixel(texelCoords.x, texelCoords.y, mForceLinearSpace);
+        result = bitmapPtr->GetPixel(texelCoords.x, texelCoords.y);
     }
     else if (mFilter == BitmapTextureFilter::Bilinear || mFilter == BitmapTextureFilter::Bilinear_SmoothStep)
     {
@@ -67,7 +344,7 @@ const Vector4 BitmapTexture::Evaluate(const Vector4& coords) const
         texelCoords -= VectorInt4::AndNot(texelCoords < size, size);
 
         Vector4 colors[4];
-        bitmapPtr->GetPixelBlock(texelCoords, colors, mForceLinearSpace);
+        level.fetchFunc(*bitmapPtr, texelCoords, colors);
 
         // bilinear interpolation
         Vector4 weights = scaledCoords - intCoords.ConvertToFloat();
@@ -87,6 +364,41 @@ const Vector4 BitmapTexture::Evaluate(const Vector4& coords) const
         result = Vector4::Zero();
     }
 
+    return result;
+}
+
+const Vector4 BitmapTexture::Evaluate(const Vector4& coords) const
+{
+    if (mMipLevels.Empty())
+    {
+        return Vector4::Zero();
+    }
+
+    // select mip level based on filter footprint (in texels of the base level)
+    const float footprint = coords.z * mMaxSize;
+    const uint32 maxLevel = mMipLevels.Size() - 1u;
+
+    Vector4 result;
+
+    if (footprint <= 1.0f || maxLevel == 0)
+    {
+        result = EvaluateLevel(mMipLevels[0], coords);
+    }
+    else
+    {
+        const float lod = Min(log2f(footprint), static_cast<float>(maxLevel));
+        const uint32 level = static_cast<uint32>(lod);
+        const float levelFraction = lod - static_cast<float>(level);
+
+        result = EvaluateLevel(mMipLevels[level], coords);
+
+        // trilinear filtering
+        if (level < maxLevel && levelFraction > 0.0f)
+        {
+            result = Vector4::Lerp(result, EvaluateLevel(mMipLevels[level + 1u], coords), levelFraction);
+        }
+    }
+
     RT_ASSERT(result.IsValid());
 
     return result;
@@ -119,6 +431,156 @@ const Vector4 BitmapTexture::Sample(const Float2 u, Vector4& outCoords, float* o
     return BitmapTexture::Evaluate(outCoords);
 }
 
+namespace {
+
+// base level texels covered by the first min/max pyramid level (in each direction, as log2)
+constexpr uint32 FirstValueRangeLevelShift = 2;
+
+RT_FORCE_INLINE uint32 WrapTexelCoord(const int32 coord, const int32 size)
+{
+    return static_cast<uint32>((coord % size + size) % size);
+}
+
+} // namespace
+
+void BitmapTexture::GenerateValueRangeLevels() const
+{
+    const uint32 baseWidth = mBitmap->GetWidth();
+    const uint32 baseHeight = mBitmap->GetHeight();
+
+    // first level is computed directly from the base level texels
+    // (the last entry in a row/column covers fewer texels if the size is not a multiple of the block size)
+    uint32 width = (baseWidth + (1u << FirstValueRangeLevelShift) - 1u) >> FirstValueRangeLevelShift;
+    uint32 height = (baseHeight + (1u << FirstValueRangeLevelShift) - 1u) >> FirstValueRangeLevelShift;
+
+    mValueRangeLevels.Clear();
+    mValueRangeLevels.PushBack({ width, height, 0 });
+    mRangeMinValues.Resize(width * height, VECTOR_MAX);
+    mRangeMaxValues.Resize(width * height, -VECTOR_MAX);
+
+    for (uint32 y = 0; y < baseHeight; ++y)
+    {
+        for (uint32 x = 0; x < baseWidth; ++x)
+        {
+            const uint32 index = width * (y >> FirstValueRangeLevelShift) + (x >> FirstValueRangeLevelShift);
+            const Vector4 value = mBitmap->GetPixel(x, y);
+            mRangeMinValues[index] = Vector4::Min(mRangeMinValues[index], value);
+            mRangeMaxValues[index] = Vector4::Max(mRangeMaxValues[index], value);
+        }
+    }
+
+    // coarser levels merge 2x2 entries of the previous level
+    while (width > 1u || height > 1u)
+    {
+        const ValueRangeLevel source = mValueRangeLevels.Back();
+        const ValueRangeLevel level = { (width + 1u) / 2u, (height + 1u) / 2u, mRangeMinValues.Size() };
+
+        mRangeMinValues.Resize(level.offset + level.width * level.height, VECTOR_MAX);
+        mRangeMaxValues.Resize(level.offset + level.width * level.height, -VECTOR_MAX);
+
+        for (uint32 y = 0; y < level.height; ++y)
+        {
+            for (uint32 x = 0; x < level.width; ++x)
+            {
+                const uint32 index = level.offset + level.width * y + x;
+
+                for (uint32 sourceY = 2u * y; sourceY < Min(2u * y + 2u, source.height); ++sourceY)
+                {
+                    for (uint32 sourceX = 2u * x; sourceX < Min(2u * x + 2u, source.width); ++sourceX)
+                    {
+                        const uint32 sourceIndex = source.offset + source.width * sourceY + sourceX;
+                        mRangeMinValues[index] = Vector4::Min(mRangeMinValues[index], mRangeMinValues[sourceIndex]);
+                        mRangeMaxValues[index] = Vector4::Max(mRangeMaxValues[index], mRangeMaxValues[sourceIndex]);
+                    }
+                }
+            }
+        }
+
+        mValueRangeLevels.PushBack(level);
+        width = level.width;
+        height = level.height;
+    }
+}
+
+bool BitmapTexture::GetValueRange(const Vector4& minCoords, const Vector4& maxCoords, Vector4& outMin, Vector4& outMax) const
+{
+    if (!mBitmap)
+    {
+        return false;
+    }
+
+    const int32 width = static_cast<int32>(mBitmap->GetWidth());
+    const int32 height = static_cast<int32>(mBitmap->GetHeight());
+
+    // texels touched by the filter (see EvaluateLevel), with one extra texel margin for rounding of the wrapped coordinates
+    const Vector4 minTexelCoords = Vector4::Floor(minCoords * mBitmap->mFloatSize) - Vector4(1.0f);
+    const Vector4 maxTexelCoords = Vector4::Floor(maxCoords * mBitmap->mFloatSize) + Vector4(2.0f);
+
+    // the box is wrapped, so limit the range to the whole texture
+    const int32 minX = static_cast<int32>(minTexelCoords.x);
+    const int32 minY = static_cast<int32>(minTexelCoords.y);
+    const int32 numX = Min(static_cast<int32>(maxTexelCoords.x) - minX + 1, width);
+    const int32 numY = Min(static_cast<int32>(maxTexelCoords.y) - minY + 1, height);
+
+    // pick the level at which the box spans at most 4-8 entries in each direction
+    const uint32 extent = static_cast<uint32>(Max(numX, numY));
+    uint32 shift = 0;
+    while ((extent >> (shift + 3u)) > 0u)
+    {
+        shift++;
+    }
+
+    uint32 levelIndex = 0;
+    if (shift >= FirstValueRangeLevelShift)
+    {
+        std::call_once(mValueRangeLevelsFlag, [this]() { GenerateValueRangeLevels(); });
+
+        levelIndex = Min(shift - FirstValueRangeLevelShift, mValueRangeLevels.Size() - 1u);
+        shift = levelIndex + FirstValueRangeLevelShift;
+    }
+    else
+    {
+        // small box - base level texels are read directly
+        shift = 0;
+    }
+
+    outMin = VECTOR_MAX;
+    outMax = -VECTOR_MAX;
+
+    for (int32 j = 0; j < numY; )
+    {
+        const uint32 y = WrapTexelCoord(minY + j, height);
+        const uint32 entryY = y >> shift;
+
+        for (int32 i = 0; i < numX; )
+        {
+            const uint32 x = WrapTexelCoord(minX + i, width);
+            const uint32 entryX = x >> shift;
+
+            if (shift == 0)
+            {
+                const Vector4 value = mBitmap->GetPixel(x, y);
+                outMin = Vector4::Min(outMin, value);
+                outMax = Vector4::Max(outMax, value);
+            }
+            else
+            {
+                const ValueRangeLevel& level = mValueRangeLevels[levelIndex];
+                const uint32 index = level.offset + level.width * entryY + entryX;
+                outMin = Vector4::Min(outMin, mRangeMinValues[index]);
+                outMax = Vector4::Max(outMax, mRangeMaxValues[index]);
+            }
+
+            // skip to the next entry (an entry can't span over the texture edge)
+            i += static_cast<int32>(Min((entryX + 1u) << shift, static_cast<uint32>(width)) - x);
+        }
+
+        j += static_cast<int32>(Min((entryY + 1u) << shift, static_cast<uint32>(height)) - y);
+    }
+
+    return true;
+}
+
 bool BitmapTexture::MakeSamplable()
 {
     if (mImportanceMap)
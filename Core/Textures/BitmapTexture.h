@@ -1,6 +1,10 @@
 #pragma once
 
 #include "Texture.h"
+#include "../Utils/Bitmap.h"
+#include "../Containers/DynArray.h"
+
+#include <mutex>
 
 namespace rt {
 
@@ -8,7 +12,6 @@ namespace math {
 class Distribution;
 }
 
-class Bitmap;
 using BitmapPtr = std::shared_ptr<Bitmap>;
 
 enum class BitmapTextureFilter : uint8
@@ -19,6 +22,8 @@ enum class BitmapTextureFilter : uint8
 };
 
 // texture wrapper for Bitmap class
+// NOTE: texture coordinates' Z component is interpreted as texture-space filter footprint,
+// which is used to select mip level (zero means the most detailed level)
 class BitmapTexture : public ITexture
 {
 public:
@@ -33,11 +38,53 @@ public:
     virtual bool MakeSamplable() override;
     virtual bool IsSamplable() const override;
 
+    // NOTE: only the most detailed mip level is taken into account
+    // NOTE: min/max pyramid used for the queries is built on the first call
+    virtual bool GetValueRange(const math::Vector4& minCoords, const math::Vector4& maxCoords, math::Vector4& outMin, math::Vector4& outMax) const override;
+
+    // get number of mip levels (including the original bitmap)
+    RT_FORCE_INLINE uint32 GetNumMipLevels() const { return mMipLevels.Size(); }
+
+    // get bitmap of given mip level (level 0 is the original bitmap)
+    RT_FORCE_INLINE const Bitmap& GetMipLevel(uint32 level) const { return *mMipLevels[level].bitmap; }
+
 private:
+    struct MipLevel
+    {
+        const Bitmap* bitmap;
+        Bitmap::PixelBlockFetchFunc fetchFunc;
+    };
+
+    // level of min/max pyramid, each entry bounds block of base level texels
+    struct ValueRangeLevel
+    {
+        uint32 width;
+        uint32 height;
+        uint32 offset;  // index of the first entry in mRangeMinValues/mRangeMaxValues
+    };
+
+    // generate mip chain by successive 2x2 downsampling of the bitmap
+    bool GenerateMipmaps();
+
+    // generate min/max pyramid for GetValueRange() queries
+    void GenerateValueRangeLevels() const;
+
+    // filtered lookup in a single mip level
+    const math::Vector4 EvaluateLevel(const MipLevel& level, const math::Vector4& coords) const;
+
     BitmapPtr mBitmap;
+    DynArray<Bitmap> mMipBitmaps;       // downsampled bitmaps (starting from mip level 1)
+    DynArray<MipLevel> mMipLevels;      // all mip levels (level 0 is the original bitmap)
     std::unique_ptr<math::Distribution> mImportanceMap;
+    float mMaxSize;                     // larger bitmap dimension (for mip level selection)
     BitmapTextureFilter mFilter;
-    bool mForceLinearSpace;
+
+    // min/max pyramid (level 'i' entry covers 2^(i+2) x 2^(i+2) base level texels), built lazily,
+    // as only mask textures are queried for value ranges
+    mutable DynArray<ValueRangeLevel> mValueRangeLevels;
+    mutable DynArray<math::Vector4> mRangeMinValues;
+    mutable DynArray<math::Vector4> mRangeMaxValues;
+    mutable std::once_flag mValueRangeLevelsFlag;
 };
 
 } // namespace rt
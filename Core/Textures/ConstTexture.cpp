@@ -35,4 +35,14 @@ const Vector4 ConstTexture::Sample(const Float2 u, Vector4& outCoords, float* ou
     return mColor;
 }
 
+bool ConstTexture::GetValueRange(const Vector4& minCoords, const Vector4& maxCoords, Vector4& outMin, Vector4& outMax) const
+{
+    RT_UNUSED(minCoords);
+    RT_UNUSED(maxCoords);
+
+    outMin = mColor;
+    outMax = mColor;
+    return true;
+}
+
 } // namespace rt
\ No newline at end of file
@@ -16,6 +16,7 @@ public:
     virtual const char* GetName() const override;
     virtual const math::Vector4 Evaluate(const math::Vector4& coords) const override;
     virtual const math::Vector4 Sample(const math::Float2 u, math::Vector4& outCoords, float* outPdf) const override;
+    virtual bool GetValueRange(const math::Vector4& minCoords, const math::Vector4& maxCoords, math::Vector4& outMin, math::Vector4& outMax) const override;
 
 private:
     math::Vector4 mColor;
@@ -15,4 +15,14 @@ bool ITexture::IsSamplable() const
     return true;
 }
 
+bool ITexture::GetValueRange(const math::Vector4& minCoords, const math::Vector4& maxCoords, math::Vector4& outMin, math::Vector4& outMax) const
+{
+    RT_UNUSED(minCoords);
+    RT_UNUSED(maxCoords);
+    RT_UNUSED(outMin);
+    RT_UNUSED(outMax);
+
+    return false;
+}
+
 } // namespace rt
\ No newline at end of file
@@ -29,6 +29,10 @@ public:
 
     // check if the texture is samplable (if it's not, calling Sample is illegal)
     virtual bool IsSamplable() const;
+
+    // compute conservative bounds of values evaluated anywhere within given texture coordinates box
+    // returns false if the texture can't be bounded
+    virtual bool GetValueRange(const math::Vector4& minCoords, const math::Vector4& maxCoords, math::Vector4& outMin, math::Vector4& outMax) const;
 };
 
 using TexturePtr = std::shared_ptr<ITexture>;
@@ -8,6 +8,15 @@
 constexpr uint32 RT_INVALID_OBJECT = UINT32_MAX;
 constexpr uint32 RT_LIGHT_OBJECT = 0xFFFFFFFE;
 
+// marks hits of lights with sub-objects (e.g. triangles of a mesh light), lower bits hold the sub-object ID
+constexpr uint32 RT_LIGHT_SUB_OBJECT_FLAG = 0x80000000;
+
+// check if sub-object ID denotes a light hit
+RT_FORCE_INLINE constexpr bool IsLightSubObject(const uint32 subObjectId)
+{
+    return (subObjectId & RT_LIGHT_SUB_OBJECT_FLAG) != 0 && subObjectId != RT_INVALID_OBJECT;
+}
+
 namespace rt {
 
 // Ray-scene intersection data (non-SIMD)
@@ -12,6 +12,13 @@ struct IntersectionData
     math::Vector4 texCoord;
     const Material* material = nullptr;
 
+    // ratio of texture-space to local-space lengths at the intersection point (zero if unknown),
+    // used to convert ray footprint into texture footprint
+    float texCoordScale = 0.0f;
+
+    // world-space width of the ray cone projected onto the surface (zero if unknown)
+    float surfaceFootprint = 0.0f;
+
     RT_FORCE_INLINE const math::Vector4 LocalToWorld(const math::Vector4& localCoords) const
     {
         return frame.TransformVector(localCoords);
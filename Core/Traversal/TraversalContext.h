@@ -25,6 +25,31 @@ struct SimdTraversalContext
     RenderingContext& context;
 };
 
+// 8-wide occlusion query (any-hit, no hit data is written)
+struct SimdShadowTraversalContext
+{
+    const math::Ray_Simd8& ray;
+
+    // per-lane ray length, set to -infinity once a lane is occluded (or inactive) so it is culled by all subsequent tests
+    math::Vector8& maxDistances;
+
+    RenderingContext& context;
+
+    static constexpr float TerminatedDistance = -std::numeric_limits<float>::infinity();
+
+    // bit mask of lanes that still need to be traced
+    RT_FORCE_INLINE int32 GetActiveMask() const
+    {
+        return ~maxDistances.GetSignMask() & 0xFF;
+    }
+
+    // stop tracing lanes that hit an occluder
+    RT_FORCE_INLINE void Terminate(const math::VectorBool8& mask) const
+    {
+        maxDistances = math::Vector8::Select(maxDistances, math::Vector8(TerminatedDistance), mask);
+    }
+};
+
 struct PacketTraversalContext
 {
     RayPacket& ray;
@@ -30,7 +30,7 @@ template <typename ObjectType, uint32 traversalDepth>
 void GenericTraverse(const PacketTraversalContext& context, const uint32 objectID, const ObjectType* object, uint32 numActiveGroups)
 {
     // all nodes
-    const BVH::Node* __restrict nodes = object->GetBVH().GetNodes();
+    const BVH::Node* __restrict nodes = object->GetBVH().GetNodes(context.context.numaNode);
 
     struct StackFrame
     {
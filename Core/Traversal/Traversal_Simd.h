@@ -1,12 +1,14 @@
 #pragma once
 
 #include "HitPoint.h"
+#include "TraversalContext.h"
 #include "Math/Ray.h"
 #include "BVH/BVH.h"
 #include "Math/Geometry.h"
 #include "Math/Simd8Geometry.h"
 #include "Utils/iacaMarks.h"
 #include "Rendering/Counters.h"
+#include "Rendering/Context.h"
 
 
 namespace rt {
@@ -20,7 +22,7 @@ static void GenericTraverse(const SimdTraversalContext& context, const uint32 ob
     const math::Vector3x8 rayOriginDivDir = context.ray.origin * context.ray.invDir;
 
     // all nodes
-    const BVH::Node* __restrict nodes = object->GetBVH().GetNodes();
+    const BVH::Node* __restrict nodes = object->GetBVH().GetNodes(context.context.numaNode);
 
     // "nodes to visit" stack
     uint32 stackSize = 0;
@@ -41,15 +43,13 @@ static void GenericTraverse(const SimdTraversalContext& context, const uint32 ob
             RT_PREFETCH_L1(nodes + childA->childIndex);
 
             math::Vector8 distanceA;
-            const math::Vector8 maskA = Intersect_BoxRay(rayInvDir, rayOriginDivDir, childA->GetBox(), context.hitPoint.distance, distanceA);
-            const int32 intMaskA = maskA.GetSignMask();
+            const int32 intMaskA = math::Intersect_BoxRay_Simd8(rayInvDir, rayOriginDivDir, childA->GetBox_Simd8(), context.hitPoint.distance, distanceA).GetMask();
 
             // Note: according to Intel manuals, prefetch instructions should not be grouped together
             RT_PREFETCH_L1(nodes + childB->childIndex);
 
             math::Vector8 distanceB;
-            const math::Vector8 maskB = Intersect_BoxRay(rayInvDir, rayOriginDivDir, childB->GetBox(), context.hitPoint.distance, distanceB);
-            const int32 intMaskB = maskB.GetSignMask();
+            const int32 intMaskB = math::Intersect_BoxRay_Simd8(rayInvDir, rayOriginDivDir, childB->GetBox_Simd8(), context.hitPoint.distance, distanceB).GetMask();
 
 #ifdef RT_ENABLE_INTERSECTION_COUNTERS
             context.context.localCounters.numRayBoxTests += 2 * 8;
@@ -99,4 +99,122 @@ static void GenericTraverse(const SimdTraversalContext& context, const uint32 ob
     }
 }
 
+// occlusion-only traversal of 8 rays at a time
+// each lane is terminated as soon as any hit is found, returns true if all the lanes are terminated
+template <typename ObjectType>
+bool GenericTraverse_Shadow(const SimdShadowTraversalContext& context, const ObjectType* object)
+{
+    if (object->GetBVH().GetNumNodes() == 0)
+    {
+        // tree is empty
+        return false;
+    }
+
+    const math::Vector3x8 rayInvDir = context.ray.invDir;
+    const math::Vector3x8 rayOriginDivDir = context.ray.origin * context.ray.invDir;
+
+    // all nodes
+    const BVH::Node* __restrict nodes = object->GetBVH().GetNodes(context.context.numaNode);
+
+    // "nodes to visit" stack
+    uint32 stackSize = 0;
+    const BVH::Node* __restrict nodesStack[BVH::MaxDepth];
+
+    // BVH traversal
+    for (const BVH::Node* __restrict currentNode = nodes;;)
+    {
+        if (currentNode->IsLeaf())
+        {
+            if (object->Traverse_Leaf_Shadow_Simd8(context, *currentNode))
+            {
+                return true;
+            }
+        }
+        else
+        {
+            const BVH::Node* __restrict childA = nodes + currentNode->childIndex;
+            const BVH::Node* __restrict childB = childA + 1;
+
+            // prefetch grand-children
+            RT_PREFETCH_L1(nodes + childA->childIndex);
+
+            // Note: terminated lanes have negative max distance, so they never pass the box test
+            math::Vector8 distanceA;
+            const int32 intMaskA = math::Intersect_BoxRay_Simd8(rayInvDir, rayOriginDivDir, childA->GetBox_Simd8(), context.maxDistances, distanceA).GetMask();
+
+            // Note: according to Intel manuals, prefetch instructions should not be grouped together
+            RT_PREFETCH_L1(nodes + childB->childIndex);
+
+            math::Vector8 distanceB;
+            const int32 intMaskB = math::Intersect_BoxRay_Simd8(rayInvDir, rayOriginDivDir, childB->GetBox_Simd8(), context.maxDistances, distanceB).GetMask();
+
+#ifdef RT_ENABLE_INTERSECTION_COUNTERS
+            context.context.localCounters.numRayBoxTests += 2 * math::PopCount(context.GetActiveMask());
+            context.context.localCounters.numPassedRayBoxTests += math::PopCount(intMaskA);
+            context.context.localCounters.numPassedRayBoxTests += math::PopCount(intMaskB);
+#endif // RT_ENABLE_INTERSECTION_COUNTERS
+
+            if (intMaskA && intMaskB)
+            {
+                currentNode = childA;
+                nodesStack[stackSize++] = childB;
+                continue;
+            }
+
+            if (intMaskA)
+            {
+                currentNode = childA;
+                continue;
+            }
+
+            if (intMaskB)
+            {
+                currentNode = childB;
+                continue;
+            }
+        }
+
+        if (stackSize == 0)
+        {
+            break;
+        }
+
+        // pop a node
+        currentNode = nodesStack[--stackSize];
+    }
+
+    return false;
+}
+
+// occlusion test of 8 rays one by one, for objects without 8-wide intersection code
+template <typename ObjectType>
+void GenericTraverse_Shadow_SingleRays(const SimdShadowTraversalContext& context, const ObjectType* object)
+{
+    const math::Ray_Simd8& rays = context.ray;
+
+    const int32 activeMask = context.GetActiveMask();
+
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        if (!(activeMask & (1 << i)))
+        {
+            continue;
+        }
+
+        math::Ray ray;
+        ray.origin = math::Vector4(rays.origin.x[i], rays.origin.y[i], rays.origin.z[i], 0.0f);
+        ray.dir = math::Vector4(rays.dir.x[i], rays.dir.y[i], rays.dir.z[i], 0.0f);
+        ray.invDir = math::Vector4(rays.invDir.x[i], rays.invDir.y[i], rays.invDir.z[i], 0.0f);
+        ray.originDivDir = ray.origin * ray.invDir;
+
+        HitPoint hitPoint;
+        hitPoint.distance = context.maxDistances[i];
+
+        if (object->Traverse_Shadow({ ray, hitPoint, context.context }))
+        {
+            context.maxDistances[i] = SimdShadowTraversalContext::TerminatedDistance;
+        }
+    }
+}
+
 } // namespace rt
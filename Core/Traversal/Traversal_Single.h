@@ -7,6 +7,7 @@
 #include "Math/Geometry.h"
 #include "Utils/iacaMarks.h"
 #include "Rendering/Counters.h"
+#include "Rendering/Context.h"
 
 
 namespace rt {
@@ -24,7 +25,7 @@ void GenericTraverse(const SingleTraversalContext& context, const uint32 objectI
     }
 
     // all nodes
-    const BVH::Node* __restrict nodes = object->GetBVH().GetNodes();
+    const BVH::Node* __restrict nodes = object->GetBVH().GetNodes(context.context.numaNode);
 
     // "nodes to visit" stack
     uint32 stackSize = 0;
@@ -107,7 +108,7 @@ bool GenericTraverse_Shadow(const SingleTraversalContext& context, const ObjectT
     }
 
     // all nodes
-    const BVH::Node* __restrict nodes = object->GetBVH().GetNodes();
+    const BVH::Node* __restrict nodes = object->GetBVH().GetNodes(context.context.numaNode);
 
     // "nodes to visit" stack
     uint32 stackSize = 0;
@@ -14,6 +14,23 @@ using namespace math;
 
 static_assert(sizeof(Bitmap) <= 64, "Bitmap class is too big");
 
+static Bitmap::BlockCompressionMode gBlockCompressionMode = Bitmap::BlockCompressionMode::Cached;
+
+void Bitmap::SetBlockCompressionMode(BlockCompressionMode mode)
+{
+    gBlockCompressionMode = mode;
+}
+
+Bitmap::BlockCompressionMode Bitmap::GetBlockCompressionMode()
+{
+    return gBlockCompressionMode;
+}
+
+bool Bitmap::IsBlockCompressed(Format format)
+{
+    return format == Format::BC1 || format == Format::BC4 || format == Format::BC5;
+}
+
 uint8 Bitmap::BitsPerPixel(Format format)
 {
     switch (format)
@@ -109,6 +126,7 @@ Bitmap::Bitmap(const char* debugName)
     , mFormat(Format::Unknown)
     , mLinearSpace(false)
     , mUsesDefaultAllocator(false)
+    , mWrapsData(false)
 {
     RT_ASSERT(debugName, "Invalid debug name");
     mDebugName = strdup(debugName);
@@ -154,9 +172,51 @@ Bitmap& Bitmap::operator = (const Bitmap& other)
     return *this;
 }
 
-Bitmap::Bitmap(Bitmap&&) = default;
+Bitmap::Bitmap(Bitmap&& other)
+    : mFloatSize(other.mFloatSize)
+    , mData(other.mData)
+    , mPalette(other.mPalette)
+    , mWidth(other.mWidth)
+    , mHeight(other.mHeight)
+    , mStride(other.mStride)
+    , mPaletteSize(other.mPaletteSize)
+    , mFormat(other.mFormat)
+    , mLinearSpace(other.mLinearSpace)
+    , mUsesDefaultAllocator(other.mUsesDefaultAllocator)
+    , mWrapsData(other.mWrapsData)
+    , mDebugName(strdup(other.mDebugName))
+{
+    // the source must not free moved buffers
+    other.mData = nullptr;
+    other.mPalette = nullptr;
+}
+
+Bitmap& Bitmap::operator = (Bitmap&& other)
+{
+    if (this != &other)
+    {
+        Release();
+        free(mDebugName);
 
-Bitmap& Bitmap::operator = (Bitmap&&) = default;
+        mFloatSize = other.mFloatSize;
+        mData = other.mData;
+        mPalette = other.mPalette;
+        mWidth = other.mWidth;
+        mHeight = other.mHeight;
+        mStride = other.mStride;
+        mPaletteSize = other.mPaletteSize;
+        mFormat = other.mFormat;
+        mLinearSpace = other.mLinearSpace;
+        mUsesDefaultAllocator = other.mUsesDefaultAllocator;
+        mWrapsData = other.mWrapsData;
+        mDebugName = strdup(other.mDebugName);
+
+        other.mData = nullptr;
+        other.mPalette = nullptr;
+    }
+
+    return *this;
+}
 
 void Bitmap::Clear()
 {
@@ -170,7 +230,16 @@ void Bitmap::Release()
 {
     if (mData)
     {
-        if (mUsesDefaultAllocator)
+        if (IsBlockCompressed(mFormat))
+        {
+            InvalidateDecodedBlockCache();
+        }
+
+        if (mWrapsData)
+        {
+            // memory is owned by the caller
+        }
+        else if (mUsesDefaultAllocator)
         {
             DefaultAllocator::Free(mData);
         }
@@ -184,7 +253,7 @@ void Bitmap::Release()
     if (mPalette)
     {
         DefaultAllocator::Free(mPalette);
-        mData = nullptr;
+        mPalette = nullptr;
     }
 
     mStride = 0;
@@ -208,19 +277,30 @@ bool Bitmap::Init(const InitData& initData)
         return false;
     }
 
+    if (initData.wrapData && (!initData.data || initData.paletteSize > 0))
+    {
+        RT_LOG_ERROR("Bitmap: Only non-palette bitmaps with valid data can be wrapped");
+        return false;
+    }
+
     Release();
 
     // align to cache line
     const uint32 marigin = RT_CACHE_LINE_SIZE;
 
     mUsesDefaultAllocator = initData.useDefaultAllocator;
-    if (mUsesDefaultAllocator)
+    mWrapsData = initData.wrapData;
+    if (mWrapsData)
+    {
+        mData = const_cast<uint8*>(static_cast<const uint8*>(initData.data));
+    }
+    else if (mUsesDefaultAllocator)
     {
         mData = (uint8*)DefaultAllocator::Allocate(dataSize + marigin, RT_CACHE_LINE_SIZE);
     }
     else
     {
-        mData = (uint8*)SystemAllocator::Allocate(dataSize + marigin);
+        mData = (uint8*)SystemAllocator::Allocate(dataSize + marigin, RT_CACHE_LINE_SIZE);
     }
 
     if (!mData)
@@ -229,9 +309,15 @@ bool Bitmap::Init(const InitData& initData)
         return false;
     }
 
-    if (initData.data)
+    if (!mWrapsData)
     {
-        memcpy(mData, initData.data, dataSize);
+        if (initData.data)
+        {
+            memcpy(mData, initData.data, dataSize);
+        }
+
+        // clear marigin
+        memset(mData + dataSize, 0, marigin);
     }
 
     if (initData.paletteSize > 0)
@@ -239,9 +325,6 @@ bool Bitmap::Init(const InitData& initData)
         mPalette = (uint8*)DefaultAllocator::Allocate(sizeof(uint32) * (size_t)initData.paletteSize, RT_CACHE_LINE_SIZE);
     }
 
-    // clear marigin
-    memset(mData + dataSize, 0, marigin);
-
     mStride = Max(initData.stride, ComputeDataStride(initData.width, initData.format));
     mWidth = initData.width;
     mHeight = initData.height;
@@ -292,6 +375,11 @@ bool Bitmap::Copy(Bitmap& target, const Bitmap& source)
         memcpy(target.mPalette, source.mPalette, sizeof(uint32) * source.mPaletteSize);
     }
 
+    if (IsBlockCompressed(target.mFormat))
+    {
+        InvalidateDecodedBlockCache();
+    }
+
     return true;
 }
 
@@ -325,6 +413,14 @@ bool Bitmap::Load(const char* path)
 
     fclose(file);
 
+    if (IsBlockCompressed(mFormat) && gBlockCompressionMode == BlockCompressionMode::TranscodeOnLoad)
+    {
+        if (!TranscodeBlockCompressed())
+        {
+            return false;
+        }
+    }
+
     const float elapsedTime = static_cast<float>(1000.0 * timer.Stop());
     RT_LOG_INFO("Bitmap '%hs' loaded in %.3fms: width=%u, height=%u, format=%s, %s",
         path, elapsedTime, mWidth, mHeight, FormatToString(mFormat),
@@ -332,6 +428,54 @@ bool Bitmap::Load(const char* path)
     return true;
 }
 
+bool Bitmap::TranscodeBlockCompressed()
+{
+    RT_ASSERT(IsBlockCompressed(mFormat));
+
+    Bitmap transcoded(mDebugName);
+    if (!transcoded.Init({ mWidth, mHeight, Format::R8G8B8A8_UNorm, nullptr, 0, mLinearSpace }))
+    {
+        RT_LOG_ERROR("Failed to transcode bitmap '%s'", mDebugName);
+        return false;
+    }
+
+    using DecodeBlockFunc = void (*)(const uint8*, Vector4*);
+    DecodeBlockFunc decodeFunc = nullptr;
+    size_t bytesPerBlock = 0;
+    switch (mFormat)
+    {
+    case Format::BC1:   decodeFunc = DecodeBlockBC1; bytesPerBlock = 8;   break;
+    case Format::BC4:   decodeFunc = DecodeBlockBC4; bytesPerBlock = 8;   break;
+    case Format::BC5:   decodeFunc = DecodeBlockBC5; bytesPerBlock = 16;  break;
+    default:            RT_FATAL("Invalid format");
+    }
+
+    const uint32 blocksInRow = mWidth / 4u; // TODO non-4-multiply width support
+    const uint32 blocksInColumn = mHeight / 4u;
+
+    Vector4 texels[16];
+    for (uint32 blockY = 0; blockY < blocksInColumn; ++blockY)
+    {
+        for (uint32 blockX = 0; blockX < blocksInRow; ++blockX)
+        {
+            decodeFunc(mData + bytesPerBlock * ((size_t)blocksInRow * blockY + blockX), texels);
+
+            for (uint32 i = 0; i < 16; ++i)
+            {
+                const VectorInt4 value = VectorInt4::Convert(Vector4::Saturate(texels[i]) * 255.0f);
+                uint8* target = reinterpret_cast<uint8*>(&transcoded.GetPixelRef<uint32>(4u * blockX + i % 4u, 4u * blockY + i / 4u));
+                target[0] = static_cast<uint8>(value.x);
+                target[1] = static_cast<uint8>(value.y);
+                target[2] = static_cast<uint8>(value.z);
+                target[3] = static_cast<uint8>(value.w);
+            }
+        }
+    }
+
+    *this = std::move(transcoded);
+    return true;
+}
+
 const Vector4 Bitmap::GetPixel(uint32 x, uint32 y, const bool forceLinearSpace) const
 {
     RT_ASSERT(x < mWidth);
@@ -485,19 +629,25 @@ const Vector4 Bitmap::GetPixel(uint32 x, uint32 y, const bool forceLinearSpace)
 
     case Format::BC1:
     {
-        color = DecodeBC1(reinterpret_cast<const uint8*>(mData), x, y, mWidth);
+        color = gBlockCompressionMode == BlockCompressionMode::Direct ?
+            DecodeBC1(mData, x, y, mWidth) :
+            DecodeBC1_Cached(mData, x, y, mWidth);
         break;
     }
 
     case Format::BC4:
     {
-        color = DecodeBC4(reinterpret_cast<const uint8*>(mData), x, y, mWidth);
+        color = gBlockCompressionMode == BlockCompressionMode::Direct ?
+            DecodeBC4(mData, x, y, mWidth) :
+            DecodeBC4_Cached(mData, x, y, mWidth);
         break;
     }
 
     case Format::BC5:
     {
-        color = DecodeBC5(reinterpret_cast<const uint8*>(mData), x, y, mWidth);
+        color = gBlockCompressionMode == BlockCompressionMode::Direct ?
+            DecodeBC5(mData, x, y, mWidth) :
+            DecodeBC5_Cached(mData, x, y, mWidth);
         break;
     }
 
@@ -517,19 +667,22 @@ const Vector4 Bitmap::GetPixel(uint32 x, uint32 y, const bool forceLinearSpace)
     return color;
 }
 
-void Bitmap::GetPixelBlock(const VectorInt4 coords, Vector4* outColors, const bool forceLinearSpace) const
+template<Bitmap::Format format, bool convertFromSRGB>
+void Bitmap::FetchPixelBlock(const Bitmap& bitmap, const VectorInt4 coords, Vector4* outColors)
 {
-    RT_ASSERT(coords.x >= 0 && coords.x < (int32)mWidth);
-    RT_ASSERT(coords.y >= 0 && coords.y < (int32)mHeight);
-    RT_ASSERT(coords.z >= 0 && coords.z < (int32)mWidth);
-    RT_ASSERT(coords.w >= 0 && coords.w < (int32)mHeight);
+    RT_ASSERT(bitmap.mFormat == format);
+    RT_ASSERT(coords.x >= 0 && coords.x < (int32)bitmap.mWidth);
+    RT_ASSERT(coords.y >= 0 && coords.y < (int32)bitmap.mHeight);
+    RT_ASSERT(coords.z >= 0 && coords.z < (int32)bitmap.mWidth);
+    RT_ASSERT(coords.w >= 0 && coords.w < (int32)bitmap.mHeight);
 
-    const uint8* rowData0 = mData + mStride * static_cast<size_t>(coords.y);
-    const uint8* rowData1 = mData + mStride * static_cast<size_t>(coords.w);
+    const uint8* rowData0 = bitmap.mData + bitmap.mStride * static_cast<size_t>(coords.y);
+    const uint8* rowData1 = bitmap.mData + bitmap.mStride * static_cast<size_t>(coords.w);
 
     Vector4 color[4];
 
-    switch (mFormat)
+    // Note: the switch is resolved at compile time
+    switch (format)
     {
     case Format::R8_UNorm:
     {
@@ -591,10 +744,10 @@ void Bitmap::GetPixelBlock(const VectorInt4 coords, Vector4* outColors, const bo
     case Format::B8G8R8A8_UNorm_Palette:
     {
         constexpr float scale = 1.0f / 255.0f;
-        const uint8* source0 = mPalette + 4u * rowData0[coords.x];
-        const uint8* source1 = mPalette + 4u * rowData0[coords.z];
-        const uint8* source2 = mPalette + 4u * rowData1[coords.x];
-        const uint8* source3 = mPalette + 4u * rowData1[coords.z];
+        const uint8* source0 = bitmap.mPalette + 4u * rowData0[coords.x];
+        const uint8* source1 = bitmap.mPalette + 4u * rowData0[coords.z];
+        const uint8* source2 = bitmap.mPalette + 4u * rowData1[coords.x];
+        const uint8* source3 = bitmap.mPalette + 4u * rowData1[coords.z];
         color[0] = Vector4_Load_4xUint8(source0).Swizzle<2, 1, 0, 3>() * scale;
         color[1] = Vector4_Load_4xUint8(source1).Swizzle<2, 1, 0, 3>() * scale;
         color[2] = Vector4_Load_4xUint8(source2).Swizzle<2, 1, 0, 3>() * scale;
@@ -798,39 +951,69 @@ void Bitmap::GetPixelBlock(const VectorInt4 coords, Vector4* outColors, const bo
 
     case Format::BC1:
     {
-        color[0] = DecodeBC1(mData, coords.x, coords.y, mWidth);
-        color[1] = DecodeBC1(mData, coords.z, coords.y, mWidth);
-        color[2] = DecodeBC1(mData, coords.x, coords.w, mWidth);
-        color[3] = DecodeBC1(mData, coords.z, coords.w, mWidth);
+        if (gBlockCompressionMode == BlockCompressionMode::Direct)
+        {
+            color[0] = DecodeBC1(bitmap.mData, coords.x, coords.y, bitmap.mWidth);
+            color[1] = DecodeBC1(bitmap.mData, coords.z, coords.y, bitmap.mWidth);
+            color[2] = DecodeBC1(bitmap.mData, coords.x, coords.w, bitmap.mWidth);
+            color[3] = DecodeBC1(bitmap.mData, coords.z, coords.w, bitmap.mWidth);
+        }
+        else
+        {
+            color[0] = DecodeBC1_Cached(bitmap.mData, coords.x, coords.y, bitmap.mWidth);
+            color[1] = DecodeBC1_Cached(bitmap.mData, coords.z, coords.y, bitmap.mWidth);
+            color[2] = DecodeBC1_Cached(bitmap.mData, coords.x, coords.w, bitmap.mWidth);
+            color[3] = DecodeBC1_Cached(bitmap.mData, coords.z, coords.w, bitmap.mWidth);
+        }
         break;
     }
 
     case Format::BC4:
     {
-        color[0] = DecodeBC4(mData, coords.x, coords.y, mWidth);
-        color[1] = DecodeBC4(mData, coords.z, coords.y, mWidth);
-        color[2] = DecodeBC4(mData, coords.x, coords.w, mWidth);
-        color[3] = DecodeBC4(mData, coords.z, coords.w, mWidth);
+        if (gBlockCompressionMode == BlockCompressionMode::Direct)
+        {
+            color[0] = DecodeBC4(bitmap.mData, coords.x, coords.y, bitmap.mWidth);
+            color[1] = DecodeBC4(bitmap.mData, coords.z, coords.y, bitmap.mWidth);
+            color[2] = DecodeBC4(bitmap.mData, coords.x, coords.w, bitmap.mWidth);
+            color[3] = DecodeBC4(bitmap.mData, coords.z, coords.w, bitmap.mWidth);
+        }
+        else
+        {
+            color[0] = DecodeBC4_Cached(bitmap.mData, coords.x, coords.y, bitmap.mWidth);
+            color[1] = DecodeBC4_Cached(bitmap.mData, coords.z, coords.y, bitmap.mWidth);
+            color[2] = DecodeBC4_Cached(bitmap.mData, coords.x, coords.w, bitmap.mWidth);
+            color[3] = DecodeBC4_Cached(bitmap.mData, coords.z, coords.w, bitmap.mWidth);
+        }
         break;
     }
 
     case Format::BC5:
     {
-        color[0] = DecodeBC5(mData, coords.x, coords.y, mWidth);
-        color[1] = DecodeBC5(mData, coords.z, coords.y, mWidth);
-        color[2] = DecodeBC5(mData, coords.x, coords.w, mWidth);
-        color[3] = DecodeBC5(mData, coords.z, coords.w, mWidth);
+        if (gBlockCompressionMode == BlockCompressionMode::Direct)
+        {
+            color[0] = DecodeBC5(bitmap.mData, coords.x, coords.y, bitmap.mWidth);
+            color[1] = DecodeBC5(bitmap.mData, coords.z, coords.y, bitmap.mWidth);
+            color[2] = DecodeBC5(bitmap.mData, coords.x, coords.w, bitmap.mWidth);
+            color[3] = DecodeBC5(bitmap.mData, coords.z, coords.w, bitmap.mWidth);
+        }
+        else
+        {
+            color[0] = DecodeBC5_Cached(bitmap.mData, coords.x, coords.y, bitmap.mWidth);
+            color[1] = DecodeBC5_Cached(bitmap.mData, coords.z, coords.y, bitmap.mWidth);
+            color[2] = DecodeBC5_Cached(bitmap.mData, coords.x, coords.w, bitmap.mWidth);
+            color[3] = DecodeBC5_Cached(bitmap.mData, coords.z, coords.w, bitmap.mWidth);
+        }
         break;
     }
 
     default:
     {
         RT_FATAL("Unsupported bitmap format");
+        color[0] = color[1] = color[2] = color[3] = Vector4::Zero();
     }
     }
 
-    (void)forceLinearSpace;
-    if (!mLinearSpace /*&& !forceLinearSpace*/)
+    if (convertFromSRGB)
     {
         color[0] = Convert_sRGB_To_Linear(color[0]);
         color[1] = Convert_sRGB_To_Linear(color[1]);
@@ -844,6 +1027,52 @@ void Bitmap::GetPixelBlock(const VectorInt4 coords, Vector4* outColors, const bo
     outColors[3] = color[3];
 }
 
+Bitmap::PixelBlockFetchFunc Bitmap::GetPixelBlockFetchFunc() const
+{
+#define RT_BITMAP_FETCH_FUNC(f) \
+    case Format::f: return mLinearSpace ? &Bitmap::FetchPixelBlock<Format::f, false> : &Bitmap::FetchPixelBlock<Format::f, true>;
+
+    switch (mFormat)
+    {
+    RT_BITMAP_FETCH_FUNC(R8_UNorm)
+    RT_BITMAP_FETCH_FUNC(R8G8_UNorm)
+    RT_BITMAP_FETCH_FUNC(B8G8R8_UNorm)
+    RT_BITMAP_FETCH_FUNC(B8G8R8A8_UNorm)
+    RT_BITMAP_FETCH_FUNC(R8G8B8A8_UNorm)
+    RT_BITMAP_FETCH_FUNC(B8G8R8A8_UNorm_Palette)
+    RT_BITMAP_FETCH_FUNC(B5G6R5_UNorm)
+    RT_BITMAP_FETCH_FUNC(R16_UNorm)
+    RT_BITMAP_FETCH_FUNC(R16G16_UNorm)
+    RT_BITMAP_FETCH_FUNC(R16G16B16A16_UNorm)
+    RT_BITMAP_FETCH_FUNC(R32_Float)
+    RT_BITMAP_FETCH_FUNC(R32G32_Float)
+    RT_BITMAP_FETCH_FUNC(R32G32B32_Float)
+    RT_BITMAP_FETCH_FUNC(R32G32B32A32_Float)
+    RT_BITMAP_FETCH_FUNC(R16_Half)
+    RT_BITMAP_FETCH_FUNC(R16G16_Half)
+    RT_BITMAP_FETCH_FUNC(R16G16B16_Half)
+    RT_BITMAP_FETCH_FUNC(R16G16B16A16_Half)
+    RT_BITMAP_FETCH_FUNC(R9G9B9E5_SharedExp)
+    RT_BITMAP_FETCH_FUNC(R11G11B10_Float)
+    RT_BITMAP_FETCH_FUNC(BC1)
+    RT_BITMAP_FETCH_FUNC(BC4)
+    RT_BITMAP_FETCH_FUNC(BC5)
+    default:
+        break;
+    }
+
+#undef RT_BITMAP_FETCH_FUNC
+
+    RT_FATAL("Unsupported bitmap format");
+    return nullptr;
+}
+
+void Bitmap::GetPixelBlock(const VectorInt4 coords, Vector4* outColors, const bool forceLinearSpace) const
+{
+    (void)forceLinearSpace;
+    GetPixelBlockFetchFunc()(*this, coords, outColors);
+}
+
 bool Bitmap::Scale(const math::Vector4& factor)
 {
     if (mFormat == Format::R32G32B32_Float)
@@ -40,6 +40,14 @@ public:
         BC5,
     };
 
+    // sampling strategy for block-compressed (BCn) formats
+    enum class BlockCompressionMode : uint8
+    {
+        Direct = 0,         // decode the block for every fetched texel
+        Cached,             // decode whole blocks into a per-thread cache of recently used blocks
+        TranscodeOnLoad,    // decompress to R8G8B8A8_UNorm when loading (fastest sampling, 4-8x more memory)
+    };
+
     struct InitData
     {
         uint32 width = 0;
@@ -50,6 +58,7 @@ public:
         bool linearSpace = true;
         uint32 paletteSize = 0;
         bool useDefaultAllocator = false;
+        bool wrapData = false;      // use 'data' as the bitmap storage instead of making a copy (memory is owned by the caller)
     };
 
     RAYLIB_API Bitmap(const char* debugName = "<unnamed>");
@@ -87,6 +96,7 @@ public:
     RT_FORCE_INLINE uint32 GetStride() const { return mStride; }
     RT_FORCE_INLINE uint32 GetHeight() const { return mHeight; }
     RT_FORCE_INLINE Format GetFormat() const { return mFormat; }
+    RT_FORCE_INLINE bool IsWrappingData() const { return mWrapsData; }
 
     // get allocated size
     RT_FORCE_INLINE size_t GetDataSize() const { return (size_t)mStride * (size_t)mHeight; }
@@ -98,6 +108,7 @@ public:
     RAYLIB_API bool Init(const InitData& initData);
 
     // release memory
+    // NOTE: wrapped memory (see InitData::wrapData) is not freed
     void Release();
 
     // copy texture data
@@ -107,6 +118,14 @@ public:
     // load from file
     RAYLIB_API bool Load(const char* path);
 
+    // select how block-compressed bitmaps are sampled (global setting)
+    // NOTE: TranscodeOnLoad affects bitmaps loaded afterwards only
+    RAYLIB_API static void SetBlockCompressionMode(BlockCompressionMode mode);
+    RAYLIB_API static BlockCompressionMode GetBlockCompressionMode();
+
+    // check if the format is block-compressed
+    static bool IsBlockCompressed(Format format);
+
     // save to BMP file
     RAYLIB_API bool SaveBMP(const char* path, bool flipVertically) const;
 
@@ -126,6 +145,12 @@ public:
     // get 2x2 pixel block
     RAYLIB_API void GetPixelBlock(const math::VectorInt4 coords, math::Vector4* outColors, const bool forceLinearSpace = false) const;
 
+    // function fetching 2x2 pixel block (in linear space) from a bitmap of a specific format
+    using PixelBlockFetchFunc = void (*)(const Bitmap& bitmap, const math::VectorInt4 coords, math::Vector4* outColors);
+
+    // get pixel block fetch function specialized for the bitmap format (allows to skip format dispatch per fetch)
+    RAYLIB_API PixelBlockFetchFunc GetPixelBlockFetchFunc() const;
+
     // fill with zeros
     RAYLIB_API void Clear();
 
@@ -138,6 +163,12 @@ private:
 
     friend class BitmapTexture;
 
+    template<Format format, bool convertFromSRGB>
+    static void FetchPixelBlock(const Bitmap& bitmap, const math::VectorInt4 coords, math::Vector4* outColors);
+
+    // decompress block-compressed data into R8G8B8A8_UNorm format
+    bool TranscodeBlockCompressed();
+
     bool LoadBMP(FILE* file, const char* path);
     bool LoadDDS(FILE* file, const char* path);
     bool LoadEXR(FILE* file, const char* path);
@@ -152,6 +183,7 @@ private:
     Format mFormat;
     bool mLinearSpace : 1;
     bool mUsesDefaultAllocator : 1;
+    bool mWrapsData : 1;
     char* mDebugName;
 };
 
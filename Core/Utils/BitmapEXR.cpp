@@ -195,7 +195,7 @@ exrImageError:
 
 bool Bitmap::SaveEXR(const char* path, const float exposure) const
 {
-    if (mFormat != Format::R32G32B32_Float)
+    if (mFormat != Format::R32G32B32_Float && mFormat != Format::R32G32B32A32_Float)
     {
         RT_LOG_ERROR("Bitmap::SaveEXR: Unsupported format");
         return false;
@@ -203,7 +203,9 @@ bool Bitmap::SaveEXR(const char* path, const float exposure) const
 
     // TODO support more types
 
-    const Float3* data = reinterpret_cast<const Float3*>(mData);
+    // alpha channel (if present) is skipped
+    const uint32 pixelStride = mFormat == Format::R32G32B32A32_Float ? 4 : 3;
+    const float* data = reinterpret_cast<const float*>(mData);
 
     EXRHeader header;
     InitEXRHeader(&header);
@@ -222,9 +224,9 @@ bool Bitmap::SaveEXR(const char* path, const float exposure) const
     const uint32 numPixels = GetWidth() * GetHeight();
     for (uint32 i = 0; i < numPixels; i++)
     {
-        images[0][i] = exposure * data[i].x;
-        images[1][i] = exposure * data[i].y;
-        images[2][i] = exposure * data[i].z;
+        images[0][i] = exposure * data[pixelStride * i + 0];
+        images[1][i] = exposure * data[pixelStride * i + 1];
+        images[2][i] = exposure * data[pixelStride * i + 2];
     }
 
     float* image_ptr[3];
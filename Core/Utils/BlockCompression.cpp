@@ -1,5 +1,9 @@
 #include "PCH.h"
+#include "BlockCompression.h"
 #include "Math/VectorInt4.h"
+#include "Math/Vector8.h"
+
+#include <atomic>
 
 namespace rt {
 
@@ -144,4 +148,302 @@ const Vector4 DecodeBC5(const uint8* data, uint32 x, uint32 y, const uint32 widt
     return Vector4(green, red, 0.0f, 1.0f);
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DecodeBlockBC1(const uint8* blockData, Vector4* outTexels)
+{
+    // extract base colors
+    const VectorInt4 mask = { 0x1F << 11, 0x3F << 5, 0x1F, 0 };
+    const VectorInt4 raw0 = VectorInt4(*reinterpret_cast<const int32*>(blockData + 0)) & mask;
+    const VectorInt4 raw1 = VectorInt4(*reinterpret_cast<const int32*>(blockData + 2)) & mask;
+
+    // scale down from 5,6,5 bit ranges to 0...1 float range
+    const Vector4 scale{ 1.0f / 2048.0f / 31.0f, 1.0f / 32.0f / 63.0f, 1.0f / 31.0f, 0.0f };
+    const Vector4 color0 = raw0.ConvertToFloat() * scale;
+    const Vector4 color1 = raw1.ConvertToFloat() * scale;
+
+    // build the palette once for the whole block
+    const Vector4 palette[4] =
+    {
+        color0,
+        color1,
+        Vector4::Lerp(color0, color1, 1.0f / 3.0f),
+        Vector4::Lerp(color0, color1, 2.0f / 3.0f),
+    };
+
+    uint32 code = *reinterpret_cast<const uint32*>(blockData + 4);
+    for (uint32 i = 0; i < 16; ++i, code >>= 2u)
+    {
+        outTexels[i] = palette[code & 3u];
+    }
+}
+
+namespace helper
+{
+
+// expand all 8 grayscale palette entries at once and write 16 texels to a given component
+static void DecodeBlockBC_Grayscale(const uint8* blockData, float* outValues, const uint32 outStride)
+{
+    const float color0 = static_cast<float>(blockData[0]) / 255.0f;
+    const float color1 = static_cast<float>(blockData[1]) / 255.0f;
+
+    Vector8 palette;
+    if (blockData[0] > blockData[1])
+    {
+        const Vector8 weights0(1.0f, 0.0f, 6.0f / 7.0f, 5.0f / 7.0f, 4.0f / 7.0f, 3.0f / 7.0f, 2.0f / 7.0f, 1.0f / 7.0f);
+        const Vector8 weights1(0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f);
+        palette = Vector8(color0) * weights0 + Vector8(color1) * weights1;
+    }
+    else
+    {
+        const Vector8 weights0(1.0f, 0.0f, 4.0f / 5.0f, 3.0f / 5.0f, 2.0f / 5.0f, 1.0f / 5.0f, 0.0f, 0.0f);
+        const Vector8 weights1(0.0f, 1.0f, 1.0f / 5.0f, 2.0f / 5.0f, 3.0f / 5.0f, 4.0f / 5.0f, 0.0f, 0.0f);
+        const Vector8 constant(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+        palette = Vector8(color0) * weights0 + Vector8(color1) * weights1 + constant;
+    }
+
+    uint64 code = 0;
+    memcpy(&code, blockData + 2, 6);
+    for (uint32 i = 0; i < 16; ++i, code >>= 3u)
+    {
+        outValues[i * outStride] = palette[static_cast<uint32>(code & 7u)];
+    }
+}
+
+} // helper
+
+void DecodeBlockBC4(const uint8* blockData, Vector4* outTexels)
+{
+    float values[16];
+    helper::DecodeBlockBC_Grayscale(blockData, values, 1u);
+
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        outTexels[i] = Vector4(values[i], values[i], values[i], 1.0f);
+    }
+}
+
+void DecodeBlockBC5(const uint8* blockData, Vector4* outTexels)
+{
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        outTexels[i] = Vector4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    // first channel is stored in green, second in red (matches DecodeBC5)
+    float* outValues = reinterpret_cast<float*>(outTexels);
+    helper::DecodeBlockBC_Grayscale(blockData, outValues + 1u, 4u);
+    helper::DecodeBlockBC_Grayscale(blockData + 8, outValues + 0u, 4u);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void EncodeBlockBC1(const Vector4* texels, uint8* outBlockData)
+{
+    Vector4 minColor = Vector4::Saturate(texels[0]);
+    Vector4 maxColor = minColor;
+    Vector4 meanColor = Vector4::Zero();
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        const Vector4 color = Vector4::Saturate(texels[i]);
+        minColor = Vector4::Min(minColor, color);
+        maxColor = Vector4::Max(maxColor, color);
+        meanColor += color;
+    }
+    meanColor *= 1.0f / 16.0f;
+
+    // pick bounding box diagonal: flip channels that are anti-correlated with the widest one
+    const Vector4 extent = maxColor - minColor;
+    const uint32 mainChannel = extent.x >= extent.y ? (extent.x >= extent.z ? 0u : 2u) : (extent.y >= extent.z ? 1u : 2u);
+    for (uint32 channel = 0; channel < 3; ++channel)
+    {
+        float covariance = 0.0f;
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            const Vector4 color = Vector4::Saturate(texels[i]);
+            covariance += (color[mainChannel] - meanColor[mainChannel]) * (color[channel] - meanColor[channel]);
+        }
+
+        if (covariance < 0.0f)
+        {
+            std::swap(minColor[channel], maxColor[channel]);
+        }
+    }
+
+    const auto quantize = [](const Vector4& color) -> uint16
+    {
+        const uint32 red = static_cast<uint32>(color.x * 31.0f + 0.5f);
+        const uint32 green = static_cast<uint32>(color.y * 63.0f + 0.5f);
+        const uint32 blue = static_cast<uint32>(color.z * 31.0f + 0.5f);
+        return static_cast<uint16>((red << 11u) | (green << 5u) | blue);
+    };
+
+    uint16 color0 = quantize(maxColor);
+    uint16 color1 = quantize(minColor);
+
+    // decoder always uses 4-color palette, but keep color0 > color1 so other decoders agree
+    if (color0 < color1)
+    {
+        std::swap(color0, color1);
+    }
+
+    memcpy(outBlockData + 0, &color0, sizeof(uint16));
+    memcpy(outBlockData + 2, &color1, sizeof(uint16));
+
+    // project texels onto the (quantized) endpoints line
+    const auto dequantize = [](uint16 color)
+    {
+        return Vector4(static_cast<float>(color >> 11u) / 31.0f, static_cast<float>((color >> 5u) & 0x3Fu) / 63.0f, static_cast<float>(color & 0x1Fu) / 31.0f, 0.0f);
+    };
+
+    const Vector4 endpoint0 = dequantize(color0);
+    const Vector4 axis = dequantize(color1) - endpoint0;
+    const float axisLengthSqr = Vector4::Dot3(axis, axis);
+
+    // palette index for 0, 1/3, 2/3 and 1 of the way from color0 to color1
+    const uint32 indices[] = { 0u, 2u, 3u, 1u };
+
+    uint32 code = 0;
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        float t = 0.0f;
+        if (axisLengthSqr > 0.0f)
+        {
+            t = Clamp(Vector4::Dot3(Vector4::Saturate(texels[i]) - endpoint0, axis) / axisLengthSqr, 0.0f, 1.0f);
+        }
+
+        code |= indices[static_cast<uint32>(t * 3.0f + 0.5f)] << (2u * i);
+    }
+
+    memcpy(outBlockData + 4, &code, sizeof(uint32));
+}
+
+namespace helper
+{
+
+// always uses 8-value mode (color0 > color1), unless the whole block is uniform
+static void EncodeBlockBC_Grayscale(const float* values, const uint32 stride, uint8* outBlockData)
+{
+    float minValue = 1.0f;
+    float maxValue = 0.0f;
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        const float value = Clamp(values[i * stride], 0.0f, 1.0f);
+        minValue = Min(minValue, value);
+        maxValue = Max(maxValue, value);
+    }
+
+    const uint32 intColor0 = static_cast<uint32>(maxValue * 255.0f + 0.5f);
+    const uint32 intColor1 = static_cast<uint32>(minValue * 255.0f + 0.5f);
+    outBlockData[0] = static_cast<uint8>(intColor0);
+    outBlockData[1] = static_cast<uint8>(intColor1);
+
+    uint64 code = 0;
+    if (intColor0 > intColor1)
+    {
+        const float color0 = static_cast<float>(intColor0) / 255.0f;
+        const float color1 = static_cast<float>(intColor1) / 255.0f;
+        const float scale = 7.0f / (color0 - color1);
+
+        for (uint32 i = 0; i < 16; ++i)
+        {
+            const float value = Clamp(values[i * stride], color1, color0);
+            const uint32 step = static_cast<uint32>((color0 - value) * scale + 0.5f);
+
+            // palette order: color0, color1, then 6 interpolated values from color0 towards color1
+            const uint32 index = step == 0u ? 0u : (step == 7u ? 1u : step + 1u);
+            code |= static_cast<uint64>(index) << (3u * i);
+        }
+    }
+
+    memcpy(outBlockData + 2, &code, 6);
+}
+
+} // helper
+
+void EncodeBlockBC4(const Vector4* texels, uint8* outBlockData)
+{
+    helper::EncodeBlockBC_Grayscale(reinterpret_cast<const float*>(texels), 4u, outBlockData);
+}
+
+void EncodeBlockBC5(const Vector4* texels, uint8* outBlockData)
+{
+    // first channel is stored in green, second in red (matches DecodeBC5)
+    const float* values = reinterpret_cast<const float*>(texels);
+    helper::EncodeBlockBC_Grayscale(values + 1u, 4u, outBlockData);
+    helper::EncodeBlockBC_Grayscale(values + 0u, 4u, outBlockData + 8);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// bumped whenever block-compressed data is released, so stale thread-local entries are never hit
+std::atomic<uint32> gDecodedBlockCacheEpoch{ 1u };
+
+// small direct-mapped cache of decoded blocks (tagged with the block address)
+struct DecodedBlockCache
+{
+    static constexpr uint32 NumEntries = 64;
+
+    const uint8* tags[NumEntries];
+    uint32 epoch;
+    RT_ALIGN(64) Vector4 texels[NumEntries][16];
+};
+
+thread_local DecodedBlockCache gDecodedBlockCache;
+
+using DecodeBlockFunc = void (*)(const uint8*, Vector4*);
+
+template<uint32 BytesPerBlock, DecodeBlockFunc decodeFunc>
+RT_FORCE_INLINE const Vector4 DecodeBC_Cached(const uint8* data, uint32 x, uint32 y, const uint32 width)
+{
+    const size_t blocksInRow = width / 4u; // TODO non-4-multiply width support
+    const size_t blockX = x / 4u;
+    const size_t blockY = y / 4u;
+    const uint8* blockData = data + BytesPerBlock * (blocksInRow * blockY + blockX);
+
+    DecodedBlockCache& cache = gDecodedBlockCache;
+
+    const uint32 epoch = gDecodedBlockCacheEpoch.load(std::memory_order_relaxed);
+    if (cache.epoch != epoch)
+    {
+        memset(cache.tags, 0, sizeof(cache.tags));
+        cache.epoch = epoch;
+    }
+
+    // hash block coordinates instead of the address, so vertically adjacent blocks don't collide when the row pitch
+    // is a multiple of the cache size (bitmap address is mixed in to separate textures sampled at the same coordinates)
+    const size_t entryIndex = (blockX ^ (blockY * 0x9E37u) ^ (reinterpret_cast<size_t>(data) / RT_CACHE_LINE_SIZE)) % DecodedBlockCache::NumEntries;
+    if (cache.tags[entryIndex] != blockData)
+    {
+        decodeFunc(blockData, cache.texels[entryIndex]);
+        cache.tags[entryIndex] = blockData;
+    }
+
+    return cache.texels[entryIndex][4u * (y % 4u) + (x % 4u)];
+}
+
+} // namespace
+
+const Vector4 DecodeBC1_Cached(const uint8* data, uint32 x, uint32 y, const uint32 width)
+{
+    return DecodeBC_Cached<8, DecodeBlockBC1>(data, x, y, width);
+}
+
+const Vector4 DecodeBC4_Cached(const uint8* data, uint32 x, uint32 y, const uint32 width)
+{
+    return DecodeBC_Cached<8, DecodeBlockBC4>(data, x, y, width);
+}
+
+const Vector4 DecodeBC5_Cached(const uint8* data, uint32 x, uint32 y, const uint32 width)
+{
+    return DecodeBC_Cached<16, DecodeBlockBC5>(data, x, y, width);
+}
+
+void InvalidateDecodedBlockCache()
+{
+    gDecodedBlockCacheEpoch.fetch_add(1u, std::memory_order_relaxed);
+}
+
 } // namespace rt
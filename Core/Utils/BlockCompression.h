@@ -10,4 +10,23 @@ const math::Vector4 DecodeBC1(const uint8* data, uint32 x, uint32 y, const uint3
 const math::Vector4 DecodeBC4(const uint8* data, uint32 x, uint32 y, const uint32 width);
 const math::Vector4 DecodeBC5(const uint8* data, uint32 x, uint32 y, const uint32 width);
 
+// decode whole 4x4 block into 16 texels (row-major order)
+void DecodeBlockBC1(const uint8* blockData, math::Vector4* outTexels);
+void DecodeBlockBC4(const uint8* blockData, math::Vector4* outTexels);
+void DecodeBlockBC5(const uint8* blockData, math::Vector4* outTexels);
+
+// encode 16 texels (row-major order, 0...1 range) into a single block
+// NOTE: simple bounding box fit, good enough for generating mip levels
+RAYLIB_API void EncodeBlockBC1(const math::Vector4* texels, uint8* outBlockData);
+RAYLIB_API void EncodeBlockBC4(const math::Vector4* texels, uint8* outBlockData);
+RAYLIB_API void EncodeBlockBC5(const math::Vector4* texels, uint8* outBlockData);
+
+// decode single texel via per-thread cache of recently decoded blocks
+const math::Vector4 DecodeBC1_Cached(const uint8* data, uint32 x, uint32 y, const uint32 width);
+const math::Vector4 DecodeBC4_Cached(const uint8* data, uint32 x, uint32 y, const uint32 width);
+const math::Vector4 DecodeBC5_Cached(const uint8* data, uint32 x, uint32 y, const uint32 width);
+
+// drop all cached blocks (must be called when block-compressed data is modified or released)
+void InvalidateDecodedBlockCache();
+
 } // namespace rt
@@ -37,6 +37,9 @@ public:
             // TODO tweak this
             uint32 hashTableSize = math::NextPowerOfTwo(particles.Size());
             mHashTableMask = hashTableSize - 1;
+
+            // size by particle list capacity, so the table doesn't need to be reallocated as long as the list isn't
+            mCellEnds.Reserve(math::NextPowerOfTwo(particles.Capacity()));
             mCellEnds.Resize(hashTableSize);
 
             memset(mCellEnds.Data(), 0, mCellEnds.Size() * sizeof(uint32));
@@ -61,6 +64,7 @@ public:
         }
 
         // fill up particle indices
+        mIndices.Reserve(particles.Capacity());
         mIndices.Resize(particles.Size());
         for (uint32 i = 0; i < particles.Size(); i++)
         {
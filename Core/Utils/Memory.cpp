@@ -1,14 +1,29 @@
 #include "PCH.h"
 #include "Memory.h"
+#include "Numa.h"
 #include "Logger.h"
 #include "../Math/Math.h"
 
 #include <stdlib.h>
 #include <malloc.h>
+#include <atomic>
+
+#if defined(WIN32)
 #include <Windows.h>
+#elif defined(__LINUX__) | defined(__linux__)
+#include <sys/mman.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fstream>
+#include <string>
+#include <mutex>
+#include <unordered_map>
+#endif // defined(WIN32)
 
 namespace rt {
 
+static std::atomic<uint64> gNumHeapAllocations(0);
+
 #if defined(WIN32)
 
 static bool TogglePrivilege(TCHAR* pszPrivilege, BOOL bEnable)
@@ -72,11 +87,78 @@ static void EnableLargePagesSupport()
     }
 }
 
-#else
+#elif defined(__LINUX__) | defined(__linux__)
+
+// huge pages are used only if enabled via InitMemory()
+static bool gLargePagesEnabled = false;
+
+// default huge page size on x86-64, overriden with value from /proc/meminfo
+static size_t gHugePageSize = 2u * 1024u * 1024u;
+
+// Sizes of mappings made by SystemAllocator, required by munmap()
+// NOTE: kept aside instead of a header in front of the user data, so that e.g. a 2 MB allocation fits exactly one huge page
+struct SystemAllocations
+{
+    std::mutex lock;
+    std::unordered_map<void*, size_t> mappingSizes;
+};
+
+static SystemAllocations& GetSystemAllocations()
+{
+    // intentionally leaked, so that static objects can still free their memory when destroyed
+    static SystemAllocations* allocations = new SystemAllocations;
+    return *allocations;
+}
 
 static void EnableLargePagesSupport()
 {
-    // TODO
+    size_t numFreeHugePages = 0;
+
+    // query preallocated huge pages pool (used by MAP_HUGETLB)
+    {
+        std::ifstream file("/proc/meminfo");
+        std::string line;
+        while (std::getline(file, line))
+        {
+            size_t value = 0;
+            if (sscanf(line.c_str(), "Hugepagesize: %zu kB", &value) == 1 && value > 0)
+            {
+                gHugePageSize = value * 1024u;
+            }
+            else if (sscanf(line.c_str(), "HugePages_Free: %zu", &value) == 1)
+            {
+                numFreeHugePages = value;
+            }
+        }
+    }
+
+    // query transparent huge pages mode (used by madvise(MADV_HUGEPAGE))
+    std::string transparentHugePagesMode = "unavailable";
+    {
+        std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+        std::string line;
+        if (std::getline(file, line))
+        {
+            // active mode is marked with brackets, e.g. "always [madvise] never"
+            const size_t begin = line.find('[');
+            const size_t end = line.find(']');
+            if (begin != std::string::npos && end != std::string::npos && end > begin)
+            {
+                transparentHugePagesMode = line.substr(begin + 1, end - begin - 1);
+            }
+        }
+    }
+
+    gLargePagesEnabled = true;
+
+    RT_LOG_INFO("Large page support enabled. Huge page size: %zu bytes, free hugetlb pages: %zu, transparent huge pages: %s",
+        gHugePageSize, numFreeHugePages, transparentHugePagesMode.c_str());
+}
+
+static void* MapMemory(size_t size, int extraFlags)
+{
+    void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extraFlags, -1, 0);
+    return ptr != MAP_FAILED ? ptr : nullptr;
 }
 
 #endif // WIN32
@@ -87,6 +169,19 @@ void InitMemory(const MemoryInitOptions& options)
     {
         EnableLargePagesSupport();
     }
+#if defined(__LINUX__) | defined(__linux__)
+    else
+    {
+        gLargePagesEnabled = false;
+    }
+#endif // defined(__LINUX__) | defined(__linux__)
+
+    Numa::SetReplicationEnabled(options.replicateOnNumaNodes);
+}
+
+uint64 GetNumHeapAllocations()
+{
+    return gNumHeapAllocations.load(std::memory_order_relaxed);
 }
 
 void* DefaultAllocator::Allocate(size_t size, size_t alignment)
@@ -103,6 +198,9 @@ void* DefaultAllocator::Allocate(size_t size, size_t alignment)
         ptr = nullptr;
     }
 #endif // defined(WIN32)
+
+    gNumHeapAllocations.fetch_add(1, std::memory_order_relaxed);
+
     return ptr;
 }
 
@@ -162,11 +260,86 @@ void* SystemAllocator::Allocate(size_t size, size_t alignment)
 
 #elif defined(__LINUX__) | defined(__linux__)
 
-    // TODO
-    DefaultAllocator::Allocate(size, alignment);
+    const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+
+    RT_ASSERT(alignment <= pageSize, "SystemAllocator: Alignment is too big (requested %zu bytes)", alignment);
+
+    void* mappingBase = nullptr;
+    size_t mappingSize = 0;
+
+    if (gLargePagesEnabled && size >= gHugePageSize)
+    {
+        // try preallocated huge pages first (requires reserved pool, see /proc/sys/vm/nr_hugepages)
+        mappingSize = math::RoundUp(size, gHugePageSize);
+        mappingBase = MapMemory(mappingSize, MAP_HUGETLB);
+        if (mappingBase)
+        {
+            RT_LOG_DEBUG("SystemAllocator: Allocated %.2f KB (via hugetlb pages)", size / 1024.0);
+        }
+
+        // then transparent huge pages
+        if (!mappingBase)
+        {
+            // over-allocate, so the region can be trimmed to huge page boundaries
+            const size_t reservedSize = mappingSize + gHugePageSize;
+            char* reservedBase = static_cast<char*>(MapMemory(reservedSize, 0));
+            if (reservedBase)
+            {
+                char* alignedBase = reinterpret_cast<char*>(math::RoundUp(reinterpret_cast<size_t>(reservedBase), gHugePageSize));
+                const size_t headSize = alignedBase - reservedBase;
+                const size_t tailSize = reservedSize - headSize - mappingSize;
+
+                if (headSize > 0)
+                {
+                    ::munmap(reservedBase, headSize);
+                }
+                if (tailSize > 0)
+                {
+                    ::munmap(alignedBase + mappingSize, tailSize);
+                }
+
+                mappingBase = alignedBase;
+
+                if (0 == ::madvise(mappingBase, mappingSize, MADV_HUGEPAGE))
+                {
+                    RT_LOG_DEBUG("SystemAllocator: Allocated %.2f KB (via transparent huge pages)", size / 1024.0);
+                }
+                else
+                {
+                    RT_LOG_DEBUG("SystemAllocator: Allocated %.2f KB (huge pages advice rejected, error code: %i)", size / 1024.0, errno);
+                }
+            }
+        }
+    }
+
+    // fallback to regular pages
+    if (!mappingBase)
+    {
+        mappingSize = math::RoundUp(size, pageSize);
+        mappingBase = MapMemory(mappingSize, 0);
+        if (mappingBase)
+        {
+            RT_LOG_DEBUG("SystemAllocator: Allocated %.2f KB", size / 1024.0);
+        }
+        else
+        {
+            RT_LOG_ERROR("SystemAllocator: Failed to allocate %.2f KB, error code: %i", size / 1024.0, errno);
+            return nullptr;
+        }
+    }
+
+    ptr = mappingBase;
+
+    {
+        SystemAllocations& allocations = GetSystemAllocations();
+        std::lock_guard<std::mutex> lock(allocations.lock);
+        allocations.mappingSizes[ptr] = mappingSize;
+    }
+
+#endif // defined(WIN32)
+
+    gNumHeapAllocations.fetch_add(1, std::memory_order_relaxed);
 
-#endif // 
-    
     return ptr;
 }
 
@@ -175,9 +348,177 @@ void SystemAllocator::Free(void* ptr)
 #if defined(WIN32)
     ::VirtualFree(ptr, 0, MEM_RELEASE);
 #elif defined(__LINUX__) | defined(__linux__)
-    // TODO
-    DefaultAllocator::Free(ptr);
-#endif // 
+    if (ptr)
+    {
+        size_t mappingSize = 0;
+        {
+            SystemAllocations& allocations = GetSystemAllocations();
+            std::lock_guard<std::mutex> lock(allocations.lock);
+            const auto iter = allocations.mappingSizes.find(ptr);
+            if (iter == allocations.mappingSizes.end())
+            {
+                RT_LOG_ERROR("SystemAllocator: Freeing unknown pointer %p", ptr);
+                return;
+            }
+            mappingSize = iter->second;
+            allocations.mappingSizes.erase(iter);
+        }
+
+        ::munmap(ptr, mappingSize);
+    }
+#endif // defined(WIN32)
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+struct FrameArena
+{
+    static constexpr uint32 MaxChunks = 32;
+    static constexpr size_t MinChunkSize = 256u * 1024u;
+
+    struct Chunk
+    {
+        char* data;
+        size_t size;
+    };
+
+    Chunk chunks[MaxChunks];
+    uint32 numChunks = 0;
+
+    // current position
+    uint32 currentChunk = 0;
+    size_t offset = 0;
+
+    ~FrameArena()
+    {
+        for (uint32 i = 0; i < numChunks; ++i)
+        {
+            DefaultAllocator::Free(chunks[i].data);
+        }
+    }
+
+    bool AddChunk(size_t minSize)
+    {
+        if (numChunks == MaxChunks)
+        {
+            return false;
+        }
+
+        // each chunk is at least twice as big as the previous one
+        size_t size = numChunks > 0 ? 2 * chunks[numChunks - 1].size : MinChunkSize;
+        size = std::max(size, minSize);
+
+        char* data = static_cast<char*>(DefaultAllocator::Allocate(size, RT_CACHE_LINE_SIZE));
+        if (!data)
+        {
+            return false;
+        }
+
+        chunks[numChunks].data = data;
+        chunks[numChunks].size = size;
+        numChunks++;
+        return true;
+    }
+};
+
+thread_local FrameArena gFrameArena;
+
+} // namespace
+
+void* FrameAllocator::Allocate(size_t size, size_t alignment)
+{
+    if (size == 0)
+    {
+        return nullptr;
+    }
+
+    FrameArena& arena = gFrameArena;
+    alignment = std::max<size_t>(alignment, 1u);
+
+    for (;;)
+    {
+        if (arena.currentChunk < arena.numChunks)
+        {
+            const FrameArena::Chunk& chunk = arena.chunks[arena.currentChunk];
+            const size_t base = reinterpret_cast<size_t>(chunk.data);
+            const size_t alignedOffset = math::RoundUp(base + arena.offset, alignment) - base;
+
+            if (alignedOffset + size <= chunk.size)
+            {
+                arena.offset = alignedOffset + size;
+                return chunk.data + alignedOffset;
+            }
+
+            // the rest of current chunk is wasted
+            if (arena.currentChunk + 1 < arena.numChunks)
+            {
+                arena.currentChunk++;
+                arena.offset = 0;
+                continue;
+            }
+        }
+
+        if (!arena.AddChunk(size + alignment))
+        {
+            RT_LOG_ERROR("FrameAllocator: Failed to allocate %zu bytes", size);
+            return nullptr;
+        }
+
+        arena.currentChunk = arena.numChunks - 1;
+        arena.offset = 0;
+    }
+}
+
+void FrameAllocator::Reset()
+{
+    FrameArena& arena = gFrameArena;
+    arena.currentChunk = 0;
+    arena.offset = 0;
+}
+
+FrameAllocator::Marker FrameAllocator::GetMarker()
+{
+    const FrameArena& arena = gFrameArena;
+    return { arena.currentChunk, arena.offset };
+}
+
+void FrameAllocator::Restore(const Marker& marker)
+{
+    FrameArena& arena = gFrameArena;
+    RT_ASSERT(marker.chunkIndex < arena.currentChunk || (marker.chunkIndex == arena.currentChunk && marker.offset <= arena.offset),
+              "FrameAllocator: Marker is ahead of current position");
+
+    arena.currentChunk = marker.chunkIndex;
+    arena.offset = marker.offset;
+}
+
+void FrameAllocator::ReleaseUnusedMemory()
+{
+    FrameArena& arena = gFrameArena;
+
+    // chunk at current position is in use unless nothing is allocated
+    const uint32 firstUnusedChunk = (arena.currentChunk == 0 && arena.offset == 0) ? 0 : arena.currentChunk + 1;
+
+    for (uint32 i = firstUnusedChunk; i < arena.numChunks; ++i)
+    {
+        DefaultAllocator::Free(arena.chunks[i].data);
+    }
+
+    arena.numChunks = std::min(arena.numChunks, firstUnusedChunk);
+}
+
+size_t FrameAllocator::GetArenaSize()
+{
+    const FrameArena& arena = gFrameArena;
+
+    size_t size = 0;
+    for (uint32 i = 0; i < arena.numChunks; ++i)
+    {
+        size += arena.chunks[i].size;
+    }
+    return size;
 }
 
-} // namespace rt
\ No newline at end of file
+} // namespace rt
@@ -10,10 +10,17 @@ namespace rt {
 struct MemoryInitOptions
 {
     bool useLargePages = false;
+
+    // keep a copy of read-only acceleration data (BVH nodes, triangles) on each NUMA node
+    bool replicateOnNumaNodes = false;
 };
 
 RAYLIB_API void InitMemory(const MemoryInitOptions& options = MemoryInitOptions());
 
+// Total number of allocations made so far via DefaultAllocator and SystemAllocator
+// Used to verify that hot code paths don't allocate memory.
+RAYLIB_API uint64 GetNumHeapAllocations();
+
 class DefaultAllocator
 {
 public:
@@ -28,6 +35,64 @@ public:
     RAYLIB_API static void Free(void* ptr);
 };
 
+/**
+ * Linear (bump) allocator working on calling thread's memory arena.
+ * Allocations are not freed individually - all of them are released at once with Reset()
+ * (at the end of a frame) or when a FrameAllocatorScope is left.
+ * Arena memory is retained, so steady-state frames don't touch the heap.
+ * Intended for short-lived scratch data, e.g. as DynArray's allocator.
+ */
+class FrameAllocator
+{
+public:
+    // Position in the arena
+    struct Marker
+    {
+        uint32 chunkIndex;
+        size_t offset;
+    };
+
+    RAYLIB_API static void* Allocate(size_t size, size_t alignment = 1);
+
+    RT_FORCE_INLINE static void Free(void* ptr)
+    {
+        RT_UNUSED(ptr);
+    }
+
+    // Release all the allocations made by calling thread
+    RAYLIB_API static void Reset();
+
+    // Release allocations made by calling thread after the marker was taken
+    RAYLIB_API static Marker GetMarker();
+    RAYLIB_API static void Restore(const Marker& marker);
+
+    // Return arena chunks that are not in use to the system
+    RAYLIB_API static void ReleaseUnusedMemory();
+
+    // Total size of calling thread's arena
+    RAYLIB_API static size_t GetArenaSize();
+};
+
+// Releases all frame allocations made within a C++ scope
+class FrameAllocatorScope
+{
+public:
+    RT_FORCE_INLINE FrameAllocatorScope()
+        : mMarker(FrameAllocator::GetMarker())
+    { }
+
+    RT_FORCE_INLINE ~FrameAllocatorScope()
+    {
+        FrameAllocator::Restore(mMarker);
+    }
+
+    FrameAllocatorScope(const FrameAllocatorScope&) = delete;
+    FrameAllocatorScope& operator = (const FrameAllocatorScope&) = delete;
+
+private:
+    FrameAllocator::Marker mMarker;
+};
+
 // Override this class to align children objects.
 template <size_t Alignment, typename Allocator = DefaultAllocator>
 class Aligned
@@ -8,6 +8,14 @@
 
 namespace rt {
 
+/**
+ * Tells if objects of a type can be relocated with a plain memory copy, i.e. if moving the bytes to a new
+ * place and forgetting the old ones is equivalent to move construction followed by destruction.
+ * True for trivially copyable types. Specialize for types that own memory, but never point to themselves.
+ */
+template<typename T>
+struct IsTriviallyRelocatable : public std::integral_constant<bool, std::is_trivially_copyable<T>::value> { };
+
 /**
  * Collection of various classes for low-level C++ objects memory manipulation.
  */
@@ -58,12 +66,29 @@ public:
         memcpy(target, source, sizeof(T));
     }
 
+    /**
+     * Move an array of trivially relocatable objects with a single memory copy.
+     * @note    Source and target memory blocks can overlap.
+     */
+    template<typename T>
+    RT_FORCE_INLINE static
+        typename std::enable_if<IsTriviallyRelocatable<T>::value, void>::type
+        MoveArray(T* target, T* source, size_t numElements)
+    {
+        if (target != source && numElements > 0)
+        {
+            memmove(static_cast<void*>(target), static_cast<const void*>(source), numElements * sizeof(T));
+        }
+    }
+
     /**
      * Move an array of objects (will call move constructor or copy constructor if possible).
      * @note    Source and target memory blocks can overlap.
      */
     template<typename T>
-    static void MoveArray(T* target, T* source, size_t numElements)
+    static
+        typename std::enable_if<!IsTriviallyRelocatable<T>::value, void>::type
+        MoveArray(T* target, T* source, size_t numElements)
     {
         if (target == source || numElements == 0)
         {
@@ -0,0 +1,346 @@
+#include "PCH.h"
+#include "Numa.h"
+#include "Memory.h"
+#include "Logger.h"
+
+#if defined(WIN32)
+#include <Windows.h>
+#elif defined(__LINUX__) | defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <fstream>
+#include <string>
+#endif // defined(WIN32)
+
+namespace rt {
+
+namespace {
+
+struct NumaNode
+{
+    // logical processor indices (within processor group on Windows)
+    DynArray<uint32> processors;
+
+#if defined(WIN32)
+    GROUP_AFFINITY affinity;
+#endif // defined(WIN32)
+};
+
+struct NumaTopology
+{
+    DynArray<NumaNode> nodes;
+};
+
+bool gNumaReplicationEnabled = false;
+
+#if defined(__LINUX__) | defined(__linux__)
+
+// parse list in kernel format, e.g. "0-15,32-47"
+bool ParseIndexList(const std::string& str, DynArray<uint32>& outIndices)
+{
+    const char* ptr = str.c_str();
+    while (*ptr)
+    {
+        char* end = nullptr;
+        const uint32 first = static_cast<uint32>(strtoul(ptr, &end, 10));
+        if (end == ptr)
+        {
+            return false;
+        }
+        ptr = end;
+
+        uint32 last = first;
+        if (*ptr == '-')
+        {
+            ++ptr;
+            last = static_cast<uint32>(strtoul(ptr, &end, 10));
+            if (end == ptr || last < first)
+            {
+                return false;
+            }
+            ptr = end;
+        }
+
+        for (uint32 i = first; i <= last; ++i)
+        {
+            outIndices.PushBack(i);
+        }
+
+        if (*ptr == ',')
+        {
+            ++ptr;
+        }
+        else if (*ptr == '\n' || *ptr == 0)
+        {
+            break;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ReadIndexList(const std::string& filePath, DynArray<uint32>& outIndices)
+{
+    std::ifstream file(filePath);
+    std::string line;
+    if (!std::getline(file, line))
+    {
+        return false;
+    }
+
+    return ParseIndexList(line, outIndices);
+}
+
+void QueryTopology(NumaTopology& outTopology)
+{
+    DynArray<uint32> nodeIndices;
+    if (!ReadIndexList("/sys/devices/system/node/online", nodeIndices))
+    {
+        return;
+    }
+
+    for (const uint32 nodeIndex : nodeIndices)
+    {
+        NumaNode node;
+        if (!ReadIndexList("/sys/devices/system/node/node" + std::to_string(nodeIndex) + "/cpulist", node.processors))
+        {
+            continue;
+        }
+
+        // skip memory-only nodes
+        if (!node.processors.Empty())
+        {
+            outTopology.nodes.PushBack(std::move(node));
+        }
+    }
+}
+
+#elif defined(WIN32)
+
+void QueryTopology(NumaTopology& outTopology)
+{
+    ULONG highestNodeNumber = 0;
+    if (!::GetNumaHighestNodeNumber(&highestNodeNumber))
+    {
+        return;
+    }
+
+    for (USHORT nodeIndex = 0; nodeIndex <= highestNodeNumber; ++nodeIndex)
+    {
+        NumaNode node;
+        if (!::GetNumaNodeProcessorMaskEx(nodeIndex, &node.affinity) || node.affinity.Mask == 0)
+        {
+            continue;
+        }
+
+        for (uint32 i = 0; i < 64; ++i)
+        {
+            if (node.affinity.Mask & (KAFFINITY(1) << i))
+            {
+                node.processors.PushBack(i);
+            }
+        }
+
+        outTopology.nodes.PushBack(std::move(node));
+    }
+}
+
+#endif // defined(__LINUX__) | defined(__linux__)
+
+const NumaTopology& GetTopology()
+{
+    static const NumaTopology topology = []()
+    {
+        NumaTopology result;
+        QueryTopology(result);
+
+        if (result.nodes.Size() > MaxNumaNodes)
+        {
+            RT_LOG_WARNING("Found %u NUMA nodes, only first %u will be used", result.nodes.Size(), MaxNumaNodes);
+            result.nodes.Resize(MaxNumaNodes);
+        }
+
+        if (result.nodes.Size() > 1)
+        {
+            for (uint32 i = 0; i < result.nodes.Size(); ++i)
+            {
+                RT_LOG_INFO("NUMA node %u: %u logical processors", i, result.nodes[i].processors.Size());
+            }
+        }
+
+        return result;
+    }();
+
+    return topology;
+}
+
+} // namespace
+
+uint32 Numa::GetNumNodes()
+{
+    return std::max(1u, GetTopology().nodes.Size());
+}
+
+uint32 Numa::GetNumNodeProcessors(const uint32 node)
+{
+    const NumaTopology& topology = GetTopology();
+
+    if (topology.nodes.Empty())
+    {
+        RT_ASSERT(node == 0);
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    return topology.nodes[node].processors.Size();
+}
+
+bool Numa::PinCurrentThread(const uint32 node)
+{
+    const NumaTopology& topology = GetTopology();
+
+    if (node >= topology.nodes.Size())
+    {
+        return false;
+    }
+
+#if defined(__LINUX__) | defined(__linux__)
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (const uint32 processor : topology.nodes[node].processors)
+    {
+        if (processor < CPU_SETSIZE)
+        {
+            CPU_SET(processor, &cpuSet);
+        }
+    }
+
+    const int result = ::pthread_setaffinity_np(::pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (result != 0)
+    {
+        RT_LOG_ERROR("Failed to pin thread to NUMA node %u. Error code: %i", node, result);
+        return false;
+    }
+
+#elif defined(WIN32)
+
+    if (!::SetThreadGroupAffinity(::GetCurrentThread(), &topology.nodes[node].affinity, nullptr))
+    {
+        RT_LOG_ERROR("Failed to pin thread to NUMA node %u. Error code: %u", node, ::GetLastError());
+        return false;
+    }
+
+#endif // defined(__LINUX__) | defined(__linux__)
+
+    return true;
+}
+
+void Numa::SetReplicationEnabled(const bool enabled)
+{
+    gNumaReplicationEnabled = enabled;
+}
+
+bool Numa::IsReplicationEnabled()
+{
+    return gNumaReplicationEnabled;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+NumaReplicas::NumaReplicas(NumaReplicas&& other)
+{
+    for (uint32 i = 0; i < MaxNumaNodes; ++i)
+    {
+        mReplicas[i] = other.mReplicas[i];
+        other.mReplicas[i] = nullptr;
+    }
+}
+
+NumaReplicas& NumaReplicas::operator = (NumaReplicas&& other)
+{
+    if (this != &other)
+    {
+        Clear();
+
+        for (uint32 i = 0; i < MaxNumaNodes; ++i)
+        {
+            mReplicas[i] = other.mReplicas[i];
+            other.mReplicas[i] = nullptr;
+        }
+    }
+
+    return *this;
+}
+
+NumaReplicas::~NumaReplicas()
+{
+    Clear();
+}
+
+void NumaReplicas::Clear()
+{
+    for (void*& replica : mReplicas)
+    {
+        if (replica)
+        {
+            SystemAllocator::Free(replica);
+            replica = nullptr;
+        }
+    }
+}
+
+bool NumaReplicas::Create(const void* data, const size_t size)
+{
+    Clear();
+
+    const uint32 numNodes = Numa::GetNumNodes();
+    if (!gNumaReplicationEnabled || numNodes < 2 || size == 0)
+    {
+        return true;
+    }
+
+    // Memory pages are physically allocated on the node of a thread that touches them first,
+    // so each copy is made by a thread pinned to the target node.
+    DynArray<std::thread> threads;
+    threads.Reserve(numNodes);
+    for (uint32 i = 0; i < numNodes; ++i)
+    {
+        threads.EmplaceBack([this, data, size, i]()
+        {
+            if (Numa::PinCurrentThread(i))
+            {
+                void* replica = SystemAllocator::Allocate(size, RT_CACHE_LINE_SIZE);
+                if (replica)
+                {
+                    memcpy(replica, data, size);
+                    mReplicas[i] = replica;
+                }
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (uint32 i = 0; i < numNodes; ++i)
+    {
+        if (!mReplicas[i])
+        {
+            RT_LOG_ERROR("Failed to replicate data on NUMA node %u", i);
+            Clear();
+            return false;
+        }
+    }
+
+    RT_LOG_DEBUG("Replicated %.2f KB of data on %u NUMA nodes", size / 1024.0, numNodes);
+
+    return true;
+}
+
+} // namespace rt
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../RayLib.h"
+#include "../Containers/DynArray.h"
+
+namespace rt {
+
+// Maximum number of NUMA nodes that are taken into account (remaining nodes are ignored)
+static constexpr uint32 MaxNumaNodes = 8;
+
+/**
+ * Non-uniform memory access helpers.
+ * Nodes are numbered from 0 to GetNumNodes()-1, nodes without processors are skipped.
+ */
+class Numa
+{
+public:
+    // Number of NUMA nodes with processors (1 on single-socket machines or if the topology can't be queried)
+    RAYLIB_API static uint32 GetNumNodes();
+
+    // Number of logical processors belonging to a node
+    RAYLIB_API static uint32 GetNumNodeProcessors(const uint32 node);
+
+    // Restrict calling thread to processors of a given node
+    RAYLIB_API static bool PinCurrentThread(const uint32 node);
+
+    // Enable per-node copies of read-only acceleration data (see NumaReplicas)
+    RAYLIB_API static void SetReplicationEnabled(const bool enabled);
+    RAYLIB_API static bool IsReplicationEnabled();
+};
+
+/**
+ * Copies of read-only data placed in memory local to each NUMA node.
+ * Threads pinned to a node should read their node's copy instead of the original data,
+ * which lives on whichever node touched it first.
+ */
+class NumaReplicas : public NoCopyable
+{
+public:
+    NumaReplicas() = default;
+    RAYLIB_API NumaReplicas(NumaReplicas&& other);
+    RAYLIB_API NumaReplicas& operator = (NumaReplicas&& other);
+    RAYLIB_API ~NumaReplicas();
+
+    // Copy data to every node
+    // Does nothing if replication is disabled or there's only one node
+    RAYLIB_API bool Create(const void* data, const size_t size);
+
+    RAYLIB_API void Clear();
+
+    // Get node's copy of the data or null if there is none
+    RT_FORCE_INLINE const void* Get(const uint32 node) const
+    {
+        return mReplicas[node];
+    }
+
+private:
+    void* mReplicas[MaxNumaNodes] = {};
+};
+
+} // namespace rt
@@ -1,5 +1,6 @@
 #include "PCH.h"
 #include "ThreadPool.h"
+#include "Numa.h"
 
 
 namespace rt {
@@ -9,6 +10,7 @@ ThreadPool::ThreadPool()
     , mCurrentTask(0)
     , mTasksLeft(0)
     , mFinishThreads(true)
+    , mPinToNumaNodes(false)
 {
     StartWorkerThreads(std::thread::hardware_concurrency());
 }
@@ -30,6 +32,43 @@ void ThreadPool::StartWorkerThreads(uint32 num)
     RT_ASSERT(mFinishThreads == true);
     mFinishThreads = false;
 
+    const uint32 numNodes = mPinToNumaNodes ? Numa::GetNumNodes() : 1;
+
+    mThreadNumaNodes.Resize(num);
+    if (numNodes > 1)
+    {
+        uint32 numProcessors = 0;
+        for (uint32 node = 0; node < numNodes; ++node)
+        {
+            numProcessors += Numa::GetNumNodeProcessors(node);
+        }
+
+        // map threads evenly onto all the processors and pick the node owning the processor
+        for (uint32 i = 0; i < num; ++i)
+        {
+            const uint32 processorIndex = static_cast<uint32>(static_cast<uint64>(i) * numProcessors / num);
+
+            uint32 node = 0;
+            for (uint32 firstProcessor = 0; node + 1 < numNodes; ++node)
+            {
+                firstProcessor += Numa::GetNumNodeProcessors(node);
+                if (processorIndex < firstProcessor)
+                {
+                    break;
+                }
+            }
+
+            mThreadNumaNodes[i] = node;
+        }
+    }
+    else
+    {
+        for (uint32& node : mThreadNumaNodes)
+        {
+            node = 0;
+        }
+    }
+
     for (uint32 i = 0; i < num; ++i)
     {
         mThreads.EmplaceBack(&ThreadPool::ThreadCallback, this, i);
@@ -56,6 +95,11 @@ void ThreadPool::StopWorkerThreads()
 
 void ThreadPool::ThreadCallback(uint32 threadID)
 {
+    if (mPinToNumaNodes && Numa::GetNumNodes() > 1)
+    {
+        Numa::PinCurrentThread(mThreadNumaNodes[threadID]);
+    }
+
     for (;;)
     {
         uint32 taskID;
@@ -90,11 +134,17 @@ void ThreadPool::ThreadCallback(uint32 threadID)
     }
 }
 
-void ThreadPool::SetNumThreads(const uint32 numThreads)
+void ThreadPool::SetNumThreads(uint32 numThreads, const bool pinToNumaNodes)
 {
-    if (numThreads != GetNumThreads())
+    if (numThreads == 0)
+    {
+        numThreads = std::thread::hardware_concurrency();
+    }
+
+    if (numThreads != GetNumThreads() || pinToNumaNodes != mPinToNumaNodes)
     {
         StopWorkerThreads();
+        mPinToNumaNodes = pinToNumaNodes;
         StartWorkerThreads(numThreads);
     }
 }
@@ -25,7 +25,9 @@ public:
     ThreadPool();
     ~ThreadPool();
 
-    void SetNumThreads(const uint32 numThreads);
+    // Zero means one thread per logical processor.
+    // Optionally, worker threads can be pinned to NUMA nodes (spread proportionally to nodes' processor counts)
+    void SetNumThreads(uint32 numThreads, const bool pinToNumaNodes = false);
 
     void RunParallelTask(const ParallelTask& task, uint32 num);
 
@@ -34,6 +36,12 @@ public:
         return mThreads.Size();
     }
 
+    // NUMA node a worker thread is pinned to (always 0 if pinning is disabled)
+    RT_FORCE_INLINE uint32 GetThreadNumaNode(const uint32 threadID) const
+    {
+        return mThreadNumaNodes[threadID];
+    }
+
 private:
 
     void StartWorkerThreads(uint32 num);
@@ -42,6 +50,7 @@ private:
     using Lock = std::unique_lock<std::mutex>;
 
     DynArray<std::thread> mThreads;
+    DynArray<uint32> mThreadNumaNodes;
     std::condition_variable mNewTaskCV;
     std::condition_variable mTileFinishedCV;
     std::mutex mMutex;
@@ -53,6 +62,7 @@ private:
     std::atomic<uint32> mTasksLeft;
 
     bool mFinishThreads;
+    bool mPinToNumaNodes;
 
     void ThreadCallback(uint32 id);
 };
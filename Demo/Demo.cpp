@@ -67,6 +67,8 @@ bool DemoWindow::Initialize()
     mRendererName = gOptions.rendererName;
     mRenderingParams.numThreads = std::thread::hardware_concurrency();
     mRenderingParams.traversalMode = gOptions.enablePacketTracing ? TraversalMode::Packet : TraversalMode::Single;
+    mRenderingParams.pinThreadsToNumaNodes = gOptions.enableNuma;
+    mRenderingParams.resolutionCascadeLevels = 2; // 1/16, 1/4, then all pixels after camera movement
 
     mViewport = std::make_unique<Viewport>();
     mViewport->Resize(gOptions.windowWidth, gOptions.windowHeight);
@@ -79,6 +81,11 @@ bool DemoWindow::Initialize()
     initData.useDefaultAllocator = true; // for some reason displaying a bitmap that uses large page fails
     mImage.Init(initData);
 
+    if (InitPresentBuffers())
+    {
+        InitPresentImages();
+    }
+
     mCamera.mDOF.aperture = 0.0f;
 
     SwitchScene(gOptions.sceneName);
@@ -86,6 +93,82 @@ bool DemoWindow::Initialize()
     return true;
 }
 
+void DemoWindow::InitPresentImages()
+{
+    mPresentImages.clear();
+
+    const uint32 numPresentBuffers = GetNumPresentBuffers();
+    if (numPresentBuffers == 0)
+    {
+        mViewport->SetFrontBufferTargets(nullptr, 0);
+        return;
+    }
+
+    std::vector<Bitmap*> targets;
+    mPresentImages.reserve(numPresentBuffers);
+
+    for (uint32 i = 0; i < numPresentBuffers; ++i)
+    {
+        Bitmap::InitData initData;
+        initData.linearSpace = false;
+        initData.width = mViewport->GetWidth();
+        initData.height = mViewport->GetHeight();
+        initData.format = Bitmap::Format::B8G8R8A8_UNorm;
+        initData.data = GetPresentBufferData(i);
+        initData.wrapData = true;
+
+        mPresentImages.emplace_back("PresentImage");
+        if (!mPresentImages.back().Init(initData))
+        {
+            mPresentImages.clear();
+            return;
+        }
+        targets.push_back(&mPresentImages.back());
+    }
+
+    if (!mViewport->SetFrontBufferTargets(targets.data(), numPresentBuffers))
+    {
+        RT_LOG_WARNING("Failed to set viewport front buffer targets, falling back to image upload");
+        mPresentImages.clear();
+    }
+}
+
+void DemoWindow::InvalidateUIRegions()
+{
+    const ImDrawData* drawData = ImGui::GetDrawData();
+    if (!drawData)
+    {
+        return;
+    }
+
+    for (int i = 0; i < drawData->CmdListsCount; ++i)
+    {
+        const ImDrawList* drawList = drawData->CmdLists[i];
+        if (drawList->CmdBuffer.Size == 0)
+        {
+            continue;
+        }
+
+        // bounding box of the whole UI window
+        ImVec4 bounds(FLT_MAX, FLT_MAX, 0.0f, 0.0f);
+        for (const ImDrawCmd& cmd : drawList->CmdBuffer)
+        {
+            bounds.x = Min(bounds.x, cmd.ClipRect.x);
+            bounds.y = Min(bounds.y, cmd.ClipRect.y);
+            bounds.z = Max(bounds.z, cmd.ClipRect.z);
+            bounds.w = Max(bounds.w, cmd.ClipRect.w);
+        }
+
+        const math::Rectangle<uint32> region(
+            static_cast<uint32>(Max(0.0f, floorf(bounds.x))),
+            static_cast<uint32>(Max(0.0f, ceilf(bounds.z))),
+            static_cast<uint32>(Max(0.0f, floorf(bounds.y))),
+            static_cast<uint32>(Max(0.0f, ceilf(bounds.w))));
+
+        mViewport->InvalidateFrontBufferTarget(region);
+    }
+}
+
 void DemoWindow::InitializeUI()
 {
     ImGui::CreateContext();
@@ -140,11 +223,12 @@ void DemoWindow::CheckSceneFileModificationTime()
 {
     if (!mSceneFileName.empty())
     {
-        // read modification time
-        struct stat fileStat;
-        if (stat(mSceneFileName.c_str(), &fileStat) == 0)
+        const time_t modificationTime = helpers::GetFileModificationTime(mSceneFileName);
+        if (modificationTime != 0 && mSceneFileModificationTime != modificationTime)
         {
-            if (mSceneFileModificationTime != fileStat.st_mtime)
+            mSceneFileModificationTime = modificationTime;
+
+            if (!UpdateScene())
             {
                 RT_LOG_INFO("Scene file '%s' modified, reloading", mSceneFileName.c_str());
                 SwitchScene(mSceneFileName);
@@ -153,34 +237,61 @@ void DemoWindow::CheckSceneFileModificationTime()
     }
 }
 
+bool DemoWindow::UpdateScene()
+{
+    if (!mLoadedScene)
+    {
+        return false;
+    }
+
+    bool cameraChanged = false;
+    if (!helpers::UpdateScene(mSceneFileName, *mScene, mCamera, *mLoadedScene, cameraChanged))
+    {
+        return false;
+    }
+
+    if (cameraChanged)
+    {
+        mCameraSetup.position = mCamera.mTransform.GetTranslation();
+        mCameraSetup.orientation = mCamera.mTransform.GetRotation().ToEulerAngles();
+        mCameraSetup.fov = RadToDeg(mCamera.mFieldOfView);
+    }
+
+    // light objects may have been recreated
+    mSelectedLight = nullptr;
+
+    ResetFrame();
+    return true;
+}
+
 void DemoWindow::SwitchScene(const std::string& sceneName)
 {
     mScene = std::make_unique<Scene>();
+    mLoadedScene = std::make_unique<helpers::LoadedScene>();
 
     if (!sceneName.empty())
     {
-        if (helpers::LoadScene(sceneName, *mScene, mCamera))
+        if (helpers::LoadScene(sceneName, *mScene, mCamera, mLoadedScene.get()))
         {
             mSceneFileName = sceneName;
-
-            // read modification time
-            struct stat fileStat;
-            if (stat(sceneName.c_str(), &fileStat) == 0)
-            {
-                mSceneFileModificationTime = fileStat.st_mtime;
-            }
+            mSceneFileModificationTime = helpers::GetFileModificationTime(sceneName);
         }
         else
         {
             mSceneFileName.clear();
+            mLoadedScene.reset();
         }
     }
     else
     {
         helpers::LoadCustomScene(*mScene, mCamera);
         mSceneFileName.clear();
+        mLoadedScene.reset();
     }
 
+    // meshes of the previous scene are no longer needed
+    helpers::ReleaseUnusedMeshes();
+
     mCameraSetup.position = mCamera.mTransform.GetTranslation();
     mCameraSetup.orientation = mCamera.mTransform.GetRotation().ToEulerAngles();
     mCameraSetup.fov = RadToDeg(mCamera.mFieldOfView);
@@ -230,6 +341,9 @@ void DemoWindow::OnResize(uint32 width, uint32 height)
         initData.format = Bitmap::Format::B8G8R8A8_UNorm;
         initData.useDefaultAllocator = true; // for some reason displaying a bitmap that uses large page fails
         mImage.Init(initData);
+
+        // presentation images were recreated by the window
+        InitPresentImages();
     }
 
     UpdateCamera();
@@ -297,7 +411,7 @@ void DemoWindow::OnMouseDown(MouseButton button, int x, int y)
 
         if (hitPoint.objectId != UINT32_MAX)
         {
-            if (hitPoint.subObjectId == RT_LIGHT_OBJECT)
+            if (IsLightSubObject(hitPoint.subObjectId))
             {
                 mSelectedMaterial = nullptr;
                 mSelectedObject = nullptr;
@@ -404,7 +518,7 @@ bool DemoWindow::Loop()
 
         mDeltaTime = displayTimer.Reset();
 
-        UpdateCamera();
+        bool cameraMoved = UpdateCamera();
 
         bool resetFrame = false;
 
@@ -412,7 +526,7 @@ bool DemoWindow::Loop()
         {
             mPreviewRenderingParams = mRenderingParams;
             mPreviewRenderingParams.antiAliasingSpread = 0.0f;
-            resetFrame |= true;
+            cameraMoved = true;
         }
 
         if (mEnableUI)
@@ -426,31 +540,65 @@ bool DemoWindow::Loop()
         {
             ResetFrame();
         }
+        else if (cameraMoved)
+        {
+            // keeps samples which are still valid in the new view (if enabled)
+            mViewport->Reproject(mCamera);
+            ResetCounters();
+        }
 
         //// render
         localTimer.Start();
         // display pixels in the window
-        mViewport->Render(mCamera);
+        const bool rendered = mViewport->Render(mCamera);
         mRenderDeltaTime = localTimer.Stop();
 
+        if (!mPresentImages.empty())
         {
-            RT_SCOPED_TIMER(CopyFrontBuffer);
-            rt::Bitmap::Copy(mImage, mViewport->GetFrontBuffer());
+            // the viewport has post-processed directly into the presentation image
+            // NOTE: the image must not be touched if it was not written, as it may be still read by the window system
+            if (rendered)
+            {
+                const uint32 imageIndex = mViewport->GetFrontBufferTargetIndex();
+                Bitmap& image = mPresentImages[imageIndex];
+
+                if (mVisualizeAdaptiveRenderingBlocks)
+                {
+                    mViewport->VisualizeActiveBlocks(image);
+                    mViewport->InvalidateFrontBufferTarget(math::Rectangle<uint32>(0, image.GetWidth(), 0, image.GetHeight()));
+                }
+
+                // render UI into the presentation image, covered pixels will be restored when the image is written next time
+                if (mEnableUI)
+                {
+                    imgui_sw::paint_imgui((uint32_t*)image.GetData(), image.GetWidth(), image.GetHeight());
+                    InvalidateUIRegions();
+                }
+
+                Present(imageIndex);
+            }
         }
-
-        if (mVisualizeAdaptiveRenderingBlocks)
+        else
         {
-            mViewport->VisualizeActiveBlocks(mImage);
-        }
+            {
+                RT_SCOPED_TIMER(CopyFrontBuffer);
+                rt::Bitmap::Copy(mImage, mViewport->GetFrontBuffer());
+            }
 
-        // render UI into the front buffer
-        if (mEnableUI)
-        {
-            imgui_sw::paint_imgui((uint32_t*)mImage.GetData(), mImage.GetWidth(), mImage.GetHeight());
-        }
+            if (mVisualizeAdaptiveRenderingBlocks)
+            {
+                mViewport->VisualizeActiveBlocks(mImage);
+            }
 
-        // display pixels in the window
-        DrawPixels(mImage);
+            // render UI into the front buffer
+            if (mEnableUI)
+            {
+                imgui_sw::paint_imgui((uint32_t*)mImage.GetData(), mImage.GetWidth(), mImage.GetHeight());
+            }
+
+            // display pixels in the window
+            DrawPixels(mImage);
+        }
 
         mLastKeyDown = KeyCode::Invalid;
 
@@ -474,7 +622,7 @@ bool DemoWindow::IsPreview() const
     return IsMouseButtonDown(MouseButton::Right);
 }
 
-void DemoWindow::UpdateCamera()
+bool DemoWindow::UpdateCamera()
 {
     uint32 width, height;
     GetSize(width, height);
@@ -504,10 +652,9 @@ void DemoWindow::UpdateCamera()
     // TODO
     //mCamera.mLinearVelocity = mCameraSetup.linearVelocity;
 
-    if (movement.Length3() > RT_EPSILON)
+    const bool moved = movement.Length3() > RT_EPSILON;
+    if (moved)
     {
-        ResetFrame();
-
         movement.Normalize3();
         movement *= mCameraSpeed;
 
@@ -541,4 +688,6 @@ void DemoWindow::UpdateCamera()
     {
         mCamera.SetAngularVelocity(Quaternion::FromEulerAngles(mCameraSetup.angularVelocity));
     }
+
+    return moved;
 }
\ No newline at end of file
@@ -9,6 +9,10 @@
 #include "../Core/Rendering/Context.h"
 #include "../Core/Rendering/PathDebugging.h"
 
+namespace helpers {
+struct LoadedScene;
+} // namespace helpers
+
 struct Options
 {
     uint32 windowWidth = 1280;
@@ -18,6 +22,7 @@ struct Options
     uint32 numThreads = 0;
 
     bool enablePacketTracing = false;
+    bool enableNuma = false;
     std::string rendererName = "Path Tracer";
 
     std::string sceneName;
@@ -52,6 +57,9 @@ private:
     std::unique_ptr<rt::Viewport> mViewport;
     rt::Bitmap mImage;
 
+    // window-owned presentation images the viewport post-processes into directly (empty if not supported)
+    std::vector<rt::Bitmap> mPresentImages;
+
     KeyCode mLastKeyDown;
 
     rt::Camera mCamera;
@@ -77,6 +85,7 @@ private:
 
     std::string mSceneFileName;
     time_t mSceneFileModificationTime;
+    std::unique_ptr<helpers::LoadedScene> mLoadedScene;
 
     std::string mRendererName;
     rt::RendererPtr mRenderer;
@@ -94,9 +103,18 @@ private:
 
     void InitializeUI();
 
+    // wrap window's presentation images and register them as viewport's front buffer targets
+    void InitPresentImages();
+
+    // notify the viewport which parts of the front buffer target were covered by the UI
+    void InvalidateUIRegions();
+
     void CheckSceneFileModificationTime();
     void SwitchScene(const std::string& sceneName);
 
+    // apply scene file changes to the current scene without full reload, returns false if not possible
+    bool UpdateScene();
+
     bool RenderUI();
     void RenderUI_Stats();
     void RenderUI_Profiler();
@@ -127,7 +145,8 @@ private:
 
     bool IsPreview() const;
     void ResetCounters();
-    void UpdateCamera();
+    // returns true if the camera was moved with keyboard
+    bool UpdateCamera();
 };
 
 extern Options gOptions;
\ No newline at end of file
@@ -293,9 +293,7 @@ void DemoWindow::RenderUI_Debugging_Color()
     Vector4 hdrColor, ldrColor;
     if (x >= 0 && y >= 0 && (uint32)x < width && (uint32)y < height)
     {
-        // TODO this is incorrect, each pixel can have different number of samples
-        const uint32 numSamples = mViewport->GetProgress().passesFinished;
-        hdrColor = mViewport->GetSumBuffer().GetPixel(x, y, true) / static_cast<float>(numSamples);
+        hdrColor = mViewport->GetPixelAverage(x, y);
         ldrColor = mViewport->GetFrontBuffer().GetPixel(x, y, true);
     }
 
@@ -408,6 +406,7 @@ bool DemoWindow::RenderUI_Settings_Rendering()
     {
         uint32 maxThreads = std::thread::hardware_concurrency();
         ImGui::SliderInt("Threads", (int*)&mRenderingParams.numThreads, 1, 2 * maxThreads);
+        ImGui::Checkbox("Pin threads to NUMA nodes", &mRenderingParams.pinThreadsToNumaNodes);
     }
 
     // renderer selection
@@ -475,6 +474,8 @@ bool DemoWindow::RenderUI_Settings_Rendering()
         ImGui::SameLine();
         resetFrame |= ImGui::Checkbox("Vertex merging", &renderer->mUseVertexMerging);
         resetFrame |= ImGui::SliderInt("Max path length", (int32*)&renderer->mMaxPathLength, 1, 20);
+        resetFrame |= ImGui::SliderInt("Vertex connections", (int32*)&renderer->mNumVertexConnections, 1, 16);
+        resetFrame |= ImGui::SliderFloat("Light paths per pixel", &renderer->mLightPathsPerPixel, 0.05f, 4.0f, "%.2f", 2.0f);
         resetFrame |= ImGui::SliderFloat("Initial merging radius", &renderer->mInitialMergingRadius, renderer->mMinMergingRadius, 10.0f, "%.4f", 10.0f);
         resetFrame |= ImGui::SliderFloat("Min merging radius", &renderer->mMinMergingRadius, 0.0001f, renderer->mInitialMergingRadius, "%.4f", 10.0f);
         resetFrame |= ImGui::SliderFloat("Merging radius multiplier", &renderer->mMergingRadiusMultiplier, 0.5f, 0.9999f);
@@ -507,6 +508,13 @@ bool DemoWindow::RenderUI_Settings_Rendering()
     resetFrame |= ImGui::SliderInt("Russian roulette depth", (int*)&mRenderingParams.minRussianRouletteDepth, 1, 64);
     resetFrame |= ImGui::SliderFloat("Antialiasing spread", &mRenderingParams.antiAliasingSpread, 0.0f, 3.0f);
     resetFrame |= ImGui::SliderFloat("Motion blur strength", &mRenderingParams.motionBlurStrength, 0.0f, 1.0f);
+    resetFrame |= ImGui::SliderInt("Resolution cascade levels", (int*)&mRenderingParams.resolutionCascadeLevels, 0, 4);
+    resetFrame |= ImGui::Checkbox("Temporal reprojection", &mRenderingParams.reprojectionSettings.enable);
+    if (mRenderingParams.reprojectionSettings.enable)
+    {
+        ImGui::SliderInt("Max reprojected passes", (int*)&mRenderingParams.reprojectionSettings.maxHistoryPasses, 2, 256);
+        ImGui::SliderFloat("Reprojection depth tolerance", &mRenderingParams.reprojectionSettings.depthTolerance, 0.001f, 0.1f, "%.3f", 2.0f);
+    }
 
     mRenderingParams.traversalMode = static_cast<TraversalMode>(traversalModeIndex);
     mRenderingParams.lightSamplingStrategy = static_cast<LightSamplingStrategy>(lightSamplingStrategyIndex);
@@ -4,6 +4,9 @@
 #include "../Core/Utils/Logger.h"
 #include "../Core/Utils/Bitmap.h"
 
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
 namespace {
 
 const char* TranslateErrorCodeToStr(int err)
@@ -43,6 +46,7 @@ Window::Window()
     , mDeleteReply(nullptr)
     , mConnScreen(0)
     , mGraphicsContext(0u)
+    , mUsePresentBuffers(false)
     , mClosed(true)
     , mInvisible(false)
     , mWidth(400)
@@ -65,6 +69,7 @@ Window::~Window()
 
     if (mConnection)
     {
+        ReleasePresentBuffers();
         xcb_set_screen_saver(mConnection, -1, 0, XCB_BLANKING_NOT_PREFERRED, XCB_EXPOSURES_ALLOWED);
         xcb_destroy_window(mConnection, mWindow);
         xcb_flush(mConnection);
@@ -341,6 +346,12 @@ void Window::ProcessMessages()
                 {
                     mWidth = cn->width;
                     mHeight = cn->height;
+
+                    if (mUsePresentBuffers)
+                    {
+                        mUsePresentBuffers = CreatePresentBuffers();
+                    }
+
                     OnResize(mWidth, mHeight);
                 }
                 break;
@@ -379,6 +390,143 @@ bool Window::DrawPixels(const rt::Bitmap& bitmap)
     return true;
 }
 
+bool Window::InitPresentBuffers()
+{
+    const xcb_query_extension_reply_t* extension = xcb_get_extension_data(mConnection, &xcb_shm_id);
+    if (!extension || !extension->present)
+    {
+        RT_LOG_WARNING("MIT-SHM extension is not available, falling back to image upload");
+        return false;
+    }
+
+    mUsePresentBuffers = CreatePresentBuffers();
+    return mUsePresentBuffers;
+}
+
+bool Window::CreatePresentBuffers()
+{
+    ReleasePresentBuffers();
+
+    const size_t dataSize = 4u * (size_t)mWidth * (size_t)mHeight;
+    if (dataSize == 0)
+    {
+        return false;
+    }
+
+    for (ShmImage& image : mPresentBuffers)
+    {
+        const int shmId = shmget(IPC_PRIVATE, dataSize, IPC_CREAT | 0600);
+        if (shmId < 0)
+        {
+            RT_LOG_ERROR("Failed to create shared memory segment (%zu bytes)", dataSize);
+            ReleasePresentBuffers();
+            return false;
+        }
+
+        void* data = shmat(shmId, nullptr, 0);
+        if (data == reinterpret_cast<void*>(-1))
+        {
+            RT_LOG_ERROR("Failed to attach shared memory segment");
+            shmctl(shmId, IPC_RMID, nullptr);
+            ReleasePresentBuffers();
+            return false;
+        }
+        image.data = static_cast<uint8*>(data);
+
+        const xcb_shm_seg_t segment = xcb_generate_id(mConnection);
+        xcb_void_cookie_t cookie = xcb_shm_attach_checked(mConnection, segment, shmId, 0);
+        xcb_generic_error_t* err = xcb_request_check(mConnection, cookie);
+
+        // the segment is destroyed once both sides detach from it
+        shmctl(shmId, IPC_RMID, nullptr);
+
+        if (err)
+        {
+            // e.g. remote X server
+            RT_LOG_WARNING("Failed to attach shared memory segment to X server (X11 protocol error: %s), falling back to image upload", TranslateErrorCodeToStr(err->error_code));
+            free(err);
+            ReleasePresentBuffers();
+            return false;
+        }
+        image.segment = segment;
+    }
+
+    return true;
+}
+
+void Window::ReleasePresentBuffers()
+{
+    for (ShmImage& image : mPresentBuffers)
+    {
+        if (image.pending)
+        {
+            // nobody is going to check the result anymore
+            xcb_discard_reply(mConnection, image.putCookie.sequence);
+            image.pending = false;
+        }
+
+        if (image.segment)
+        {
+            // requests are processed in order, so pending put requests are completed before detaching
+            xcb_shm_detach(mConnection, image.segment);
+            image.segment = 0;
+        }
+
+        if (image.data)
+        {
+            shmdt(image.data);
+            image.data = nullptr;
+        }
+    }
+}
+
+uint32 Window::GetNumPresentBuffers() const
+{
+    return mUsePresentBuffers ? NumPresentBuffers : 0;
+}
+
+uint8* Window::GetPresentBufferData(uint32 index) const
+{
+    RT_ASSERT(index < GetNumPresentBuffers());
+    return mPresentBuffers[index].data;
+}
+
+bool Window::Present(uint32 index)
+{
+    RT_ASSERT(index < GetNumPresentBuffers());
+
+    ShmImage& image = mPresentBuffers[index];
+    image.putCookie = xcb_shm_put_image_checked(mConnection, mWindow, mGraphicsContext,
+                                                static_cast<uint16_t>(mWidth), static_cast<uint16_t>(mHeight),
+                                                0, 0, static_cast<uint16_t>(mWidth), static_cast<uint16_t>(mHeight), 0, 0,
+                                                mScreen->root_depth, XCB_IMAGE_FORMAT_Z_PIXMAP, 0, image.segment, 0);
+    image.pending = true;
+    xcb_flush(mConnection);
+
+    // X server reads the shared memory while processing put request, so make sure it's done with the other images
+    // (they were presented earlier, so usually no waiting is involved)
+    bool success = true;
+    for (uint32 i = 0; i < NumPresentBuffers; ++i)
+    {
+        ShmImage& otherImage = mPresentBuffers[i];
+        if (i == index || !otherImage.pending)
+        {
+            continue;
+        }
+
+        xcb_generic_error_t* err = xcb_request_check(mConnection, otherImage.putCookie);
+        otherImage.pending = false;
+        if (err)
+        {
+            RT_LOG_ERROR("Failed to put image on window: X11 protocol error: %s", TranslateErrorCodeToStr(err->error_code));
+            free(err);
+            success = false;
+        }
+    }
+
+    return success;
+}
+
 void Window::LostFocus()
 {
     MouseUp(MouseButton::Left);
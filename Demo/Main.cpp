@@ -12,6 +12,7 @@ bool ParseOptions(int argc, char** argv, Options& outOptions)
         ("s,scene", "Initial scene", cxxopts::value<std::string>())
         ("renderer", "Renderer name", cxxopts::value<std::string>())
         ("p,packet-tracing", "Use ray packet tracing by default", cxxopts::value<bool>())
+        ("numa", "Pin render threads to NUMA nodes and replicate scene data on each node", cxxopts::value<bool>())
         ("data", "Data path", cxxopts::value<std::string>())
         ;
 
@@ -35,6 +36,7 @@ bool ParseOptions(int argc, char** argv, Options& outOptions)
             outOptions.rendererName = result["renderer"].as<std::string>();
 
         outOptions.enablePacketTracing = result["p"].count() > 0;
+        outOptions.enableNuma = result["numa"].count() > 0;
     }
     catch (cxxopts::OptionParseException& e)
     {
@@ -50,13 +52,16 @@ Options gOptions;
 int main(int argc, char* argv[])
 {
     rt::math::SetFlushDenormalsToZero();
-    rt::InitMemory();
 
     if (!ParseOptions(argc, argv, gOptions))
     {
         return 1;
     }
 
+    rt::MemoryInitOptions memoryOptions;
+    memoryOptions.replicateOnNumaNodes = gOptions.enableNuma;
+    rt::InitMemory(memoryOptions);
+
     {
         DemoWindow demo;
 
@@ -7,6 +7,8 @@
 #include "../Core/Math/Geometry.h"
 #include "../Core/Textures/BitmapTexture.h"
 
+#include <fstream>
+
 namespace helpers {
 
 using namespace rt;
@@ -28,33 +30,59 @@ struct TriangleIndicesHash
     }
 };
 
-BitmapPtr LoadBitmapObject(const std::string& baseDir, const std::string& path)
+time_t GetFileModificationTime(const std::string& path)
 {
-    if (path.empty())
+    struct stat fileStat;
+    if (stat(path.c_str(), &fileStat) != 0)
     {
-        return nullptr;
+        return 0;
     }
 
+    return fileStat.st_mtime;
+}
+
+std::string GetBitmapFilePath(const std::string& baseDir, const std::string& path)
+{
     std::string fullPath = baseDir + path;
     if ((fullPath.rfind(".png") == fullPath.length() - 4) || (fullPath.rfind(".jpg") == fullPath.length() - 4))
     {
         fullPath.replace(fullPath.length() - 4, 4, ".bmp");
     }
+    return fullPath;
+}
+
+BitmapPtr LoadBitmapObject(const std::string& baseDir, const std::string& path)
+{
+    if (path.empty())
+    {
+        return nullptr;
+    }
+
+    const std::string fullPath = GetBitmapFilePath(baseDir, path);
+
+    struct CachedBitmap
+    {
+        BitmapPtr bitmap;
+        time_t modificationTime = 0;
+    };
 
-    // cache bitmaps so they are loaded only once
-    static std::map<std::string, BitmapPtr> bitmapsList;
-    BitmapPtr& bitmapPtr = bitmapsList[fullPath];
+    // cache bitmaps so they are loaded only once (unless modified)
+    static std::map<std::string, CachedBitmap> bitmapsList;
+    CachedBitmap& cachedBitmap = bitmapsList[fullPath];
 
-    if (!bitmapPtr)
+    const time_t modificationTime = GetFileModificationTime(fullPath);
+    if (!cachedBitmap.bitmap || cachedBitmap.modificationTime != modificationTime)
     {
-        bitmapPtr = BitmapPtr(new Bitmap(path.c_str()));
-        if (!bitmapPtr->Load(fullPath.c_str()))
+        cachedBitmap.bitmap = BitmapPtr(new Bitmap(path.c_str()));
+        cachedBitmap.modificationTime = modificationTime;
+        if (!cachedBitmap.bitmap->Load(fullPath.c_str()))
         {
+            cachedBitmap.bitmap = nullptr;
             return nullptr;
         }
     }
 
-    return bitmapPtr;
+    return cachedBitmap.bitmap;
 }
 
 TexturePtr LoadTexture(const std::string& baseDir, const std::string& path)
@@ -107,6 +135,29 @@ MaterialPtr CreateDefaultMaterial(MaterialsMap& outMaterials)
     return material;
 }
 
+// records paths of all the material files requested by the mesh file
+class TrackingMaterialFileReader : public tinyobj::MaterialFileReader
+{
+public:
+    TrackingMaterialFileReader(const std::string& baseDir, std::vector<std::string>& outFilePaths)
+        : tinyobj::MaterialFileReader(baseDir)
+        , mBaseDir(baseDir)
+        , mFilePaths(outFilePaths)
+    {
+    }
+
+    virtual bool operator()(const std::string& matId, std::vector<tinyobj::material_t>* materials,
+                            std::map<std::string, int>* matMap, std::string* warn, std::string* err) override
+    {
+        mFilePaths.push_back(mBaseDir + matId);
+        return tinyobj::MaterialFileReader::operator()(matId, materials, matMap, warn, err);
+    }
+
+private:
+    std::string mBaseDir;
+    std::vector<std::string>& mFilePaths;
+};
+
 class MeshLoader
 {
 public:
@@ -130,7 +181,16 @@ public:
         {
             Timer timer;
             std::string warning, err;
-            bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &warning, &err, filePath.c_str(), meshBaseDir.c_str(), true, false);
+
+            std::ifstream fileStream(filePath);
+            if (!fileStream)
+            {
+                RT_LOG_ERROR("Failed to open mesh file '%s'", filePath.c_str());
+                return false;
+            }
+
+            TrackingMaterialFileReader materialReader(meshBaseDir, mDependencies);
+            bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &warning, &err, &fileStream, &materialReader, true, false);
             if (!warning.empty())
             {
                 RT_LOG_WARNING("Mesh '%s' loading message:\n%s", filePath.c_str(), err.c_str());
@@ -261,6 +321,10 @@ public:
             auto material = LoadMaterial(meshBaseDir, materials[i]);
             mMaterialPointers.push_back(material);
             outMaterials[material->debugName] = material;
+
+            AddTextureDependency(meshBaseDir, materials[i].diffuse_texname);
+            AddTextureDependency(meshBaseDir, materials[i].normal_texname);
+            AddTextureDependency(meshBaseDir, materials[i].alpha_texname);
         }
 
         // fallback to default material
@@ -376,16 +440,101 @@ public:
         }
     }
 
+    // move triangles with constant emission materials to separate meshes
+    bool ExtractEmissiveMeshes(std::vector<EmissiveMesh>& outEmissiveMeshes)
+    {
+        for (uint32 materialIndex = 0; materialIndex < mMaterialPointers.size(); ++materialIndex)
+        {
+            const Material& material = *mMaterialPointers[materialIndex];
+            if (material.emission.baseValue.HorizontalMax().x <= 0.0f)
+            {
+                continue;
+            }
+
+            // NOTE: MeshLight only supports constant emission color, so textured emissive surfaces stay regular geometry
+            // (they are still visible, but they can be hit only by BSDF sampling, so the image is noisier)
+            if (material.emission.texture)
+            {
+                RT_LOG_WARNING("Mesh '%s': material '%s' has textured emission, it won't be registered as light",
+                    mFilePath.c_str(), material.debugName.c_str());
+                continue;
+            }
+
+            std::vector<uint32> emissiveIndices;
+            std::vector<uint32> emissiveMaterialIndices;
+            std::vector<uint32> remainingIndices;
+            std::vector<uint32> remainingMaterialIndices;
+
+            for (size_t i = 0; i < mMaterialIndices.size(); ++i)
+            {
+                const bool isEmissive = mMaterialIndices[i] == materialIndex;
+                std::vector<uint32>& indices = isEmissive ? emissiveIndices : remainingIndices;
+                std::vector<uint32>& materialIndices = isEmissive ? emissiveMaterialIndices : remainingMaterialIndices;
+
+                indices.push_back(mVertexIndices[3 * i + 0]);
+                indices.push_back(mVertexIndices[3 * i + 1]);
+                indices.push_back(mVertexIndices[3 * i + 2]);
+                materialIndices.push_back(mMaterialIndices[i]);
+            }
+
+            if (emissiveIndices.empty())
+            {
+                continue;
+            }
+
+            MeshShapePtr emissiveMesh = BuildMesh(emissiveIndices, emissiveMaterialIndices);
+            if (!emissiveMesh)
+            {
+                return false;
+            }
+
+            RT_LOG_INFO("Mesh '%s': %zu triangles with emissive material '%s' registered as light",
+                mFilePath.c_str(), emissiveMaterialIndices.size(), material.debugName.c_str());
+
+            outEmissiveMeshes.push_back({ emissiveMesh, material.emission.baseValue });
+
+            mVertexIndices = std::move(remainingIndices);
+            mMaterialIndices = std::move(remainingMaterialIndices);
+        }
+
+        return true;
+    }
+
+    // material and texture files the loaded mesh depends on
+    const std::vector<std::string>& GetDependencies() const
+    {
+        return mDependencies;
+    }
+
     MeshShapePtr BuildMesh()
+    {
+        if (mVertexIndices.empty())
+        {
+            return nullptr;
+        }
+
+        return BuildMesh(mVertexIndices, mMaterialIndices);
+    }
+
+private:
+    void AddTextureDependency(const std::string& baseDir, const std::string& path)
+    {
+        if (!path.empty())
+        {
+            mDependencies.push_back(GetBitmapFilePath(baseDir, path));
+        }
+    }
+
+    MeshShapePtr BuildMesh(const std::vector<uint32>& vertexIndices, const std::vector<uint32>& materialIndices)
     {
         MeshDesc meshDesc;
         meshDesc.path = mFilePath;
-        meshDesc.vertexBufferDesc.numTriangles = static_cast<uint32>(mVertexIndices.size() / 3);
+        meshDesc.vertexBufferDesc.numTriangles = static_cast<uint32>(vertexIndices.size() / 3);
         meshDesc.vertexBufferDesc.numVertices = static_cast<uint32>(mVertexPositions.size());
         meshDesc.vertexBufferDesc.numMaterials = static_cast<uint32>(mMaterialPointers.size());
         meshDesc.vertexBufferDesc.materials = mMaterialPointers.data();
-        meshDesc.vertexBufferDesc.materialIndexBuffer = mMaterialIndices.data();
-        meshDesc.vertexBufferDesc.vertexIndexBuffer = mVertexIndices.data();
+        meshDesc.vertexBufferDesc.materialIndexBuffer = materialIndices.data();
+        meshDesc.vertexBufferDesc.vertexIndexBuffer = vertexIndices.data();
         meshDesc.vertexBufferDesc.positions = mVertexPositions.data();
         meshDesc.vertexBufferDesc.normals = mVertexNormals.data();
         meshDesc.vertexBufferDesc.tangents = mVertexTangents.data();
@@ -401,7 +550,6 @@ public:
         return mesh;
     }
 
-private:
     std::string mFilePath;
 
     std::vector<uint32> mVertexIndices;
@@ -411,18 +559,147 @@ private:
     std::vector<Float3> mVertexTangents;
     std::vector<Float2> mVertexTexCoords;
     std::vector<MaterialPtr> mMaterialPointers;
+    std::vector<std::string> mDependencies;
     std::unordered_map<tinyobj::index_t, uint32, TriangleIndicesHash, TriangleIndicesComparator> mUniqueIndices;
 };
 
-rt::MeshShapePtr LoadMesh(const std::string& filePath, MaterialsMap& outMaterials, const float scale)
+namespace {
+
+struct CachedFile
+{
+    std::string path;
+    time_t modificationTime = 0;
+};
+
+struct CachedMesh
+{
+    time_t modificationTime = 0;
+    std::vector<CachedFile> dependencies;
+    float scale = 1.0f;
+    bool hasEmissiveMeshes = false;
+    uint32 generation = 0;
+    MeshShapePtr mesh;
+    std::vector<EmissiveMesh> emissiveMeshes;
+    MaterialsMap materials;
+};
+
+// cache meshes, so scene reload only loads mesh files which were modified
+// (parsing and BVH building is by far the most expensive part of scene loading)
+std::map<std::string, CachedMesh> gMeshesList;
+
+// meshes not requested since the last ReleaseUnusedMeshes() call have older generation
+uint32 gMeshesGeneration = 0;
+
+// editing material file or a texture must invalidate the mesh as well (it holds parsed materials)
+bool AreDependenciesUpToDate(const CachedMesh& cachedMesh)
 {
+    for (const CachedFile& file : cachedMesh.dependencies)
+    {
+        if (GetFileModificationTime(file.path) != file.modificationTime)
+        {
+            RT_LOG_DEBUG("Mesh dependency '%s' was modified", file.path.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+rt::MeshShapePtr LoadMesh(const std::string& filePath, MaterialsMap& outMaterials, const float scale, std::vector<EmissiveMesh>* outEmissiveMeshes)
+{
+    const time_t modificationTime = GetFileModificationTime(filePath);
+
+    const auto iter = gMeshesList.find(filePath);
+    if (iter != gMeshesList.end())
+    {
+        CachedMesh& cachedMesh = iter->second;
+        if (cachedMesh.modificationTime == modificationTime && cachedMesh.scale == scale && cachedMesh.hasEmissiveMeshes == (outEmissiveMeshes != nullptr) &&
+            AreDependenciesUpToDate(cachedMesh))
+        {
+            RT_LOG_DEBUG("Mesh file '%s' taken from cache", filePath.c_str());
+
+            cachedMesh.generation = gMeshesGeneration;
+
+            for (const auto& material : cachedMesh.materials)
+            {
+                outMaterials[material.first] = material.second;
+            }
+
+            if (outEmissiveMeshes)
+            {
+                outEmissiveMeshes->insert(outEmissiveMeshes->end(), cachedMesh.emissiveMeshes.begin(), cachedMesh.emissiveMeshes.end());
+            }
+
+            return cachedMesh.mesh;
+        }
+
+        gMeshesList.erase(iter);
+    }
+
+    CachedMesh cachedMesh;
+    cachedMesh.modificationTime = modificationTime;
+    cachedMesh.scale = scale;
+    cachedMesh.hasEmissiveMeshes = outEmissiveMeshes != nullptr;
+    cachedMesh.generation = gMeshesGeneration;
+
     MeshLoader loader;
-    if (!loader.LoadMesh(filePath, outMaterials, scale))
+    if (!loader.LoadMesh(filePath, cachedMesh.materials, scale))
+    {
+        return nullptr;
+    }
+
+    for (const std::string& dependencyPath : loader.GetDependencies())
+    {
+        cachedMesh.dependencies.push_back({ dependencyPath, GetFileModificationTime(dependencyPath) });
+    }
+
+    if (outEmissiveMeshes)
+    {
+        if (!loader.ExtractEmissiveMeshes(cachedMesh.emissiveMeshes))
+        {
+            return nullptr;
+        }
+    }
+
+    cachedMesh.mesh = loader.BuildMesh();
+    if (!cachedMesh.mesh && cachedMesh.emissiveMeshes.empty())
     {
         return nullptr;
     }
 
-    return loader.BuildMesh();
+    for (const auto& material : cachedMesh.materials)
+    {
+        outMaterials[material.first] = material.second;
+    }
+
+    if (outEmissiveMeshes)
+    {
+        outEmissiveMeshes->insert(outEmissiveMeshes->end(), cachedMesh.emissiveMeshes.begin(), cachedMesh.emissiveMeshes.end());
+    }
+
+    MeshShapePtr mesh = cachedMesh.mesh;
+    gMeshesList[filePath] = std::move(cachedMesh);
+    return mesh;
+}
+
+void ReleaseUnusedMeshes()
+{
+    for (auto iter = gMeshesList.begin(); iter != gMeshesList.end(); )
+    {
+        if (iter->second.generation != gMeshesGeneration)
+        {
+            RT_LOG_DEBUG("Mesh file '%s' released from cache", iter->first.c_str());
+            iter = gMeshesList.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    gMeshesGeneration++;
 }
 
 } // namespace helpers
\ No newline at end of file
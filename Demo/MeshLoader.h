@@ -12,9 +12,27 @@ namespace helpers {
 
 using MaterialsMap = std::map<std::string, rt::MaterialPtr>;
 
+// part of a mesh with constant emissive material (to be registered as a light)
+struct EmissiveMesh
+{
+    rt::MeshShapePtr mesh;
+    rt::math::Vector4 emission;
+};
+
+// get last modification time of a file (zero if the file does not exist)
+time_t GetFileModificationTime(const std::string& path);
+
+// NOTE: bitmaps and meshes are cached by path, cached object is reused until the file is modified
 rt::BitmapPtr LoadBitmapObject(const std::string& baseDir, const std::string& path);
 rt::TexturePtr LoadTexture(const std::string& baseDir, const std::string& path);
-rt::MeshShapePtr LoadMesh(const std::string& filePath, MaterialsMap& outMaterials, const float scale = 1.0f);
+
+// load mesh from file
+// if outEmissiveMeshes is provided, triangles with constant emissive materials are moved to separate meshes
+// NOTE: returned mesh can be null if all the triangles were emissive
+rt::MeshShapePtr LoadMesh(const std::string& filePath, MaterialsMap& outMaterials, const float scale = 1.0f, std::vector<EmissiveMesh>* outEmissiveMeshes = nullptr);
+
+// drop cached meshes which were not loaded since the previous call (e.g. meshes of the previous scene)
+void ReleaseUnusedMeshes();
 rt::MaterialPtr CreateDefaultMaterial(MaterialsMap& outMaterials);
 
 } // namespace helpers
\ No newline at end of file
@@ -1,10 +1,12 @@
 #include "PCH.h"
 #include "Demo.h"
+#include "SceneLoader.h"
 #include "MeshLoader.h"
 
 #include "../Core/Utils/Logger.h"
 #include "../Core/Scene/Light/PointLight.h"
 #include "../Core/Scene/Light/AreaLight.h"
+#include "../Core/Scene/Light/MeshLight.h"
 #include "../Core/Scene/Light/BackgroundLight.h"
 #include "../Core/Scene/Light/DirectionalLight.h"
 #include "../Core/Scene/Light/SpotLight.h"
@@ -21,15 +23,12 @@
 #include "../Core/Textures/MixTexture.h"
 
 #include "rapidjson/document.h"
-#include "rapidjson/filereadstream.h"
 
 namespace helpers {
 
 using namespace rt;
 using namespace math;
 
-using TexturesMap = std::map<std::string, TexturePtr>;
-
 static bool ParseVector2(const rapidjson::Value& value, Vector4& outVector)
 {
     if (!value.IsArray())
@@ -415,7 +414,7 @@ static MaterialPtr ParseMaterial(const rapidjson::Value& value, const TexturesMa
     return material;
 }
 
-static ShapePtr ParseShape(const rapidjson::Value& value, Scene& scene, MaterialsMap& materials = MaterialsMap())
+static ShapePtr ParseShape(const rapidjson::Value& value, Scene& scene, MaterialsMap& materials = MaterialsMap(), std::vector<EmissiveMesh>* outEmissiveMeshes = nullptr)
 {
     ShapePtr shape;
 
@@ -488,7 +487,7 @@ static ShapePtr ParseShape(const rapidjson::Value& value, Scene& scene, Material
         }
 
         const std::string path = gOptions.dataPath + value["path"].GetString();
-        shape = helpers::LoadMesh(path, materials, scale);
+        shape = helpers::LoadMesh(path, materials, scale, outEmissiveMeshes);
     }
     else
     {
@@ -498,24 +497,24 @@ static ShapePtr ParseShape(const rapidjson::Value& value, Scene& scene, Material
     return shape;
 }
 
-static bool ParseLight(const rapidjson::Value& value, Scene& scene, const TexturesMap& textures)
+static SceneObjectPtr ParseLight(const rapidjson::Value& value, Scene& scene, const TexturesMap& textures)
 {
     if (!value.IsObject())
     {
         RT_LOG_ERROR("Light description must be a structure");
-        return false;
+        return nullptr;
     }
 
     if (!value.HasMember("type"))
     {
         RT_LOG_ERROR("Light is missing 'type' field");
-        return false;
+        return nullptr;
     }
 
     Vector4 lightColor;
     if (!TryParseVector3(value, "color", false, lightColor))
     {
-        return false;
+        return nullptr;
     }
 
     LightPtr light;
@@ -527,14 +526,14 @@ static bool ParseLight(const rapidjson::Value& value, Scene& scene, const Textur
         if (!value.HasMember("shape"))
         {
             RT_LOG_ERROR("Area light is missing 'shape' field");
-            return false;
+            return nullptr;
         }
 
         ShapePtr shape = ParseShape(value["shape"], scene);
         auto areaLight = std::make_unique<AreaLight>(std::move(shape), lightColor);
 
         if (!TryParseTextureName(value, "texture", textures, areaLight->mTexture))
-            return false;
+            return nullptr;
 
         if (areaLight->mTexture && !areaLight->mTexture->IsSamplable())
         {
@@ -555,7 +554,7 @@ static bool ParseLight(const rapidjson::Value& value, Scene& scene, const Textur
         float angle = 0.0f;
         if (!TryParseFloat(value, "angle", true, angle))
         {
-            return false;
+            return nullptr;
         }
         const float angleRad = angle / 180.0f * RT_PI;
 
@@ -568,7 +567,7 @@ static bool ParseLight(const rapidjson::Value& value, Scene& scene, const Textur
         float angle = 0.0f;
         if (!TryParseFloat(value, "angle", true, angle))
         {
-            return false;
+            return nullptr;
         }
 
         auto dirLight = std::make_unique<DirectionalLight>(lightColor, DegToRad(angle));
@@ -580,7 +579,9 @@ static bool ParseLight(const rapidjson::Value& value, Scene& scene, const Textur
         auto backgroundLight = std::make_unique<BackgroundLight>(lightColor);
 
         if (!TryParseTextureName(value, "texture", textures, backgroundLight->mTexture))
-            return false;
+            return nullptr;
+
+        backgroundLight->MakeSamplable();
 
         light = std::move(backgroundLight);
     }
@@ -589,7 +590,7 @@ static bool ParseLight(const rapidjson::Value& value, Scene& scene, const Textur
         float radius = 0.0f;
         if (!TryParseFloat(value, "radius", false, radius))
         {
-            return false;
+            return nullptr;
         }
 
         auto shape = std::make_unique<SphereShape>(radius);
@@ -598,7 +599,7 @@ static bool ParseLight(const rapidjson::Value& value, Scene& scene, const Textur
     else
     {
         RT_LOG_ERROR("Unknown light type: '%s'", typeStr.c_str());
-        return false;
+        return nullptr;
     }
 
     auto lightObject = std::make_unique<LightSceneObject>(std::move(light));
@@ -607,14 +608,12 @@ static bool ParseLight(const rapidjson::Value& value, Scene& scene, const Textur
         Transform transform;
         if (!TryParseTransform(value, "transform", transform))
         {
-            return false;
+            return nullptr;
         }
         lightObject->SetTransform(transform.ToMatrix4());
     }
 
-    scene.AddObject(std::move(lightObject));
-
-    return true;
+    return std::move(lightObject);
 }
 
 static bool ParseObject(const rapidjson::Value& value, Scene& scene, MaterialsMap& materials)
@@ -625,12 +624,30 @@ static bool ParseObject(const rapidjson::Value& value, Scene& scene, MaterialsMa
         return false;
     }
 
-    ShapePtr shape = ParseShape(value, scene, materials);
-    if (!shape)
+    std::vector<EmissiveMesh> emissiveMeshes;
+    ShapePtr shape = ParseShape(value, scene, materials, &emissiveMeshes);
+    if (!shape && emissiveMeshes.empty())
     {
         return false;
     }
 
+    Transform transform;
+    if (!TryParseTransform(value, "transform", transform))
+        return false;
+
+    // emissive parts of the mesh are represented as mesh lights
+    for (const EmissiveMesh& emissiveMesh : emissiveMeshes)
+    {
+        auto lightObject = std::make_unique<LightSceneObject>(std::make_unique<MeshLight>(emissiveMesh.mesh, emissiveMesh.emission));
+        lightObject->SetTransform(transform.ToMatrix4());
+        scene.AddObject(std::move(lightObject));
+    }
+
+    if (!shape)
+    {
+        return true;
+    }
+
     ShapeSceneObjectPtr sceneObject = std::make_unique<ShapeSceneObject>(std::move(shape));
 
     // TODO velocity
@@ -640,9 +657,6 @@ static bool ParseObject(const rapidjson::Value& value, Scene& scene, MaterialsMa
         return false;
     sceneObject->SetDefaultMaterial(material);
 
-    Transform transform;
-    if (!TryParseTransform(value, "transform", transform))
-        return false;
     sceneObject->SetTransform(transform.ToMatrix4());
 
     scene.AddObject(std::move(sceneObject));
@@ -689,7 +703,7 @@ static bool ParseCamera(const rapidjson::Value& value, const TexturesMap& textur
     return true;
 }
 
-bool LoadScene(const std::string& path, Scene& scene, rt::Camera& camera)
+static bool ReadSceneFile(const std::string& path, std::string& outContent)
 {
     FILE* fp = fopen(path.c_str(), "rb");
     if (!fp)
@@ -699,11 +713,23 @@ bool LoadScene(const std::string& path, Scene& scene, rt::Camera& camera)
     }
 
     char readBuffer[4096];
-    rapidjson::FileReadStream is(fp, readBuffer, sizeof(readBuffer));
-    rapidjson::Document d;
-    d.ParseStream(is);
+    outContent.clear();
+    for (;;)
+    {
+        const size_t bytesRead = fread(readBuffer, 1, sizeof(readBuffer), fp);
+        if (bytesRead == 0)
+            break;
+        outContent.append(readBuffer, bytesRead);
+    }
     fclose(fp);
 
+    return true;
+}
+
+static bool ParseSceneFile(const std::string& path, const std::string& content, rapidjson::Document& d)
+{
+    d.Parse(content.c_str());
+
     if (!d.IsObject())
     {
         const char* errorStr = rapidjson::GetParseError_En(d.GetParseError());
@@ -711,8 +737,23 @@ bool LoadScene(const std::string& path, Scene& scene, rt::Camera& camera)
         return false;
     }
 
+    return true;
+}
+
+bool LoadScene(const std::string& path, Scene& scene, rt::Camera& camera, LoadedScene* outLoadedScene)
+{
+    std::string content;
+    if (!ReadSceneFile(path, content))
+        return false;
+
+    rapidjson::Document d;
+    if (!ParseSceneFile(path, content, d))
+        return false;
+
     MaterialsMap materialsMap;
     TexturesMap texturesMap;
+    std::vector<std::vector<uint32>> objectIndices;
+    std::vector<uint32> lightIndices;
 
     if (d.HasMember("textures"))
     {
@@ -778,8 +819,17 @@ bool LoadScene(const std::string& path, Scene& scene, rt::Camera& camera)
         {
             for (rapidjson::SizeType i = 0; i < objectsArray.Size(); i++)
             {
+                const uint32 firstObjectIndex = scene.GetNumObjects();
                 if (!ParseObject(objectsArray[i], scene, materialsMap))
                     return false;
+
+                // single entry may result in multiple scene objects (e.g. emissive parts of a mesh)
+                std::vector<uint32> indices;
+                for (uint32 j = firstObjectIndex; j < scene.GetNumObjects(); ++j)
+                {
+                    indices.push_back(j);
+                }
+                objectIndices.push_back(std::move(indices));
             }
         }
         else
@@ -796,8 +846,12 @@ bool LoadScene(const std::string& path, Scene& scene, rt::Camera& camera)
         {
             for (rapidjson::SizeType i = 0; i < lightsArray.Size(); i++)
             {
-                if (!ParseLight(lightsArray[i], scene, texturesMap))
+                SceneObjectPtr lightObject = ParseLight(lightsArray[i], scene, texturesMap);
+                if (!lightObject)
                     return false;
+
+                lightIndices.push_back(scene.GetNumObjects());
+                scene.AddObject(std::move(lightObject));
             }
         }
         else
@@ -816,6 +870,254 @@ bool LoadScene(const std::string& path, Scene& scene, rt::Camera& camera)
         }
     }
 
+    if (outLoadedScene)
+    {
+        outLoadedScene->fileContent = std::move(content);
+        outLoadedScene->textures = std::move(texturesMap);
+        outLoadedScene->materials = std::move(materialsMap);
+        outLoadedScene->objectIndices = std::move(objectIndices);
+        outLoadedScene->lightIndices = std::move(lightIndices);
+    }
+
+    return true;
+}
+
+static const rapidjson::Value& GetMemberOrNull(const rapidjson::Value& value, const char* name)
+{
+    static const rapidjson::Value nullValue;
+
+    if (!value.IsObject())
+        return nullValue;
+
+    const auto iter = value.FindMember(name);
+    return iter != value.MemberEnd() ? iter->value : nullValue;
+}
+
+// compare two JSON values, skipping given members of (top-level) object
+static bool EqualExcept(const rapidjson::Value& a, const rapidjson::Value& b, std::initializer_list<const char*> ignoredMembers)
+{
+    if (!a.IsObject() || !b.IsObject())
+        return a == b;
+
+    const auto isIgnored = [&ignoredMembers](const rapidjson::Value& name)
+    {
+        for (const char* ignoredName : ignoredMembers)
+        {
+            if (name == ignoredName)
+                return true;
+        }
+        return false;
+    };
+
+    uint32 numMembersA = 0;
+    for (auto iter = a.MemberBegin(); iter != a.MemberEnd(); ++iter)
+    {
+        if (isIgnored(iter->name))
+            continue;
+
+        const auto otherIter = b.FindMember(iter->name);
+        if (otherIter == b.MemberEnd() || iter->value != otherIter->value)
+            return false;
+
+        numMembersA++;
+    }
+
+    uint32 numMembersB = 0;
+    for (auto iter = b.MemberBegin(); iter != b.MemberEnd(); ++iter)
+    {
+        if (!isIgnored(iter->name))
+            numMembersB++;
+    }
+
+    return numMembersA == numMembersB;
+}
+
+static uint32 GetArraySize(const rapidjson::Value& value)
+{
+    return value.IsArray() ? value.Size() : 0;
+}
+
+bool UpdateScene(const std::string& path, Scene& scene, rt::Camera& camera, LoadedScene& loadedScene, bool& outCameraChanged)
+{
+    outCameraChanged = false;
+
+    std::string content;
+    if (!ReadSceneFile(path, content))
+        return false;
+
+    if (content == loadedScene.fileContent)
+    {
+        // touched, but not modified
+        return true;
+    }
+
+    rapidjson::Document d;
+    if (!ParseSceneFile(path, content, d))
+    {
+        // file is probably being edited, keep the current scene until it's valid again
+        return true;
+    }
+
+    rapidjson::Document oldDocument;
+    if (!ParseSceneFile(path, loadedScene.fileContent, oldDocument))
+        return false;
+
+    // textures may be referenced anywhere, don't bother tracking them
+    if (GetMemberOrNull(d, "textures") != GetMemberOrNull(oldDocument, "textures"))
+        return false;
+
+    const rapidjson::Value& materials = GetMemberOrNull(d, "materials");
+    const rapidjson::Value& oldMaterials = GetMemberOrNull(oldDocument, "materials");
+    const rapidjson::Value& objects = GetMemberOrNull(d, "objects");
+    const rapidjson::Value& oldObjects = GetMemberOrNull(oldDocument, "objects");
+    const rapidjson::Value& lights = GetMemberOrNull(d, "lights");
+    const rapidjson::Value& oldLights = GetMemberOrNull(oldDocument, "lights");
+
+    // check if scene structure is the same
+    {
+        if (GetArraySize(materials) != GetArraySize(oldMaterials))
+            return false;
+
+        for (uint32 i = 0; i < GetArraySize(materials); ++i)
+        {
+            if (GetMemberOrNull(materials[i], "name") != GetMemberOrNull(oldMaterials[i], "name"))
+                return false;
+        }
+
+        if (GetArraySize(objects) != GetArraySize(oldObjects) || GetArraySize(objects) != loadedScene.objectIndices.size())
+            return false;
+
+        for (uint32 i = 0; i < GetArraySize(objects); ++i)
+        {
+            if (!EqualExcept(objects[i], oldObjects[i], { "transform", "material" }))
+                return false;
+        }
+
+        if (GetArraySize(lights) != GetArraySize(oldLights) || GetArraySize(lights) != loadedScene.lightIndices.size())
+            return false;
+
+        for (uint32 i = 0; i < GetArraySize(lights); ++i)
+        {
+            if (GetMemberOrNull(lights[i], "type") != GetMemberOrNull(oldLights[i], "type"))
+                return false;
+        }
+    }
+
+    bool refitBVH = false;
+
+    // parse all the changed materials first, so nothing is patched if a full reload is needed
+    std::vector<MaterialPtr> changedMaterials;
+    for (uint32 i = 0; i < GetArraySize(materials); ++i)
+    {
+        if (materials[i] == oldMaterials[i])
+            continue;
+
+        // opacity micromaps are baked from the mask when a mesh is built, so they would go stale
+        if (GetMemberOrNull(materials[i], "maskMap") != GetMemberOrNull(oldMaterials[i], "maskMap"))
+            return false;
+
+        MaterialPtr material = ParseMaterial(materials[i], loadedScene.textures);
+        if (!material)
+            return false;
+
+        const auto iter = loadedScene.materials.find(material->debugName);
+        if (iter == loadedScene.materials.end())
+            return false;
+
+        // keep the very mask texture the micromaps were built from (bitmap textures are recreated on every parse)
+        material->maskMap = iter->second->maskMap;
+
+        changedMaterials.push_back(std::move(material));
+    }
+
+    // patch materials in place, so all the objects using them see the change
+    for (MaterialPtr& material : changedMaterials)
+    {
+        Material& targetMaterial = *loadedScene.materials[material->debugName];
+        targetMaterial = std::move(*material);
+        RT_LOG_INFO("Updated material: '%s'", targetMaterial.debugName.c_str());
+    }
+
+    for (uint32 i = 0; i < GetArraySize(objects); ++i)
+    {
+        const std::vector<uint32>& objectIndices = loadedScene.objectIndices[i];
+
+        if (GetMemberOrNull(objects[i], "transform") != GetMemberOrNull(oldObjects[i], "transform"))
+        {
+            Transform transform;
+            if (!TryParseTransform(objects[i], "transform", transform))
+                return false;
+
+            for (const uint32 objectIndex : objectIndices)
+            {
+                scene.GetSceneObject(objectIndex)->SetTransform(transform.ToMatrix4());
+            }
+            refitBVH = true;
+        }
+
+        if (GetMemberOrNull(objects[i], "material") != GetMemberOrNull(oldObjects[i], "material"))
+        {
+            MaterialPtr material;
+            if (!TryParseMaterialName(loadedScene.materials, objects[i], "material", material))
+                return false;
+
+            for (const uint32 objectIndex : objectIndices)
+            {
+                ISceneObject* sceneObject = scene.GetSceneObject(objectIndex);
+                if (sceneObject->GetType() == ISceneObject::Type::Shape)
+                {
+                    static_cast<ShapeSceneObject*>(sceneObject)->SetDefaultMaterial(material);
+                }
+            }
+        }
+    }
+
+    for (uint32 i = 0; i < GetArraySize(lights); ++i)
+    {
+        if (lights[i] == oldLights[i])
+            continue;
+
+        const uint32 objectIndex = loadedScene.lightIndices[i];
+
+        if (EqualExcept(lights[i], oldLights[i], { "transform" }))
+        {
+            Transform transform;
+            if (!TryParseTransform(lights[i], "transform", transform))
+                return false;
+
+            scene.GetSceneObject(objectIndex)->SetTransform(transform.ToMatrix4());
+        }
+        else
+        {
+            // light parameters are baked into light object (e.g. sampling tables), so it's recreated
+            SceneObjectPtr lightObject = ParseLight(lights[i], scene, loadedScene.textures);
+            if (!lightObject)
+                return false;
+
+            if (!scene.ReplaceObject(objectIndex, std::move(lightObject)))
+                return false;
+        }
+        refitBVH = true;
+    }
+
+    const rapidjson::Value& cameraObject = GetMemberOrNull(d, "camera");
+    if (cameraObject != GetMemberOrNull(oldDocument, "camera") && !cameraObject.IsNull())
+    {
+        if (!ParseCamera(cameraObject, loadedScene.textures, camera))
+            return false;
+
+        outCameraChanged = true;
+    }
+
+    if (refitBVH)
+    {
+        if (!scene.RefitBVH())
+            return false;
+    }
+
+    loadedScene.fileContent = std::move(content);
+
+    RT_LOG_INFO("Scene file '%s' changes applied", path.c_str());
     return true;
 }
 
@@ -1,9 +1,27 @@
 #pragma once
 
+#include "MeshLoader.h"
 #include "../Core/Scene/Scene.h"
 
 namespace helpers {
 
-bool LoadScene(const std::string& path, rt::Scene& scene, rt::Camera& camera);
+using TexturesMap = std::map<std::string, rt::TexturePtr>;
+
+// scene file contents and objects created from it, allows for applying changes of the file without full reload
+struct LoadedScene
+{
+    std::string fileContent;
+    TexturesMap textures;
+    MaterialsMap materials;
+    std::vector<std::vector<uint32>> objectIndices; // scene objects created for each entry of 'objects' array
+    std::vector<uint32> lightIndices;               // scene object created for each entry of 'lights' array
+};
+
+bool LoadScene(const std::string& path, rt::Scene& scene, rt::Camera& camera, LoadedScene* outLoadedScene = nullptr);
+
+// Apply changes of already loaded scene file. Materials, lights and object transforms are updated in place
+// (top-level BVH is refitted), camera is updated only if it was changed in the file.
+// Returns false if scene structure changed (e.g. objects were added or mesh was changed) and full reload is required.
+bool UpdateScene(const std::string& path, rt::Scene& scene, rt::Camera& camera, LoadedScene& loadedScene, bool& outCameraChanged);
 
 } // namespace helpers
\ No newline at end of file
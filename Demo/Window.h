@@ -7,6 +7,7 @@
 #if defined(__LINUX__) | defined(__linux__)
 #include <xcb/xcb.h>
 #include <xcb/xcb_image.h>
+#include <xcb/shm.h>
 #endif // defined(__LINUX__) | defined(__linux__)
 
 namespace rt
@@ -86,6 +87,27 @@ public:
 
     bool DrawPixels(const rt::Bitmap& bitmap);
 
+    /**
+     * Allocate window-owned presentation images (B8G8R8A8, tightly packed rows), which can be drawn into directly
+     * and shown without copying the pixels. The images are recreated when the window is resized.
+     *
+     * @return False if not supported (e.g. MIT-SHM extension is not available), @p DrawPixels must be used then.
+     */
+    bool InitPresentBuffers();
+
+    // Get number of presentation images (0 if not initialized).
+    uint32 GetNumPresentBuffers() const;
+
+    // Get pixels of a presentation image.
+    uint8* GetPresentBufferData(uint32 index) const;
+
+    /**
+     * Show a presentation image.
+     *
+     * @remarks When the function returns, all the other presentation images are safe to be written to.
+     */
+    bool Present(uint32 index);
+
 private:
 
     void LostFocus();
@@ -109,6 +131,23 @@ private:
     xcb_intern_atom_reply_t* mDeleteReply;
     int mConnScreen;
     uint32_t mGraphicsContext;
+
+    // image in a shared memory segment attached to the X server
+    struct ShmImage
+    {
+        uint8* data = nullptr;
+        xcb_shm_seg_t segment = 0;
+        xcb_void_cookie_t putCookie = { 0 };
+        bool pending = false;   // put request may not be processed yet
+    };
+
+    static constexpr uint32 NumPresentBuffers = 2;
+
+    bool CreatePresentBuffers();
+    void ReleasePresentBuffers();
+
+    ShmImage mPresentBuffers[NumPresentBuffers];
+    bool mUsePresentBuffers;
 #else
 #error "Target not supported!" // TODO Consider supporting Wayland as well
 #endif // defined(WIN32)
@@ -273,6 +273,27 @@ bool Window::DrawPixels(const rt::Bitmap& bitmap)
     return true;
 }
 
+bool Window::InitPresentBuffers()
+{
+    // not supported, DrawPixels is used
+    return false;
+}
+
+uint32 Window::GetNumPresentBuffers() const
+{
+    return 0;
+}
+
+uint8* Window::GetPresentBufferData(uint32) const
+{
+    return nullptr;
+}
+
+bool Window::Present(uint32)
+{
+    return false;
+}
+
 bool Window::Close()
 {
     if (mClosed)
@@ -0,0 +1,240 @@
+#include "PCH.h"
+#include "../Core/Material/Material.h"
+#include "../Core/Math/Random.h"
+
+using namespace rt;
+using namespace rt::math;
+
+#ifndef RT_ENABLE_SPECTRAL_RENDERING
+
+namespace {
+
+const char* const TestedBSDFs[] =
+{
+    "null", "diffuse", "roughDiffuse", "dielectric", "roughDielectric", "metal", "roughMetal", "plastic", "roughPlastic",
+};
+
+// mix of smooth (specular fallback) and rough lanes
+const float TestedRoughness[8] = { 0.001f, 0.05f, 0.2f, 0.35f, 0.5f, 0.7f, 0.9f, 1.0f };
+
+const uint32 NumIterations = 2000;
+const uint64 TestSeed = 12345;
+
+const Vector4 RandomDirection(Random& random)
+{
+    for (;;)
+    {
+        const Vector4 v = random.GetVector4Bipolar() & Vector4::MakeMask<1,1,1,0>();
+        const float sqrLength = v.SqrLength3();
+        if (sqrLength > 0.01f && sqrLength <= 1.0f)
+        {
+            return v / sqrtf(sqrLength);
+        }
+    }
+}
+
+::testing::AssertionResult AlmostEqual(float expected, float actual)
+{
+    const float tolerance = 2.0e-3f * Max(1.0f, Max(Abs(expected), Abs(actual)));
+    if (Abs(expected - actual) <= tolerance)
+    {
+        return ::testing::AssertionSuccess();
+    }
+    return ::testing::AssertionFailure() << "expected " << expected << ", got " << actual;
+}
+
+// refraction sampling PDF is proportional to 1 / (eta * VdotH + LdotH)^2, so near-singular Jacobian amplifies tiny
+// differences of the sampled direction - relative error grows with square root of the PDF
+::testing::AssertionResult PdfAlmostEqual(float expected, float actual)
+{
+    const float tolerance = Max(2.0e-3f, 4.0e-6f * sqrtf(Abs(expected))) * Max(1.0f, Max(Abs(expected), Abs(actual)));
+    if (Abs(expected - actual) <= tolerance)
+    {
+        return ::testing::AssertionSuccess();
+    }
+    return ::testing::AssertionFailure() << "expected " << expected << ", got " << actual;
+}
+
+struct LaneInputs
+{
+    Vector4 baseColor[8];
+    Vector4 outgoingDir[8];
+    Vector4 incomingDir[8];
+    Vector4 sample[8];
+    float IoR[8];
+};
+
+void GenerateInputs(Random& random, LaneInputs& inputs)
+{
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        inputs.baseColor[i] = random.GetVector4() & Vector4::MakeMask<1,1,1,0>();
+        inputs.outgoingDir[i] = RandomDirection(random);
+        inputs.incomingDir[i] = RandomDirection(random);
+        inputs.sample[i] = random.GetVector4();
+        inputs.IoR[i] = 1.1f + random.GetFloat();
+    }
+}
+
+const SampledMaterialParameters MakeMaterialParams(const LaneInputs& inputs, uint32 lane)
+{
+    SampledMaterialParameters params;
+    params.baseColor = RayColor(inputs.baseColor[lane]);
+    params.emissionColor = RayColor::Zero();
+    params.roughness = TestedRoughness[lane];
+    params.metalness = 0.0f;
+    params.IoR = inputs.IoR[lane];
+    return params;
+}
+
+} // namespace
+
+// 8-wide BSDF sampling must match the scalar implementation lane by lane
+TEST(BSDFTest, Sample_Simd8)
+{
+    // fixed seed, so that rare ill-conditioned lanes don't make the test flaky
+    Random random;
+    random.Reset(TestSeed);
+    const Wavelength wavelength;
+
+    for (const char* bsdfName : TestedBSDFs)
+    {
+        SCOPED_TRACE(bsdfName);
+
+        Material material;
+        material.SetBsdf(bsdfName);
+        material.Compile();
+        const BSDF* bsdf = material.GetBSDF();
+        ASSERT_NE(nullptr, bsdf);
+
+        for (uint32 iteration = 0; iteration < NumIterations; ++iteration)
+        {
+            LaneInputs inputs;
+            GenerateInputs(random, inputs);
+
+            BSDF::SamplingContext_Simd8 ctx
+            {
+                material,
+                Vector3x8(inputs.baseColor[0], inputs.baseColor[1], inputs.baseColor[2], inputs.baseColor[3], inputs.baseColor[4], inputs.baseColor[5], inputs.baseColor[6], inputs.baseColor[7]),
+                Vector8(TestedRoughness),
+                Vector8(inputs.IoR),
+                Vector3x8(inputs.sample[0], inputs.sample[1], inputs.sample[2], inputs.sample[3], inputs.sample[4], inputs.sample[5], inputs.sample[6], inputs.sample[7]),
+                Vector3x8(inputs.outgoingDir[0], inputs.outgoingDir[1], inputs.outgoingDir[2], inputs.outgoingDir[3], inputs.outgoingDir[4], inputs.outgoingDir[5], inputs.outgoingDir[6], inputs.outgoingDir[7]),
+            };
+
+            const int32 validMask = bsdf->Sample_Simd8(ctx).GetMask();
+
+            Vector4 simdIncomingDirs[8];
+            ctx.outIncomingDir.Unpack(simdIncomingDirs);
+
+            for (uint32 i = 0; i < 8; ++i)
+            {
+                SCOPED_TRACE("lane " + std::to_string(i));
+
+                Wavelength laneWavelength = wavelength;
+                BSDF::SamplingContext scalarCtx
+                {
+                    material,
+                    MakeMaterialParams(inputs, i),
+                    inputs.sample[i].ToFloat3(),
+                    inputs.outgoingDir[i],
+                    laneWavelength,
+                };
+
+                const bool scalarValid = bsdf->Sample(scalarCtx);
+                const bool simdValid = (validMask & (1 << i)) != 0;
+                ASSERT_EQ(scalarValid, simdValid);
+
+                if (!scalarValid)
+                {
+                    EXPECT_EQ(0.0f, ctx.outPdf[i]);
+                    continue;
+                }
+
+                EXPECT_EQ(scalarCtx.outEventType, ctx.outEventType[i]);
+                EXPECT_TRUE(PdfAlmostEqual(scalarCtx.outPdf, ctx.outPdf[i]));
+                EXPECT_TRUE(AlmostEqual(scalarCtx.outColor.value.x, ctx.outColor.x[i]));
+                EXPECT_TRUE(AlmostEqual(scalarCtx.outColor.value.y, ctx.outColor.y[i]));
+                EXPECT_TRUE(AlmostEqual(scalarCtx.outColor.value.z, ctx.outColor.z[i]));
+                EXPECT_TRUE(AlmostEqual(scalarCtx.outIncomingDir.x, simdIncomingDirs[i].x));
+                EXPECT_TRUE(AlmostEqual(scalarCtx.outIncomingDir.y, simdIncomingDirs[i].y));
+                EXPECT_TRUE(AlmostEqual(scalarCtx.outIncomingDir.z, simdIncomingDirs[i].z));
+            }
+        }
+    }
+}
+
+// 8-wide BSDF evaluation must match the scalar implementation lane by lane
+TEST(BSDFTest, Evaluate_Simd8)
+{
+    // fixed seed, so that rare ill-conditioned lanes don't make the test flaky
+    Random random;
+    random.Reset(TestSeed);
+    const Wavelength wavelength;
+
+    for (const char* bsdfName : TestedBSDFs)
+    {
+        SCOPED_TRACE(bsdfName);
+
+        Material material;
+        material.SetBsdf(bsdfName);
+        material.Compile();
+        const BSDF* bsdf = material.GetBSDF();
+        ASSERT_NE(nullptr, bsdf);
+
+        for (uint32 iteration = 0; iteration < NumIterations; ++iteration)
+        {
+            LaneInputs inputs;
+            GenerateInputs(random, inputs);
+
+            const BSDF::EvaluationContext_Simd8 ctx
+            {
+                material,
+                Vector3x8(inputs.baseColor[0], inputs.baseColor[1], inputs.baseColor[2], inputs.baseColor[3], inputs.baseColor[4], inputs.baseColor[5], inputs.baseColor[6], inputs.baseColor[7]),
+                Vector8(TestedRoughness),
+                Vector8(inputs.IoR),
+                Vector3x8(inputs.outgoingDir[0], inputs.outgoingDir[1], inputs.outgoingDir[2], inputs.outgoingDir[3], inputs.outgoingDir[4], inputs.outgoingDir[5], inputs.outgoingDir[6], inputs.outgoingDir[7]),
+                Vector3x8(inputs.incomingDir[0], inputs.incomingDir[1], inputs.incomingDir[2], inputs.incomingDir[3], inputs.incomingDir[4], inputs.incomingDir[5], inputs.incomingDir[6], inputs.incomingDir[7]),
+            };
+
+            Vector8 simdDirectPdf, simdReversePdf;
+            const Vector3x8 simdColor = bsdf->Evaluate_Simd8(ctx, &simdDirectPdf, &simdReversePdf);
+            const Vector8 simdForwardPdf = bsdf->Pdf_Simd8(ctx, BSDF::ForwardPdf);
+            const Vector8 simdBackwardPdf = bsdf->Pdf_Simd8(ctx, BSDF::ReversePdf);
+
+            for (uint32 i = 0; i < 8; ++i)
+            {
+                SCOPED_TRACE("lane " + std::to_string(i));
+
+                const BSDF::EvaluationContext scalarCtx
+                {
+                    material,
+                    MakeMaterialParams(inputs, i),
+                    wavelength,
+                    inputs.outgoingDir[i],
+                    inputs.incomingDir[i],
+                };
+
+                // scalar evaluation leaves PDFs untouched for rejected directions
+                float scalarDirectPdf = 0.0f;
+                float scalarReversePdf = -1.0f;
+                const RayColor scalarColor = bsdf->Evaluate(scalarCtx, &scalarDirectPdf, &scalarReversePdf);
+
+                EXPECT_TRUE(AlmostEqual(scalarColor.value.x, simdColor.x[i]));
+                EXPECT_TRUE(AlmostEqual(scalarColor.value.y, simdColor.y[i]));
+                EXPECT_TRUE(AlmostEqual(scalarColor.value.z, simdColor.z[i]));
+                EXPECT_TRUE(AlmostEqual(scalarDirectPdf, simdDirectPdf[i]));
+
+                if (scalarReversePdf >= 0.0f)
+                {
+                    EXPECT_TRUE(AlmostEqual(scalarReversePdf, simdReversePdf[i]));
+                }
+
+                EXPECT_TRUE(AlmostEqual(bsdf->Pdf(scalarCtx, BSDF::ForwardPdf), simdForwardPdf[i]));
+                EXPECT_TRUE(AlmostEqual(bsdf->Pdf(scalarCtx, BSDF::ReversePdf), simdBackwardPdf[i]));
+            }
+        }
+    }
+}
+
+#endif // RT_ENABLE_SPECTRAL_RENDERING
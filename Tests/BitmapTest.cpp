@@ -1,7 +1,10 @@
 #include "PCH.h"
 #include "../Core/Utils/Bitmap.h"
+#include "../Core/Textures/BitmapTexture.h"
+#include "../Core/Utils/BlockCompression.h"
 #include "../Core/Math/Half.h"
 #include "../Core/Math/Packed.h"
+#include "../Core/Math/Random.h"
 
 using namespace rt;
 using namespace rt::math;
@@ -18,6 +21,48 @@ TEST(BitmapTest, Empty)
     EXPECT_EQ(nullptr, bitmap.GetData());
 }
 
+TEST(BitmapTest, WrapData)
+{
+    uint32 data[4 * 3] = { 0 };
+
+    Bitmap::InitData initData;
+    initData.width = 3;
+    initData.height = 3;
+    initData.stride = 4 * sizeof(uint32);
+    initData.format = Bitmap::Format::B8G8R8A8_UNorm;
+    initData.data = data;
+    initData.wrapData = true;
+
+    {
+        Bitmap bitmap;
+        ASSERT_TRUE(bitmap.Init(initData));
+        EXPECT_TRUE(bitmap.IsWrappingData());
+        EXPECT_EQ(reinterpret_cast<uint8*>(data), bitmap.GetData());
+        EXPECT_EQ(4 * sizeof(uint32), bitmap.GetStride());
+
+        // writes go directly to the wrapped memory
+        bitmap.GetPixelRef<uint32>(1, 2) = 0x12345678u;
+        EXPECT_EQ(0x12345678u, data[4 * 2 + 1]);
+
+        // copy owns its memory
+        Bitmap copy(bitmap);
+        EXPECT_FALSE(copy.IsWrappingData());
+        EXPECT_NE(bitmap.GetData(), copy.GetData());
+        EXPECT_EQ(0x12345678u, copy.GetPixelRef<uint32>(1, 2));
+
+        Bitmap moved(std::move(bitmap));
+        EXPECT_TRUE(moved.IsWrappingData());
+        EXPECT_EQ(reinterpret_cast<uint8*>(data), moved.GetData());
+    }
+
+    // wrapped memory is left intact
+    EXPECT_EQ(0x12345678u, data[4 * 2 + 1]);
+
+    initData.data = nullptr;
+    Bitmap bitmap;
+    EXPECT_FALSE(bitmap.Init(initData));
+}
+
 void CompareVector(const Vector4& ref, const Vector4& val, float maxError = 0.0f)
 {
     const Vector4 diff = Vector4::Abs(ref - val);
@@ -492,3 +537,376 @@ TEST(BitmapTest, Format_R16G16B16A16_Half)
     Validate_GetPixel(bitmap, expected, 0.001f);
     Validate_GetPixelBlock(bitmap, expected, 0.001f);
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST(BitmapTest, Texture_MipLevels)
+{
+    BitmapPtr bitmap = std::make_shared<Bitmap>();
+    {
+        // checkerboard
+        const float data[] =
+        {
+            0.0f, 1.0f, 0.0f, 1.0f,
+            1.0f, 0.0f, 1.0f, 0.0f,
+            0.0f, 1.0f, 0.0f, 1.0f,
+            1.0f, 0.0f, 1.0f, 0.0f,
+        };
+        ASSERT_TRUE(bitmap->Init({ 4, 4, Bitmap::Format::R32_Float, data }));
+    }
+
+    BitmapTexture texture(bitmap);
+    ASSERT_EQ(3u, texture.GetNumMipLevels());
+
+    // zero footprint - the most detailed level (sample exactly at a texel)
+    EXPECT_NEAR(0.0f, texture.Evaluate(Vector4(0.25f, 0.25f, 0.0f, 0.0f)).x, 0.001f);
+
+    // footprint covering multiple texels - checkerboard averages out
+    EXPECT_NEAR(0.5f, texture.Evaluate(Vector4(0.375f, 0.375f, 0.5f, 0.0f)).x, 0.001f);
+    EXPECT_NEAR(0.5f, texture.Evaluate(Vector4(0.1f, 0.7f, 1.0f, 0.0f)).x, 0.001f);
+}
+
+TEST(BitmapTest, Texture_MipLevels_OddSize)
+{
+    BitmapPtr bitmap = std::make_shared<Bitmap>();
+    {
+        // thin bright features in the last row and column
+        const float data[] =
+        {
+            0.0f, 0.0f, 0.0f, 0.0f, 5.0f,
+            0.0f, 0.0f, 0.0f, 0.0f, 5.0f,
+            0.0f, 0.0f, 0.0f, 0.0f, 5.0f,
+            1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+        };
+        ASSERT_TRUE(bitmap->Init({ 5, 4, Bitmap::Format::R32_Float, data }));
+    }
+
+    BitmapTexture texture(bitmap);
+    ASSERT_EQ(3u, texture.GetNumMipLevels());
+
+    const auto computeMean = [](const Bitmap& mip)
+    {
+        float sum = 0.0f;
+        for (uint32 y = 0; y < mip.GetHeight(); ++y)
+        {
+            for (uint32 x = 0; x < mip.GetWidth(); ++x)
+            {
+                sum += mip.GetPixel(x, y).x;
+            }
+        }
+        return sum / static_cast<float>(mip.GetWidth() * mip.GetHeight());
+    };
+
+    // every source texel contributes, so the mean is preserved
+    const float baseMean = computeMean(*bitmap);
+    for (uint32 level = 1; level < texture.GetNumMipLevels(); ++level)
+    {
+        SCOPED_TRACE("level=" + std::to_string(level));
+        EXPECT_NEAR(baseMean, computeMean(texture.GetMipLevel(level)), 0.01f);
+    }
+
+    // 3-tap filter along the odd dimension: weights 2/5, 2/5, 1/5 and 1/5, 2/5, 2/5
+    const Bitmap& mip = texture.GetMipLevel(1);
+    ASSERT_EQ(2u, mip.GetWidth());
+    ASSERT_EQ(2u, mip.GetHeight());
+    EXPECT_NEAR(0.0f, mip.GetPixel(0, 0).x, 0.01f);
+    EXPECT_NEAR(0.4f * 5.0f, mip.GetPixel(1, 0).x, 0.01f);
+    EXPECT_NEAR(0.5f, mip.GetPixel(0, 1).x, 0.01f);
+    EXPECT_NEAR(0.5f * (0.4f * 5.0f + 1.0f), mip.GetPixel(1, 1).x, 0.01f);
+}
+
+TEST(BitmapTest, Texture_ValueRange)
+{
+    // odd size, so that the min/max pyramid has partially covered entries
+    const uint32 width = 77;
+    const uint32 height = 45;
+
+    Random random;
+
+    DynArray<float> data;
+    data.Resize(width * height);
+    for (float& value : data)
+    {
+        value = random.GetFloat();
+    }
+
+    BitmapPtr bitmap = std::make_shared<Bitmap>();
+    ASSERT_TRUE(bitmap->Init({ width, height, Bitmap::Format::R32_Float, data.Data() }));
+
+    BitmapTexture texture(bitmap);
+
+    for (uint32 i = 0; i < 1000; ++i)
+    {
+        SCOPED_TRACE("i=" + std::to_string(i));
+
+        // boxes of various sizes, including ones crossing texture edges
+        const float size = random.GetFloat() * (i % 2 ? 1.5f : 0.1f);
+        const Vector4 minCoords = Vector4(random.GetFloat() * 3.0f - 1.0f, random.GetFloat() * 3.0f - 1.0f, 0.0f, 0.0f);
+        const Vector4 maxCoords = minCoords + Vector4(size, size * random.GetFloat(), 0.0f, 0.0f);
+
+        Vector4 minValue, maxValue;
+        ASSERT_TRUE(texture.GetValueRange(minCoords, maxCoords, minValue, maxValue));
+
+        // range must bound values evaluated anywhere within the box
+        for (uint32 j = 0; j < 100; ++j)
+        {
+            const Vector4 coords = Vector4::Lerp(minCoords, maxCoords, Vector4(random.GetFloat(), random.GetFloat(), 0.0f, 0.0f));
+            const float value = texture.Evaluate(coords).x;
+            ASSERT_LE(minValue.x, value);
+            ASSERT_GE(maxValue.x, value);
+        }
+    }
+
+    // whole texture
+    Vector4 minValue, maxValue;
+    ASSERT_TRUE(texture.GetValueRange(Vector4::Zero(), Vector4(1.0f), minValue, maxValue));
+    EXPECT_EQ(*std::min_element(data.begin(), data.end()), minValue.x);
+    EXPECT_EQ(*std::max_element(data.begin(), data.end()), maxValue.x);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void Validate_BlockCompressionModes(const Bitmap& bitmap)
+{
+    const Bitmap::BlockCompressionMode prevMode = Bitmap::GetBlockCompressionMode();
+
+    for (uint32 y = 0; y < bitmap.GetHeight(); ++y)
+    {
+        SCOPED_TRACE("y=" + std::to_string(y));
+
+        for (uint32 x = 0; x < bitmap.GetWidth(); ++x)
+        {
+            SCOPED_TRACE("x=" + std::to_string(x));
+
+            Bitmap::SetBlockCompressionMode(Bitmap::BlockCompressionMode::Direct);
+            const Vector4 expected = bitmap.GetPixel(x, y);
+
+            Bitmap::SetBlockCompressionMode(Bitmap::BlockCompressionMode::Cached);
+            const Vector4 actual = bitmap.GetPixel(x, y);
+            CompareVector(expected, actual, 0.00001f);
+        }
+    }
+
+    Bitmap::SetBlockCompressionMode(prevMode);
+}
+
+TEST(BitmapTest, Format_BC1)
+{
+    Bitmap bitmap;
+    {
+        const uint8 data[] =
+        {
+            // red to blue
+            0x00, 0xF8,     0x1F, 0x00,     0xE4, 0x1B, 0x4E, 0xB1,
+            // green to black
+            0xE0, 0x07,     0x00, 0x00,     0x00, 0x55, 0xAA, 0xFF,
+        };
+        ASSERT_TRUE(bitmap.Init({ 8, 4, Bitmap::Format::BC1, data }));
+    }
+
+    // index 0 - first color, index 1 - second color
+    CompareVector(Vector4(1.0f, 0.0f, 0.0f, 0.0f), bitmap.GetPixel(0, 0), 0.00001f);
+    CompareVector(Vector4(0.0f, 0.0f, 1.0f, 0.0f), bitmap.GetPixel(1, 0), 0.00001f);
+    CompareVector(Vector4(0.0f, 1.0f, 0.0f, 0.0f), bitmap.GetPixel(4, 0), 0.00001f);
+    CompareVector(Vector4(0.0f, 0.0f, 0.0f, 0.0f), bitmap.GetPixel(4, 1), 0.00001f);
+
+    Validate_BlockCompressionModes(bitmap);
+}
+
+TEST(BitmapTest, Format_BC4)
+{
+    Bitmap bitmap;
+    {
+        const uint8 data[] =
+        {
+            // 8-value mode
+            200, 10,    0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA,
+            // 6-value mode
+            10, 200,    0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA,
+        };
+        ASSERT_TRUE(bitmap.Init({ 8, 4, Bitmap::Format::BC4, data }));
+    }
+
+    CompareVector(Vector4(200.0f / 255.0f, 200.0f / 255.0f, 200.0f / 255.0f, 1.0f), bitmap.GetPixel(0, 0), 0.00001f);
+    CompareVector(Vector4(10.0f / 255.0f, 10.0f / 255.0f, 10.0f / 255.0f, 1.0f), bitmap.GetPixel(4, 0), 0.00001f);
+
+    Validate_BlockCompressionModes(bitmap);
+}
+
+TEST(BitmapTest, Format_BC4_WideRows)
+{
+    // row pitch is a multiple of the decoded block cache size
+    const uint32 width = 256;
+    const uint32 height = 8;
+
+    DynArray<uint8> data;
+    data.Resize(width * height / 2);
+    for (uint32 i = 0; i < data.Size(); ++i)
+    {
+        data[i] = static_cast<uint8>((i * 37u) ^ (i >> 3u));
+    }
+
+    Bitmap bitmap;
+    ASSERT_TRUE(bitmap.Init({ width, height, Bitmap::Format::BC4, data.Data() }));
+
+    Validate_BlockCompressionModes(bitmap);
+}
+
+TEST(BitmapTest, Format_BC5)
+{
+    Bitmap bitmap;
+    {
+        const uint8 data[] =
+        {
+            200, 10,    0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA,
+            10, 200,    0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA,
+        };
+        ASSERT_TRUE(bitmap.Init({ 4, 4, Bitmap::Format::BC5, data }));
+    }
+
+    Validate_BlockCompressionModes(bitmap);
+}
+
+TEST(BitmapTest, EncodeBlock)
+{
+    Vector4 texels[16];
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        // red and green are anti-correlated
+        const float t = static_cast<float>(i) / 15.0f;
+        texels[i] = Vector4(1.0f - t, t, 0.25f + 0.5f * t, 0.0f);
+    }
+
+    uint8 blockData[16];
+    Vector4 decoded[16];
+
+    EncodeBlockBC1(texels, blockData);
+    DecodeBlockBC1(blockData, decoded);
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        // half of the distance between palette entries
+        CompareVector(texels[i], decoded[i], 0.17f);
+    }
+
+    EncodeBlockBC4(texels, blockData);
+    DecodeBlockBC4(blockData, decoded);
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        EXPECT_NEAR(texels[i].x, decoded[i].x, 0.075f);
+    }
+
+    EncodeBlockBC5(texels, blockData);
+    DecodeBlockBC5(blockData, decoded);
+    for (uint32 i = 0; i < 16; ++i)
+    {
+        EXPECT_NEAR(texels[i].x, decoded[i].x, 0.075f);
+        EXPECT_NEAR(texels[i].y, decoded[i].y, 0.075f);
+    }
+}
+
+static void Validate_MipLevel(const BitmapTexture& texture, uint32 level, float maxError)
+{
+    SCOPED_TRACE("level=" + std::to_string(level));
+
+    const Bitmap& source = texture.GetMipLevel(level - 1u);
+    const Bitmap& mip = texture.GetMipLevel(level);
+
+    for (uint32 y = 0; y < mip.GetHeight(); ++y)
+    {
+        for (uint32 x = 0; x < mip.GetWidth(); ++x)
+        {
+            const Vector4 expected = 0.25f * (
+                source.GetPixel(2 * x, 2 * y) + source.GetPixel(2 * x + 1, 2 * y) +
+                source.GetPixel(2 * x, 2 * y + 1) + source.GetPixel(2 * x + 1, 2 * y + 1));
+            CompareVector(expected, mip.GetPixel(x, y), maxError);
+        }
+    }
+}
+
+TEST(BitmapTest, Texture_MipLevels_BC1)
+{
+    const uint32 size = 16;
+
+    DynArray<uint8> data;
+    data.Resize(size * size / 2);
+    for (uint32 blockY = 0; blockY < size / 4; ++blockY)
+    {
+        for (uint32 blockX = 0; blockX < size / 4; ++blockX)
+        {
+            Vector4 texels[16];
+            for (uint32 i = 0; i < 16; ++i)
+            {
+                const float u = static_cast<float>(4 * blockX + i % 4) / static_cast<float>(size - 1);
+                const float v = static_cast<float>(4 * blockY + i / 4) / static_cast<float>(size - 1);
+                const float t = 0.5f * (u + v);
+                texels[i] = Vector4(t, 1.0f - t, 0.5f * t, 0.0f);
+            }
+            EncodeBlockBC1(texels, data.Data() + 8 * (blockY * (size / 4) + blockX));
+        }
+    }
+
+    BitmapPtr bitmap = std::make_shared<Bitmap>();
+    ASSERT_TRUE(bitmap->Init({ size, size, Bitmap::Format::BC1, data.Data() }));
+
+    BitmapTexture texture(bitmap);
+    ASSERT_EQ(5u, texture.GetNumMipLevels());
+
+    // levels stay block-compressed as long as block decoders can handle them
+    EXPECT_EQ(Bitmap::Format::BC1, texture.GetMipLevel(1).GetFormat());
+    EXPECT_EQ(Bitmap::Format::BC1, texture.GetMipLevel(2).GetFormat());
+    EXPECT_EQ(Bitmap::Format::R8G8B8A8_UNorm, texture.GetMipLevel(3).GetFormat());
+    EXPECT_EQ(Bitmap::Format::R8G8B8A8_UNorm, texture.GetMipLevel(4).GetFormat());
+    EXPECT_EQ(bitmap->GetDataSize() / 4, texture.GetMipLevel(1).GetDataSize());
+
+    // block compression error is too large for per-texel comparison, but the mean must be roughly preserved
+    // (a single 4x4 block of a linear ramp has many texels exactly between two palette entries)
+    const auto computeMean = [](const Bitmap& mip)
+    {
+        Vector4 sum = Vector4::Zero();
+        for (uint32 y = 0; y < mip.GetHeight(); ++y)
+        {
+            for (uint32 x = 0; x < mip.GetWidth(); ++x)
+            {
+                sum += mip.GetPixel(x, y);
+            }
+        }
+        return sum / static_cast<float>(mip.GetWidth() * mip.GetHeight());
+    };
+
+    const Vector4 baseMean = computeMean(*bitmap);
+    for (uint32 level = 1; level < texture.GetNumMipLevels(); ++level)
+    {
+        SCOPED_TRACE("level=" + std::to_string(level));
+        CompareVector(baseMean, computeMean(texture.GetMipLevel(level)), 0.06f);
+    }
+}
+
+TEST(BitmapTest, Texture_MipLevels_UNorm8)
+{
+    const uint32 size = 8;
+
+    uint8 data[size * size * 4];
+    for (uint32 i = 0; i < size * size; ++i)
+    {
+        data[4 * i + 0] = static_cast<uint8>(i * 4);
+        data[4 * i + 1] = static_cast<uint8>(255 - i * 4);
+        data[4 * i + 2] = static_cast<uint8>((i % 2) * 255);
+        data[4 * i + 3] = 255;
+    }
+
+    BitmapPtr bitmap = std::make_shared<Bitmap>();
+    {
+        Bitmap::InitData initData = { size, size, Bitmap::Format::R8G8B8A8_UNorm, data };
+        initData.linearSpace = false;
+        ASSERT_TRUE(bitmap->Init(initData));
+    }
+
+    BitmapTexture texture(bitmap);
+    ASSERT_EQ(4u, texture.GetNumMipLevels());
+
+    for (uint32 level = 1; level < texture.GetNumMipLevels(); ++level)
+    {
+        EXPECT_EQ(Bitmap::Format::R8G8B8A8_UNorm, texture.GetMipLevel(level).GetFormat());
+        Validate_MipLevel(texture, level, 0.01f);
+    }
+}
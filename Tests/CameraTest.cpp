@@ -0,0 +1,96 @@
+#include "PCH.h"
+#include "../Core/Scene/Camera.h"
+#include "../Core/Rendering/Context.h"
+#include "../Core/Rendering/RendererContext.h"
+#include "../Core/Math/Random.h"
+#include "../Core/Math/Simd8Ray.h"
+
+using namespace rt;
+using namespace rt::math;
+
+namespace {
+
+void ValidateSimdRayGeneration(const Camera& camera)
+{
+    ASSERT_TRUE(camera.SupportsRayGeneration_Simd8());
+
+    Random random;
+
+    // scalar and SIMD contexts draw aperture samples from the same sequence
+    Random scalarSamplerRandom;
+    Random simdSamplerRandom = scalarSamplerRandom;
+
+    RenderingContext scalarContext;
+    scalarContext.sampler.fallbackGenerator = &scalarSamplerRandom;
+
+    RenderingContext simdContext;
+    simdContext.sampler.fallbackGenerator = &simdSamplerRandom;
+
+    for (uint32 iteration = 0; iteration < 1000; ++iteration)
+    {
+        Vector2x8 coords;
+        Vector2x8 apertureSamples = Vector2x8::Zero();
+        Ray scalarRays[8];
+
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            coords.x[i] = random.GetFloat();
+            coords.y[i] = random.GetFloat();
+            scalarRays[i] = camera.GenerateRay(Vector4(coords.x[i], coords.y[i], 0.0f, 0.0f), scalarContext);
+
+            if (camera.mDOF.enable)
+            {
+                apertureSamples.x[i] = simdContext.sampler.GetFloat();
+                apertureSamples.y[i] = simdContext.sampler.GetFloat();
+            }
+        }
+
+        const Ray_Simd8 simdRays = camera.GenerateRay_Simd8(coords, apertureSamples, simdContext);
+
+        Vector4 origins[8];
+        Vector4 directions[8];
+        simdRays.origin.Unpack(origins);
+        simdRays.dir.Unpack(directions);
+
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            SCOPED_TRACE("lane " + std::to_string(i));
+
+            for (uint32 j = 0; j < 3; ++j)
+            {
+                EXPECT_NEAR(scalarRays[i].origin[j], origins[i][j], 1.0e-5f);
+                EXPECT_NEAR(scalarRays[i].dir[j], directions[i][j], 1.0e-5f);
+            }
+        }
+    }
+}
+
+} // namespace
+
+// 8-wide camera ray generation must match the scalar version
+TEST(CameraTest, GenerateRay_Simd8)
+{
+    Camera camera;
+    camera.SetTransform(Transform(Vector4(1.0f, 2.0f, -3.0f), Quaternion::FromEulerAngles(Float3(0.1f, 0.2f, 0.3f))));
+    camera.SetPerspective(1.5f, DegToRad(60.0f));
+
+    ValidateSimdRayGeneration(camera);
+}
+
+TEST(CameraTest, GenerateRay_Simd8_DoF)
+{
+    Camera camera;
+    camera.SetTransform(Transform(Vector4(1.0f, 2.0f, -3.0f), Quaternion::FromEulerAngles(Float3(0.1f, 0.2f, 0.3f))));
+    camera.SetPerspective(1.5f, DegToRad(60.0f));
+    camera.mDOF.enable = true;
+    camera.mDOF.aperture = 0.2f;
+    camera.mDOF.focalPlaneDistance = 5.0f;
+
+    for (const BokehShape bokehShape : { BokehShape::Circle, BokehShape::Square })
+    {
+        SCOPED_TRACE("bokeh shape " + std::to_string(static_cast<uint32>(bokehShape)));
+
+        camera.mDOF.bokehShape = bokehShape;
+        ValidateSimdRayGeneration(camera);
+    }
+}
@@ -0,0 +1,95 @@
+#include "PCH.h"
+#include "../Core/Scene/DecalGrid.h"
+#include "../Core/Scene/Object/SceneObject_Decal.h"
+#include "../Core/Math/Random.h"
+
+using namespace rt;
+using namespace rt::math;
+
+TEST(DecalGridTest, Empty)
+{
+    DecalGrid grid;
+    ASSERT_TRUE(grid.Build({}));
+    EXPECT_TRUE(grid.Empty());
+    EXPECT_TRUE(grid.Find(Vector4::Zero()).Empty());
+}
+
+// there is no limit on number of decals overlapping a single point
+TEST(DecalGridTest, ManyOverlappingDecals)
+{
+    const uint32 numDecals = 1000;
+
+    Random random;
+    DynArray<std::unique_ptr<DecalSceneObject>> objects;
+    DynArray<const DecalSceneObject*> decals;
+    for (uint32 i = 0; i < numDecals; ++i)
+    {
+        std::unique_ptr<DecalSceneObject> decal = std::make_unique<DecalSceneObject>();
+        decal->SetTransform(Matrix4::MakeScaling(Vector4(1.0f + random.GetFloat())));
+        decal->order = random.GetInt() % 100;
+        decals.PushBack(decal.get());
+        objects.PushBack(std::move(decal));
+    }
+
+    DecalGrid grid;
+    ASSERT_TRUE(grid.Build(decals));
+
+    const auto foundDecals = grid.Find(Vector4(0.1f, -0.2f, 0.3f));
+    ASSERT_EQ(numDecals, foundDecals.Size());
+
+    for (uint32 i = 1; i < foundDecals.Size(); ++i)
+    {
+        EXPECT_GE(foundDecals[i - 1]->order, foundDecals[i]->order);
+    }
+
+    // outside of all the decals
+    EXPECT_TRUE(grid.Find(Vector4(10.0f, 0.0f, 0.0f)).Empty());
+}
+
+// grid query must return (at least) all decals with bounding box containing the point, in application order
+TEST(DecalGridTest, ScatteredDecals)
+{
+    const uint32 numDecals = 2000;
+    const uint32 numQueries = 10000;
+
+    Random random;
+    DynArray<std::unique_ptr<DecalSceneObject>> objects;
+    DynArray<const DecalSceneObject*> decals;
+    for (uint32 i = 0; i < numDecals; ++i)
+    {
+        std::unique_ptr<DecalSceneObject> decal = std::make_unique<DecalSceneObject>();
+        const Vector4 position = random.GetVector4Bipolar() * 50.0f;
+        const Vector4 scale = Vector4(0.1f) + random.GetVector4() * 2.0f;
+        decal->SetTransform(Matrix4::MakeTranslation(position) * Matrix4::MakeScaling(scale));
+        decal->order = random.GetInt() % 10;
+        decals.PushBack(decal.get());
+        objects.PushBack(std::move(decal));
+    }
+
+    DecalGrid grid;
+    ASSERT_TRUE(grid.Build(decals));
+
+    for (uint32 i = 0; i < numQueries; ++i)
+    {
+        const Vector4 point = random.GetVector4Bipolar() * 52.0f;
+        const auto foundDecals = grid.Find(point);
+
+        for (uint32 j = 1; j < foundDecals.Size(); ++j)
+        {
+            ASSERT_GE(foundDecals[j - 1]->order, foundDecals[j]->order);
+        }
+
+        for (const DecalSceneObject* decal : decals)
+        {
+            if (decal->GetBoundingBox().Intersects(point))
+            {
+                bool found = false;
+                for (const DecalSceneObject* foundDecal : foundDecals)
+                {
+                    found |= foundDecal == decal;
+                }
+                ASSERT_TRUE(found);
+            }
+        }
+    }
+}
@@ -723,4 +723,113 @@ TEST(DynArray, Erase_Range_Empty)
 
     EXPECT_FALSE(array.Erase(array.End(), array.End()));
     ASSERT_EQ(5u, array.Size());
-}
\ No newline at end of file
+}
+TEST(DynArray, LargePolicy)
+{
+    LargeDynArray<int> array;
+    static_assert(std::is_same<size_t, decltype(array.Size())>::value, "Large array must use 64-bit sizes");
+    static_assert(sizeof(LargeDynArray<int>) == sizeof(void*) + 2 * sizeof(size_t), "Invalid LargeDynArray size");
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_NE(array.End(), array.PushBack(i));
+    }
+
+    ASSERT_EQ(1000u, array.Size());
+    EXPECT_EQ(999, array.Back());
+    EXPECT_EQ(array.Begin() + 500, array.Find(500));
+
+    ASSERT_TRUE(array.Erase(array.Begin(), array.Begin() + 10));
+    EXPECT_EQ(990u, array.Size());
+    EXPECT_EQ(10, array.Front());
+}
+
+TEST(DynArray, Reserve_TooBig)
+{
+    DynArray<uint64> array;
+    EXPECT_FALSE(array.Reserve(std::numeric_limits<uint32>::max()));
+    EXPECT_EQ(0u, array.Capacity());
+
+    LargeDynArray<uint64> largeArray;
+    EXPECT_FALSE(largeArray.Reserve(std::numeric_limits<size_t>::max() / 4));
+    EXPECT_EQ(0u, largeArray.Capacity());
+}
+
+namespace {
+
+struct DoublingPolicy : public DynArrayPolicy
+{
+    static constexpr uint32 GrowthNumerator = 2;
+    static constexpr uint32 GrowthDenominator = 1;
+};
+
+} // namespace
+
+TEST(DynArray, GrowthPolicy)
+{
+    DynArray<int, DefaultAllocator, DoublingPolicy> array;
+
+    uint32 numReallocations = 0;
+    uint32 prevCapacity = 0;
+    for (int i = 0; i < 1024; ++i)
+    {
+        array.PushBack(i);
+        if (array.Capacity() != prevCapacity)
+        {
+            if (prevCapacity > 0)
+            {
+                EXPECT_EQ(2 * prevCapacity, array.Capacity());
+            }
+            prevCapacity = array.Capacity();
+            numReallocations++;
+        }
+    }
+
+    EXPECT_EQ(11u, numReallocations);
+    EXPECT_EQ(1024u, array.Capacity());
+}
+
+TEST(DynArray, Relocation_NestedArrays)
+{
+    // inner arrays are relocated with memcpy when the outer array grows
+    static_assert(IsTriviallyRelocatable<DynArray<int>>::value, "DynArray must be trivially relocatable");
+
+    DynArray<DynArray<int>> array;
+    for (int i = 0; i < 100; ++i)
+    {
+        array.PushBack(DynArray<int>({ i, 2 * i, 3 * i }));
+    }
+
+    ASSERT_EQ(100u, array.Size());
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(3u, array[i].Size());
+        EXPECT_EQ(i, array[i][0]);
+        EXPECT_EQ(2 * i, array[i][1]);
+        EXPECT_EQ(3 * i, array[i][2]);
+    }
+
+    array.Erase(array.Begin());
+    EXPECT_EQ(1, array[0][0]);
+}
+
+TEST(DynArray, Relocation_NonTrivialType)
+{
+    using TestClass = MoveOnlyTestClass<int>;
+    static_assert(!IsTriviallyRelocatable<TestClass>::value, "Test class must not be trivially relocatable");
+
+    ClassMethodCallCounters counters;
+    {
+        DynArray<TestClass> array;
+        for (int i = 0; i < 10; ++i)
+        {
+            array.EmplaceBack(&counters, i);
+        }
+
+        // every reallocation moves existing elements with move constructor
+        EXPECT_EQ(10, counters.constructor);
+        EXPECT_GT(counters.moveConstructor, 0);
+        EXPECT_EQ(0, counters.destructor);
+    }
+    EXPECT_EQ(10, counters.destructor);
+}
@@ -0,0 +1,88 @@
+#include "PCH.h"
+#include "../Core/Material/Material.h"
+#include "../Core/Rendering/ShadingData.h"
+#include "../Core/Color/Spectrum.h"
+#include "../Core/Textures/BitmapTexture.h"
+#include "../Core/Textures/CheckerboardTexture.h"
+#include "../Core/Utils/Bitmap.h"
+
+using namespace rt;
+using namespace rt::math;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static TexturePtr CreateTestTexture(uint32 type)
+{
+    if (type == 1)
+    {
+        const float data[] =
+        {
+            0.1f, 0.2f, 0.3f, 0.4f,     0.5f, 0.6f, 0.7f, 0.8f,
+            0.9f, 1.0f, 0.5f, 0.5f,     0.25f, 0.75f, 1.0f, 0.0f,
+        };
+
+        BitmapPtr bitmap = std::make_shared<Bitmap>();
+        bitmap->Init({ 2, 2, Bitmap::Format::R32G32B32A32_Float, data });
+        return std::make_shared<BitmapTexture>(bitmap);
+    }
+    else if (type == 2)
+    {
+        Vector4 colorB(0.2f, 0.4f, 0.6f, 0.0f);
+        return std::make_shared<CheckerboardTexture>(Vector4(0.8f, 0.6f, 0.4f, 0.0f), colorB);
+    }
+
+    return nullptr;
+}
+
+// specialized evaluation paths selected in Material::Compile() must match generic parameter evaluation
+TEST(MaterialTest, EvaluateShadingData_Specialized)
+{
+    const Vector4 texCoords[] =
+    {
+        Vector4(0.25f, 0.25f, 0.0f, 0.0f),
+        Vector4(0.7f, 0.2f, 0.0f, 0.0f),
+        Vector4(0.4f, 0.9f, 0.0f, 0.0f),
+    };
+
+    const Wavelength wavelength;
+
+    // 0 - constant, 1 - bitmap texture, 2 - other texture
+    for (uint32 baseColorType = 0; baseColorType < 3; ++baseColorType)
+    {
+        for (uint32 emissionType = 0; emissionType < 3; ++emissionType)
+        {
+            for (uint32 roughnessType = 0; roughnessType < 3; ++roughnessType)
+            {
+                SCOPED_TRACE("baseColor=" + std::to_string(baseColorType) + " emission=" + std::to_string(emissionType) + " roughness=" + std::to_string(roughnessType));
+
+                Material material;
+                material.baseColor = Vector4(0.9f, 0.5f, 0.25f, 0.0f);
+                material.baseColor.texture = CreateTestTexture(baseColorType);
+                material.emission = Vector4(2.0f, 3.0f, 4.0f, 0.0f);
+                material.emission.texture = CreateTestTexture(emissionType);
+                material.roughness = 0.5f;
+                material.roughness.texture = CreateTestTexture(roughnessType);
+                material.metalness = 0.25f;
+                material.metalness.texture = CreateTestTexture(2 - roughnessType);
+                material.IoR = 1.33f;
+                material.Compile();
+
+                for (const Vector4& texCoord : texCoords)
+                {
+                    ShadingData shadingData;
+                    shadingData.intersection.texCoord = texCoord;
+                    material.EvaluateShadingData(wavelength, shadingData);
+
+                    const RayColor expectedBaseColor = RayColor::Resolve(wavelength, Spectrum(material.baseColor.Evaluate(texCoord)));
+                    const RayColor expectedEmission = RayColor::Resolve(wavelength, Spectrum(material.emission.Evaluate(texCoord)));
+
+                    EXPECT_TRUE((shadingData.materialParams.baseColor.value == expectedBaseColor.value).All());
+                    EXPECT_TRUE((shadingData.materialParams.emissionColor.value == expectedEmission.value).All());
+                    EXPECT_EQ(material.roughness.Evaluate(texCoord), shadingData.materialParams.roughness);
+                    EXPECT_EQ(material.metalness.Evaluate(texCoord), shadingData.materialParams.metalness);
+                    EXPECT_EQ(1.33f, shadingData.materialParams.IoR);
+                }
+            }
+        }
+    }
+}
@@ -59,3 +59,21 @@ TEST(MathTest, Distribution_MultipleValues)
         EXPECT_LT(Abs(expected - counters[i]), 200);
     }
 }
+
+TEST(MathTest, Distribution_RemappedSample)
+{
+    const float p[] = { 0.25f, 0.0f, 0.75f };
+    Distribution distr;
+    ASSERT_TRUE(distr.Initialize(p, 3));
+
+    float pdf = 0.0f;
+    float remappedU = 0.0f;
+
+    EXPECT_EQ(0u, distr.SampleDiscrete(0.125f, pdf, remappedU));
+    EXPECT_NEAR(0.5f, remappedU, 0.0001f);
+    EXPECT_NEAR(0.75f, pdf, 0.0001f);
+
+    EXPECT_EQ(2u, distr.SampleDiscrete(0.625f, pdf, remappedU));
+    EXPECT_NEAR(0.5f, remappedU, 0.0001f);
+    EXPECT_NEAR(2.25f, pdf, 0.0001f);
+}
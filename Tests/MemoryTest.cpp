@@ -0,0 +1,116 @@
+#include "PCH.h"
+#include "../Core/Utils/Memory.h"
+#include "../Core/Containers/DynArray.h"
+
+using namespace rt;
+
+namespace {
+
+void TestSystemAllocator()
+{
+    const size_t sizes[] = { 1, 100, 4096, 64 * 1024, 3 * 1024 * 1024 + 7, 16 * 1024 * 1024 };
+    const size_t alignments[] = { 1, 16, 64, 4096 };
+
+    for (const size_t size : sizes)
+    {
+        for (const size_t alignment : alignments)
+        {
+            SCOPED_TRACE("size=" + std::to_string(size) + ", alignment=" + std::to_string(alignment));
+
+            uint8* ptr = static_cast<uint8*>(SystemAllocator::Allocate(size, alignment));
+            ASSERT_NE(nullptr, ptr);
+            EXPECT_EQ(0u, reinterpret_cast<size_t>(ptr) % alignment);
+
+            // no bookkeeping data in front of the allocation, so it starts at a page boundary
+            EXPECT_EQ(0u, reinterpret_cast<size_t>(ptr) % 4096u);
+
+            // whole range must be writable
+            memset(ptr, 0xAB, size);
+            EXPECT_EQ(0xAB, ptr[0]);
+            EXPECT_EQ(0xAB, ptr[size - 1]);
+
+            SystemAllocator::Free(ptr);
+        }
+    }
+
+    EXPECT_EQ(nullptr, SystemAllocator::Allocate(0));
+}
+
+} // namespace
+
+TEST(MemoryTest, SystemAllocator)
+{
+    TestSystemAllocator();
+}
+
+TEST(MemoryTest, SystemAllocator_LargePages)
+{
+    MemoryInitOptions options;
+    options.useLargePages = true;
+    InitMemory(options);
+
+    TestSystemAllocator();
+
+    InitMemory();
+}
+
+TEST(MemoryTest, FrameAllocator)
+{
+    FrameAllocatorScope scope;
+
+    const FrameAllocator::Marker marker = FrameAllocator::GetMarker();
+
+    const size_t alignments[] = { 1, 4, 16, 64, 256 };
+    for (const size_t alignment : alignments)
+    {
+        uint8* ptr = static_cast<uint8*>(FrameAllocator::Allocate(13, alignment));
+        ASSERT_NE(nullptr, ptr);
+        EXPECT_EQ(0u, reinterpret_cast<size_t>(ptr) % alignment);
+        memset(ptr, 0xAB, 13);
+    }
+
+    // bigger than any chunk allocated so far
+    const size_t bigSize = 2 * FrameAllocator::GetArenaSize() + 1;
+    uint8* bigPtr = static_cast<uint8*>(FrameAllocator::Allocate(bigSize, 16));
+    ASSERT_NE(nullptr, bigPtr);
+    memset(bigPtr, 0xCD, bigSize);
+
+    // memory is reused after restoring the marker
+    FrameAllocator::Restore(marker);
+    void* first = FrameAllocator::Allocate(13, 1);
+    FrameAllocator::Restore(marker);
+    EXPECT_EQ(first, FrameAllocator::Allocate(13, 1));
+
+    EXPECT_EQ(nullptr, FrameAllocator::Allocate(0));
+}
+
+TEST(MemoryTest, FrameAllocator_SteadyState)
+{
+    const auto simulateFrame = []()
+    {
+        FrameAllocatorScope scope;
+
+        DynArray<uint32, FrameAllocator> array;
+        for (uint32 i = 0; i < 100000; ++i)
+        {
+            array.PushBack(i);
+        }
+
+        DynArray<float, FrameAllocator> otherArray(1000);
+        otherArray[999] = 1.0f;
+
+        EXPECT_EQ(99999u, array.Back());
+    };
+
+    // first frame fills the arena
+    simulateFrame();
+
+    const uint64 numAllocationsBefore = GetNumHeapAllocations();
+
+    for (uint32 i = 0; i < 10; ++i)
+    {
+        simulateFrame();
+    }
+
+    EXPECT_EQ(numAllocationsBefore, GetNumHeapAllocations());
+}
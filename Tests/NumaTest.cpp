@@ -0,0 +1,101 @@
+#include "PCH.h"
+#include "../Core/Utils/Numa.h"
+#include "../Core/Utils/Memory.h"
+#include "../Core/Utils/ThreadPool.h"
+
+using namespace rt;
+
+TEST(NumaTest, Topology)
+{
+    const uint32 numNodes = Numa::GetNumNodes();
+    ASSERT_GE(numNodes, 1u);
+    ASSERT_LE(numNodes, MaxNumaNodes);
+
+    for (uint32 i = 0; i < numNodes; ++i)
+    {
+        EXPECT_GT(Numa::GetNumNodeProcessors(i), 0u);
+    }
+}
+
+TEST(NumaTest, Replicas)
+{
+    MemoryInitOptions options;
+    options.replicateOnNumaNodes = true;
+    InitMemory(options);
+
+    DynArray<uint32> data(100000);
+    for (uint32 i = 0; i < data.Size(); ++i)
+    {
+        data[i] = i * 7919u;
+    }
+
+    NumaReplicas replicas;
+    ASSERT_TRUE(replicas.Create(data.Data(), sizeof(uint32) * data.Size()));
+
+    for (uint32 node = 0; node < Numa::GetNumNodes(); ++node)
+    {
+        const void* replica = replicas.Get(node);
+
+        if (Numa::GetNumNodes() > 1)
+        {
+            ASSERT_NE(nullptr, replica);
+            EXPECT_NE(static_cast<const void*>(data.Data()), replica);
+            EXPECT_EQ(0, memcmp(data.Data(), replica, sizeof(uint32) * data.Size()));
+        }
+        else
+        {
+            // no replication on single-node machines
+            EXPECT_EQ(nullptr, replica);
+        }
+    }
+
+    replicas.Clear();
+    EXPECT_EQ(nullptr, replicas.Get(0));
+
+    InitMemory();
+
+    // replication is disabled by default
+    ASSERT_TRUE(replicas.Create(data.Data(), sizeof(uint32) * data.Size()));
+    EXPECT_EQ(nullptr, replicas.Get(0));
+}
+
+TEST(NumaTest, ThreadPool_Pinning)
+{
+    const uint32 numNodes = Numa::GetNumNodes();
+
+    ThreadPool threadPool;
+    threadPool.SetNumThreads(4 * numNodes, true);
+    ASSERT_EQ(4 * numNodes, threadPool.GetNumThreads());
+
+    // every node gets at least one thread and threads are assigned in order
+    DynArray<uint32> threadsPerNode(numNodes);
+    for (uint32 i = 0; i < numNodes; ++i)
+    {
+        threadsPerNode[i] = 0;
+    }
+
+    for (uint32 i = 0; i < threadPool.GetNumThreads(); ++i)
+    {
+        const uint32 node = threadPool.GetThreadNumaNode(i);
+        ASSERT_LT(node, numNodes);
+        if (i > 0)
+        {
+            EXPECT_GE(node, threadPool.GetThreadNumaNode(i - 1));
+        }
+        threadsPerNode[node]++;
+    }
+
+    for (uint32 i = 0; i < numNodes; ++i)
+    {
+        EXPECT_GT(threadsPerNode[i], 0u);
+    }
+
+    // pinned threads still run tasks
+    std::atomic<uint32> numTasksDone(0);
+    threadPool.RunParallelTask([&numTasksDone](uint32, uint32) { numTasksDone++; }, 100);
+    EXPECT_EQ(100u, numTasksDone.load());
+
+    threadPool.SetNumThreads(2, false);
+    EXPECT_EQ(0u, threadPool.GetThreadNumaNode(0));
+    EXPECT_EQ(0u, threadPool.GetThreadNumaNode(1));
+}
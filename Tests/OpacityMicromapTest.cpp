@@ -0,0 +1,270 @@
+#include "PCH.h"
+#include "../Core/Shapes/MeshShape.h"
+#include "../Core/Shapes/Mesh/OpacityMicromap.h"
+#include "../Core/Material/Material.h"
+#include "../Core/Textures/BitmapTexture.h"
+#include "../Core/Rendering/Context.h"
+#include "../Core/Rendering/RendererContext.h"
+#include "../Core/Traversal/TraversalContext.h"
+#include "../Core/Math/Random.h"
+
+using namespace rt;
+using namespace rt::math;
+
+namespace {
+
+// opaque disk in the middle of the texture
+class DiskMaskTexture : public ITexture
+{
+public:
+    static constexpr float Radius = 0.3f;
+
+    static bool IsInside(const Vector4& coords)
+    {
+        const float dx = coords.x - 0.5f;
+        const float dy = coords.y - 0.5f;
+        return dx * dx + dy * dy < Radius * Radius;
+    }
+
+    virtual const char* GetName() const override { return "disk"; }
+
+    virtual const Vector4 Evaluate(const Vector4& coords) const override
+    {
+        return IsInside(coords) ? Vector4(1.0f) : Vector4::Zero();
+    }
+
+    virtual const Vector4 Sample(const Float2, Vector4& outCoords, float* outPdf) const override
+    {
+        outCoords = Vector4::Zero();
+        if (outPdf)
+        {
+            *outPdf = 0.0f;
+        }
+        return Vector4::Zero();
+    }
+
+    virtual bool MakeSamplable() override { return false; }
+    virtual bool IsSamplable() const override { return false; }
+
+    virtual bool GetValueRange(const Vector4& minCoords, const Vector4& maxCoords, Vector4& outMin, Vector4& outMax) const override
+    {
+        // the closest and the farthest point of the box to the disk center
+        const Vector4 center(0.5f, 0.5f, 0.0f, 0.0f);
+        const Vector4 closest = Vector4::Clamp(center, minCoords, maxCoords);
+        const Vector4 farthest = Vector4::Select(minCoords, maxCoords, (center - minCoords) < (maxCoords - center));
+
+        outMin = IsInside(farthest) ? Vector4(1.0f) : Vector4::Zero();
+        outMax = IsInside(closest) ? Vector4(1.0f) : Vector4::Zero();
+        return true;
+    }
+};
+
+// unit quad in XY plane with texture coordinates equal to XY position, subdivided into (size x size) cells
+MeshShapePtr CreateMaskedQuad(const MaterialPtr& material, uint32 size)
+{
+    std::vector<Float3> positions;
+    std::vector<Float3> normals;
+    std::vector<Float3> tangents;
+    std::vector<Float2> texCoords;
+    std::vector<uint32> indices;
+
+    for (uint32 y = 0; y <= size; ++y)
+    {
+        for (uint32 x = 0; x <= size; ++x)
+        {
+            const float u = static_cast<float>(x) / static_cast<float>(size);
+            const float v = static_cast<float>(y) / static_cast<float>(size);
+            positions.push_back(Float3(u, v, 0.0f));
+            normals.push_back(Float3(0.0f, 0.0f, 1.0f));
+            tangents.push_back(Float3(1.0f, 0.0f, 0.0f));
+            texCoords.push_back(Float2(u, v));
+        }
+    }
+
+    for (uint32 y = 0; y < size; ++y)
+    {
+        for (uint32 x = 0; x < size; ++x)
+        {
+            const uint32 i = y * (size + 1) + x;
+            const uint32 quad[] = { i, i + 1, i + size + 2, i, i + size + 2, i + size + 1 };
+            indices.insert(indices.end(), quad, quad + 6);
+        }
+    }
+
+    const std::vector<uint32> materialIndices(indices.size() / 3, 0);
+
+    MeshDesc meshDesc;
+    meshDesc.path = "maskedQuad";
+    meshDesc.vertexBufferDesc.numTriangles = static_cast<uint32>(materialIndices.size());
+    meshDesc.vertexBufferDesc.numVertices = static_cast<uint32>(positions.size());
+    meshDesc.vertexBufferDesc.numMaterials = 1;
+    meshDesc.vertexBufferDesc.materials = &material;
+    meshDesc.vertexBufferDesc.materialIndexBuffer = materialIndices.data();
+    meshDesc.vertexBufferDesc.vertexIndexBuffer = indices.data();
+    meshDesc.vertexBufferDesc.positions = positions.data();
+    meshDesc.vertexBufferDesc.normals = normals.data();
+    meshDesc.vertexBufferDesc.tangents = tangents.data();
+    meshDesc.vertexBufferDesc.texCoords = texCoords.data();
+
+    MeshShapePtr mesh = std::make_shared<MeshShape>();
+    if (!mesh->Initialize(meshDesc))
+    {
+        return nullptr;
+    }
+
+    return mesh;
+}
+
+} // namespace
+
+// each micro-triangle covers the same area of the triangle
+TEST(OpacityMicromapTest, MicroTriangleIndex)
+{
+    const uint32 numSamples = 640000;
+    const uint32 numSegments = OpacityMicromap::NumSegments;
+    const uint32 numMicroTriangles = OpacityMicromap::NumMicroTriangles;
+
+    uint32 histogram[numMicroTriangles] = { 0 };
+
+    Random random;
+    for (uint32 i = 0; i < numSamples; ++i)
+    {
+        float u = random.GetFloat();
+        float v = random.GetFloat();
+        if (u + v > 1.0f)
+        {
+            u = 1.0f - u;
+            v = 1.0f - v;
+        }
+
+        const uint32 index = OpacityMicromap::GetMicroTriangleIndex(u, v);
+        ASSERT_LT(index, numMicroTriangles);
+        histogram[index]++;
+    }
+
+    // triangle corners
+    EXPECT_EQ(0u, OpacityMicromap::GetMicroTriangleIndex(0.0f, 0.0f));
+    EXPECT_EQ(2 * numSegments - 2, OpacityMicromap::GetMicroTriangleIndex(1.0f, 0.0f));
+    EXPECT_EQ(numMicroTriangles - 1, OpacityMicromap::GetMicroTriangleIndex(0.0f, 1.0f));
+
+    const float expectedCount = static_cast<float>(numSamples) / static_cast<float>(numMicroTriangles);
+    for (uint32 i = 0; i < numMicroTriangles; ++i)
+    {
+        SCOPED_TRACE("micro-triangle " + std::to_string(i));
+        EXPECT_NEAR(expectedCount, static_cast<float>(histogram[i]), 0.05f * expectedCount);
+    }
+}
+
+// closest-hit and shadow traversal must respect material's mask texture
+TEST(OpacityMicromapTest, MaskedMeshTraversal)
+{
+    MaterialPtr material = Material::Create();
+    material->maskMap = std::make_shared<DiskMaskTexture>();
+    material->Compile();
+
+    // both large triangles (crossing the mask edge) and small ones (mostly fully opaque or fully transparent)
+    for (const uint32 quadSize : { 1u, 16u })
+    {
+        SCOPED_TRACE("quad size " + std::to_string(quadSize));
+
+        const MeshShapePtr mesh = CreateMaskedQuad(material, quadSize);
+        ASSERT_NE(nullptr, mesh);
+
+        RenderingContext context;
+        Random random;
+
+        uint32 numHits = 0;
+
+        for (uint32 i = 0; i < 10000; ++i)
+        {
+            const Vector4 coords = random.GetVector4() & Vector4::MakeMask<1,1,0,0>();
+
+            // skip points near the mask edge
+            const float distanceToCenter = (coords - Vector4(0.5f, 0.5f, 0.0f, 0.0f)).Length2();
+            if (Abs(distanceToCenter - DiskMaskTexture::Radius) < 0.01f)
+            {
+                continue;
+            }
+
+            const bool expectedHit = DiskMaskTexture::IsInside(coords);
+            numHits += expectedHit ? 1 : 0;
+
+            const Ray ray(coords + Vector4(0.0f, 0.0f, 1.0f, 0.0f), Vector4(0.0f, 0.0f, -1.0f, 0.0f));
+
+            {
+                HitPoint hitPoint;
+                const SingleTraversalContext traversalContext = { ray, hitPoint, context };
+                mesh->Traverse(traversalContext, 0);
+                ASSERT_EQ(expectedHit, hitPoint.distance < HitPoint::DefaultDistance);
+            }
+
+            {
+                HitPoint hitPoint;
+                const SingleTraversalContext traversalContext = { ray, hitPoint, context };
+                ASSERT_EQ(expectedHit, mesh->Traverse_Shadow(traversalContext));
+            }
+        }
+
+        EXPECT_GT(numHits, 0u);
+    }
+}
+
+// mask features much smaller than micro-triangles must not be lost
+TEST(OpacityMicromapTest, ThinMaskLine)
+{
+    // one-texel-wide opaque vertical line
+    const uint32 size = 64;
+    const uint32 lineX = 37;
+
+    uint8 data[size * size] = { 0 };
+    for (uint32 y = 0; y < size; ++y)
+    {
+        data[size * y + lineX] = 255;
+    }
+
+    BitmapPtr bitmap = std::make_shared<Bitmap>();
+    ASSERT_TRUE(bitmap->Init({ size, size, Bitmap::Format::R8_UNorm, data }));
+
+    MaterialPtr material = Material::Create();
+    material->maskMap = std::make_shared<BitmapTexture>(bitmap);
+    material->Compile();
+
+    // large triangles - each micro-triangle covers several texels
+    const MeshShapePtr mesh = CreateMaskedQuad(material, 1);
+    ASSERT_NE(nullptr, mesh);
+
+    RenderingContext context;
+
+    uint32 numHits = 0;
+
+    // sweep across the line with sub-texel steps
+    for (uint32 i = 0; i < 64; ++i)
+    {
+        for (uint32 j = 0; j < 256; ++j)
+        {
+            const float u = (static_cast<float>(lineX) - 2.0f + static_cast<float>(j) / 64.0f) / static_cast<float>(size);
+            const float v = (static_cast<float>(i) + 0.37f) / static_cast<float>(size);
+            const Vector4 coords(u, v, 0.0f, 0.0f);
+
+            const bool expectedHit = material->GetMaskValue(coords);
+            numHits += expectedHit ? 1 : 0;
+
+            const Ray ray(coords + Vector4(0.0f, 0.0f, 1.0f, 0.0f), Vector4(0.0f, 0.0f, -1.0f, 0.0f));
+
+            {
+                HitPoint hitPoint;
+                const SingleTraversalContext traversalContext = { ray, hitPoint, context };
+                mesh->Traverse(traversalContext, 0);
+                ASSERT_EQ(expectedHit, hitPoint.distance < HitPoint::DefaultDistance);
+            }
+
+            {
+                HitPoint hitPoint;
+                const SingleTraversalContext traversalContext = { ray, hitPoint, context };
+                ASSERT_EQ(expectedHit, mesh->Traverse_Shadow(traversalContext));
+            }
+        }
+    }
+
+    EXPECT_GT(numHits, 0u);
+}
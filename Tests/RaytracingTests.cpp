@@ -1,15 +1,22 @@
 #include "PCH.h"
 #include "../Core/Scene/Scene.h"
+#include "../Core/Math/Random.h"
 #include "../Core/Scene/Camera.h"
 #include "../Core/Rendering/Context.h"
 #include "../Core/Material/Material.h"
 #include "../Core/Rendering/Viewport.h"
 #include "../Core/Rendering/PathTracer.h"
+#include "../Core/Rendering/VertexConnectionAndMerging.h"
 #include "../Core/Scene/Light/BackgroundLight.h"
+#include "../Core/Scene/Light/MeshLight.h"
+#include "../Core/Textures/BitmapTexture.h"
 #include "../Core/Scene/Object/SceneObject_Shape.h"
 #include "../Core/Scene/Object/SceneObject_Light.h"
+#include "../Core/Scene/Object/SceneObject_Decal.h"
 #include "../Core/Shapes/SphereShape.h"
+#include "../Core/Shapes/RectShape.h"
 #include "../Core/Shapes/MeshShape.h"
+#include "../Core/Traversal/TraversalContext.h"
 
 using namespace rt;
 using namespace math;
@@ -238,6 +245,70 @@ rt::MeshShapePtr CreateBoxMesh(const float size, const MaterialPtr& material, bo
 }
 */
 
+// closed box with faces pointing inwards
+rt::MeshShapePtr CreateInwardBoxMesh(const float size)
+{
+    std::vector<Float3> positions;
+    std::vector<Float3> normals;
+    std::vector<Float3> tangents;
+    std::vector<uint32> indices;
+
+    for (uint32 axis = 0; axis < 3; ++axis)
+    {
+        for (const float side : { -1.0f, 1.0f })
+        {
+            const uint32 axisU = (axis + 1) % 3;
+            const uint32 axisV = (axis + 2) % 3;
+
+            Float3 normal(0.0f, 0.0f, 0.0f);
+            normal.f[axis] = -side;
+
+            Float3 tangent(0.0f, 0.0f, 0.0f);
+            tangent.f[axisU] = 1.0f;
+
+            const uint32 firstVertex = static_cast<uint32>(positions.size());
+            for (const Float2 corner : { Float2(-1.0f, -1.0f), Float2(1.0f, -1.0f), Float2(1.0f, 1.0f), Float2(-1.0f, 1.0f) })
+            {
+                Float3 position;
+                position.f[axis] = side * size;
+                position.f[axisU] = corner.x * size;
+                position.f[axisV] = corner.y * size;
+                positions.push_back(position);
+                normals.push_back(normal);
+                tangents.push_back(tangent);
+            }
+
+            // (U x V) = axis, so flip the winding for the positive side to face inwards
+            const uint32 quad[] = { 0, 1, 2, 0, 2, 3 };
+            const uint32 quadFlipped[] = { 0, 2, 1, 0, 3, 2 };
+            for (uint32 i = 0; i < 6; ++i)
+            {
+                indices.push_back(firstVertex + (side > 0.0f ? quadFlipped[i] : quad[i]));
+            }
+        }
+    }
+
+    const std::vector<uint32> materialIndices(indices.size() / 3, UINT32_MAX);
+
+    MeshDesc meshDesc;
+    meshDesc.path = "box";
+    meshDesc.vertexBufferDesc.numTriangles = static_cast<uint32>(materialIndices.size());
+    meshDesc.vertexBufferDesc.numVertices = static_cast<uint32>(positions.size());
+    meshDesc.vertexBufferDesc.materialIndexBuffer = materialIndices.data();
+    meshDesc.vertexBufferDesc.vertexIndexBuffer = indices.data();
+    meshDesc.vertexBufferDesc.positions = positions.data();
+    meshDesc.vertexBufferDesc.normals = normals.data();
+    meshDesc.vertexBufferDesc.tangents = tangents.data();
+
+    rt::MeshShapePtr mesh = std::make_shared<MeshShape>();
+    if (!mesh->Initialize(meshDesc))
+    {
+        return nullptr;
+    }
+
+    return mesh;
+}
+
 void ValidateBitmap(const Bitmap& bitmap, const Vector4& expectedValue, float maxError)
 {
     for (uint32 y = 0; y < bitmap.GetHeight(); ++y)
@@ -254,8 +325,58 @@ void ValidateBitmap(const Bitmap& bitmap, const Vector4& expectedValue, float ma
             EXPECT_NEAR(expectedValue.z, color.z, maxError);
         }
     }
+}
+
+// Checks an image of a scene that converges to a constant color, with tolerances derived from the expected noise level.
+// All the pixels have the same expected value, so the spread of pixel values estimates the per-pixel standard deviation,
+// and the image average (standard deviation of sigma / sqrt(numPixels)) must be within a few of its standard deviations.
+// NOTE: 'expectedRelativeStdDev' is the per-pixel standard deviation relative to the expected value
+void ValidateBitmapStatistics(const Bitmap& bitmap, const Vector4& expectedValue, float expectedRelativeStdDev)
+{
+    const uint32 numPixels = bitmap.GetWidth() * bitmap.GetHeight();
+
+    Vector4 sum = Vector4::Zero();
+    Vector4 sumSquares = Vector4::Zero();
+    for (uint32 y = 0; y < bitmap.GetHeight(); ++y)
+    {
+        for (uint32 x = 0; x < bitmap.GetWidth(); ++x)
+        {
+            const Vector4 color = bitmap.GetPixel(x, y);
+            sum += color;
+            sumSquares += color * color;
+        }
+    }
+
+    const Vector4 average = sum / static_cast<float>(numPixels);
+    const Vector4 variance = (sumSquares - sum * average) / static_cast<float>(numPixels - 1u);
+    const Vector4 expectedStdDev = expectedValue * expectedRelativeStdDev;
+
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        SCOPED_TRACE("channel=" + std::to_string(i));
+
+        // noise must not be higher than expected
+        EXPECT_LT(sqrtf(Max(0.0f, variance[i])), expectedStdDev[i]);
+
+        // bias
+        EXPECT_NEAR(expectedValue[i], average[i], 5.0f * expectedStdDev[i] / sqrtf(static_cast<float>(numPixels)));
+    }
+
+    // catch fireflies
+    for (uint32 y = 0; y < bitmap.GetHeight(); ++y)
+    {
+        SCOPED_TRACE("y=" + std::to_string(y));
+
+        for (uint32 x = 0; x < bitmap.GetWidth(); ++x)
+        {
+            SCOPED_TRACE("x=" + std::to_string(x));
 
-    // TODO compute average image color
+            const Vector4 color = bitmap.GetPixel(x, y);
+            EXPECT_NEAR(expectedValue.x, color.x, 5.0f * expectedStdDev.x);
+            EXPECT_NEAR(expectedValue.y, color.y, 5.0f * expectedStdDev.y);
+            EXPECT_NEAR(expectedValue.z, color.z, 5.0f * expectedStdDev.z);
+        }
+    }
 }
 
 static const std::string g_ouputFilePrefix = "RenderingTests/";
@@ -365,18 +486,25 @@ TEST_F(RenderingTest, FurnaceTest_Diffuse)
     }
 }
 
-TEST_F(RenderingTest, FurnaceTest_Emissive)
+TEST_F(RenderingTest, FurnaceTest_Diffuse_TexturedBackground)
 {
-    const Vector4 emissionColor(3.0f, 2.0f, 1.0f);
-
+    const Vector4 materialColor(0.4f, 0.6f, 0.8f);
     MaterialPtr material = std::make_unique<Material>();
-    material->SetBsdf("null");
-    material->baseColor = Vector4::Zero();
-    material->emission = emissionColor;
+    material->SetBsdf("diffuse");
+    material->baseColor = materialColor;
     material->Compile();
 
+    // constant texture, but sampled via importance map
+    BitmapPtr bitmap = std::make_shared<Bitmap>();
+    {
+        const float data[] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+        ASSERT_TRUE(bitmap->Init({ 4, 2, Bitmap::Format::R32_Float, data }));
+    }
+
     const Vector4 lightColor(1.0f, 2.0f, 3.0f);
     auto backgroundLight = std::make_unique<BackgroundLight>(lightColor);
+    backgroundLight->mTexture = std::make_shared<BitmapTexture>(bitmap);
+    ASSERT_TRUE(backgroundLight->MakeSamplable());
     auto lightObject = std::make_unique<LightSceneObject>(std::move(backgroundLight));
     mScene->AddObject(std::move(lightObject));
 
@@ -393,7 +521,7 @@ TEST_F(RenderingTest, FurnaceTest_Emissive)
     camera.SetPerspective(1.0f, DegToRad(10.0f));
     camera.SetTransform(Transform(Vector4(0.0f, 0.0f, -3.0f)));
 
-    uint32 numPasses = 1;
+    uint32 numPasses = 1000;
 
     for (const char* rendererName : gRendererNames)
     {
@@ -408,30 +536,126 @@ TEST_F(RenderingTest, FurnaceTest_Emissive)
             mViewport->Render(camera);
         }
 
-        Bitmap bitmap = mViewport->GetSumBuffer();
-        bitmap.Scale(Vector4(1.0f / numPasses));
+        Bitmap result = mViewport->GetSumBuffer();
+        result.Scale(Vector4(1.0f / numPasses));
 
-        ValidateBitmap(bitmap, emissionColor, 0.0f);
+        ValidateBitmap(result, lightColor * materialColor, 0.05f);
 
-        std::string outputFilePath = g_ouputFilePrefix + "FurnaceTest_Diffuse_" + rendererName + ".exr";
-        bitmap.SaveEXR(outputFilePath.c_str());
+        std::string outputFilePath = g_ouputFilePrefix + "FurnaceTest_Diffuse_TexturedBackground_" + rendererName + ".exr";
+        result.SaveEXR(outputFilePath.c_str());
     }
 }
 
-TEST_F(RenderingTest, FurnaceTest_Metal)
+TEST_F(RenderingTest, FurnaceTest_Decal_MipSelection)
 {
-    const Vector4 materialColor(0.4f, 0.6f, 0.8f);
+    MaterialPtr material = std::make_unique<Material>();
+    material->SetBsdf("diffuse");
+    material->baseColor = Vector4(0.5f);
+    material->Compile();
+
+    // 4x4 checkerboard - any mip level other than the base one is uniformly gray
+    BitmapPtr bitmap = std::make_shared<Bitmap>();
+    {
+        Vector4 data[4 * 4];
+        for (uint32 y = 0; y < 4; ++y)
+        {
+            for (uint32 x = 0; x < 4; ++x)
+            {
+                data[4 * y + x] = (x + y) % 2 == 0 ? Vector4(1.0f) : Vector4(0.0f, 0.0f, 0.0f, 1.0f);
+            }
+        }
+        ASSERT_TRUE(bitmap->Init({ 4, 4, Bitmap::Format::R32G32B32A32_Float, data }));
+    }
+    const TexturePtr texture = std::make_shared<BitmapTexture>(bitmap);
+
+    const Vector4 lightColor(1.0f, 1.0f, 1.0f);
+    auto backgroundLight = std::make_unique<BackgroundLight>(lightColor);
+    mScene->AddObject(std::make_unique<LightSceneObject>(std::move(backgroundLight)));
+
+    ShapePtr shape = std::make_unique<RectShape>(Float2(10.0f));
+    ShapeSceneObjectPtr sceneObject = std::make_unique<ShapeSceneObject>(std::move(shape));
+    sceneObject->SetDefaultMaterial(material);
+    mScene->AddObject(std::move(sceneObject));
+
+    // decal covering the rectangle, the rectangle is placed at given depth inside the decal box
+    DecalSceneObject* decal = nullptr;
+    {
+        std::unique_ptr<DecalSceneObject> decalObject = std::make_unique<DecalSceneObject>();
+        decalObject->baseColor.texture = texture;
+        decal = decalObject.get();
+        mScene->AddObject(std::move(decalObject));
+    }
+
+    mViewport->Resize(ViewportSize, ViewportSize);
+
+    // camera is looking at the front side of the rectangle, at a white texel (texture is magnified)
+    // NOTE: bilinear filter reaches pure texel value at integer texel coordinates
+    Camera camera;
+    camera.SetPerspective(1.0f, DegToRad(2.0f));
+    camera.SetTransform(Transform(Vector4(0.0f, 0.0f, 3.0f), Quaternion::FromAxisAndAngle(VECTOR_Y, RT_PI)));
+
+    const uint32 numPasses = 20;
+    const float depths[] = { 0.1f, 0.5f, 0.9f };
+
+    for (const float depth : depths)
+    {
+        SCOPED_TRACE("depth=" + std::to_string(depth));
+
+        decal->SetTransform(Matrix4::MakeTranslation(Vector4(0.0f, 0.0f, 1.0f - 2.0f * depth)));
+        mScene->BuildBVH();
+
+        RendererPtr renderer = CreateRenderer("Path Tracer", *mScene);
+        mViewport->SetRenderer(renderer);
+        mViewport->Reset();
+
+        for (uint32 i = 0; i < numPasses; ++i)
+        {
+            mViewport->Render(camera);
+        }
+
+        Bitmap result = mViewport->GetSumBuffer();
+        result.Scale(Vector4(1.0f / numPasses));
+
+        // coarse mip level would result in gray color
+        ValidateBitmap(result, lightColor, 0.15f);
+    }
+}
+
+TEST_F(RenderingTest, MeshLight_Sampling)
+{
+    const rt::MeshShapePtr mesh = CreateInwardBoxMesh(2.0f);
+    ASSERT_TRUE(mesh);
 
+    EXPECT_NEAR(6.0f * 4.0f * 4.0f, mesh->GetSurfaceArea(), 1.0e-4f);
+
+    Random random;
+    for (uint32 i = 0; i < 1000; ++i)
+    {
+        Vector4 normal;
+        float pdf = 0.0f;
+        const Vector4 position = mesh->Sample(random.GetFloat3(), &normal, &pdf);
+
+        // sampled point lies on the box surface and the normal points inwards
+        EXPECT_NEAR(2.0f, Vector4::Abs(position).HorizontalMax().x, 1.0e-4f);
+        EXPECT_LT(Vector4::Dot3(normal, position), 0.0f);
+        EXPECT_NEAR(1.0f, normal.Length3(), 1.0e-4f);
+        EXPECT_NEAR(1.0f / mesh->GetSurfaceArea(), pdf, 1.0e-6f);
+    }
+}
+
+TEST_F(RenderingTest, FurnaceTest_Diffuse_MeshLight)
+{
+    const Vector4 materialColor(0.4f, 0.6f, 0.8f);
     MaterialPtr material = std::make_unique<Material>();
-    material->SetBsdf("metal");
+    material->SetBsdf("diffuse");
     material->baseColor = materialColor;
-    material->IoR = 0.0f;
-    material->K = 100.0;
     material->Compile();
 
+    // diffuse sphere enclosed by an emissive box
     const Vector4 lightColor(1.0f, 2.0f, 3.0f);
-    auto backgroundLight = std::make_unique<BackgroundLight>(lightColor);
-    auto lightObject = std::make_unique<LightSceneObject>(std::move(backgroundLight));
+    const rt::MeshShapePtr lightMesh = CreateInwardBoxMesh(5.0f);
+    ASSERT_TRUE(lightMesh);
+    auto lightObject = std::make_unique<LightSceneObject>(std::make_unique<MeshLight>(lightMesh, lightColor));
     mScene->AddObject(std::move(lightObject));
 
     ShapePtr shape = std::make_unique<SphereShape>(1.0f);
@@ -443,10 +667,18 @@ TEST_F(RenderingTest, FurnaceTest_Metal)
 
     mViewport->Resize(ViewportSize, ViewportSize);
 
+    // single thread and fixed seed, so that the result is reproducible
+    RenderingParams params;
+    params.numThreads = 1;
+    params.samplingParams.seed = 12345;
+    mViewport->SetRenderingParams(params);
+
     Camera camera;
     camera.SetPerspective(1.0f, DegToRad(10.0f));
     camera.SetTransform(Transform(Vector4(0.0f, 0.0f, -3.0f)));
 
+    const uint32 numPasses = 400;
+
     for (const char* rendererName : gRendererNames)
     {
         SCOPED_TRACE(rendererName);
@@ -455,7 +687,64 @@ TEST_F(RenderingTest, FurnaceTest_Metal)
         mViewport->SetRenderer(renderer);
         mViewport->Reset();
 
-        uint32 numPasses = 20;
+        for (uint32 i = 0; i < numPasses; ++i)
+        {
+            mViewport->Render(camera);
+        }
+
+        Bitmap bitmap = mViewport->GetSumBuffer();
+        bitmap.Scale(Vector4(1.0f / numPasses));
+
+        // per-pixel standard deviation after 400 passes is about 0.6% of the value for all the renderers
+        ValidateBitmapStatistics(bitmap, lightColor * materialColor, 0.01f);
+
+        std::string outputFilePath = g_ouputFilePrefix + "FurnaceTest_Diffuse_MeshLight_" + rendererName + ".exr";
+        bitmap.SaveEXR(outputFilePath.c_str());
+    }
+}
+
+// light paths are traced in a separate pass, so their number doesn't have to match number of pixels
+// (light paths budget affects MIS weights and merging normalization, but the result must stay the same)
+TEST_F(RenderingTest, FurnaceTest_Diffuse_MeshLight_LightPathsPerPixel)
+{
+    const Vector4 materialColor(0.4f, 0.6f, 0.8f);
+    MaterialPtr material = std::make_unique<Material>();
+    material->SetBsdf("diffuse");
+    material->baseColor = materialColor;
+    material->Compile();
+
+    // diffuse sphere enclosed by an emissive box
+    const Vector4 lightColor(1.0f, 2.0f, 3.0f);
+    const rt::MeshShapePtr lightMesh = CreateInwardBoxMesh(5.0f);
+    ASSERT_TRUE(lightMesh);
+    auto lightObject = std::make_unique<LightSceneObject>(std::make_unique<MeshLight>(lightMesh, lightColor));
+    mScene->AddObject(std::move(lightObject));
+
+    ShapePtr shape = std::make_unique<SphereShape>(1.0f);
+    ShapeSceneObjectPtr sceneObject = std::make_unique<ShapeSceneObject>(std::move(shape));
+    sceneObject->SetDefaultMaterial(material);
+    mScene->AddObject(std::move(sceneObject));
+
+    mScene->BuildBVH();
+
+    mViewport->Resize(ViewportSize, ViewportSize);
+
+    Camera camera;
+    camera.SetPerspective(1.0f, DegToRad(10.0f));
+    camera.SetTransform(Transform(Vector4(0.0f, 0.0f, -3.0f)));
+
+    const uint32 numPasses = 1000;
+    const float lightPathsPerPixelValues[] = { 0.5f, 2.0f };
+
+    for (const float lightPathsPerPixel : lightPathsPerPixelValues)
+    {
+        SCOPED_TRACE("lightPathsPerPixel=" + std::to_string(lightPathsPerPixel));
+
+        auto renderer = std::make_shared<VertexConnectionAndMerging>(*mScene);
+        renderer->mLightPathsPerPixel = lightPathsPerPixel;
+
+        mViewport->SetRenderer(renderer);
+        mViewport->Reset();
 
         for (uint32 i = 0; i < numPasses; ++i)
         {
@@ -466,17 +755,137 @@ TEST_F(RenderingTest, FurnaceTest_Metal)
         bitmap.Scale(Vector4(1.0f / numPasses));
 
         ValidateBitmap(bitmap, lightColor * materialColor, 0.05f);
+    }
+}
 
-        std::string outputFilePath = g_ouputFilePrefix + "FurnaceTest_Metal_" + rendererName + ".exr";
-        bitmap.SaveEXR(outputFilePath.c_str());
+TEST_F(RenderingTest, AdaptiveRendering_FurnaceTest_Diffuse)
+{
+    const Vector4 materialColor(0.4f, 0.6f, 0.8f);
+    MaterialPtr material = std::make_unique<Material>();
+    material->SetBsdf("diffuse");
+    material->baseColor = materialColor;
+    material->Compile();
+
+    const Vector4 lightColor(1.0f, 2.0f, 3.0f);
+    auto backgroundLight = std::make_unique<BackgroundLight>(lightColor);
+    auto lightObject = std::make_unique<LightSceneObject>(std::move(backgroundLight));
+    mScene->AddObject(std::move(lightObject));
+
+    ShapePtr shape = std::make_unique<SphereShape>(1.0f);
+    ShapeSceneObjectPtr sceneObject = std::make_unique<ShapeSceneObject>(std::move(shape));
+    sceneObject->SetDefaultMaterial(material);
+    mScene->AddObject(std::move(sceneObject));
+
+    mScene->BuildBVH();
+
+    RenderingParams params;
+    params.tileSize = 8;
+    params.adaptiveSettings.enable = true;
+    params.adaptiveSettings.numInitialPasses = 4;
+    params.adaptiveSettings.minBlockSize = 4;
+    params.adaptiveSettings.maxBlockSize = 16;
+    params.adaptiveSettings.subdivisionTreshold = 0.05f;
+    params.adaptiveSettings.convergenceTreshold = 0.01f;
+    mViewport->SetRenderingParams(params);
+    mViewport->Resize(ViewportSize, ViewportSize);
+
+    Camera camera;
+    camera.SetPerspective(1.0f, DegToRad(10.0f));
+    camera.SetTransform(Transform(Vector4(0.0f, 0.0f, -3.0f)));
+
+    RendererPtr renderer = CreateRenderer("Path Tracer", *mScene);
+    mViewport->SetRenderer(renderer);
+    mViewport->Reset();
+
+    const uint32 numPasses = 100;
+    for (uint32 i = 0; i < numPasses; ++i)
+    {
+        mViewport->Render(camera);
+    }
+
+    // each pixel must be normalized by its own number of samples
+    Bitmap bitmap = mViewport->GetSumBuffer();
+    for (uint32 y = 0; y < bitmap.GetHeight(); ++y)
+    {
+        for (uint32 x = 0; x < bitmap.GetWidth(); ++x)
+        {
+            const uint32 numPixelPasses = mViewport->GetNumPixelPasses(x, y);
+            ASSERT_GE(numPixelPasses, params.adaptiveSettings.numInitialPasses);
+            ASSERT_LE(numPixelPasses, numPasses);
+
+            Vector4& pixel = bitmap.GetPixelRef<Vector4>(x, y);
+            pixel /= static_cast<float>(numPixelPasses);
+        }
     }
+
+    ValidateBitmap(bitmap, lightColor * materialColor, 0.05f);
 }
 
-TEST_F(RenderingTest, FurnaceTest_Dielectric)
+TEST_F(RenderingTest, CompactAccumulation_FurnaceTest_Diffuse)
 {
+    const Vector4 materialColor(0.4f, 0.6f, 0.8f);
     MaterialPtr material = std::make_unique<Material>();
-    material->SetBsdf("dielectric");
-    material->baseColor = Vector4(1.0f);
+    material->SetBsdf("diffuse");
+    material->baseColor = materialColor;
+    material->Compile();
+
+    const Vector4 lightColor(1.0f, 2.0f, 3.0f);
+    auto backgroundLight = std::make_unique<BackgroundLight>(lightColor);
+    auto lightObject = std::make_unique<LightSceneObject>(std::move(backgroundLight));
+    mScene->AddObject(std::move(lightObject));
+
+    ShapePtr shape = std::make_unique<SphereShape>(1.0f);
+    ShapeSceneObjectPtr sceneObject = std::make_unique<ShapeSceneObject>(std::move(shape));
+    sceneObject->SetDefaultMaterial(material);
+    mScene->AddObject(std::move(sceneObject));
+
+    mScene->BuildBVH();
+
+    mViewport->Resize(ViewportSize, ViewportSize);
+
+    RenderingParams params;
+    params.accumulationMode = AccumulationMode::CompensatedHalf;
+    mViewport->SetRenderingParams(params);
+
+    Camera camera;
+    camera.SetPerspective(1.0f, DegToRad(10.0f));
+    camera.SetTransform(Transform(Vector4(0.0f, 0.0f, -3.0f)));
+
+    RendererPtr renderer = CreateRenderer("Path Tracer", *mScene);
+    mViewport->SetRenderer(renderer);
+    mViewport->Reset();
+
+    const uint32 numPasses = 100;
+    for (uint32 i = 0; i < numPasses; ++i)
+    {
+        mViewport->Render(camera);
+    }
+
+    ASSERT_EQ(Bitmap::Format::R16G16B16_Half, mViewport->GetSumBuffer().GetFormat());
+
+    // the image holds per-pixel averages
+    ValidateBitmap(mViewport->GetSumBuffer(), lightColor * materialColor, 0.05f);
+
+    for (uint32 y = 0; y < ViewportSize; ++y)
+    {
+        for (uint32 x = 0; x < ViewportSize; ++x)
+        {
+            const Vector4 average = mViewport->GetPixelAverage(x, y);
+            EXPECT_NEAR(lightColor.x * materialColor.x, average.x, 0.05f);
+            EXPECT_NEAR(lightColor.y * materialColor.y, average.y, 0.05f);
+            EXPECT_NEAR(lightColor.z * materialColor.z, average.z, 0.05f);
+        }
+    }
+}
+
+TEST_F(RenderingTest, FurnaceTest_Emissive)
+{
+    const Vector4 emissionColor(3.0f, 2.0f, 1.0f);
+
+    MaterialPtr material = std::make_unique<Material>();
+    material->SetBsdf("null");
+    material->baseColor = Vector4::Zero();
+    material->emission = emissionColor;
     material->Compile();
 
     const Vector4 lightColor(1.0f, 2.0f, 3.0f);
@@ -497,6 +906,8 @@ TEST_F(RenderingTest, FurnaceTest_Dielectric)
     camera.SetPerspective(1.0f, DegToRad(10.0f));
     camera.SetTransform(Transform(Vector4(0.0f, 0.0f, -3.0f)));
 
+    uint32 numPasses = 1;
+
     for (const char* rendererName : gRendererNames)
     {
         SCOPED_TRACE(rendererName);
@@ -505,8 +916,6 @@ TEST_F(RenderingTest, FurnaceTest_Dielectric)
         mViewport->SetRenderer(renderer);
         mViewport->Reset();
 
-        uint32 numPasses = 1000;
-
         for (uint32 i = 0; i < numPasses; ++i)
         {
             mViewport->Render(camera);
@@ -515,11 +924,656 @@ TEST_F(RenderingTest, FurnaceTest_Dielectric)
         Bitmap bitmap = mViewport->GetSumBuffer();
         bitmap.Scale(Vector4(1.0f / numPasses));
 
-        ValidateBitmap(bitmap, lightColor, 0.075f);
+        ValidateBitmap(bitmap, emissionColor, 0.0f);
+
+        std::string outputFilePath = g_ouputFilePrefix + "FurnaceTest_Diffuse_" + rendererName + ".exr";
+        bitmap.SaveEXR(outputFilePath.c_str());
+    }
+}
+
+TEST_F(RenderingTest, FurnaceTest_Metal)
+{
+    const Vector4 materialColor(0.4f, 0.6f, 0.8f);
+
+    MaterialPtr material = std::make_unique<Material>();
+    material->SetBsdf("metal");
+    material->baseColor = materialColor;
+    material->IoR = 0.0f;
+    material->K = 100.0;
+    material->Compile();
+
+    const Vector4 lightColor(1.0f, 2.0f, 3.0f);
+    auto backgroundLight = std::make_unique<BackgroundLight>(lightColor);
+    auto lightObject = std::make_unique<LightSceneObject>(std::move(backgroundLight));
+    mScene->AddObject(std::move(lightObject));
+
+    ShapePtr shape = std::make_unique<SphereShape>(1.0f);
+    ShapeSceneObjectPtr sceneObject = std::make_unique<ShapeSceneObject>(std::move(shape));
+    sceneObject->SetDefaultMaterial(material);
+    mScene->AddObject(std::move(sceneObject));
+
+    mScene->BuildBVH();
+
+    mViewport->Resize(ViewportSize, ViewportSize);
+
+    Camera camera;
+    camera.SetPerspective(1.0f, DegToRad(10.0f));
+    camera.SetTransform(Transform(Vector4(0.0f, 0.0f, -3.0f)));
+
+    for (const char* rendererName : gRendererNames)
+    {
+        SCOPED_TRACE(rendererName);
+
+        RendererPtr renderer = CreateRenderer(rendererName, *mScene);
+        mViewport->SetRenderer(renderer);
+        mViewport->Reset();
+
+        uint32 numPasses = 20;
+
+        for (uint32 i = 0; i < numPasses; ++i)
+        {
+            mViewport->Render(camera);
+        }
+
+        Bitmap bitmap = mViewport->GetSumBuffer();
+        bitmap.Scale(Vector4(1.0f / numPasses));
+
+        ValidateBitmap(bitmap, lightColor * materialColor, 0.05f);
+
+        std::string outputFilePath = g_ouputFilePrefix + "FurnaceTest_Metal_" + rendererName + ".exr";
+        bitmap.SaveEXR(outputFilePath.c_str());
+    }
+}
+
+TEST_F(RenderingTest, FurnaceTest_Dielectric)
+{
+    MaterialPtr material = std::make_unique<Material>();
+    material->SetBsdf("dielectric");
+    material->baseColor = Vector4(1.0f);
+    material->Compile();
+
+    const Vector4 lightColor(1.0f, 2.0f, 3.0f);
+    auto backgroundLight = std::make_unique<BackgroundLight>(lightColor);
+    auto lightObject = std::make_unique<LightSceneObject>(std::move(backgroundLight));
+    mScene->AddObject(std::move(lightObject));
+
+    ShapePtr shape = std::make_unique<SphereShape>(1.0f);
+    ShapeSceneObjectPtr sceneObject = std::make_unique<ShapeSceneObject>(std::move(shape));
+    sceneObject->SetDefaultMaterial(material);
+    mScene->AddObject(std::move(sceneObject));
+
+    mScene->BuildBVH();
+
+    mViewport->Resize(ViewportSize, ViewportSize);
+
+    Camera camera;
+    camera.SetPerspective(1.0f, DegToRad(10.0f));
+    camera.SetTransform(Transform(Vector4(0.0f, 0.0f, -3.0f)));
+
+    for (const char* rendererName : gRendererNames)
+    {
+        SCOPED_TRACE(rendererName);
+
+        RendererPtr renderer = CreateRenderer(rendererName, *mScene);
+        mViewport->SetRenderer(renderer);
+        mViewport->Reset();
+
+        uint32 numPasses = 1000;
+
+        for (uint32 i = 0; i < numPasses; ++i)
+        {
+            mViewport->Render(camera);
+        }
+
+        Bitmap bitmap = mViewport->GetSumBuffer();
+        bitmap.Scale(Vector4(1.0f / numPasses));
+
+        ValidateBitmap(bitmap, lightColor, 0.075f);
 
         std::string outputFilePath = g_ouputFilePrefix + "FurnaceTest_Dielectric_" + rendererName + ".exr";
         bitmap.SaveEXR(outputFilePath.c_str());
     }
 }
 
+// after warm-up, rendering a frame must not allocate any heap memory
+TEST_F(RenderingTest, SteadyStateFramesDontAllocate)
+{
+    MaterialPtr material = std::make_unique<Material>();
+    material->SetBsdf("diffuse");
+    material->baseColor = Vector4(0.5f);
+    material->Compile();
+
+    auto backgroundLight = std::make_unique<BackgroundLight>(Vector4(1.0f));
+    auto lightObject = std::make_unique<LightSceneObject>(std::move(backgroundLight));
+    mScene->AddObject(std::move(lightObject));
+
+    ShapePtr shape = std::make_unique<SphereShape>(1.0f);
+    ShapeSceneObjectPtr sceneObject = std::make_unique<ShapeSceneObject>(std::move(shape));
+    sceneObject->SetDefaultMaterial(material);
+    mScene->AddObject(std::move(sceneObject));
+
+    mScene->BuildBVH();
+
+    // single thread, so that the rendering is deterministic
+    RenderingParams params;
+    params.numThreads = 1;
+    params.tileSize = 8;
+    params.adaptiveSettings.enable = true;
+    params.adaptiveSettings.numInitialPasses = 2;
+    params.adaptiveSettings.subdivisionTreshold = 1.0f;
+    mViewport->SetRenderingParams(params);
+    mViewport->Resize(ViewportSize, ViewportSize);
+
+    Camera camera;
+    camera.SetPerspective(1.0f, DegToRad(60.0f));
+    camera.SetTransform(Transform(Vector4(0.0f, 0.0f, -3.0f)));
+
+    for (const char* rendererName : gRendererNames)
+    {
+        SCOPED_TRACE(rendererName);
+
+        RendererPtr renderer = CreateRenderer(rendererName, *mScene);
+        mViewport->SetRenderer(renderer);
+        mViewport->Reset();
+
+        for (uint32 i = 0; i < 20; ++i)
+        {
+            mViewport->Render(camera);
+        }
+
+        const uint64 numAllocationsBefore = GetNumHeapAllocations();
+
+        for (uint32 i = 0; i < 10; ++i)
+        {
+            mViewport->Render(camera);
+        }
+
+        EXPECT_EQ(numAllocationsBefore, GetNumHeapAllocations());
+
+        // adaptive blocks list must have been updated (blocks are split down to the minimum size)
+        EXPECT_LT(1u, mViewport->GetProgress().activeBlocks);
+    }
+}
+
+TEST_F(RenderingTest, ResolutionCascade_FurnaceTest_Diffuse)
+{
+    const Vector4 materialColor(0.4f, 0.6f, 0.8f);
+    MaterialPtr material = std::make_unique<Material>();
+    material->SetBsdf("diffuse");
+    material->baseColor = materialColor;
+    material->Compile();
+
+    const Vector4 lightColor(1.0f, 2.0f, 3.0f);
+    auto backgroundLight = std::make_unique<BackgroundLight>(lightColor);
+    auto lightObject = std::make_unique<LightSceneObject>(std::move(backgroundLight));
+    mScene->AddObject(std::move(lightObject));
+
+    ShapePtr shape = std::make_unique<SphereShape>(1.0f);
+    ShapeSceneObjectPtr sceneObject = std::make_unique<ShapeSceneObject>(std::move(shape));
+    sceneObject->SetDefaultMaterial(material);
+    mScene->AddObject(std::move(sceneObject));
+
+    mScene->BuildBVH();
+
+    RenderingParams params;
+    params.tileSize = 6; // tiles not aligned to the cascade lattice
+    params.resolutionCascadeLevels = 2;
+    mViewport->SetRenderingParams(params);
+    mViewport->Resize(ViewportSize, ViewportSize);
+
+    // make the post process output deterministic
+    PostprocessParams postprocessParams;
+    postprocessParams.ditheringStrength = 0.0f;
+    mViewport->SetPostprocessParams(postprocessParams);
+
+    Camera camera;
+    camera.SetPerspective(1.0f, DegToRad(10.0f));
+    camera.SetTransform(Transform(Vector4(0.0f, 0.0f, -3.0f)));
+
+    RendererPtr renderer = CreateRenderer("Path Tracer", *mScene);
+    mViewport->SetRenderer(renderer);
+    mViewport->Reset();
+
+    // 1/16 of pixels, then 1/4 of pixels
+    const uint32 cascadeSteps[] = { 4, 2 };
+    for (const uint32 step : cascadeSteps)
+    {
+        SCOPED_TRACE("step=" + std::to_string(step));
+
+        mViewport->Render(camera);
+
+        const Bitmap& frontBuffer = mViewport->GetFrontBuffer();
+        for (uint32 y = 0; y < ViewportSize; ++y)
+        {
+            for (uint32 x = 0; x < ViewportSize; ++x)
+            {
+                const bool isRendered = x % step == 0 && y % step == 0;
+                ASSERT_EQ(isRendered ? 1u : 0u, mViewport->GetNumPixelPasses(x, y)) << "x=" << x << ", y=" << y;
+
+                // missing pixels are upsampled
+                const uint32 sourceX = x - x % step;
+                const uint32 sourceY = y - y % step;
+                ASSERT_EQ(frontBuffer.GetPixelRef<uint32>(sourceX, sourceY), frontBuffer.GetPixelRef<uint32>(x, y)) << "x=" << x << ", y=" << y;
+            }
+        }
+    }
+
+    // the remaining pixels
+    mViewport->Render(camera);
+    for (uint32 y = 0; y < ViewportSize; ++y)
+    {
+        for (uint32 x = 0; x < ViewportSize; ++x)
+        {
+            ASSERT_EQ(1u, mViewport->GetNumPixelPasses(x, y)) << "x=" << x << ", y=" << y;
+        }
+    }
+
+    // regular passes afterwards
+    const uint32 numPasses = 100;
+    for (uint32 i = 1; i < numPasses; ++i)
+    {
+        mViewport->Render(camera);
+    }
+
+    Bitmap bitmap = mViewport->GetSumBuffer();
+    for (uint32 y = 0; y < bitmap.GetHeight(); ++y)
+    {
+        for (uint32 x = 0; x < bitmap.GetWidth(); ++x)
+        {
+            ASSERT_EQ(numPasses, mViewport->GetNumPixelPasses(x, y));
+        }
+    }
+    bitmap.Scale(Vector4(1.0f / numPasses));
+
+    ValidateBitmap(bitmap, lightColor * materialColor, 0.05f);
+}
+
+TEST_F(RenderingTest, ResolutionCascade_LightTracer)
+{
+    const Vector4 materialColor(0.4f, 0.6f, 0.8f);
+    MaterialPtr material = std::make_unique<Material>();
+    material->SetBsdf("diffuse");
+    material->baseColor = materialColor;
+    material->Compile();
+
+    // diffuse sphere enclosed by an emissive box
+    const Vector4 lightColor(1.0f, 2.0f, 3.0f);
+    const rt::MeshShapePtr lightMesh = CreateInwardBoxMesh(5.0f);
+    ASSERT_TRUE(lightMesh);
+    auto lightObject = std::make_unique<LightSceneObject>(std::make_unique<MeshLight>(lightMesh, lightColor));
+    mScene->AddObject(std::move(lightObject));
+
+    ShapePtr shape = std::make_unique<SphereShape>(1.0f);
+    ShapeSceneObjectPtr sceneObject = std::make_unique<ShapeSceneObject>(std::move(shape));
+    sceneObject->SetDefaultMaterial(material);
+    mScene->AddObject(std::move(sceneObject));
+
+    mScene->BuildBVH();
+
+    RenderingParams params;
+    params.resolutionCascadeLevels = 2;
+    mViewport->SetRenderingParams(params);
+    mViewport->Resize(ViewportSize, ViewportSize);
+
+    Camera camera;
+    camera.SetPerspective(1.0f, DegToRad(10.0f));
+    camera.SetTransform(Transform(Vector4(0.0f, 0.0f, -3.0f)));
+
+    RendererPtr renderer = CreateRenderer("Light Tracer", *mScene);
+    mViewport->SetRenderer(renderer);
+    mViewport->Reset();
+
+    // light paths splat onto every pixel, so the cascade must not skip any
+    // (the image itself is too noisy after a few passes to check its brightness)
+    const uint32 numPasses = 4;
+    for (uint32 i = 0; i < numPasses; ++i)
+    {
+        mViewport->Render(camera);
+
+        for (uint32 y = 0; y < ViewportSize; ++y)
+        {
+            for (uint32 x = 0; x < ViewportSize; ++x)
+            {
+                ASSERT_EQ(i + 1, mViewport->GetNumPixelPasses(x, y)) << "x=" << x << ", y=" << y;
+            }
+        }
+    }
+}
+
+TEST_F(RenderingTest, AdaptiveRendering_LightTracer)
+{
+    const Vector4 materialColor(0.4f, 0.6f, 0.8f);
+    MaterialPtr material = std::make_unique<Material>();
+    material->SetBsdf("diffuse");
+    material->baseColor = materialColor;
+    material->Compile();
+
+    // diffuse sphere enclosed by an emissive box
+    const Vector4 lightColor(1.0f, 2.0f, 3.0f);
+    const rt::MeshShapePtr lightMesh = CreateInwardBoxMesh(5.0f);
+    ASSERT_TRUE(lightMesh);
+    auto lightObject = std::make_unique<LightSceneObject>(std::make_unique<MeshLight>(lightMesh, lightColor));
+    mScene->AddObject(std::move(lightObject));
+
+    ShapePtr shape = std::make_unique<SphereShape>(1.0f);
+    ShapeSceneObjectPtr sceneObject = std::make_unique<ShapeSceneObject>(std::move(shape));
+    sceneObject->SetDefaultMaterial(material);
+    mScene->AddObject(std::move(sceneObject));
+
+    mScene->BuildBVH();
+
+    // thresholds high enough for every block to be removed right after the initial passes
+    RenderingParams params;
+    params.tileSize = 8;
+    params.adaptiveSettings.enable = true;
+    params.adaptiveSettings.numInitialPasses = 4;
+    params.adaptiveSettings.minBlockSize = 4;
+    params.adaptiveSettings.maxBlockSize = 16;
+    params.adaptiveSettings.subdivisionTreshold = 1000.0f;
+    params.adaptiveSettings.convergenceTreshold = 1000.0f;
+    mViewport->SetRenderingParams(params);
+    mViewport->Resize(ViewportSize, ViewportSize);
+
+    Camera camera;
+    camera.SetPerspective(1.0f, DegToRad(60.0f));
+    camera.SetTransform(Transform(Vector4(0.0f, 0.0f, -1.5f)));
+
+    RendererPtr renderer = CreateRenderer("Light Tracer", *mScene);
+    mViewport->SetRenderer(renderer);
+    mViewport->Reset();
+
+    const uint32 numPasses = 200;
+    for (uint32 i = 0; i < numPasses; ++i)
+    {
+        mViewport->Render(camera);
+    }
+
+    // light paths splat onto every pixel, so every pixel must keep being rendered
+    const Bitmap& sum = mViewport->GetSumBuffer();
+    Vector4 average = Vector4::Zero();
+    for (uint32 y = 0; y < ViewportSize; ++y)
+    {
+        for (uint32 x = 0; x < ViewportSize; ++x)
+        {
+            ASSERT_EQ(numPasses, mViewport->GetNumPixelPasses(x, y)) << "x=" << x << ", y=" << y;
+            average += sum.GetPixel(x, y, true) / static_cast<float>(mViewport->GetNumPixelPasses(x, y));
+        }
+    }
+    average /= static_cast<float>(ViewportSize * ViewportSize);
+
+    // splats accumulated onto removed blocks would make the image many times too bright
+    // (light tracer estimate is still noisy after 200 passes, so only the image average is checked)
+    const Vector4 expectedColor = lightColor * materialColor;
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        EXPECT_NEAR(expectedColor[i], average[i], 0.25f * expectedColor[i]);
+    }
+}
+
+TEST_F(RenderingTest, FrontBufferTargets)
+{
+    const Vector4 lightColor(0.2f, 0.4f, 0.6f);
+    auto backgroundLight = std::make_unique<BackgroundLight>(lightColor);
+    auto lightObject = std::make_unique<LightSceneObject>(std::move(backgroundLight));
+    mScene->AddObject(std::move(lightObject));
+    mScene->BuildBVH();
+
+    // constant image converges quickly, so nothing is rendered afterwards
+    RenderingParams params;
+    params.tileSize = 8;
+    params.adaptiveSettings.enable = true;
+    params.adaptiveSettings.numInitialPasses = 2;
+    mViewport->SetRenderingParams(params);
+    mViewport->Resize(ViewportSize, ViewportSize);
+
+    // make the post process output deterministic
+    PostprocessParams postprocessParams;
+    postprocessParams.ditheringStrength = 0.0f;
+    mViewport->SetPostprocessParams(postprocessParams);
+
+    Camera camera;
+    camera.SetPerspective(1.0f, DegToRad(90.0f));
+
+    mViewport->SetRenderer(CreateRenderer("Path Tracer", *mScene));
+    mViewport->Reset();
+
+    // reference image from the internal front buffer
+    mViewport->Render(camera);
+    const Bitmap reference = mViewport->GetFrontBuffer();
+
+    Bitmap::InitData initData;
+    initData.width = ViewportSize;
+    initData.height = ViewportSize;
+    initData.format = Bitmap::Format::B8G8R8A8_UNorm;
+
+    Bitmap targetA, targetB;
+    ASSERT_TRUE(targetA.Init(initData));
+    ASSERT_TRUE(targetB.Init(initData));
+
+    Bitmap* targets[] = { &targetA, &targetB };
+    ASSERT_TRUE(mViewport->SetFrontBufferTargets(targets, 2));
+
+    const auto compareWithReference = [&reference](const Bitmap& bitmap)
+    {
+        for (uint32 y = 0; y < ViewportSize; ++y)
+        {
+            for (uint32 x = 0; x < ViewportSize; ++x)
+            {
+                ASSERT_EQ(reference.GetPixelRef<uint32>(x, y), bitmap.GetPixelRef<uint32>(x, y)) << "x=" << x << ", y=" << y;
+            }
+        }
+    };
+
+    // targets are written round-robin
+    mViewport->Render(camera);
+    EXPECT_EQ(0u, mViewport->GetFrontBufferTargetIndex());
+    EXPECT_EQ(targetA.GetData(), mViewport->GetFrontBuffer().GetData());
+    compareWithReference(targetA);
+
+    mViewport->Render(camera);
+    EXPECT_EQ(1u, mViewport->GetFrontBufferTargetIndex());
+    EXPECT_EQ(targetB.GetData(), mViewport->GetFrontBuffer().GetData());
+    compareWithReference(targetB);
+
+    for (uint32 i = 0; i < 100 && mViewport->GetProgress().activeBlocks > 0; ++i)
+    {
+        mViewport->Render(camera);
+    }
+    ASSERT_EQ(0u, mViewport->GetProgress().activeBlocks);
+
+    mViewport->Render(camera);
+    mViewport->Render(camera);
+    ASSERT_EQ(1u, mViewport->GetFrontBufferTargetIndex());
+
+    // overwrite part of the target, as an UI overlay would do
+    for (uint32 y = 3; y < 20; ++y)
+    {
+        for (uint32 x = 5; x < 11; ++x)
+        {
+            targetB.GetPixelRef<uint32>(x, y) = 0xFF00FF00u;
+        }
+    }
+    mViewport->InvalidateFrontBufferTarget(math::Rectangle<uint32>(5, 11, 3, 20));
+
+    mViewport->Render(camera);
+    EXPECT_EQ(0u, mViewport->GetFrontBufferTargetIndex());
+    compareWithReference(targetA);
+
+    mViewport->Render(camera);
+    EXPECT_EQ(1u, mViewport->GetFrontBufferTargetIndex());
+    compareWithReference(targetB);
+
+    // unregistered on resize
+    mViewport->Resize(ViewportSize / 2, ViewportSize / 2);
+    EXPECT_EQ(mViewport->GetWidth(), mViewport->GetFrontBuffer().GetWidth());
+    EXPECT_FALSE(mViewport->SetFrontBufferTargets(targets, 2));
+}
+
+TEST_F(RenderingTest, SceneUpdate_RefitAndReplace)
+{
+    auto backgroundLight = std::make_unique<BackgroundLight>(Vector4(1.0f));
+    mScene->AddObject(std::make_unique<LightSceneObject>(std::move(backgroundLight)));
+
+    const uint32 numSpheres = 4;
+    for (uint32 i = 0; i < numSpheres; ++i)
+    {
+        ShapeSceneObjectPtr sceneObject = std::make_unique<ShapeSceneObject>(std::make_unique<SphereShape>(0.5f));
+        sceneObject->SetTransform(Matrix4::MakeTranslation(Vector4(2.0f * (float)i, 0.0f, 0.0f)));
+        mScene->AddObject(std::move(sceneObject));
+    }
+
+    ASSERT_TRUE(mScene->BuildBVH());
+    ASSERT_EQ(numSpheres + 1u, mScene->GetNumObjects());
+
+    RenderingContext context;
+
+    const auto traceRay = [&](float x, float y) -> const ISceneObject*
+    {
+        // NOTE: slightly tilted, as axis-aligned rays are degenerate in ray-box test
+        const Ray ray(Vector4(x, y, -10.0f), Vector4(0.001f, 0.002f, 1.0f));
+        HitPoint hitPoint;
+        mScene->Traverse({ ray, hitPoint, context });
+        return hitPoint.objectId != RT_INVALID_OBJECT ? mScene->GetHitObject(hitPoint.objectId) : nullptr;
+    };
+
+    for (uint32 i = 0; i < numSpheres; ++i)
+    {
+        EXPECT_EQ(mScene->GetSceneObject(i + 1), traceRay(2.0f * (float)i, 0.0f));
+    }
+
+    // move the second sphere away from the others
+    mScene->GetSceneObject(2)->SetTransform(Matrix4::MakeTranslation(Vector4(10.0f, 5.0f, 0.0f)));
+    ASSERT_TRUE(mScene->RefitBVH());
+
+    EXPECT_EQ(nullptr, traceRay(2.0f, 0.0f));
+    EXPECT_EQ(mScene->GetSceneObject(2), traceRay(10.0f, 5.0f));
+    EXPECT_EQ(mScene->GetSceneObject(1), traceRay(0.0f, 0.0f));
+    EXPECT_EQ(mScene->GetSceneObject(3), traceRay(4.0f, 0.0f));
+
+    // replaced sphere takes the place of the old one
+    {
+        ShapeSceneObjectPtr sceneObject = std::make_unique<ShapeSceneObject>(std::make_unique<SphereShape>(1.5f));
+        sceneObject->SetTransform(Matrix4::MakeTranslation(Vector4(6.0f, 0.0f, 0.0f)));
+        ASSERT_TRUE(mScene->ReplaceObject(4, std::move(sceneObject)));
+        ASSERT_TRUE(mScene->RefitBVH());
+    }
+    EXPECT_EQ(mScene->GetSceneObject(4), traceRay(6.0f, 1.2f));
+
+    // light is replaced with a light of the same kind
+    ASSERT_TRUE(mScene->ReplaceObject(0, std::make_unique<LightSceneObject>(std::make_unique<BackgroundLight>(Vector4(2.0f)))));
+    ASSERT_EQ(1u, mScene->GetGlobalLights().Size());
+    EXPECT_EQ(mScene->GetSceneObject(0), mScene->GetGlobalLights()[0]);
+    EXPECT_EQ(mScene->GetSceneObject(0), mScene->GetLights()[0]);
+
+    // changing object type requires rebuilding the scene
+    EXPECT_FALSE(mScene->ReplaceObject(0, std::make_unique<ShapeSceneObject>(std::make_unique<SphereShape>(1.0f))));
+}
+
+TEST_F(RenderingTest, Reprojection_FurnaceTest_Diffuse)
+{
+    const Vector4 materialColor(0.4f, 0.6f, 0.8f);
+    MaterialPtr material = std::make_unique<Material>();
+    material->SetBsdf("diffuse");
+    material->baseColor = materialColor;
+    material->Compile();
+
+    const Vector4 lightColor(1.0f, 2.0f, 3.0f);
+    auto backgroundLight = std::make_unique<BackgroundLight>(lightColor);
+    auto lightObject = std::make_unique<LightSceneObject>(std::move(backgroundLight));
+    mScene->AddObject(std::move(lightObject));
+
+    ShapePtr shape = std::make_unique<SphereShape>(1.0f);
+    ShapeSceneObjectPtr sceneObject = std::make_unique<ShapeSceneObject>(std::move(shape));
+    sceneObject->SetDefaultMaterial(material);
+    mScene->AddObject(std::move(sceneObject));
+
+    mScene->BuildBVH();
+
+    const uint32 numPasses = 100;
+
+    RenderingParams params;
+    params.tileSize = 6;
+    params.antiAliasingSpread = 0.0f; // every pixel sees either the sphere or the background
+    params.reprojectionSettings.enable = true;
+    params.reprojectionSettings.maxHistoryPasses = numPasses;
+    mViewport->SetRenderingParams(params);
+    mViewport->Resize(ViewportSize, ViewportSize);
+
+    Camera camera;
+    camera.SetPerspective(1.0f, DegToRad(30.0f));
+    camera.SetTransform(Transform(Vector4(0.0f, 0.0f, -5.0f)));
+
+    RendererPtr renderer = CreateRenderer("Path Tracer", *mScene);
+    mViewport->SetRenderer(renderer);
+    mViewport->Reset();
+
+    for (uint32 i = 0; i < numPasses + 1; ++i)
+    {
+        mViewport->Render(camera);
+    }
+
+    // sphere moves by a few pixels
+    Camera newCamera = camera;
+    newCamera.SetTransform(Transform(Vector4(0.3f, 0.0f, -5.0f)));
+    mViewport->Reproject(newCamera);
+
+    RenderingContext context;
+    context.params = &params;
+
+    uint32 numReprojectedPixels = 0;
+    for (uint32 y = 0; y < ViewportSize; ++y)
+    {
+        for (uint32 x = 0; x < ViewportSize; ++x)
+        {
+            SCOPED_TRACE("x=" + std::to_string(x) + ", y=" + std::to_string(y));
+
+            const uint32 pixelPasses = mViewport->GetNumPixelPasses(x, y);
+            if (pixelPasses == 0)
+            {
+                continue;
+            }
+
+            ASSERT_EQ(numPasses, pixelPasses);
+            numReprojectedPixels++;
+
+            const Vector4 coords((float)x / (float)ViewportSize, (float)(ViewportSize - 1 - y) / (float)ViewportSize, 0.0f, 0.0f);
+            const Ray ray = newCamera.GenerateRay(coords, context);
+            HitPoint hitPoint;
+            mScene->Traverse({ ray, hitPoint, context });
+
+            const Vector4 expectedColor = hitPoint.objectId != RT_INVALID_OBJECT ? lightColor * materialColor : lightColor;
+            const Vector4 color = mViewport->GetPixelAverage(x, y);
+            EXPECT_NEAR(expectedColor.x, color.x, 0.05f);
+            EXPECT_NEAR(expectedColor.y, color.y, 0.05f);
+            EXPECT_NEAR(expectedColor.z, color.z, 0.05f);
+        }
+    }
+
+    // newly visible background and pixels entering from the image edge start from scratch
+    EXPECT_GT(numReprojectedPixels, ViewportSize * ViewportSize * 3 / 4);
+    EXPECT_LT(numReprojectedPixels, ViewportSize * ViewportSize);
+
+    mViewport->Render(newCamera);
+    for (uint32 y = 0; y < ViewportSize; ++y)
+    {
+        for (uint32 x = 0; x < ViewportSize; ++x)
+        {
+            const uint32 pixelPasses = mViewport->GetNumPixelPasses(x, y);
+            ASSERT_TRUE(pixelPasses == 1u || pixelPasses == numPasses + 1u) << "x=" << x << ", y=" << y;
+        }
+    }
+
+    // disabled reprojection falls back to reset
+    params.reprojectionSettings.enable = false;
+    mViewport->SetRenderingParams(params);
+    mViewport->Reproject(camera);
+    for (uint32 y = 0; y < ViewportSize; ++y)
+    {
+        for (uint32 x = 0; x < ViewportSize; ++x)
+        {
+            ASSERT_EQ(0u, mViewport->GetNumPixelPasses(x, y));
+        }
+    }
+}
+
 // TODO
\ No newline at end of file
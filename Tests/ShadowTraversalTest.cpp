@@ -0,0 +1,159 @@
+#include "PCH.h"
+#include "../Core/Scene/Scene.h"
+#include "../Core/Scene/Object/SceneObject_Shape.h"
+#include "../Core/Shapes/MeshShape.h"
+#include "../Core/Shapes/SphereShape.h"
+#include "../Core/Rendering/Context.h"
+#include "../Core/Rendering/RendererContext.h"
+#include "../Core/Traversal/TraversalContext.h"
+#include "../Core/Math/Random.h"
+#include "../Core/Math/Transform.h"
+
+using namespace rt;
+using namespace math;
+
+namespace {
+
+// random triangles inside [-1, 1] cube
+MeshShapePtr CreateTriangleSoup(Random& random, const uint32 numTriangles)
+{
+    std::vector<Float3> positions;
+    std::vector<Float3> normals;
+    std::vector<Float3> tangents;
+    std::vector<uint32> indices;
+
+    for (uint32 i = 0; i < numTriangles; ++i)
+    {
+        const Vector4 center = random.GetVector4Bipolar();
+        for (uint32 j = 0; j < 3; ++j)
+        {
+            indices.push_back(static_cast<uint32>(positions.size()));
+            positions.push_back((center + random.GetVector4Bipolar() * 0.3f).ToFloat3());
+            normals.push_back(Float3(0.0f, 0.0f, 1.0f));
+            tangents.push_back(Float3(1.0f, 0.0f, 0.0f));
+        }
+    }
+
+    const std::vector<uint32> materialIndices(numTriangles, UINT32_MAX);
+
+    MeshDesc meshDesc;
+    meshDesc.path = "triangleSoup";
+    meshDesc.vertexBufferDesc.numTriangles = numTriangles;
+    meshDesc.vertexBufferDesc.numVertices = static_cast<uint32>(positions.size());
+    meshDesc.vertexBufferDesc.materialIndexBuffer = materialIndices.data();
+    meshDesc.vertexBufferDesc.vertexIndexBuffer = indices.data();
+    meshDesc.vertexBufferDesc.positions = positions.data();
+    meshDesc.vertexBufferDesc.normals = normals.data();
+    meshDesc.vertexBufferDesc.tangents = tangents.data();
+
+    MeshShapePtr mesh = std::make_shared<MeshShape>();
+    if (!mesh->Initialize(meshDesc))
+    {
+        return nullptr;
+    }
+
+    return mesh;
+}
+
+void AddObject(Scene& scene, Random& random, const ShapePtr& shape, const float positionRange)
+{
+    const Vector4 position = random.GetVector4Bipolar() * positionRange;
+    const Float3 angles = (random.GetVector4() * 6.0f).ToFloat3();
+
+    ShapeSceneObjectPtr sceneObject = std::make_unique<ShapeSceneObject>(shape);
+    sceneObject->SetTransform(Transform(position, Quaternion::FromEulerAngles(angles)).ToMatrix4());
+    scene.AddObject(std::move(sceneObject));
+}
+
+// 8-wide occlusion query must report exactly the same rays as single shadow rays
+// rays are shot from outside towards random points within given range
+void ValidateSimdShadowTraversal(const Scene& scene, Random& random, const float targetRange)
+{
+    RenderingContext context;
+
+    uint32 numOccluded = 0;
+    uint32 numUnoccluded = 0;
+
+    for (uint32 iteration = 0; iteration < 5000; ++iteration)
+    {
+        Ray rays[8];
+        float maxDistances[8];
+        int32 expectedMask = 0;
+
+        // random subset of lanes is active
+        const int32 activeMask = static_cast<int32>(random.GetInt() & 0xFF);
+
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            const Vector4 origin = random.GetVector4Bipolar() * 8.0f;
+            const Vector4 target = random.GetVector4Bipolar() * targetRange;
+            rays[i] = Ray(origin, target - origin);
+            maxDistances[i] = random.GetFloat() * 2.0f * (target - origin).Length3();
+
+            if (activeMask & (1 << i))
+            {
+                HitPoint hitPoint;
+                hitPoint.distance = maxDistances[i];
+                if (scene.Traverse_Shadow({ rays[i], hitPoint, context }))
+                {
+                    expectedMask |= 1 << i;
+                }
+            }
+        }
+
+        Vector8 simdMaxDistances(SimdShadowTraversalContext::TerminatedDistance);
+        for (uint32 i = 0; i < 8; ++i)
+        {
+            if (activeMask & (1 << i))
+            {
+                simdMaxDistances[i] = maxDistances[i];
+            }
+        }
+
+        const Ray_Simd8 simdRay(rays[0], rays[1], rays[2], rays[3], rays[4], rays[5], rays[6], rays[7]);
+        const int32 occludedMask = scene.Traverse_Shadow_Simd8({ simdRay, simdMaxDistances, context });
+
+        ASSERT_EQ(expectedMask, occludedMask);
+
+        numOccluded += PopCount(expectedMask);
+        numUnoccluded += PopCount(activeMask & ~expectedMask);
+    }
+
+    // make sure both cases are actually tested
+    EXPECT_GT(numOccluded, 1000u);
+    EXPECT_GT(numUnoccluded, 1000u);
+}
+
+} // namespace
+
+TEST(ShadowTraversalTest, SingleMesh)
+{
+    Random random;
+
+    Scene scene;
+    AddObject(scene, random, CreateTriangleSoup(random, 256), 0.0f);
+    ASSERT_TRUE(scene.BuildBVH());
+
+    ValidateSimdShadowTraversal(scene, random, 1.0f);
+}
+
+TEST(ShadowTraversalTest, MultipleObjects)
+{
+    Random random;
+
+    Scene scene;
+    for (uint32 i = 0; i < 8; ++i)
+    {
+        AddObject(scene, random, CreateTriangleSoup(random, 64), 3.0f);
+    }
+
+    // shapes without 8-wide intersection code
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        AddObject(scene, random, std::make_shared<SphereShape>(0.5f), 3.0f);
+    }
+
+    ASSERT_TRUE(scene.BuildBVH());
+
+    ValidateSimdShadowTraversal(scene, random, 3.0f);
+}
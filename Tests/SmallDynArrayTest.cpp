@@ -0,0 +1,174 @@
+#include "PCH.h"
+#include "../Core/Containers/SmallDynArray.h"
+
+using namespace rt;
+
+#include "TestClasses.h"
+
+TEST(SmallDynArray, Empty)
+{
+    SmallDynArray<int, 4> array;
+
+    EXPECT_EQ(0u, array.Size());
+    EXPECT_TRUE(array.Empty());
+    EXPECT_TRUE(array.IsInline());
+    EXPECT_EQ(4u, array.Capacity());
+    EXPECT_EQ(array.Begin(), array.End());
+}
+
+TEST(SmallDynArray, PushBack_Inline)
+{
+    SmallDynArray<int, 4> array;
+
+    const uint64 numAllocationsBefore = GetNumHeapAllocations();
+
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_NE(array.End(), array.PushBack(i));
+    }
+
+    EXPECT_EQ(numAllocationsBefore, GetNumHeapAllocations());
+    EXPECT_TRUE(array.IsInline());
+    ASSERT_EQ(4u, array.Size());
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(i, array[i]);
+    }
+}
+
+TEST(SmallDynArray, PushBack_Spill)
+{
+    SmallDynArray<int, 4> array;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        ASSERT_NE(array.End(), array.PushBack(i));
+    }
+
+    EXPECT_FALSE(array.IsInline());
+    ASSERT_EQ(100u, array.Size());
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(i, array[i]);
+    }
+
+    // keeps heap buffer
+    array.Clear();
+    EXPECT_TRUE(array.Empty());
+    EXPECT_FALSE(array.IsInline());
+
+    // goes back to inline storage
+    array.PushBack(1);
+    array.Clear(true);
+    EXPECT_TRUE(array.Empty());
+    EXPECT_TRUE(array.IsInline());
+    EXPECT_EQ(4u, array.Capacity());
+}
+
+TEST(SmallDynArray, PopBack)
+{
+    SmallDynArray<int, 2> array;
+    EXPECT_FALSE(array.PopBack());
+
+    array.PushBack(1);
+    array.PushBack(2);
+    array.PushBack(3);
+
+    EXPECT_TRUE(array.PopBack());
+    ASSERT_EQ(2u, array.Size());
+    EXPECT_EQ(2, array.Back());
+}
+
+TEST(SmallDynArray, Resize)
+{
+    SmallDynArray<int, 8> array;
+
+    ASSERT_TRUE(array.Resize(5));
+    EXPECT_EQ(5u, array.Size());
+    EXPECT_TRUE(array.IsInline());
+
+    ASSERT_TRUE(array.Resize(20));
+    EXPECT_EQ(20u, array.Size());
+    EXPECT_FALSE(array.IsInline());
+
+    ASSERT_TRUE(array.Resize(3));
+    EXPECT_EQ(3u, array.Size());
+}
+
+TEST(SmallDynArray, CopyAndMove)
+{
+    // both inline and heap storage
+    const uint32 sizes[] = { 3, 30 };
+
+    for (const uint32 size : sizes)
+    {
+        SCOPED_TRACE("size=" + std::to_string(size));
+
+        SmallDynArray<int, 4> array;
+        for (uint32 i = 0; i < size; ++i)
+        {
+            array.PushBack(static_cast<int>(i));
+        }
+
+        SmallDynArray<int, 4> copy(array);
+        ASSERT_EQ(size, copy.Size());
+        EXPECT_EQ(array.IsInline(), copy.IsInline());
+        EXPECT_NE(array.Data(), copy.Data());
+
+        SmallDynArray<int, 4> moved(std::move(copy));
+        ASSERT_EQ(size, moved.Size());
+        EXPECT_TRUE(copy.Empty());
+        EXPECT_TRUE(copy.IsInline());
+
+        SmallDynArray<int, 4> assigned;
+        assigned = std::move(moved);
+        ASSERT_EQ(size, assigned.Size());
+        EXPECT_TRUE(moved.Empty());
+
+        for (uint32 i = 0; i < size; ++i)
+        {
+            EXPECT_EQ(static_cast<int>(i), assigned[i]);
+        }
+    }
+}
+
+TEST(SmallDynArray, NonTrivialType)
+{
+    using TestClass = MoveOnlyTestClass<int>;
+
+    ClassMethodCallCounters counters;
+    {
+        SmallDynArray<TestClass, 2> array;
+        for (int i = 0; i < 10; ++i)
+        {
+            array.EmplaceBack(&counters, i);
+        }
+
+        EXPECT_EQ(10, counters.constructor);
+        EXPECT_GT(counters.moveConstructor, 0);
+
+        SmallDynArray<TestClass, 2> moved(std::move(array));
+        EXPECT_EQ(10u, moved.Size());
+        EXPECT_EQ(TestClass(nullptr, 9), moved.Back());
+    }
+    EXPECT_EQ(10, counters.destructor);
+}
+
+TEST(SmallDynArray, View)
+{
+    SmallDynArray<int, 4> array;
+    array.PushBack(10);
+    array.PushBack(20);
+
+    const ArrayView<int>& view = array;
+    ASSERT_EQ(2u, view.Size());
+    EXPECT_EQ(10, view[0]);
+    EXPECT_EQ(20, view[1]);
+
+    int sum = 0;
+    for (const int value : array)
+    {
+        sum += value;
+    }
+    EXPECT_EQ(30, sum);
+}